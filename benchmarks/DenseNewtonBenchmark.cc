@@ -0,0 +1,139 @@
+// Copyright (C) Rishabh Iyer, John T. Halloran, and Kai Wei
+// Licensed under the Open Software License version 3.0
+// See COPYING or http://opensource.org/licenses/OSL-3.0
+/*
+        Passes over the data and wall-clock time of Newton's method (newton, with the hessian built by the
+        blocked Gram kernel of DenseLinearAlgebra.h), tron and lbfgsMin on dense problems of small
+        dimension. All start at 0 and stop at the same relative gradient norm -eps; the table reports the
+        passes over the data (an eval, a line search direction or a Hessian vector product is one pass, an
+        eval with the dense hessian two), the seconds and the objective. The synthetic profile has n x m dense rows with columns scaled by
+        10^u, u uniform in [-1.5, 1.5], labelled by a noisy random linear model. The Gram kernel alone is
+        timed first.
+ *
+ */
+
+#include <iostream>
+#include <cstdlib>
+#include <time.h>
+#include "../src/jensen.h"
+using namespace jensen;
+using namespace std;
+int n = 20000;
+int m = 300;
+double lambda = 1;
+double eps = 1e-6;
+int nThreads = 0;
+char* help = NULL;
+
+Arg Arg::Args[]={
+	Arg("n", Arg::Opt, n, "number of rows (default 20000)",Arg::SINGLE),
+	Arg("m", Arg::Opt, m, "number of features (default 300)",Arg::SINGLE),
+	Arg("reg", Arg::Opt, lambda, "regularization parameter (default 1)",Arg::SINGLE),
+	Arg("eps", Arg::Opt, eps, "relative gradient norm to stop at (default 1e-6)",Arg::SINGLE),
+	Arg("nThreads", Arg::Opt, nThreads, "threads of the Gram kernel and the losses (default 0: all cores)",Arg::SINGLE),
+	Arg("help", Arg::Help, help, "Print this message"),
+	Arg()
+};
+
+// Forwards to a function and counts the passes an algorithm makes over the data.
+class CountingFunction : public ContinuousFunctions {
+const ContinuousFunctions& c;
+public:
+mutable int passes;
+CountingFunction(const ContinuousFunctions& c) : ContinuousFunctions(c), c(c), passes(0) {
+}
+double eval(const Vector& x) const {
+	passes++;
+	return c.eval(x);
+}
+void eval(const Vector& x, double& f, Vector& g) const {
+	passes++;
+	c.eval(x, f, g);
+}
+bool evalDenseHessian(const Vector& x, double& f, Vector& g, Vector& H) const {
+	passes += 2;
+	return c.evalDenseHessian(x, f, g, H);
+}
+void evalHessianVectorProduct(const Vector& x, const Vector& v, Vector& Hxv) const {
+	passes++;
+	c.evalHessianVectorProduct(x, v, Hxv);
+}
+bool prepareDirection(const Vector& x, const Vector& d) const {
+	passes++;
+	return c.prepareDirection(x, d);
+}
+double evalAlongDirection(const double a) const {
+	return c.evalAlongDirection(a);
+}
+};
+
+static void syntheticDataset(std::vector<DenseFeature>& data, Vector& y){
+	srand(1);
+	Vector scale(m), w(m);
+	for (int j = 0; j < m; j++) {
+		scale[j] = pow(10.0, 3.0*rand()/RAND_MAX - 1.5);
+		w[j] = (2.0*rand()/RAND_MAX - 1)/scale[j];
+	}
+	data.resize(n);
+	y.resize(n);
+	for (int i = 0; i < n; i++) {
+		data[i].index = i;
+		data[i].numFeatures = m;
+		data[i].featureVec.resize(m);
+		double s = 0;
+		for (int j = 0; j < m; j++) {
+			data[i].featureVec[j] = (2.0*rand()/RAND_MAX - 1)*scale[j];
+			s += w[j]*data[i].featureVec[j];
+		}
+		y[i] = (s + 3*(2.0*rand()/RAND_MAX - 1) > 0) ? 1 : -1;
+	}
+}
+
+static void benchmark(const char* name, const ContinuousFunctions& loss){
+	const char* algorithms[] = {"newton", "tron", "lbfgs"};
+	for (int a = 0; a < 3; a++) {
+		CountingFunction c(loss);
+		Vector x0(m, 0);
+		double start = now();
+		Vector x;
+		if (a == 0)
+			x = newton(c, x0, 1e-4, 1000, eps, 0);
+		else if (a == 1)
+			x = tron(c, x0, 1000, eps, 0);
+		else {
+			double f;
+			Vector g;
+			loss.eval(x0, f, g);
+			x = lbfgsMin(c, x0, 1, 1e-4, 1000, 100, eps*norm(g), true, false, 0);
+		}
+		double seconds = now() - start;
+		printf("%-12s %-8s %8d %10.3f %16.8e\n", name, algorithms[a], c.passes, seconds, loss.eval(x));
+	}
+}
+
+int main(int argc, char** argv){
+	bool parse_was_ok = Arg::parse(argc,(char**)argv);
+	if(!parse_was_ok) {
+		Arg::usage(); exit(-1);
+	}
+	std::vector<DenseFeature> data;
+	Vector y;
+	syntheticDataset(data, y);
+	printf("%d rows, %d features, lambda %g, eps %g\n", n, m, lambda, eps);
+	Vector D(n, 1);
+	Vector G((long int) m*m);
+	double start = now();
+	weightedGram<DenseFeature>(data, D.data(), m, G.data(), nThreads);
+	double seconds = now() - start;
+	printf("Gram X^T D X: %.3f seconds, %.2f GFlop/s\n", seconds, 1e-9*n*m*(m + 1.0)/max(seconds, 1e-9));
+	printf("%-12s %-8s %8s %10s %16s\n", "loss", "method", "passes", "seconds", "objective");
+	L2LogisticLoss<DenseFeature> lr(m, data, y, lambda);
+	L2SmoothSVMLoss<DenseFeature> svm(m, data, y, lambda);
+	if (nThreads > 0) {
+		lr.setNumThreads(nThreads);
+		svm.setNumThreads(nThreads);
+	}
+	benchmark("L2LR", lr);
+	benchmark("L2SmoothSVM", svm);
+	return 0;
+}
@@ -0,0 +1,114 @@
+// Copyright (C) Rishabh Iyer, John T. Halloran, and Kai Wei
+// Licensed under the Open Software License version 3.0
+// See COPYING or http://opensource.org/licenses/OSL-3.0
+/*
+        Wall-clock time of the dual coordinate descent solver SVCDual with 1, 2, 4, ... threads (the
+        parallel sweeps are asynchronous, with atomic updates of w). Every run stops at the same
+        tolerance -eps of the projected gradient; the table reports the primal objective, its relative
+        gap to a reference solved serially to -eps/100 and the speedup over one thread. Without a data
+        file a synthetic sparse text profile (like 20newsgroup, ~80 non-zeros out of 62061 features)
+        with labels from a random linear model is used. For a LIBSVM file, the label of the first row
+        is the positive class.
+ *
+ */
+
+#include <iostream>
+#include <cstdlib>
+#include <time.h>
+#include "../src/jensen.h"
+using namespace jensen;
+using namespace std;
+char* dataFile = NULL;
+int method = 2;
+double lambda = 1;
+double eps = 1e-2;
+int maxIter = 1000;
+int maxThreads = 0;
+char* help = NULL;
+
+Arg Arg::Args[]={
+	Arg("data", Arg::Opt, dataFile, "a LIBSVM or binary dataset to benchmark on (default: synthetic profile)",Arg::SINGLE),
+	Arg("method", Arg::Opt, method, "the loss: 1 (L2 regularized hinge SVM), 2 (L2 regularized smooth SVM)",Arg::SINGLE),
+	Arg("reg", Arg::Opt, lambda, "regularization parameter (default 1)",Arg::SINGLE),
+	Arg("eps", Arg::Opt, eps, "tolerance of the projected gradient (default 1e-2)",Arg::SINGLE),
+	Arg("maxIter", Arg::Opt, maxIter, "maximum number of sweeps (default 1000)",Arg::SINGLE),
+	Arg("threads", Arg::Opt, maxThreads, "largest number of threads (default 0: all cores)",Arg::SINGLE),
+	Arg("help", Arg::Help, help, "Print this message"),
+	Arg()
+};
+
+// Rows with power-law lengths and a skewed feature popularity (feature j is drawn with density ~ j^(-2/3), as
+// words in text), labelled by a random linear model on the 2% most frequent features with 10% label noise.
+static void syntheticDataset(int n, int m, int avgLength, SparseDataset& data, Vector& y){
+	data = SparseDataset(m);
+	y.resize(n);
+	srand(1);
+	Vector w(m, 0);
+	for (int j = 0; j < m/50; j++)
+		w[j] = 2.0*rand()/RAND_MAX - 1;
+	for (int i = 0; i < n; i++) {
+		double u = (rand() + 1.0)/(RAND_MAX + 2.0);
+		int len = min((double) m, max(1.0, 0.5*avgLength/sqrt(u)));
+		SparseFeature f;
+		for (int k = 0; k < len; k++) {
+			double v = (double) rand()/RAND_MAX;
+			f.featureIndex.push_back(min(m - 1, (int) (m*v*v*v)));
+		}
+		sort(f.featureIndex.begin(), f.featureIndex.end());
+		f.featureIndex.erase(unique(f.featureIndex.begin(), f.featureIndex.end()), f.featureIndex.end());
+		f.featureVec.assign(f.featureIndex.size(), 1.0);
+		f.numFeatures = m;
+		f.numUniqueFeatures = f.featureIndex.size();
+		data.push_back(f);
+		y[i] = (w*data[i] > 0) ? 1 : -1;
+		if (rand()%10 == 0)
+			y[i] = -y[i];
+	}
+}
+
+template <class Loss>
+static void benchmark(SparseDataset& data, Vector& y, int solverType){
+	int n = data.size(), m = data.numFeatures();
+	Loss c(m, data, y, lambda);
+	c.setNumThreads(1);
+	srand(1);
+	double fOpt = c.eval(SVCDual(data, y, solverType, lambda, 1e-2*eps, 100*maxIter, 0, 1));
+	printf("%d rows, %d features, %.1f non-zeros per row, reference objective %e\n", n, m, (double) data.nnz()/max(n, 1), fOpt);
+	printf("%-12s %12s %14s %12s %11s\n", "threads", "seconds", "objective", "rel. gap", "speedup");
+	double serialSeconds = 0;
+	for (int threads = 1; threads <= maxThreads; threads *= 2) {
+		srand(1);
+		double start = now();
+		Vector w = SVCDual(data, y, solverType, lambda, eps, maxIter, 0, threads);
+		double seconds = now() - start;
+		if (threads == 1)
+			serialSeconds = seconds;
+		double f = c.eval(w);
+		printf("%-12d %12.3f %14.6e %12.3e %10.2fx\n", threads, seconds, f, (f - fOpt)/fabs(fOpt), serialSeconds/seconds);
+	}
+}
+
+int main(int argc, char** argv){
+	bool parse_was_ok = Arg::parse(argc,(char**)argv);
+	if(!parse_was_ok) {
+		Arg::usage(); exit(-1);
+	}
+	if (maxThreads <= 0)
+		maxThreads = resolveThreads(0);
+	SparseDataset data;
+	Vector y;
+	if (dataFile != NULL) {
+		int n, m;
+		readDataset(dataFile, data, y, n, m);
+		double positive = y[0];
+		for (int i = 0; i < n; i++)
+			y[i] = (y[i] == positive) ? 1 : -1;
+	}
+	else
+		syntheticDataset(15935, 62061, 80, data, y);
+	if (method == 1)
+		benchmark<L2HingeSVMLoss<SparseRow> >(data, y, 1);
+	else
+		benchmark<L2SmoothSVMLoss<SparseRow> >(data, y, 2);
+	return 0;
+}
@@ -0,0 +1,151 @@
+// Copyright (C) Rishabh Iyer, John T. Halloran, and Kai Wei
+// Licensed under the Open Software License version 3.0
+// See COPYING or http://opensource.org/licenses/OSL-3.0
+/*
+        Wall-clock time to a target objective of the serial stochastic gradient solvers (sgd,
+        sgdDecayingLearningRate, sgdAdagrad) and of the lock-free parallel sgdHogwild with 1, 2, 4, ...
+        threads. The target is the objective the serial solver reaches after -epochs epochs, relaxed
+        by the relative -gap. Every configuration is run for 1, 2, 4, ... epochs until it reaches the
+        target. Without a data file a synthetic sparse text profile (like 20newsgroup, ~80 non-zeros
+        out of 62061 features) with labels from a random linear model is used. For a LIBSVM file,
+        the label of the first row is the positive class.
+ *
+ */
+
+#include <iostream>
+#include <cstdlib>
+#include <time.h>
+#include "../src/jensen.h"
+using namespace jensen;
+using namespace std;
+char* dataFile = NULL;
+int method = 1;
+int rule = 0;
+double lambda = 1;
+double alpha = 1e-2;
+int miniBatchSize = 1;
+int epochs = 10;
+double gap = 1e-2;
+int maxThreads = 0;
+char* help = NULL;
+
+Arg Arg::Args[]={
+	Arg("data", Arg::Opt, dataFile, "a LIBSVM or binary dataset to benchmark on (default: synthetic profile)",Arg::SINGLE),
+	Arg("method", Arg::Opt, method, "the loss: 1 (L2 logistic regression), 2 (L2 smooth SVM)",Arg::SINGLE),
+	Arg("rule", Arg::Opt, rule, "the step size rule: 0 (fixed, sgd), 1 (decaying), 2 (AdaGrad)",Arg::SINGLE),
+	Arg("reg", Arg::Opt, lambda, "regularization parameter (default 1)",Arg::SINGLE),
+	Arg("alpha", Arg::Opt, alpha, "step size (default 1e-2)",Arg::SINGLE),
+	Arg("miniBatch", Arg::Opt, miniBatchSize, "mini-batch size (default 1)",Arg::SINGLE),
+	Arg("epochs", Arg::Opt, epochs, "epochs of the serial run defining the target (default 10)",Arg::SINGLE),
+	Arg("gap", Arg::Opt, gap, "relative gap of the target objective (default 1e-2)",Arg::SINGLE),
+	Arg("threads", Arg::Opt, maxThreads, "largest number of threads (default 0: all cores)",Arg::SINGLE),
+	Arg("help", Arg::Help, help, "Print this message"),
+	Arg()
+};
+
+// Rows with power-law lengths and a skewed feature popularity (feature j is drawn with density ~ j^(-2/3), as
+// words in text), labelled by a random linear model on the 2% most frequent features with 10% label noise.
+static void syntheticDataset(int n, int m, int avgLength, SparseDataset& data, Vector& y){
+	data = SparseDataset(m);
+	y.resize(n);
+	srand(1);
+	Vector w(m, 0);
+	for (int j = 0; j < m/50; j++)
+		w[j] = 2.0*rand()/RAND_MAX - 1;
+	for (int i = 0; i < n; i++) {
+		double u = (rand() + 1.0)/(RAND_MAX + 2.0);
+		int len = min((double) m, max(1.0, 0.5*avgLength/sqrt(u)));
+		SparseFeature f;
+		for (int k = 0; k < len; k++) {
+			double v = (double) rand()/RAND_MAX;
+			f.featureIndex.push_back(min(m - 1, (int) (m*v*v*v)));
+		}
+		sort(f.featureIndex.begin(), f.featureIndex.end());
+		f.featureIndex.erase(unique(f.featureIndex.begin(), f.featureIndex.end()), f.featureIndex.end());
+		f.featureVec.assign(f.featureIndex.size(), 1.0);
+		f.numFeatures = m;
+		f.numUniqueFeatures = f.featureIndex.size();
+		data.push_back(f);
+		y[i] = (w*data[i] > 0) ? 1 : -1;
+		if (rand()%10 == 0)
+			y[i] = -y[i];
+	}
+}
+
+// Runs the solver for the given number of epochs (threads = 0: the serial solver), returns the seconds and the objective.
+static double run(const ContinuousFunctions& c, int n, int m, int threads, int numEpochs, double& f){
+	Vector x0(m, 0), x;
+	double start = now();
+	if (threads == 0) {
+		if (rule == 0)
+			x = sgd(c, x0, n, alpha, miniBatchSize, 0, numEpochs + 1, 0, 1);
+		else if (rule == 1)
+			x = sgdDecayingLearningRate(c, x0, n, alpha, miniBatchSize, 0, numEpochs + 1, 0.5, 0, 1);
+		else
+			x = sgdAdagrad(c, x0, n, alpha, miniBatchSize, 0, numEpochs + 1, 0, 1);
+	}
+	else
+		x = sgdHogwild(c, x0, n, alpha, miniBatchSize, 0, numEpochs + 1, (HogwildRule) rule, threads, 0);
+	double seconds = now() - start;
+	f = c.eval(x);
+	return seconds;
+}
+
+// Doubles the number of epochs until the target is reached, returns the seconds of that run (-1 if never reached).
+static double timeToTarget(const ContinuousFunctions& c, int n, int m, int threads, double target, double serialSeconds){
+	double f = 0, seconds = 0;
+	int numEpochs;
+	for (numEpochs = 1; numEpochs <= 4*epochs; numEpochs *= 2) {
+		seconds = run(c, n, m, threads, numEpochs, f);
+		if (f <= target)
+			break;
+	}
+	string label = (threads == 0) ? "serial" : "hogwild, " + to_string(threads) + " threads";
+	if (f > target) {
+		printf("%-22s %8s %12s %14.6e %11s\n", label.c_str(), "-", "-", f, "-");
+		return -1;
+	}
+	printf("%-22s %8d %12.3f %14.6e %10.2fx\n", label.c_str(), numEpochs, seconds, f,
+	       (serialSeconds > 0) ? serialSeconds/seconds : 1.0);
+	return seconds;
+}
+
+template <class Loss>
+static void benchmark(SparseDataset& data, Vector& y){
+	int n = data.size(), m = data.numFeatures();
+	Loss c(m, data, y, lambda);
+	c.setNumThreads(1);                 // the serial solvers and the objective evaluations stay on one thread
+	double fRef;
+	run(c, n, m, 0, epochs, fRef);
+	double target = fRef*(1 + gap);
+	printf("%d rows, %d features, %.1f non-zeros per row, target objective %e\n", n, m, (double) data.nnz()/max(n, 1), target);
+	printf("%-22s %8s %12s %14s %11s\n", "solver", "epochs", "seconds", "objective", "speedup");
+	double serialSeconds = timeToTarget(c, n, m, 0, target, 0);
+	for (int threads = 1; threads <= maxThreads; threads *= 2)
+		timeToTarget(c, n, m, threads, target, serialSeconds);
+}
+
+int main(int argc, char** argv){
+	bool parse_was_ok = Arg::parse(argc,(char**)argv);
+	if(!parse_was_ok) {
+		Arg::usage(); exit(-1);
+	}
+	if (maxThreads <= 0)
+		maxThreads = resolveThreads(0);
+	SparseDataset data;
+	Vector y;
+	if (dataFile != NULL) {
+		int n, m;
+		readDataset(dataFile, data, y, n, m);
+		double positive = y[0];
+		for (int i = 0; i < n; i++)
+			y[i] = (y[i] == positive) ? 1 : -1;
+	}
+	else
+		syntheticDataset(15935, 62061, 80, data, y);
+	if (method == 1)
+		benchmark<L2LogisticLoss<SparseRow> >(data, y);
+	else
+		benchmark<L2SmoothSVMLoss<SparseRow> >(data, y);
+	return 0;
+}
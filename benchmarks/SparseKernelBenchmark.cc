@@ -0,0 +1,118 @@
+// Copyright (C) Rishabh Iyer, John T. Halloran, and Kai Wei
+// Licensed under the Open Software License version 3.0
+// See COPYING or http://opensource.org/licenses/OSL-3.0
+/*
+        A micro-benchmark for the sparse dot product and the sparse AXPY kernels (one pass over all
+        rows of a dataset) on every available instruction set. Without a data file it generates two
+        synthetic row length profiles: short dense-ish rows like heart_scale (13 non-zeros out of
+        14 features) and long power-law rows like 20newsgroup (~80 non-zeros out of 62061 features).
+ *
+ */
+
+#include <iostream>
+#include <cstdlib>
+#include <time.h>
+#include "../src/jensen.h"
+using namespace jensen;
+using namespace std;
+char* dataFile = NULL;
+double seconds = 0.5;
+char* help = NULL;
+
+Arg Arg::Args[]={
+	Arg("data", Arg::Opt, dataFile, "a LIBSVM or binary dataset to benchmark on (default: synthetic profiles)",Arg::SINGLE),
+	Arg("seconds", Arg::Opt, seconds, "minimum running time of each measurement (default 0.5)",Arg::SINGLE),
+	Arg("help", Arg::Help, help, "Print this message"),
+	Arg()
+};
+
+// Rows with the given average length; lengths are drawn from a heavy tailed distribution if powerLaw is set.
+static SparseDataset syntheticDataset(int n, int m, int avgLength, bool powerLaw){
+	SparseDataset data(m);
+	srand(1);
+	vector<int> perm(m);
+	for (int j = 0; j < m; j++)
+		perm[j] = j;
+	for (int i = 0; i < n; i++) {
+		int len = avgLength;
+		if (powerLaw) {
+			double u = (rand() + 1.0)/(RAND_MAX + 2.0);
+			len = min((double) m, max(1.0, 0.5*avgLength/sqrt(u)));
+		}
+		SparseFeature f;
+		for (int k = 0; k < len; k++) {         // partial Fisher-Yates: distinct indices
+			int r = k + rand()%(m - k);
+			swap(perm[k], perm[r]);
+			f.featureIndex.push_back(perm[k]);
+			f.featureVec.push_back(2.0*rand()/RAND_MAX - 1);
+		}
+		sort(f.featureIndex.begin(), f.featureIndex.end());
+		f.numFeatures = m;
+		f.numUniqueFeatures = len;
+		data.push_back(f);
+	}
+	return data;
+}
+
+static void benchmark(const char* name, const SparseDataset& data){
+	int n = data.size();
+	Vector x(data.numFeatures(), 0.5), y(data.numFeatures(), 0);
+	const long int* rowPtr = data.rowPointers();
+	const int* ind = data.indices();
+	const double* val = data.data();
+	printf("\n%s: %d rows, %d features, %.1f non-zeros per row\n", name, n, data.numFeatures(), (double) data.nnz()/max(n, 1));
+	printf("%-22s %14s %14s\n", "kernel", "dot ns/nnz", "axpy ns/nnz");
+	SimdLevel detected = detectSimdLevel();
+	double baseDot = 0, baseAxpy = 0, sink = 0;
+	for (int level = -1; level <= detected; level++) {
+		setReproducibleKernels(level < 0);                 // -1: the plain sequential loop
+		setSimdLevel((SimdLevel) max(level, 0));
+		double t[2];
+		for (int kernel = 0; kernel < 2; kernel++) {
+			long int passes = 0;
+			double start = now(), elapsed;
+			do {
+				for (int i = 0; i < n; i++) {
+					long int s = rowPtr[i], len = rowPtr[i+1] - rowPtr[i];
+					if (kernel == 0)
+						sink += sparseDotKernel(x.data(), ind + s, val + s, len);
+					else
+						sparseAxpyKernel(1e-9, ind + s, val + s, y.data(), len);
+				}
+				passes++;
+				elapsed = now() - start;
+			} while (elapsed < seconds);
+			t[kernel] = 1e9*elapsed/(passes*(double) max(data.nnz(), 1L));
+		}
+		if (level < 0) {
+			baseDot = t[0];
+			baseAxpy = t[1];
+		}
+		string label = (level < 0) ? "sequential" : string(simdLevelName((SimdLevel) level));
+		printf("%-22s %8.3f (%.2fx) %8.3f (%.2fx)\n", label.c_str(), t[0], baseDot/t[0], t[1], baseAxpy/t[1]);
+	}
+	setReproducibleKernels(false);
+	setSimdLevel(detected);
+	if (sink == 12345)                 // keep the dot products alive
+		printf("%g\n", sink + y[0]);
+}
+
+int main(int argc, char** argv){
+	bool parse_was_ok = Arg::parse(argc,(char**)argv);
+	if(!parse_was_ok) {
+		Arg::usage(); exit(-1);
+	}
+	printf("Detected instruction set: %s\n", simdLevelName(detectSimdLevel()));
+	if (dataFile != NULL) {
+		SparseDataset data;
+		Vector labels;
+		int n, m;
+		readDataset(dataFile, data, labels, n, m);
+		benchmark(dataFile, data);
+	}
+	else {
+		benchmark("heart_scale profile", syntheticDataset(270, 14, 13, false));
+		benchmark("20newsgroup profile", syntheticDataset(15935, 62061, 80, true));
+	}
+	return 0;
+}
@@ -0,0 +1,174 @@
+// Copyright (C) Rishabh Iyer, John T. Halloran, and Kai Wei
+// Licensed under the Open Software License version 3.0
+// See COPYING or http://opensource.org/licenses/OSL-3.0
+/*
+        Hessian vector products (HvP) and wall-clock time of the trust region Newton method tron with
+        plain and with diagonal (Jacobi) preconditioned CG, for the losses trained with tron. Both runs
+        start at 0 and stop at the same relative gradient norm -eps; the table reports the accepted
+        steps, the HvP (i.e. CG iterations), the seconds and the objective. Without a data file a
+        synthetic sparse text profile with badly scaled columns (term counts times a per-feature
+        scale spanning three orders of magnitude, as unnormalized features of mixed units) is used.
+        With -sample the HvP use the hessian of that fraction of the rows (subsampled Newton).
+        For a LIBSVM file with -nClasses 2 the label of the first row is the positive class, otherwise
+        the labels are mapped to 0..nClasses-1 for the multi-class losses.
+ *
+ */
+
+#include <iostream>
+#include <cstdlib>
+#include <map>
+#include <time.h>
+#include "../src/jensen.h"
+using namespace jensen;
+using namespace std;
+char* dataFile = NULL;
+int nClasses = 2;
+double lambda = 1;
+double eps = 1e-3;
+int maxIter = 1000;
+double hessianSample = 1;
+int verbosity = 0;
+char* help = NULL;
+
+Arg Arg::Args[]={
+	Arg("data", Arg::Opt, dataFile, "a LIBSVM or binary dataset to benchmark on (default: synthetic profile)",Arg::SINGLE),
+	Arg("nClasses", Arg::Opt, nClasses, "the number of classes (more than 2: the one-vs-rest and softmax losses)",Arg::SINGLE),
+	Arg("reg", Arg::Opt, lambda, "regularization parameter (default 1)",Arg::SINGLE),
+	Arg("eps", Arg::Opt, eps, "relative gradient norm to stop at (default 1e-3)",Arg::SINGLE),
+	Arg("maxIter", Arg::Opt, maxIter, "maximum number of tron iterations (default 1000)",Arg::SINGLE),
+	Arg("sample", Arg::Opt, hessianSample, "fraction of the rows the hessian vector products use (default 1)",Arg::SINGLE),
+	Arg("verb", Arg::Opt, verbosity, "verbosity of tron",Arg::SINGLE),
+	Arg("help", Arg::Help, help, "Print this message"),
+	Arg()
+};
+
+// Forwards to a function and counts the passes tron makes over the data.
+class CountingFunction : public ContinuousFunctions {
+const ContinuousFunctions& c;
+public:
+mutable int evals;
+mutable int hessianProducts;
+CountingFunction(const ContinuousFunctions& c) : ContinuousFunctions(c), c(c), evals(0), hessianProducts(0) {
+}
+double eval(const Vector& x) const {
+	evals++;
+	return c.eval(x);
+}
+void eval(const Vector& x, double& f, Vector& g) const {
+	evals++;
+	c.eval(x, f, g);
+}
+bool evalHessianDiagonal(const Vector& x, double& f, Vector& g, Vector& diagH) const {
+	evals++;
+	return c.evalHessianDiagonal(x, f, g, diagH);
+}
+void evalHessianVectorProduct(const Vector& x, const Vector& v, Vector& Hxv) const {
+	hessianProducts++;
+	c.evalHessianVectorProduct(x, v, Hxv);
+}
+bool prepareHessianSubsample() const {
+	return c.prepareHessianSubsample();
+}
+void evalSubsampledHessianVectorProduct(const Vector& x, const Vector& v, Vector& Hxv, const std::vector<int>& rows) const {
+	hessianProducts++;
+	c.evalSubsampledHessianVectorProduct(x, v, Hxv, rows);
+}
+};
+
+// Rows with power-law lengths and a skewed feature popularity (feature j is drawn with density ~ j^(-2/3), as
+// words in text) and counts times a scale 10^u, u uniform in [-1.5, 1.5], of the feature as values, labelled by a
+// random linear model on the 2% most frequent features.
+static void syntheticDataset(int n, int m, int avgLength, SparseDataset& data, Vector& y){
+	data = SparseDataset(m);
+	y.resize(n);
+	srand(1);
+	Vector scale(m);
+	for (int j = 0; j < m; j++)
+		scale[j] = pow(10.0, 3.0*rand()/RAND_MAX - 1.5);
+	std::vector<Vector> w(max(nClasses, 2), Vector(m, 0));
+	for (int c = 0; c < w.size(); c++)
+		for (int j = 0; j < m/50; j++)
+			w[c][j] = (2.0*rand()/RAND_MAX - 1)/scale[j];
+	for (int i = 0; i < n; i++) {
+		double u = (rand() + 1.0)/(RAND_MAX + 2.0);
+		int len = min((double) m, max(1.0, 0.5*avgLength/sqrt(u)));
+		std::map<int, double> counts;
+		for (int k = 0; k < len; k++) {
+			double v = (double) rand()/RAND_MAX;
+			counts[min(m - 1, (int) (m*v*v*v))] += 1;
+		}
+		SparseFeature f;
+		for (std::map<int, double>::iterator it = counts.begin(); it != counts.end(); it++) {
+			f.featureIndex.push_back(it->first);
+			f.featureVec.push_back(it->second*scale[it->first]);
+		}
+		f.numFeatures = m;
+		f.numUniqueFeatures = f.featureIndex.size();
+		data.push_back(f);
+		if (nClasses <= 2)
+			y[i] = (w[0]*data[i] > 0) ? 1 : -1;
+		else {
+			int best = 0;
+			for (int c = 1; c < nClasses; c++)
+				best = (w[c]*data[i] > w[best]*data[i]) ? c : best;
+			y[i] = best;
+		}
+	}
+}
+
+static void benchmark(const char* name, const ContinuousFunctions& loss){
+	for (int precondition = 0; precondition <= 1; precondition++) {
+		CountingFunction c(loss);
+		double start = now();
+		Vector x = tron(c, Vector(c.size(), 0), maxIter, eps, verbosity, precondition, hessianSample);
+		double seconds = now() - start;
+		int hessianProducts = c.hessianProducts;
+		printf("%-16s %-8s %8d %10d %10.3f %16.8e\n", name, precondition ? "jacobi" : "none", c.evals, hessianProducts,
+		       seconds, loss.eval(x));
+	}
+}
+
+int main(int argc, char** argv){
+	bool parse_was_ok = Arg::parse(argc,(char**)argv);
+	if(!parse_was_ok) {
+		Arg::usage(); exit(-1);
+	}
+	SparseDataset data;
+	Vector y;
+	if (dataFile != NULL) {
+		int n, m;
+		readDataset(dataFile, data, y, n, m);
+		if (nClasses <= 2) {
+			double positive = y[0];
+			for (int i = 0; i < n; i++)
+				y[i] = (y[i] == positive) ? 1 : -1;
+		}
+		else {
+			std::map<double, int> classes;
+			for (int i = 0; i < n; i++)
+				classes.insert(std::make_pair(y[i], (int) classes.size()));
+			if (classes.size() > nClasses) {
+				cout << "The data has " << classes.size() << " classes, more than -nClasses\n";
+				exit(-1);
+			}
+			for (int i = 0; i < n; i++)
+				y[i] = classes[y[i]];
+		}
+	}
+	else
+		syntheticDataset(15935, 62061, 80, data, y);
+	int n = data.size(), m = data.numFeatures();
+	printf("%d rows, %d features, %.1f non-zeros per row, lambda %g, eps %g, hessian sample %g\n", n, m,
+	       (double) data.nnz()/max(n, 1), lambda, eps, hessianSample);
+	printf("%-16s %-8s %8s %10s %10s %16s\n", "loss", "precond", "evals", "HvP", "seconds", "objective");
+	if (nClasses <= 2) {
+		benchmark("L2LR", L2LogisticLoss<SparseRow>(m, data, y, lambda));
+		benchmark("L2SmoothSVM", L2SmoothSVMLoss<SparseRow>(m, data, y, lambda));
+	}
+	else {
+		benchmark("OvR L2LR", L2OneVsRestLoss<SparseRow>(m, data, y, nClasses, lambda, OVR_LOGISTIC));
+		benchmark("OvR L2SmoothSVM", L2OneVsRestLoss<SparseRow>(m, data, y, nClasses, lambda, OVR_SMOOTH_SVM));
+		benchmark("Softmax L2LR", L2SoftmaxLoss<SparseRow>(m, data, y, nClasses, lambda));
+	}
+	return 0;
+}
@@ -27,6 +27,7 @@ int reg_type = 0;
 double tau = 1e-4;
 double eps = 1e-2;
 int verb = 0;
+int nThreads = 0;
 char* help = NULL;
 bool startwith1 = false;
 
@@ -47,8 +48,9 @@ Arg Arg::Args[]={
 	Arg("maxIter", Arg::Opt, maxIter, "Maximum number of iterations (default 250)", Arg::SINGLE),
 	Arg("epsilon", Arg::Opt, eps, "epsilon for convergence (default: 1e-2)", Arg::SINGLE),
 	Arg("algtype", Arg::Opt, algtype, "type of algorithm for training the corresponding method",Arg::SINGLE),
-	Arg("model", Arg::Opt, outFile, "saving the training model",Arg::SINGLE),
+	Arg("model", Arg::Opt, outFile, "save the trained model to this file (binary model format)",Arg::SINGLE),
 	Arg("verb", Arg::Opt, verb, "verbosity",Arg::SINGLE),
+	Arg("nThreads", Arg::Opt, nThreads, "number of threads used for training (default 0: all cores; the asynchronous solvers only run in parallel for more than 1)",Arg::SINGLE),
 	Arg("help", Arg::Help, help, "Print this message"),
 	Arg("startwith1", Arg::Opt, startwith1, "Whether the Label file starts with one or zero"),
 	Arg()
@@ -60,9 +62,11 @@ string algs[] = {"L1 Logistic Regression", "L2 Logistic Regression", "L1 Smooth
 template <class Feature>
 double predictAccuracy(Classifiers<Feature>* c, vector<Feature>& testFeatures, Vector& ytest){
 	assert(testFeatures.size() == ytest.size());
+	Vector labels(testFeatures.size());
+	c->predictBatch(testFeatures, labels);
 	double accuracy = 0;
 	for (int i = 0; i < testFeatures.size(); i++) {
-		if (c->predict(testFeatures[i]) == ytest[i])
+		if (labels[i] == ytest[i])
 			accuracy++;
 	}
 	return accuracy;
@@ -99,7 +103,10 @@ int main(int argc, char** argv){
 		reg_type = 0;
 		Classifiers<SparseFeature>* c = new LogisticRegression<SparseFeature>(trainFeatures, ytrain, mtrain, ntrain, nClasses,
 		                                                                        lambda, algtype, reg_type, maxIter, eps);
+		c->setNumThreads(nThreads);
 		c->train();
+		if (outFile != NULL)
+			c->saveModelBinary(outFile);
 		cout << "Done with Training ... now testing\n";
 		accuracy = predictAccuracy(c, testFeatures, ytest);
 		delete c;
@@ -109,7 +116,10 @@ int main(int argc, char** argv){
 		reg_type = 1;
 		Classifiers<SparseFeature>* c = new LogisticRegression<SparseFeature>(trainFeatures, ytrain, mtrain, ntrain, nClasses,
 		                                                                        lambda, algtype, reg_type, maxIter, eps);
+		c->setNumThreads(nThreads);
 		c->train();
+		if (outFile != NULL)
+			c->saveModelBinary(outFile);
 		cout << "Done with Training ... now testing\n";
 		accuracy = predictAccuracy(c, testFeatures, ytest);
 		delete c;
@@ -119,7 +129,10 @@ int main(int argc, char** argv){
 	{
 		Classifiers<SparseFeature>* c = new L1SmoothSVM<SparseFeature>(trainFeatures, ytrain, mtrain, ntrain, nClasses,
 		                                                               lambda, algtype, maxIter, eps);
+		c->setNumThreads(nThreads);
 		c->train();
+		if (outFile != NULL)
+			c->saveModelBinary(outFile);
 		cout << "Done with Training ... now testing\n";
 		accuracy = predictAccuracy(c, testFeatures, ytest);
 		delete c;
@@ -128,7 +141,10 @@ int main(int argc, char** argv){
 	{
 		Classifiers<SparseFeature>* c = new L2SmoothSVM<SparseFeature>(trainFeatures, ytrain, mtrain, ntrain, nClasses,
 		                                                               lambda, algtype, maxIter, eps);
+		c->setNumThreads(nThreads);
 		c->train();
+		if (outFile != NULL)
+			c->saveModelBinary(outFile);
 		cout << "Done with Training ... now testing\n";
 		accuracy = predictAccuracy(c, testFeatures, ytest);
 		delete c;
@@ -137,7 +153,10 @@ int main(int argc, char** argv){
 	{
 		Classifiers<SparseFeature>* c = new L2HingeSVM<SparseFeature>(trainFeatures, ytrain, mtrain, ntrain, nClasses,
 		                                                              lambda, algtype, maxIter, eps);
+		c->setNumThreads(nThreads);
 		c->train();
+		if (outFile != NULL)
+			c->saveModelBinary(outFile);
 		cout << "Done with Training ... now testing\n";
 		accuracy = predictAccuracy(c, testFeatures, ytest);
 		delete c;
@@ -25,6 +25,9 @@ int reg_type = 0;
 double tau = 1e-4;
 double eps = 1e-2;
 int verb = 0;
+int nThreads = 0;
+int multiClass = 0;
+bool scaledSteps = false;
 bool test = false;
 char* help = NULL;
 
@@ -37,16 +40,19 @@ char* help = NULL;
 // #define TEST
 
 Arg Arg::Args[]={
-	Arg("trainFile", Arg::Req, trainFile, "the input training data file",Arg::SINGLE),
-	Arg("testFile", Arg::Req, testFile, "the input test data file",Arg::SINGLE),
+	Arg("trainFile", Arg::Req, trainFile, "the input training data file (LIBSVM or binary)",Arg::SINGLE),
+	Arg("testFile", Arg::Req, testFile, "the input test data file (LIBSVM or binary)",Arg::SINGLE),
 	Arg("nClasses", Arg::Opt, nClasses, "The number of classes", Arg::SINGLE),
 	Arg("method", Arg::Opt, method, "Training method: 1(L1LR), 2(L2LR), 3(L1SSVM), 4(L2SSVM), 5(L2HSVM)", Arg::SINGLE),
 	Arg("reg", Arg::Opt, lambda, "Regularization parameter (default 1)", Arg::SINGLE),
 	Arg("maxIter", Arg::Opt, maxIter, "Maximum number of iterations (default 250)", Arg::SINGLE),
 	Arg("epsilon", Arg::Opt, eps, "epsilon for convergence (default: 1e-2)", Arg::SINGLE),
 	Arg("algtype", Arg::Opt, algtype, "type of algorithm for training the corresponding method",Arg::SINGLE),
-	Arg("model", Arg::Opt, outFile, "saving the training model",Arg::SINGLE),
+	Arg("model", Arg::Opt, outFile, "save the trained model to this file (binary model format)",Arg::SINGLE),
 	Arg("verb", Arg::Opt, verb, "verbosity",Arg::SINGLE),
+	Arg("nThreads", Arg::Opt, nThreads, "number of threads used for training (default 0: all cores; the asynchronous solvers only run in parallel for more than 1)",Arg::SINGLE),
+	Arg("multiClass", Arg::Opt, multiClass, "multi-class training: 0 (one class at a time), 1 (fused, all classes per pass), 2 (classes in parallel), 3 (softmax, logistic regression only)",Arg::SINGLE),
+	Arg("scaledSteps", Arg::Opt, scaledSteps, "stochastic gradient descent (fixed and decaying step size) of l2 losses in O(nnz) steps on scaled weights",Arg::SINGLE),
 	Arg("test", Arg::Opt, test, "calculate classification accuracy",Arg::SINGLE),
 	Arg("help", Arg::Help, help, "Print this message"),
 	Arg()
@@ -56,11 +62,13 @@ string algs[] = {"L1 Logistic Regression", "L2 Logistic Regression", "L1 Smooth
 	         "L2 Smooth SVM", "L2 Hinge SVM"};
 
 template <class Feature>
-double predictAccuracy(Classifiers<Feature>* c, vector<Feature>& testFeatures, Vector& ytest){
+double predictAccuracy(Classifiers<Feature>* c, typename FeatureSet<Feature>::type& testFeatures, Vector& ytest){
 	assert(testFeatures.size() == ytest.size());
+	Vector labels(testFeatures.size());
+	c->predictBatch(testFeatures, labels);
 	double accuracy = 0;
 	for (int i = 0; i < testFeatures.size(); i++) {
-		if (c->predict(testFeatures[i]) == ytest[i])
+		if (labels[i] == ytest[i])
 			accuracy++;
 	}
 	return accuracy;
@@ -76,11 +84,13 @@ int main(int argc, char** argv){
 	int mtrain; // numFeatures of the training data
 	int ntest; // number of data items in the test set
 	int mtest; // numFeatures of the test data
-	vector<struct SparseFeature> trainFeatures, testFeatures;
+	// Train and test on the contiguous (CSR) representation of the data. Either file can be a
+	// LIBSVM text file or a binary dataset (see ConvertLibSVM), which is memory-mapped.
+	SparseDataset trainData, testData;
 	Vector ytrain, ytest;
-	readFeatureLabelsLibSVM(trainFile, trainFeatures, ytrain, ntrain, mtrain);
+	readDataset(trainFile, trainData, ytrain, ntrain, mtrain);
 	if(test) {
-		readFeatureLabelsLibSVM(testFile, testFeatures, ytest, ntest, mtest);
+		readDataset(testFile, testData, ytest, ntest, mtest);
 		cout << "Done reading the file, the size of the training set is " << ytrain.size() << " and the size of the test set is " <<ytest.size() << endl;
 		cout << "Number of features of the train set is " << mtrain << " and the number of features of the test set is " << mtest << "\n";
 	} else {
@@ -92,17 +102,22 @@ int main(int argc, char** argv){
 		return -1;
 	}
 	cout << "Now training a " << algs[method-1] << " classifier.\n";
-	cout << trainFeatures[1].featureVec[1] << " " << trainFeatures[1].featureIndex[1] << "\n";
+	cout << trainData[1].featureVec[1] << " " << trainData[1].featureIndex[1] << "\n";
 	double accuracy = 0;
 	if (method == L1LR) {
 		reg_type = 0;
-		Classifiers<SparseFeature>* c = new LogisticRegression<SparseFeature>(trainFeatures, ytrain, mtrain, ntrain, nClasses,
-		                                                                        lambda, algtype, reg_type, maxIter, eps);
+		Classifiers<SparseRow>* c = new LogisticRegression<SparseRow>(trainData, ytrain, mtrain, ntrain, nClasses,
+		                                                                   lambda, algtype, reg_type, maxIter, eps);
+		c->setNumThreads(nThreads);
+		c->setMultiClassMode((MultiClassMode) multiClass);
+		c->setScaledSteps(scaledSteps);
 		c->train();
+		if (outFile != NULL)
+			c->saveModelBinary(outFile);
 
 		if(test) {
 			cout << "Done with Training ... now testing\n";
-			accuracy = predictAccuracy(c, testFeatures, ytest);
+			accuracy = predictAccuracy(c, testData, ytest);
 		}
 
 		delete c;
@@ -123,50 +138,70 @@ int main(int argc, char** argv){
 		// cout << "pos=" << pos << ", neg=" << neg << ", tol=" << primal_solver_tol << endl;
 
 		reg_type = 1;
-		Classifiers<SparseFeature>* c = new LogisticRegression<SparseFeature>(trainFeatures, ytrain, mtrain, ntrain, nClasses,
-		                                                                        lambda, algtype, reg_type, maxIter, eps);
+		Classifiers<SparseRow>* c = new LogisticRegression<SparseRow>(trainData, ytrain, mtrain, ntrain, nClasses,
+		                                                                   lambda, algtype, reg_type, maxIter, eps);
+		c->setNumThreads(nThreads);
+		c->setMultiClassMode((MultiClassMode) multiClass);
+		c->setScaledSteps(scaledSteps);
 		c->train();
+		if (outFile != NULL)
+			c->saveModelBinary(outFile);
 
 		if(test) {
 			cout << "Done with Training ... now testing\n";
-			accuracy = predictAccuracy(c, testFeatures, ytest);
+			accuracy = predictAccuracy(c, testData, ytest);
 		}
 
 		delete c;
 
 	}
 	else if (method == L1SSVM) {
-		Classifiers<SparseFeature>* c = new L1SmoothSVM<SparseFeature>(trainFeatures, ytrain, mtrain, ntrain, nClasses,
-		                                                               lambda, algtype, maxIter, eps);
+		Classifiers<SparseRow>* c = new L1SmoothSVM<SparseRow>(trainData, ytrain, mtrain, ntrain, nClasses,
+		                                                          lambda, algtype, maxIter, eps);
+		c->setNumThreads(nThreads);
+		c->setMultiClassMode((MultiClassMode) multiClass);
+		c->setScaledSteps(scaledSteps);
 		c->train();
+		if (outFile != NULL)
+			c->saveModelBinary(outFile);
 
 		if(test) {
 			cout << "Done with Training ... now testing\n";
-			accuracy = predictAccuracy(c, testFeatures, ytest);
+			accuracy = predictAccuracy(c, testData, ytest);
 		}
 
 		delete c;
 	}
 	else if (method == L2SSVM) {
-		Classifiers<SparseFeature>* c = new L2SmoothSVM<SparseFeature>(trainFeatures, ytrain, mtrain, ntrain, nClasses,
-		                                                               lambda, algtype, maxIter, eps);
+		Classifiers<SparseRow>* c = new L2SmoothSVM<SparseRow>(trainData, ytrain, mtrain, ntrain, nClasses,
+		                                                          lambda, algtype, maxIter, eps);
+		c->setNumThreads(nThreads);
+		c->setMultiClassMode((MultiClassMode) multiClass);
+		c->setScaledSteps(scaledSteps);
 		c->train();
+		if (outFile != NULL)
+			c->saveModelBinary(outFile);
 
 		if(test) {
 			cout << "Done with Training ... now testing\n";
-			accuracy = predictAccuracy(c, testFeatures, ytest);
+			accuracy = predictAccuracy(c, testData, ytest);
 		}
 
 		delete c;
 	}
 	else if (method == L2HSVM) {
-		Classifiers<SparseFeature>* c = new L2HingeSVM<SparseFeature>(trainFeatures, ytrain, mtrain, ntrain, nClasses,
-		                                                              lambda, algtype, maxIter, eps);
+		Classifiers<SparseRow>* c = new L2HingeSVM<SparseRow>(trainData, ytrain, mtrain, ntrain, nClasses,
+		                                                         lambda, algtype, maxIter, eps);
+		c->setNumThreads(nThreads);
+		c->setMultiClassMode((MultiClassMode) multiClass);
+		c->setScaledSteps(scaledSteps);
 		c->train();
+		if (outFile != NULL)
+			c->saveModelBinary(outFile);
 
 		if(test) {
 			cout << "Done with Training ... now testing\n";
-			accuracy = predictAccuracy(c, testFeatures, ytest);
+			accuracy = predictAccuracy(c, testData, ytest);
 		}
 		delete c;
 	}
@@ -0,0 +1,134 @@
+// Copyright (C) Rishabh Iyer, John T. Halloran, and Kai Wei
+// Licensed under the Open Software License version 3.0
+// See COPYING or http://opensource.org/licenses/OSL-3.0
+/*
+        Tuning lambda with a regularization path: trains a classifier for -points values of lambda
+        from -lambdaMax down to -lambdaMin, each warm started from the previous one, and reports the
+        training time and the test accuracy of every point. With -cold the path is also trained with
+        cold starts, for comparison.
+ *
+ */
+
+#include <iostream>
+#include <cstdlib>
+#include <string>
+#include "../src/jensen.h"
+using namespace jensen;
+using namespace std;
+char* trainFile = NULL;
+char* testFile = NULL;
+int method = 5;
+int nClasses = 2;
+double lambdaMax = 100;
+double lambdaMin = 0.01;
+int points = 20;
+int maxIter = 250;
+int algtype = 0;
+double eps = 1e-2;
+int nThreads = 0;
+bool cold = false;
+char* help = NULL;
+
+#define L1LR 1
+#define L2LR 2
+#define L1SSVM 3
+#define L2SSVM 4
+#define L2HSVM 5
+
+Arg Arg::Args[]={
+	Arg("trainFile", Arg::Req, trainFile, "the input training data file (LIBSVM or binary)",Arg::SINGLE),
+	Arg("testFile", Arg::Opt, testFile, "the input test data file (LIBSVM or binary), default: the training data",Arg::SINGLE),
+	Arg("nClasses", Arg::Opt, nClasses, "The number of classes", Arg::SINGLE),
+	Arg("method", Arg::Opt, method, "Training method: 1(L1LR), 2(L2LR), 3(L1SSVM), 4(L2SSVM), 5(L2HSVM)", Arg::SINGLE),
+	Arg("algtype", Arg::Opt, algtype, "type of algorithm for training the corresponding method",Arg::SINGLE),
+	Arg("lambdaMax", Arg::Opt, lambdaMax, "largest regularization parameter (default 100)", Arg::SINGLE),
+	Arg("lambdaMin", Arg::Opt, lambdaMin, "smallest regularization parameter (default 0.01)", Arg::SINGLE),
+	Arg("points", Arg::Opt, points, "number of lambdas on the path, spaced on a log scale (default 20)", Arg::SINGLE),
+	Arg("maxIter", Arg::Opt, maxIter, "Maximum number of iterations (default 250)", Arg::SINGLE),
+	Arg("epsilon", Arg::Opt, eps, "epsilon for convergence (default: 1e-2)", Arg::SINGLE),
+	Arg("nThreads", Arg::Opt, nThreads, "number of threads used for training (default 0: all cores; the asynchronous solvers only run in parallel for more than 1)",Arg::SINGLE),
+	Arg("cold", Arg::Opt, cold, "also train every point from a cold start",Arg::SINGLE),
+	Arg("help", Arg::Help, help, "Print this message"),
+	Arg()
+};
+
+template <class Model>
+double predictAccuracy(Model& c, SparseDataset& testFeatures, Vector& ytest){
+	Vector labels(testFeatures.size());
+	c.predictBatch(testFeatures, labels);
+	double accuracy = 0;
+	for (int i = 0; i < testFeatures.size(); i++) {
+		if (labels[i] == ytest[i])
+			accuracy++;
+	}
+	return accuracy/ytest.size();
+}
+
+template <class Model>
+void runPath(Model& c, SparseDataset& testData, Vector& ytest){
+	c.setNumThreads(nThreads);
+	Vector lambdas = lambdaSequence(lambdaMax, lambdaMin, points);
+	RegularizationPath<Model> path = trainPath(c, lambdas);
+	Vector coldSeconds;
+	if (cold)
+		coldSeconds = trainPath(c, lambdas, false).seconds;
+	printf("\n%12s %12s %12s %12s\n", "lambda", "seconds", cold ? "cold seconds" : "", "accuracy");
+	double total = 0, coldTotal = 0;
+	for (int k = 0; k < path.lambdas.size(); k++) {
+		total += path.seconds[k];
+		if (cold) {
+			coldTotal += coldSeconds[k];
+			printf("%12.4e %12.3f %12.3f %12.4f\n", path.lambdas[k], path.seconds[k], coldSeconds[k],
+			       predictAccuracy(path.models[k], testData, ytest));
+		}
+		else
+			printf("%12.4e %12.3f %12s %12.4f\n", path.lambdas[k], path.seconds[k], "",
+			       predictAccuracy(path.models[k], testData, ytest));
+	}
+	if (cold)
+		printf("%12s %12.3f %12.3f\n", "total", total, coldTotal);
+	else
+		printf("%12s %12.3f\n", "total", total);
+}
+
+int main(int argc, char** argv){
+	bool parse_was_ok = Arg::parse(argc,(char**)argv);
+	if(!parse_was_ok) {
+		Arg::usage(); exit(-1);
+	}
+	int ntrain, mtrain, ntest, mtest;
+	SparseDataset trainData, testData;
+	Vector ytrain, ytest;
+	readDataset(trainFile, trainData, ytrain, ntrain, mtrain);
+	if (testFile != NULL)
+		readDataset(testFile, testData, ytest, ntest, mtest);
+	else {
+		testData = trainData;
+		ytest = ytrain;
+	}
+	if (method == L1LR) {
+		LogisticRegression<SparseRow> c(trainData, ytrain, mtrain, ntrain, nClasses, lambdaMax, algtype, 0, maxIter, eps);
+		runPath(c, testData, ytest);
+	}
+	else if (method == L2LR) {
+		LogisticRegression<SparseRow> c(trainData, ytrain, mtrain, ntrain, nClasses, lambdaMax, algtype, 1, maxIter, eps);
+		runPath(c, testData, ytest);
+	}
+	else if (method == L1SSVM) {
+		L1SmoothSVM<SparseRow> c(trainData, ytrain, mtrain, ntrain, nClasses, lambdaMax, algtype, maxIter, eps);
+		runPath(c, testData, ytest);
+	}
+	else if (method == L2SSVM) {
+		L2SmoothSVM<SparseRow> c(trainData, ytrain, mtrain, ntrain, nClasses, lambdaMax, algtype, maxIter, eps);
+		runPath(c, testData, ytest);
+	}
+	else if (method == L2HSVM) {
+		L2HingeSVM<SparseRow> c(trainData, ytrain, mtrain, ntrain, nClasses, lambdaMax, algtype, maxIter, eps);
+		runPath(c, testData, ytest);
+	}
+	else{
+		cout << "Invalid method\n";
+		return -1;
+	}
+	return 0;
+}
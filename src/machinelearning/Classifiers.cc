@@ -8,19 +8,26 @@
  */
 
 #include <iostream>
+#include <math.h>
 using namespace std;
 
 #include "Classifiers.h"
+#include "../optimization/contFunctions/ClassBlock.h"
+#include "../utils/error.h"
+#include "../utils/Threads.h"
 #define EPSILON 1e-6
 namespace jensen {
+
 template <class Feature>
-Classifiers<Feature>::Classifiers(){
+Classifiers<Feature>::Classifiers() : nThreads(0), warmStart(false), scaledSteps(false), multiClassMode(MULTICLASS_ONE_BY_ONE){
 }
 template <class Feature>
-Classifiers<Feature>::Classifiers(int m, int n) : m(m), n(n){
+Classifiers<Feature>::Classifiers(int m, int n) : m(m), n(n), nThreads(0), warmStart(false), scaledSteps(false),
+	multiClassMode(MULTICLASS_ONE_BY_ONE){
 }
 template <class Feature>
-Classifiers<Feature>::Classifiers(const Classifiers& c) : m(c.m), n(c.n){
+Classifiers<Feature>::Classifiers(const Classifiers& c) : m(c.m), n(c.n), nThreads(c.nThreads), warmStart(c.warmStart),
+	scaledSteps(c.scaledSteps), multiClassMode(c.multiClassMode){
 }
 
 template <class Feature>
@@ -64,6 +71,106 @@ int Classifiers<Feature>::length(){         // number of convex functions adding
 	return n;
 }
 
+template <class Feature>
+void Classifiers<Feature>::setNumThreads(int nThreads){
+	this->nThreads = nThreads;
+}
+
+template <class Feature>
+void Classifiers<Feature>::setWarmStart(bool warmStart){
+	this->warmStart = warmStart;
+}
+
+template <class Feature>
+void Classifiers<Feature>::setScaledSteps(bool scaledSteps){
+	this->scaledSteps = scaledSteps;
+}
+
+template <class Feature>
+Vector Classifiers<Feature>::initialPoint(const Vector& wcurr) const {
+	if (warmStart && (wcurr.size() == m))
+		return wcurr;
+	return Vector(m, 0);
+}
+
+template <class Feature>
+void Classifiers<Feature>::setMultiClassMode(MultiClassMode mode){
+	multiClassMode = mode;
+}
+
+template <class Feature>
+int Classifiers<Feature>::classThreads(int nClasses) const {
+	if (multiClassMode != MULTICLASS_CLASS_PARALLEL)
+		return 1;
+	return max(1, min(resolveThreads(nThreads), nClasses));
+}
+
+template <class Feature>
+ProbabilityModel Classifiers<Feature>::probabilityModel(){
+	return PROBABILITY_SIGMOID;
+}
+
+template <class Feature>
+void Classifiers<Feature>::predictBatch(const typename FeatureSet<Feature>::type& features, Vector& labels){
+	int rows = features.size();
+	if (labels.size() != rows)
+		error("predictBatch: the label array has %d entries for %d rows\n", (int) labels.size(), rows);
+	Vector block;
+	int K = classWeightBlock(block);
+	#pragma omp parallel num_threads(resolveThreads(nThreads))
+	{
+		Vector s(K);
+		#pragma omp for schedule(static)
+		for (int i = 0; i < rows; i++) {
+			blockScores(block.data(), block.size()/K, K, features[i], s.data());
+			labels[i] = scoreLabel(s.data(), K);
+		}
+	}
+}
+
+template <class Feature>
+void Classifiers<Feature>::predictProbabilityBatch(const typename FeatureSet<Feature>::type& features, Vector& prob){
+	int rows = features.size();
+	Vector block;
+	int K = classWeightBlock(block);
+	int numClasses = (K == 1) ? 2 : K;
+	ProbabilityModel probability = probabilityModel();
+	if (prob.size() != (long int) rows*numClasses)
+		error("predictProbabilityBatch: the probability array has %ld entries for %d rows of %d classes\n", (long int) prob.size(),
+		      rows, numClasses);
+	#pragma omp parallel num_threads(resolveThreads(nThreads))
+	{
+		Vector s(K);
+		#pragma omp for schedule(static)
+		for (int i = 0; i < rows; i++) {
+			blockScores(block.data(), block.size()/K, K, features[i], s.data());
+			scoreProbabilities(s.data(), K, probability, &prob[(long int) i*numClasses]);
+		}
+	}
+}
+
+template <class Feature>
+int Classifiers<Feature>::saveModelBinary(const char* model){
+	Vector block;
+	int K = classWeightBlock(block);
+	writeModelBinary(model, block, K, n, probabilityModel());
+	return 0;
+}
+
+// Copies the weights of a binary model into the classifier (e.g. to continue training from it), scoring processes can
+// predict from a ModelFile directly.
+template <class Feature>
+int Classifiers<Feature>::loadModelBinary(const char* model){
+	if (!isModelBinary(model))
+		return -1;
+	ModelFile f(model);
+	m = f.numFeatures();
+	n = f.numTrainingExamples();
+	setClassWeightBlock(f.weightBlock(), f.numColumns(), f.probabilityModel());
+	return 0;
+}
+
 template class Classifiers<SparseFeature>;
 template class Classifiers<DenseFeature>;
+template class Classifiers<SparseRow>;
 }
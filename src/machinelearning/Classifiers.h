@@ -17,17 +17,35 @@
 #include "../representation/MatrixOperations.h"
 #include "../representation/DenseFeature.h"
 #include "../representation/SparseFeature.h"
+#include "../representation/SparseDataset.h"
+#include "ModelFile.h"
 
 #include <vector>
 using namespace std;
 
 namespace jensen {
 
+enum MultiClassMode {                 // how the nClasses one-vs-rest problems of a multi-class classifier are trained
+	MULTICLASS_ONE_BY_ONE = 0,                 // one binary problem after the other
+	MULTICLASS_FUSED = 1,                 // all classes as one problem, each evaluation reads every row once (L2OneVsRestLoss)
+	MULTICLASS_CLASS_PARALLEL = 2,                 // the binary problems run concurrently, one class per thread
+	MULTICLASS_SOFTMAX = 3                 // a single multinomial model instead of one-vs-rest (logistic regression only)
+};
+
 template <class Feature>
 class Classifiers {
 protected:
 int m;
 int n;
+int nThreads;                 // threads used to evaluate the losses (0: the OpenMP default), more than one also runs the asynchronous solvers in parallel
+bool warmStart;                 // start training from the current model (e.g. the previous point of a regularization path)
+bool scaledSteps;                 // the stochastic gradient solvers take O(nnz) steps on scaled weights (sgdScaledSteps)
+Vector initialPoint(const Vector& wcurr) const;                 // wcurr with warm starts (if it has m entries), else 0
+MultiClassMode multiClassMode;
+int classThreads(int nClasses) const;                 // threads of the loop over the classes (1 unless MULTICLASS_CLASS_PARALLEL)
+virtual int classWeightBlock(Vector& block) = 0;                 // the weights as an m x K block (ClassBlock.h), returns K (1 for binary models)
+virtual void setClassWeightBlock(const Vector& block, const int K, const ProbabilityModel probability) = 0;                 // the inverse
+virtual ProbabilityModel probabilityModel();                 // how the scores turn into class probabilities
 public:
 Classifiers();
 Classifiers(int m, int n);
@@ -35,18 +53,30 @@ Classifiers(const Classifiers& c);         // copy constructor
 virtual ~Classifiers();
 
 virtual void train() = 0;                 // train
+virtual void setRegularization(double lambda) = 0;                 // change lambda, e.g. between the points of a regularization path
 
 virtual int saveModel(char* model) = 0;                 // save the model
 virtual int loadModel(char* model) = 0;                 // save the model
+int saveModelBinary(const char* model);                 // the binary model format of ModelFile.h
+int loadModelBinary(const char* model);
 
 virtual double predict(const Feature& testFeature) = 0;
 virtual double predict(const Feature& testFeature, double& val) = 0;
 virtual void predictProbability(const Feature& testFeature, Vector& prob) = 0;
+// Predicts all rows of a dataset with nThreads threads, every class score of a row is computed in one pass over it.
+// labels must have features.size() entries, prob features.size()*nClasses (prob[i*nClasses + c], nClasses = 2 for binary
+// models, as predictProbability).
+void predictBatch(const typename FeatureSet<Feature>::type& features, Vector& labels);
+void predictProbabilityBatch(const typename FeatureSet<Feature>::type& features, Vector& prob);
 
 double operator()(const Feature& testFeature);
 
 int size();                 // number of features or dimension size (m)
 int length();                 // number of training examples
+void setNumThreads(int nThreads);
+void setWarmStart(bool warmStart);
+void setScaledSteps(bool scaledSteps);                 // for l_2 regularized losses, see sgd and sgdDecayingLearningRate
+void setMultiClassMode(MultiClassMode mode);
 };
 
 }
@@ -0,0 +1,116 @@
+// Copyright (C) Rishabh Iyer, John T. Halloran, and Kai Wei
+// Licensed under the Open Software License version 3.0
+// See COPYING or http://opensource.org/licenses/OSL-3.0
+/*
+ *	k-fold cross-validation with row views of a shared dataset
+        Author: Rishabh Iyer
+ *
+ */
+
+#include <iostream>
+#include <algorithm>
+#include <map>
+#include <random>
+#include <time.h>
+using namespace std;
+
+#include "CrossValidation.h"
+#include "../utils/error.h"
+#include "../utils/Threads.h"
+#include "../utils/Timer.h"
+
+namespace jensen {
+
+// The rows of every label are shuffled and dealt round robin, so every fold gets about n/k rows and the same class ratios.
+CrossValidation::CrossValidation(SparseDataset& data, Vector& y, int kfold, unsigned int seed) : data(data), y(y), kfold(kfold),
+	testRows(kfold){
+	if ((kfold < 2) || (kfold > data.size()))
+		error("CrossValidation: the number of folds must be between 2 and the number of rows (%d)\n", data.size());
+	if (y.size() != data.size())
+		error("CrossValidation: %d labels for %d rows\n", (int) y.size(), data.size());
+	map<double, vector<int> > rowsOfLabel;
+	for (int i = 0; i < data.size(); i++)
+		rowsOfLabel[y[i]].push_back(i);
+	mt19937 generator(seed);
+	int next = 0;
+	for (map<double, vector<int> >::iterator it = rowsOfLabel.begin(); it != rowsOfLabel.end(); it++) {
+		shuffle(it->second.begin(), it->second.end(), generator);
+		for (int p = 0; p < it->second.size(); p++)
+			testRows[next++ % kfold].push_back(it->second[p]);
+	}
+	for (int k = 0; k < kfold; k++)
+		sort(testRows[k].begin(), testRows[k].end());
+}
+
+int CrossValidation::numFolds() const {
+	return kfold;
+}
+
+const vector<int>& CrossValidation::foldRows(const int k) const {
+	return testRows[k];
+}
+
+void CrossValidation::foldData(const int k, SparseDataset& trainFeatures, Vector& ytrain, SparseDataset& testFeatures,
+                               Vector& ytest) const {
+	vector<int> trainRows;
+	trainRows.reserve(data.size() - testRows[k].size());
+	int p = 0;
+	for (int i = 0; i < data.size(); i++) {
+		if ((p < testRows[k].size()) && (testRows[k][p] == i))
+			p++;
+		else
+			trainRows.push_back(i);
+	}
+	trainFeatures = SparseDataset(data, trainRows);
+	testFeatures = SparseDataset(data, testRows[k]);
+	ytrain.resize(trainRows.size());
+	for (int i = 0; i < trainRows.size(); i++)
+		ytrain[i] = y[trainRows[i]];
+	ytest.resize(testRows[k].size());
+	for (int i = 0; i < testRows[k].size(); i++)
+		ytest[i] = y[testRows[k][i]];
+}
+
+vector<FoldResult> CrossValidation::run(const ClassifierFactory& factory, int nThreads, bool parallelFolds) const {
+	vector<FoldResult> results(kfold);
+	int T = parallelFolds ? min(kfold, resolveThreads(nThreads)) : 1;
+	int classifierThreads = (T > 1) ? 1 : nThreads;
+	#pragma omp parallel for schedule(dynamic, 1) num_threads(T)
+	for (int k = 0; k < kfold; k++) {
+		SparseDataset trainFeatures, testFeatures;
+		Vector ytrain, ytest;
+		foldData(k, trainFeatures, ytrain, testFeatures, ytest);
+		double start = now();
+		Classifiers<SparseRow>* c = factory.create(trainFeatures, ytrain);
+		c->setNumThreads(classifierThreads);
+		c->train();
+		double trained = now();
+		Vector labels(testFeatures.size());
+		c->predictBatch(testFeatures, labels);
+		double correct = 0;
+		for (int i = 0; i < testFeatures.size(); i++) {
+			if (labels[i] == ytest[i])
+				correct++;
+		}
+		delete c;
+		results[k].nTrain = trainFeatures.size();
+		results[k].nTest = testFeatures.size();
+		results[k].accuracy = correct/testFeatures.size();
+		results[k].trainSeconds = trained - start;
+		results[k].testSeconds = now() - trained;
+	}
+	return results;
+}
+
+void summarizeFolds(const vector<FoldResult>& results, double& mean, double& variance){
+	mean = 0;
+	variance = 0;
+	for (int k = 0; k < results.size(); k++) {
+		mean += results[k].accuracy;
+		variance += results[k].accuracy*results[k].accuracy;
+	}
+	mean /= results.size();
+	variance = variance/results.size() - mean*mean;
+}
+
+}
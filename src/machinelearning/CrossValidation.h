@@ -0,0 +1,63 @@
+// Copyright (C) Rishabh Iyer, John T. Halloran, and Kai Wei
+// Licensed under the Open Software License version 3.0
+// See COPYING or http://opensource.org/licenses/OSL-3.0
+/*
+        Jensen: A Convex Optimization And Machine Learning ToolKit
+ *	k-fold cross-validation over a dataset that is loaded once. The rows are shuffled and dealt
+        into k folds (stratified by the label), the training and test sets of a fold are row views of
+        the dataset (SparseDataset(D, rows)), so no features are copied. The folds are trained
+        concurrently, one fold per thread, and the accuracy and the timings of every fold are reported.
+        Author: Rishabh Iyer
+ *
+ */
+
+#ifndef CROSS_VALIDATION_H
+#define CROSS_VALIDATION_H
+
+#include "Classifiers.h"
+#include "../representation/Vector.h"
+#include "../representation/SparseDataset.h"
+#include <vector>
+using namespace std;
+
+namespace jensen {
+
+// Creates the (untrained) classifier of a fold. The classifier keeps references to trainFeatures and ytrain.
+class ClassifierFactory {
+public:
+virtual ~ClassifierFactory(){
+}
+virtual Classifiers<SparseRow>* create(SparseDataset& trainFeatures, Vector& ytrain) const = 0;
+};
+
+struct FoldResult {
+	int nTrain;                 // number of training rows
+	int nTest;                 // number of test rows
+	double accuracy;                 // fraction of the test rows predicted correctly
+	double trainSeconds;
+	double testSeconds;
+};
+
+class CrossValidation {
+protected:
+SparseDataset& data;
+Vector& y;
+int kfold;
+vector<vector<int> > testRows;                 // the rows of each fold, in increasing order
+public:
+CrossValidation(SparseDataset& data, Vector& y, int kfold, unsigned int seed = 1);
+
+int numFolds() const;
+const vector<int>& foldRows(const int k) const;
+// The training set (all other folds) and the test set of fold k, as views of the rows of the dataset.
+void foldData(const int k, SparseDataset& trainFeatures, Vector& ytrain, SparseDataset& testFeatures, Vector& ytest) const;
+// Trains and tests every fold. With parallelFolds the folds run concurrently on nThreads threads (0: all cores),
+// each classifier on one thread, else the folds run one after the other with nThreads threads each.
+vector<FoldResult> run(const ClassifierFactory& factory, int nThreads = 0, bool parallelFolds = true) const;
+};
+
+// mean and variance of the accuracies of the folds
+void summarizeFolds(const vector<FoldResult>& results, double& mean, double& variance);
+
+}
+#endif
@@ -0,0 +1,340 @@
+// Copyright (C) Rishabh Iyer, John T. Halloran, and Kai Wei
+// Licensed under the Open Software License version 3.0
+// See COPYING or http://opensource.org/licenses/OSL-3.0
+/*
+ *	Binary model format and memory-mapped models
+        Author: Rishabh Iyer
+ *
+ */
+
+#include <iostream>
+#include <algorithm>
+#include <math.h>
+#include <stdio.h>
+#include <string.h>
+#include <assert.h>
+using namespace std;
+
+#include "ModelFile.h"
+#include "../optimization/contFunctions/ClassBlock.h"
+#include "../utils/error.h"
+#include "../utils/Threads.h"
+
+namespace jensen {
+
+static const char modelMagic[8] = {'J', 'E', 'N', 'S', 'E', 'N', 'M', 'D'};
+
+static int64_t alignOffset(int64_t offset){
+	return (offset + 63) & ~((int64_t) 63);
+}
+
+// Whether count entries of the given size starting at offset lie after the header and within the file, at an offset aligned
+// for the entries (compared without forming offset + count*size, which a corrupt header could overflow).
+static bool sectionFits(const int64_t offset, const int64_t count, const int64_t size, const int64_t fileSize){
+	return (offset >= (int64_t) sizeof(ModelFileHeader)) && (offset <= fileSize) && (offset % size == 0) && (count >= 0)
+	       && (count <= (fileSize - offset)/size);
+}
+
+static void writeSection(FILE* fp, int64_t offset, const void* ptr, size_t size, const char* fname){
+	if (fseek(fp, offset, SEEK_SET) != 0 || (size > 0 && fwrite(ptr, 1, size, fp) != size))
+		error("ERROR: cannot write to file %s", fname);
+}
+
+double scoreLabel(const double* scores, const int K){
+	if (K == 1)
+		return (scores[0] > 0) ? 1 : -1;
+	double val = -1e30;
+	int argval = 0;
+	for (int c = 0; c < K; c++) {
+		if (scores[c] > val) {
+			val = scores[c];
+			argval = c;
+		}
+	}
+	return argval;
+}
+
+void scoreProbabilities(const double* scores, const int K, const ProbabilityModel probability, double* prob){
+	if (K == 1) {
+		prob[1] = 1/(1 + exp(-scores[0]));
+		prob[0] = 1 - prob[1];
+	}
+	else if (probability == PROBABILITY_SOFTMAX)
+		softmaxRow(scores, K, 0, prob);
+	else{
+		double sum = 0;
+		for (int c = 0; c < K; c++) {
+			prob[c] = 1/(1 + exp(-scores[c]));
+			sum += prob[c];
+		}
+		for (int c = 0; c < K; c++)
+			prob[c] = prob[c]/sum;
+	}
+}
+
+void writeModelBinary(const char* fname, const Vector& block, const int K, const int n, const ProbabilityModel probability)
+{
+	assert(sizeof(long int) == sizeof(int64_t));
+	assert(block.size() % K == 0);
+	int64_t m = block.size()/K;
+	std::vector<int> features, classes;
+	std::vector<long int> featurePtr(1, 0);
+	std::vector<double> values;
+	for (int64_t j = 0; j < m; j++) {
+		for (int c = 0; c < K; c++) {
+			if (block[j*K + c] != 0) {
+				classes.push_back(c);
+				values.push_back(block[j*K + c]);
+			}
+		}
+		if (values.size() > featurePtr.back()) {
+			features.push_back(j);
+			featurePtr.push_back(values.size());
+		}
+	}
+	int64_t nFeatures = features.size(), nnz = values.size();
+
+	ModelFileHeader h;
+	memset(&h, 0, sizeof(h));
+	memcpy(h.magic, modelMagic, sizeof(h.magic));
+	h.version = JENSEN_MODEL_VERSION;
+	h.K = K;
+	h.probability = probability;
+	h.m = m;
+	h.n = n;
+	int64_t sparseBytes = nFeatures*(sizeof(int32_t) + sizeof(int64_t)) + nnz*(sizeof(int32_t) + sizeof(double));
+	h.storage = (sparseBytes < m*K*(int64_t) sizeof(double)) ? MODEL_SPARSE : MODEL_DENSE;
+	if (h.storage == MODEL_DENSE) {
+		h.weightOffset = alignOffset(sizeof(h));
+		h.fileSize = h.weightOffset + m*K*sizeof(double);
+	}
+	else{
+		h.nFeatures = nFeatures;
+		h.nnz = nnz;
+		h.featureOffset = alignOffset(sizeof(h));
+		h.featurePtrOffset = alignOffset(h.featureOffset + nFeatures*sizeof(int32_t));
+		h.classOffset = alignOffset(h.featurePtrOffset + (nFeatures + 1)*sizeof(int64_t));
+		h.valueOffset = alignOffset(h.classOffset + nnz*sizeof(int32_t));
+		h.fileSize = h.valueOffset + nnz*sizeof(double);
+	}
+
+	FILE* fp;
+	if ((fp = fopen(fname, "wb")) == NULL)
+		error("ERROR: cannot open file %s", fname);
+	writeSection(fp, 0, &h, sizeof(h), fname);
+	if (h.storage == MODEL_DENSE)
+		writeSection(fp, h.weightOffset, block.data(), m*K*sizeof(double), fname);
+	else{
+		writeSection(fp, h.featureOffset, features.data(), nFeatures*sizeof(int32_t), fname);
+		writeSection(fp, h.featurePtrOffset, featurePtr.data(), (nFeatures + 1)*sizeof(int64_t), fname);
+		writeSection(fp, h.classOffset, classes.data(), nnz*sizeof(int32_t), fname);
+		writeSection(fp, h.valueOffset, values.data(), nnz*sizeof(double), fname);
+	}
+	if (ferror(fp) != 0 || fclose(fp) != 0)
+		error("ERROR: cannot write to file %s", fname);
+}
+
+bool isModelBinary(const char* fname)
+{
+	FILE* fp;
+	if ((fp = fopen(fname, "rb")) == NULL)
+		return false;
+	char magic[8];
+	bool isBinary = (fread(magic, 1, sizeof(magic), fp) == sizeof(magic)) && (memcmp(magic, modelMagic, sizeof(magic)) == 0);
+	fclose(fp);
+	return isBinary;
+}
+
+ModelFile::ModelFile(const char* fname) : mapping(fname), weights(NULL), features(NULL), featurePtr(NULL), classes(NULL),
+	values(NULL)
+{
+	assert(sizeof(long int) == sizeof(int64_t));
+	const char* base = mapping.data();
+	if (mapping.size() < sizeof(header))
+		error("ERROR: %s is not a binary model", fname);
+	memcpy(&header, base, sizeof(header));
+	if (memcmp(header.magic, modelMagic, sizeof(header.magic)) != 0)
+		error("ERROR: %s is not a binary model", fname);
+	if (header.version != JENSEN_MODEL_VERSION)
+		error("ERROR: %s has binary model version %d, expected version %d", fname, header.version, JENSEN_MODEL_VERSION);
+	if (header.fileSize != (int64_t) mapping.size())
+		error("ERROR: %s is truncated (%ld bytes, expected %ld)", fname, (long) mapping.size(), (long) header.fileSize);
+	if ((header.K <= 0) || (header.m < 0) || (header.n < 0))
+		error("ERROR: %s is not a binary model (K = %d, m = %ld, n = %ld)", fname, header.K, (long) header.m, (long) header.n);
+	if ((header.probability != PROBABILITY_SIGMOID) && (header.probability != PROBABILITY_SOFTMAX))
+		error("ERROR: %s is not a binary model (probability model %d)", fname, header.probability);
+	if (header.storage == MODEL_DENSE) {
+		if ((header.m > (INT64_MAX/(int64_t) sizeof(double))/header.K)
+		    || !sectionFits(header.weightOffset, header.m*header.K, sizeof(double), header.fileSize))
+			error("ERROR: %s is not a binary model (the weights lie outside the file)", fname);
+		weights = (const double*) (base + header.weightOffset);
+	}
+	else if (header.storage == MODEL_SPARSE) {
+		// every section within the file, then the arrays they hold consistent, before anything reads through them
+		if ((header.nFeatures >= INT64_MAX) || !sectionFits(header.featureOffset, header.nFeatures, sizeof(int32_t), header.fileSize)
+		    || !sectionFits(header.featurePtrOffset, header.nFeatures + 1, sizeof(int64_t), header.fileSize)
+		    || !sectionFits(header.classOffset, header.nnz, sizeof(int32_t), header.fileSize)
+		    || !sectionFits(header.valueOffset, header.nnz, sizeof(double), header.fileSize))
+			error("ERROR: %s is not a binary model (a section lies outside the file)", fname);
+		features = (const int*) (base + header.featureOffset);
+		featurePtr = (const long int*) (base + header.featurePtrOffset);
+		classes = (const int*) (base + header.classOffset);
+		values = (const double*) (base + header.valueOffset);
+		if ((header.nFeatures > header.m) || (featurePtr[0] != 0) || (featurePtr[header.nFeatures] != header.nnz))
+			error("ERROR: %s is not a binary model (inconsistent sparse weights)", fname);
+		for (long int k = 0; k < header.nFeatures; k++) {
+			if ((features[k] < 0) || (features[k] >= header.m) || ((k > 0) && (features[k] <= features[k-1]))
+			    || (featurePtr[k+1] < featurePtr[k]))
+				error("ERROR: %s is not a binary model (feature %ld of the sparse weights)", fname, k);
+		}
+		for (long int p = 0; p < header.nnz; p++) {
+			if ((classes[p] < 0) || (classes[p] >= header.K))
+				error("ERROR: %s is not a binary model (class %d of non-zero %ld)", fname, classes[p], p);
+		}
+	}
+	else
+		error("ERROR: %s is not a binary model (storage %d)", fname, header.storage);
+}
+
+int ModelFile::numClasses() const {
+	return (header.K == 1) ? 2 : header.K;
+}
+
+int ModelFile::numColumns() const {
+	return header.K;
+}
+
+long int ModelFile::numFeatures() const {
+	return header.m;
+}
+
+long int ModelFile::numTrainingExamples() const {
+	return header.n;
+}
+
+bool ModelFile::isSparse() const {
+	return header.storage == MODEL_SPARSE;
+}
+
+ProbabilityModel ModelFile::probabilityModel() const {
+	return (ProbabilityModel) header.probability;
+}
+
+Vector ModelFile::weightBlock() const {
+	int K = header.K;
+	if (weights != NULL)
+		return Vector(weights, weights + header.m*K);
+	Vector block(header.m*K, 0);
+	for (long int k = 0; k < header.nFeatures; k++)
+		for (long int p = featurePtr[k]; p < featurePtr[k+1]; p++)
+			block[(long int) features[k]*K + classes[p]] = values[p];
+	return block;
+}
+
+// For sparse models every non-zero of f is searched among the stored features from the position of the previous one
+// (the feature indices of a row are increasing), and adds to the scores of the classes with a weight on it.
+template <class Feature>
+void ModelFile::scores(const Feature& f, double* s) const {
+	int K = header.K;
+	if (weights != NULL) {
+		blockScores(weights, header.m, K, f, s);
+		return;
+	}
+	for (int c = 0; c < K; c++)
+		s[c] = 0;
+	const int* begin = features;
+	const int* end = features + header.nFeatures;
+	const int* pos = begin;
+	for (int q = 0; (q < f.featureIndex.size()) && (pos != end); q++) {
+		pos = lower_bound(pos, end, (int) f.featureIndex[q]);
+		if ((pos != end) && (*pos == f.featureIndex[q])) {
+			long int k = pos - begin;
+			double v = f.featureVec[q];
+			for (long int p = featurePtr[k]; p < featurePtr[k+1]; p++)
+				s[classes[p]] += values[p]*v;
+		}
+	}
+}
+
+template <>
+void ModelFile::scores(const DenseFeature& f, double* s) const {
+	int K = header.K;
+	if (weights != NULL) {
+		blockScores(weights, header.m, K, f, s);
+		return;
+	}
+	for (int c = 0; c < K; c++)
+		s[c] = 0;
+	for (long int k = 0; (k < header.nFeatures) && (features[k] < f.featureVec.size()); k++) {
+		double v = f.featureVec[features[k]];
+		for (long int p = featurePtr[k]; p < featurePtr[k+1]; p++)
+			s[classes[p]] += values[p]*v;
+	}
+}
+
+template <class Feature>
+double ModelFile::predict(const Feature& f) const {
+	Vector s(header.K);
+	scores(f, s.data());
+	return scoreLabel(s.data(), header.K);
+}
+
+template <class Feature>
+void ModelFile::predictProbability(const Feature& f, Vector& prob) const {
+	Vector s(header.K);
+	scores(f, s.data());
+	prob = Vector(numClasses(), 0);
+	scoreProbabilities(s.data(), header.K, probabilityModel(), prob.data());
+}
+
+template <class Feature>
+void ModelFile::predictBatch(const typename FeatureSet<Feature>::type& rows, Vector& labels, int nThreads) const {
+	int n = rows.size();
+	if (labels.size() != n)
+		error("predictBatch: the label array has %d entries for %d rows\n", (int) labels.size(), n);
+	#pragma omp parallel num_threads(resolveThreads(nThreads))
+	{
+		Vector s(header.K);
+		#pragma omp for schedule(static)
+		for (int i = 0; i < n; i++) {
+			scores(rows[i], s.data());
+			labels[i] = scoreLabel(s.data(), header.K);
+		}
+	}
+}
+
+template <class Feature>
+void ModelFile::predictProbabilityBatch(const typename FeatureSet<Feature>::type& rows, Vector& prob, int nThreads) const {
+	int n = rows.size();
+	int nc = numClasses();
+	if (prob.size() != (long int) n*nc)
+		error("predictProbabilityBatch: the probability array has %ld entries for %d rows of %d classes\n", (long int) prob.size(),
+		      n, nc);
+	#pragma omp parallel num_threads(resolveThreads(nThreads))
+	{
+		Vector s(header.K);
+		#pragma omp for schedule(static)
+		for (int i = 0; i < n; i++) {
+			scores(rows[i], s.data());
+			scoreProbabilities(s.data(), header.K, probabilityModel(), &prob[(long int) i*nc]);
+		}
+	}
+}
+
+template double ModelFile::predict(const SparseFeature& f) const;
+template double ModelFile::predict(const DenseFeature& f) const;
+template double ModelFile::predict(const SparseRow& f) const;
+template void ModelFile::predictProbability(const SparseFeature& f, Vector& prob) const;
+template void ModelFile::predictProbability(const DenseFeature& f, Vector& prob) const;
+template void ModelFile::predictProbability(const SparseRow& f, Vector& prob) const;
+template void ModelFile::predictBatch<SparseFeature>(const FeatureSet<SparseFeature>::type& rows, Vector& labels, int nThreads) const;
+template void ModelFile::predictBatch<DenseFeature>(const FeatureSet<DenseFeature>::type& rows, Vector& labels, int nThreads) const;
+template void ModelFile::predictBatch<SparseRow>(const FeatureSet<SparseRow>::type& rows, Vector& labels, int nThreads) const;
+template void ModelFile::predictProbabilityBatch<SparseFeature>(const FeatureSet<SparseFeature>::type& rows, Vector& prob,
+                                                                int nThreads) const;
+template void ModelFile::predictProbabilityBatch<DenseFeature>(const FeatureSet<DenseFeature>::type& rows, Vector& prob,
+                                                               int nThreads) const;
+template void ModelFile::predictProbabilityBatch<SparseRow>(const FeatureSet<SparseRow>::type& rows, Vector& prob,
+                                                            int nThreads) const;
+
+}
@@ -0,0 +1,108 @@
+// Copyright (C) Rishabh Iyer, John T. Halloran, and Kai Wei
+// Licensed under the Open Software License version 3.0
+// See COPYING or http://opensource.org/licenses/OSL-3.0
+/*
+        Jensen: A Convex Optimization And Machine Learning ToolKit
+ *	Binary model format (version JENSEN_MODEL_VERSION) shared by all the linear Classifiers: a fixed size
+        header (magic "JENSENMD", version, the number K of weight columns (1 for binary models), the
+        dimension m, how the scores turn into probabilities, the storage and the byte offset of every
+        section) followed by the weights, each section aligned to 64 bytes. Stored in native (little
+        endian) byte order.
+
+        The weights are stored either dense, as the m x K block of ClassBlock.h (double, m*K), or sparse,
+        grouped by feature: the features with a non-zero weight (int32, increasing), the start of each
+        feature's weights (int64, one more), and the class (int32) and value (double) of every non-zero.
+        The smaller of the two is written, so the sparse form is used for sparse (e.g. l_1) models.
+
+        A ModelFile memory-maps a model and predicts directly from the mapping: there is no parsing or
+        copying, and the pages are shared by every process scoring with the same model.
+        Author: Rishabh Iyer
+ *
+ */
+
+#ifndef MODEL_FILE_H
+#define MODEL_FILE_H
+
+#include <stdint.h>
+#include "../representation/Vector.h"
+#include "../representation/SparseFeature.h"
+#include "../representation/DenseFeature.h"
+#include "../representation/SparseDataset.h"
+#include "../utils/MappedFile.h"
+
+#define JENSEN_MODEL_VERSION 1
+
+namespace jensen {
+
+enum ProbabilityModel {
+	PROBABILITY_SIGMOID = 0,                 // the normalized sigmoids of the one-vs-rest scores
+	PROBABILITY_SOFTMAX = 1                 // the softmax of the scores of a multinomial model
+};
+
+enum ModelStorage {
+	MODEL_DENSE = 0,
+	MODEL_SPARSE = 1
+};
+
+struct ModelFileHeader {
+	char magic[8];
+	int32_t version;
+	int32_t storage;                 // ModelStorage
+	int32_t K;                 // weight columns, 1 for binary models
+	int32_t probability;                 // ProbabilityModel
+	int64_t m;                 // dimension
+	int64_t n;                 // number of training examples
+	int64_t nFeatures;                 // sparse: number of features with a non-zero weight
+	int64_t nnz;                 // sparse: number of non-zero weights
+	int64_t weightOffset;                 // dense: the m x K block
+	int64_t featureOffset;                 // sparse: the features with a non-zero weight
+	int64_t featurePtrOffset;                 // sparse: the weights of feature k span [featurePtr[k], featurePtr[k+1])
+	int64_t classOffset;                 // sparse: the class of every non-zero
+	int64_t valueOffset;                 // sparse: the value of every non-zero
+	int64_t fileSize;
+};
+
+// The predicted label of the K scores (the sign for binary models, else the first class of the largest score).
+double scoreLabel(const double* scores, const int K);
+// The class probabilities of the K scores (prob has 2 entries for binary models, prob[0] corresponds to -1).
+void scoreProbabilities(const double* scores, const int K, const ProbabilityModel probability, double* prob);
+
+// Writes the m x K weight block, exits with an error if that fails.
+void writeModelBinary(const char* fname, const Vector& block, const int K, const int n, const ProbabilityModel probability);
+
+bool isModelBinary(const char* fname);
+
+class ModelFile {
+protected:
+MappedFile mapping;
+ModelFileHeader header;
+const double* weights;                 // the dense block (NULL for sparse models)
+const int* features;                 // the sparse arrays, in the mapping
+const long int* featurePtr;
+const int* classes;
+const double* values;
+template <class Feature>
+void scores(const Feature& f, double* s) const;
+public:
+ModelFile(const char* fname);                 // maps a binary model, exits with an error if it is not one or is corrupt
+int numClasses() const;                 // 2 for binary models
+int numColumns() const;                 // K
+long int numFeatures() const;                 // m
+long int numTrainingExamples() const;
+bool isSparse() const;
+ProbabilityModel probabilityModel() const;
+Vector weightBlock() const;                 // a dense copy of the m x K block
+
+template <class Feature>
+double predict(const Feature& f) const;
+template <class Feature>
+void predictProbability(const Feature& f, Vector& prob) const;
+// As Classifiers::predictBatch and predictProbabilityBatch, with nThreads threads (0: all cores).
+template <class Feature>
+void predictBatch(const typename FeatureSet<Feature>::type& rows, Vector& labels, int nThreads = 0) const;
+template <class Feature>
+void predictProbabilityBatch(const typename FeatureSet<Feature>::type& rows, Vector& prob, int nThreads = 0) const;
+};
+
+}
+#endif
@@ -0,0 +1,70 @@
+// Copyright (C) Rishabh Iyer, John T. Halloran, and Kai Wei
+// Licensed under the Open Software License version 3.0
+// See COPYING or http://opensource.org/licenses/OSL-3.0
+/*
+ *	Regularization path with warm starts
+        Author: Rishabh Iyer
+ *
+ */
+
+#include <iostream>
+#include <algorithm>
+#include <functional>
+#include <cmath>
+#include <time.h>
+using namespace std;
+
+#include "RegularizationPath.h"
+#include "logisticRegression/LogisticRegression.h"
+#include "SVM/L1SmoothSVM.h"
+#include "SVM/L2SmoothSVM.h"
+#include "SVM/L2HingeSVM.h"
+#include "../utils/error.h"
+#include "../utils/Timer.h"
+
+namespace jensen {
+
+Vector lambdaSequence(double lambdaMax, double lambdaMin, int numPoints){
+	if ((lambdaMin <= 0) || (lambdaMax < lambdaMin) || (numPoints < 1))
+		error("lambdaSequence: need 0 < lambdaMin <= lambdaMax and at least one point\n");
+	Vector lambdas(numPoints, lambdaMax);
+	double ratio = (numPoints > 1) ? pow(lambdaMin/lambdaMax, 1.0/(numPoints - 1)) : 1;
+	for (int k = 1; k < numPoints; k++)
+		lambdas[k] = lambdas[k-1]*ratio;
+	return lambdas;
+}
+
+template <class Model>
+RegularizationPath<Model> trainPath(const Model& model, const Vector& lambdas, bool warmStart){
+	RegularizationPath<Model> path;
+	path.lambdas = lambdas;
+	sort(path.lambdas.begin(), path.lambdas.end(), greater<double>());
+	path.seconds = Vector(lambdas.size(), 0);
+	path.models.reserve(lambdas.size());
+	Model current(model);                 // carries the solution of the previous point
+	current.setWarmStart(warmStart);
+	for (int k = 0; k < path.lambdas.size(); k++) {
+		double start = now();
+		current.setRegularization(path.lambdas[k]);
+		current.train();
+		path.seconds[k] = now() - start;
+		path.models.push_back(current);
+	}
+	return path;
+}
+
+template RegularizationPath<LogisticRegression<SparseFeature> > trainPath(const LogisticRegression<SparseFeature>& model, const Vector& lambdas, bool warmStart);
+template RegularizationPath<LogisticRegression<DenseFeature> > trainPath(const LogisticRegression<DenseFeature>& model, const Vector& lambdas, bool warmStart);
+template RegularizationPath<LogisticRegression<SparseRow> > trainPath(const LogisticRegression<SparseRow>& model, const Vector& lambdas, bool warmStart);
+
+template RegularizationPath<L1SmoothSVM<SparseFeature> > trainPath(const L1SmoothSVM<SparseFeature>& model, const Vector& lambdas, bool warmStart);
+template RegularizationPath<L1SmoothSVM<DenseFeature> > trainPath(const L1SmoothSVM<DenseFeature>& model, const Vector& lambdas, bool warmStart);
+template RegularizationPath<L1SmoothSVM<SparseRow> > trainPath(const L1SmoothSVM<SparseRow>& model, const Vector& lambdas, bool warmStart);
+
+template RegularizationPath<L2SmoothSVM<SparseFeature> > trainPath(const L2SmoothSVM<SparseFeature>& model, const Vector& lambdas, bool warmStart);
+template RegularizationPath<L2SmoothSVM<SparseRow> > trainPath(const L2SmoothSVM<SparseRow>& model, const Vector& lambdas, bool warmStart);
+
+template RegularizationPath<L2HingeSVM<SparseFeature> > trainPath(const L2HingeSVM<SparseFeature>& model, const Vector& lambdas, bool warmStart);
+template RegularizationPath<L2HingeSVM<SparseRow> > trainPath(const L2HingeSVM<SparseRow>& model, const Vector& lambdas, bool warmStart);
+
+}
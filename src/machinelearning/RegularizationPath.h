@@ -0,0 +1,38 @@
+// Copyright (C) Rishabh Iyer, John T. Halloran, and Kai Wei
+// Licensed under the Open Software License version 3.0
+// See COPYING or http://opensource.org/licenses/OSL-3.0
+/*
+        Jensen: A Convex Optimization And Machine Learning ToolKit
+ *	Regularization path: trains a classifier for a decreasing sequence of lambdas, each point warm
+        started from the solution of the previous one (the primal weights for the gradient based
+        solvers, the dual variables for the dual coordinate descent). Near points of the path have
+        near solutions, so most points need only a few iterations instead of a cold start from 0.
+        Author: Rishabh Iyer
+ *
+ */
+
+#ifndef REGULARIZATION_PATH_H
+#define REGULARIZATION_PATH_H
+
+#include "../representation/Vector.h"
+#include <vector>
+using namespace std;
+
+namespace jensen {
+
+template <class Model>
+struct RegularizationPath {
+	Vector lambdas;                 // the points of the path, in decreasing order
+	vector<Model> models;                 // models[k] is trained with lambdas[k]
+	Vector seconds;                 // the training time of each point
+};
+
+// lambdaMax, ..., lambdaMin: numPoints values spaced evenly on a log scale
+Vector lambdaSequence(double lambdaMax, double lambdaMin, int numPoints);
+
+// Trains copies of model along the lambdas (sorted in decreasing order); warmStart = false gives independent cold starts.
+template <class Model>
+RegularizationPath<Model> trainPath(const Model& model, const Vector& lambdas, bool warmStart = true);
+
+}
+#endif
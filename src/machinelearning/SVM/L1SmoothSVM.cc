@@ -28,6 +28,7 @@ using namespace std;
 #include "L1SmoothSVM.h"
 #include "../../optimization/contAlgorithms/contAlgorithms.h"
 #include "../../optimization/contFunctions/L1SmoothSVMLoss.h"
+#include "../../optimization/contFunctions/ClassBlock.h"
 #include "../../representation/Set.h"
 #include <assert.h>
 #include <string.h>
@@ -36,16 +37,17 @@ using namespace std;
 #define EPSILON 1e-6
 namespace jensen {
 template <class Feature>
-L1SmoothSVM<Feature>::L1SmoothSVM(vector<Feature>& trainFeatures, Vector& y, int m, int n, int nClasses,
+L1SmoothSVM<Feature>::L1SmoothSVM(typename FeatureSet<Feature>::type& trainFeatures, Vector& y, int m, int n, int nClasses,
                                   double lambda, int algtype, int maxIter, double eps, int miniBatch, int lbfgsMemory) : Classifiers<Feature>(m, n),
 	trainFeatures(trainFeatures), y(y), nClasses(nClasses),
 	lambda(lambda), algtype(algtype), maxIter(maxIter), eps(eps), miniBatch(miniBatch), lbfgsMemory(lbfgsMemory) {
 }
 
 template <class Feature>
-L1SmoothSVM<Feature>::L1SmoothSVM(const L1SmoothSVM<Feature>& c) : Classifiers<Feature>(c.m, c.n),
+L1SmoothSVM<Feature>::L1SmoothSVM(const L1SmoothSVM<Feature>& c) : Classifiers<Feature>(c),
 	trainFeatures(c.trainFeatures), y(c.y), nClasses(c.nClasses), lambda(c.lambda), algtype(c.algtype),
-	maxIter(c.maxIter), eps(c.eps), miniBatch(c.miniBatch), lbfgsMemory(c.lbfgsMemory){
+	maxIter(c.maxIter), eps(c.eps), miniBatch(c.miniBatch), lbfgsMemory(c.lbfgsMemory),
+	w(c.w), wMany(c.wMany), wSparse(c.wSparse), wManySparse(c.wManySparse) {
 }
 
 template <class Feature>
@@ -58,10 +60,18 @@ void L1SmoothSVM<Feature>::train(){         // train L1 regularized logistic reg
 		trainOne(y, w);
 	}
 	else{
+		if ((multiClassMode == MULTICLASS_FUSED) || (multiClassMode == MULTICLASS_SOFTMAX))
+			cout << "Fused and softmax multi-class training are not available for this loss, training the classes one by one\n";
 		vector<Set> yMapping = vector<Set>(nClasses);         // a reverse mapping for indices of a particular label
 		for (int i = 0; i < n; i++)
 			yMapping[y[i]].insert(i);
-		wMany = vector<Vector>(nClasses, Vector(m));
+		if (!warmStart || (wMany.size() != nClasses))
+			wMany = vector<Vector>(nClasses, Vector(m));
+		int T = classThreads(nClasses);
+		int classifierThreads = nThreads;
+		if (T > 1)
+			nThreads = 1;                 // the classes run in parallel, each on one thread
+		#pragma omp parallel for schedule(dynamic, 1) num_threads(T)
 		for (int i = 0; i < nClasses; i++)
 		{
 			Vector yOne(n, -1);
@@ -69,74 +79,84 @@ void L1SmoothSVM<Feature>::train(){         // train L1 regularized logistic reg
 				yOne[*it] = 1;
 			trainOne(yOne, wMany[i]);
 		}
+		nThreads = classifierThreads;
 	}
+	sparsifyWeights();
+}
+
+template <class Feature>
+void L1SmoothSVM<Feature>::setRegularization(double lambda){
+	this->lambda = lambda;
 }
 
 template <class Feature>
 void L1SmoothSVM<Feature>::trainOne(Vector& yOne, Vector& wcurr){
+	Vector x0 = initialPoint(wcurr);
 	L1SmoothSVMLoss<Feature> ll(m, trainFeatures, yOne, lambda);
 	L1SmoothSVMLoss<Feature>l(m, trainFeatures, yOne, 0);
+	ll.setNumThreads(nThreads);
+	l.setNumThreads(nThreads);
 
 	if (algtype == 0) {
 		cout<<"*******************************************************************\n";
 		cout<<"Training with LBFGS-OWL...\n";
-		wcurr = lbfgsMinOwl(ll, Vector(m, 0), 1, 1e-4, maxIter, lbfgsMemory, eps);
+		wcurr = lbfgsMinOwl(ll, x0, 1, 1e-4, maxIter, lbfgsMemory, eps);
 	}
 	else if (algtype == 1) {
 		cout<<"*******************************************************************\n";
 		cout<<"Training with LBFGS...\n";
-		wcurr = lbfgsMin(ll, Vector(m, 0), 1, 1e-4, maxIter, lbfgsMemory, eps);
+		wcurr = lbfgsMin(ll, x0, 1, 1e-4, maxIter, lbfgsMemory, eps);
 	}
 	else if (algtype == 2) {
 		cout<<"*******************************************************************\n";
 		cout<<"Training with Gradient Descent with fixed step size...\n";
-		wcurr = gd(ll, Vector(m, 0), 1e-5, maxIter, eps);
+		wcurr = gd(ll, x0, 1e-5, maxIter, eps);
 	}
 	else if (algtype == 3) {
 		cout<<"*******************************************************************\n";
 		cout<<"Training with Stochastic Gradient Descent and Dual Averaging...\n";
-		wcurr = sgdRegularizedDualAveraging(ll, l, Vector(m, 0), n, 1e-1, lambda, miniBatch, eps, maxIter, 0.5);
+		wcurr = sgdRegularizedDualAveraging(ll, l, x0, n, 1e-1, lambda, miniBatch, eps, maxIter, 0.5);
 	}
 	else if (algtype == 4) {
 		cout<<"*******************************************************************\n";
 		cout<<"Training with Adaptive Gradient Descent and Dual Averaging...\n";
-		wcurr = sgdRegularizedDualAveraging(ll, l, Vector(m, 0), n, 1e-1, lambda, miniBatch, eps, maxIter);
+		wcurr = sgdRegularizedDualAveraging(ll, l, x0, n, 1e-1, lambda, miniBatch, eps, maxIter);
 	}
 	else if (algtype == 5) {
 		cout<<"*******************************************************************\n";
 		cout<<"Training with Gradient Descent with Line Search...\n";
-		wcurr = gdLineSearch(ll, Vector(m, 0), 1, 1e-5, maxIter, eps);
+		wcurr = gdLineSearch(ll, x0, 1, 1e-5, maxIter, eps);
 	}
 	else if (algtype == 6) {
 		cout<<"*******************************************************************\n";
 		cout<<"Training with Gradient Descent with Barzilia-Borwein Step Length\n";
-		wcurr = gdBarzilaiBorwein(ll, Vector(m, 0), 1, 1e-5, maxIter, eps);
+		wcurr = gdBarzilaiBorwein(ll, x0, 1, 1e-5, maxIter, eps);
 	}
 	// gradientDescentBB(ss, Vector(m, 0), 1, 1e-4, 250);
 	else if (algtype == 7) {
 		cout<<"*******************************************************************\n";
 		cout<<"Training with Conjugate Gradient...\n";
-		wcurr = cg(ll, Vector(m, 0), 1, 1e-5, maxIter, eps);
+		wcurr = cg(ll, x0, 1, 1e-5, maxIter, eps);
 	}
 	else if (algtype == 8) {
 		cout<<"*******************************************************************\n";
 		cout<<"Training with Nesterov's Method\n";
-		wcurr = gdNesterov(ll, Vector(m, 0), 1, 1e-5, maxIter, eps);
+		wcurr = gdNesterov(ll, x0, 1, 1e-5, maxIter, eps);
 	}
 	else if (algtype == 9) {
 		cout<<"*******************************************************************\n";
 		cout<<"Training with Stochastic Gradient Descent\n";
-		wcurr = sgd(ll, Vector(m, 0), n, 1e-4, miniBatch, eps, maxIter);
+		wcurr = sgd(ll, x0, n, 1e-4, miniBatch, eps, maxIter, 1, nThreads);
 	}
 	else if (algtype == 10) {
 		cout<<"*******************************************************************\n";
 		cout<<"Training with Stochastic Gradient Descent with decaying learning rate\n";
-		wcurr = sgdDecayingLearningRate(ll, Vector(m, 0), n, 0.5*1e-1, miniBatch, eps, maxIter);
+		wcurr = sgdDecayingLearningRate(ll, x0, n, 0.5*1e-1, miniBatch, eps, maxIter, 0.5, 1, nThreads);
 	}
 	else if (algtype == 11) {
 		cout<<"*******************************************************************\n";
 		cout<<"Training with Adaptive Gradient Algorithm\n";
-		wcurr = sgdAdagrad(ll, Vector(m, 0), n, 1e-2, miniBatch, eps, maxIter);
+		wcurr = sgdAdagrad(ll, x0, n, 1e-2, miniBatch, eps, maxIter, 1, nThreads);
 	}
 }
 
@@ -146,7 +166,7 @@ int L1SmoothSVM<Feature>::saveModel(char* model){
 	FILE *fp = fopen(model,"w");
 	if(fp==NULL) return -1;
 
-	fprintf(fp, "algtype %s\n", algtype);
+	fprintf(fp, "algtype %d\n", algtype);
 	fprintf(fp, "nClasses %d\n", nClasses);
 	fprintf(fp, "nFeatures %d\n", m);
 	fprintf(fp, "n %d\n", n);
@@ -180,7 +200,10 @@ int L1SmoothSVM<Feature>::loadModel(char* model){
 	char cmd[81];
 	while(1)
 	{
-		fscanf(fp,"%80s",cmd);
+		if (fscanf(fp,"%80s",cmd) != 1) {
+			fclose(fp);
+			return -1;
+		}
 		if(strcmp(cmd,"algtype")==0)
 			fscanf(fp,"%d",&algtype);
 		else if(strcmp(cmd,"nClasses")==0)
@@ -203,26 +226,43 @@ int L1SmoothSVM<Feature>::loadModel(char* model){
 	if(nClasses==2) {
 		w = Vector(m, 0);
 		for (int i = 0; i < m; i++)
-			fscanf(fp, "%lf ", w[i]);
+			fscanf(fp, "%lf ", &w[i]);
 	}
 	else{
-		wMany = vector<Vector>(nClasses, Vector());
+		wMany = vector<Vector>(nClasses, Vector(m, 0));
 		for (int i = 0; i < nClasses; i++) {
 			for (int j = 0; j < m; j++) {
-				fscanf(fp, "%lf ", wMany[i][j]);
+				fscanf(fp, "%lf ", &wMany[i][j]);
 			}
 		}
 	}
+	sparsifyWeights();
 	if (ferror(fp) != 0 || fclose(fp) != 0) return -1;
 	return 1;
 }
 
 
+template <class Feature>
+void L1SmoothSVM<Feature>::sparsifyWeights(){
+	if (nClasses == 2)
+		wSparse = SparseVector(w);
+	else{
+		wManySparse.resize(nClasses);
+		for (int j = 0; j < nClasses; j++)
+			wManySparse[j] = SparseVector(wMany[j]);
+	}
+}
+
+template <class Feature>
+double L1SmoothSVM<Feature>::classScore(const int j, const Feature& testFeature){
+	return featureProductCheck((nClasses == 2) ? wSparse : wManySparse[j], testFeature);
+}
+
 template <class Feature>
 double L1SmoothSVM<Feature>::predict(const Feature& testFeature, double& val){
 	// the assumption here is that train and test datasets have the same number of features
 	if (nClasses == 2) {
-		val = featureProductCheck(w, testFeature);
+		val = classScore(0, testFeature);
 		double argval = 0;
 		if (val > 0)
 			argval = 1;
@@ -234,8 +274,9 @@ double L1SmoothSVM<Feature>::predict(const Feature& testFeature, double& val){
 		val = -1e30;
 		double argval = 0;
 		for (int j = 0; j < nClasses; j++) {
-			if (featureProductCheck(wMany[j], testFeature) > val) {
-				val = featureProductCheck(wMany[j], testFeature);
+			double score = classScore(j, testFeature);
+			if (score > val) {
+				val = score;
 				argval = j;
 			}
 		}
@@ -247,7 +288,7 @@ template <class Feature>
 double L1SmoothSVM<Feature>::predict(const Feature& testFeature){
 	// the assumption here is that train and test datasets have the same number of features
 	if (nClasses == 2) {
-		double val = featureProductCheck(w, testFeature);
+		double val = classScore(0, testFeature);
 		double argval = 0;
 		if (val > 0)
 			argval = 1;
@@ -259,8 +300,9 @@ double L1SmoothSVM<Feature>::predict(const Feature& testFeature){
 		double val = -1e30;
 		double argval = 0;
 		for (int j = 0; j < nClasses; j++) {
-			if (featureProductCheck(wMany[j], testFeature) > val) {
-				val = featureProductCheck(wMany[j], testFeature);
+			double score = classScore(j, testFeature);
+			if (score > val) {
+				val = score;
 				argval = j;
 			}
 		}
@@ -268,6 +310,29 @@ double L1SmoothSVM<Feature>::predict(const Feature& testFeature){
 	}
 }
 
+template <class Feature>
+int L1SmoothSVM<Feature>::classWeightBlock(Vector& block){
+	if (nClasses == 2) {
+		block = w;
+		return 1;
+	}
+	block = classMajorBlock(wMany);
+	return nClasses;
+}
+
+template <class Feature>
+void L1SmoothSVM<Feature>::setClassWeightBlock(const Vector& block, const int K, const ProbabilityModel probability){
+	nClasses = (K == 1) ? 2 : K;
+	if (K == 1)
+		w = block;
+	else{
+		wMany = vector<Vector>(nClasses);
+		for (int c = 0; c < nClasses; c++)
+			wMany[c] = classWeights(block, K, c);
+	}
+	sparsifyWeights();
+}
+
 // prob is a vector. The assumption is that prob[0] corresponds to -1 and prob[1] corresponds to +1 in binary
 // classification.
 template <class Feature>
@@ -276,14 +341,14 @@ void L1SmoothSVM<Feature>::predictProbability(const Feature& testFeature, Vector
 	prob = Vector(nClasses, 0);
 	double val;
 	if (nClasses == 2) {
-		val = featureProductCheck(w, testFeature);
+		val = classScore(0, testFeature);
 		prob[1] = 1/(1+exp(-val));
 		prob[0] = 1 - prob[1];
 	}
 	else{
 		double sum = 0;
 		for (int j = 0; j < nClasses; j++) {
-			val = featureProductCheck(wMany[j], testFeature);
+			val = classScore(j, testFeature);
 			prob[j] = 1/(1 + exp(-val));
 			sum += prob[j];
 		}
@@ -295,6 +360,7 @@ void L1SmoothSVM<Feature>::predictProbability(const Feature& testFeature, Vector
 
 template class L1SmoothSVM<SparseFeature>;
 template class L1SmoothSVM<DenseFeature>;
+template class L1SmoothSVM<SparseRow>;
 
 
 }
@@ -40,11 +40,13 @@ namespace jensen {
 template <class Feature>
 class L1SmoothSVM : public Classifiers<Feature>{
 protected:
-vector<Feature>& trainFeatures;     // training features
+typename FeatureSet<Feature>::type& trainFeatures;     // training features
 Vector& y;     // size of y is number of training examples (n)
 int algtype;     // the algorithm type used for training, default LBFGS-OWL.
 vector<Vector> wMany;     // the weights in the multiclass scenario -- nClasses number of weight vectors.
 Vector w;     // the weights in the binary scenario.
+SparseVector wSparse;     // the non-zeros of w, used for the predictions
+vector<SparseVector> wManySparse;     // the non-zeros of wMany
 int nClasses;     // the number of classes
 double lambda;     // regularization
 int maxIter;     // maximum number of iterations for the algorithms
@@ -53,14 +55,24 @@ int miniBatch;     // This is the miniBatch size for Stochastic Gradient Descent
 int lbfgsMemory;     // memory specification of the lbfgs algorithm.
 using Classifiers<Feature>::m;
 using Classifiers<Feature>::n;
+using Classifiers<Feature>::nThreads;
+using Classifiers<Feature>::warmStart;
+using Classifiers<Feature>::initialPoint;
+using Classifiers<Feature>::multiClassMode;
+using Classifiers<Feature>::classThreads;
+int classWeightBlock(Vector& block);
+void setClassWeightBlock(const Vector& block, const int K, const ProbabilityModel probability);
 public:
-L1SmoothSVM(vector<Feature>& trainFeatures, Vector& y, int m, int n, int nClasses = 2, double lambda = 1,
+L1SmoothSVM(typename FeatureSet<Feature>::type& trainFeatures, Vector& y, int m, int n, int nClasses = 2, double lambda = 1,
             int algtype = 0, int maxIter = 250, double eps = 1e-2, int miniBatch = 100, int lbfgsMemory = 100);
 L1SmoothSVM(const L1SmoothSVM& c);     // copy constructor
 ~L1SmoothSVM();
 
+void sparsifyWeights();     // keeps the non-zeros of the weights
+double classScore(const int j, const Feature& testFeature);     // w^T f (binary) or wMany[j]^T f
 void trainOne(Vector& yOne, Vector& wcurr);     // a member function for binary classification.
 void train();     // train
+void setRegularization(double lambda);
 
 int saveModel(char* model);     // save the model
 int loadModel(char* model);     // save the model
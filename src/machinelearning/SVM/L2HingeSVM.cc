@@ -29,6 +29,7 @@ using namespace std;
 #include "L2HingeSVM.h"
 #include "../../optimization/contAlgorithms/contAlgorithms.h"
 #include "../../optimization/contFunctions/L2HingeSVMLoss.h"
+#include "../../optimization/contFunctions/ClassBlock.h"
 #include "../../representation/Set.h"
 #include <assert.h>
 #include <string.h>
@@ -39,16 +40,17 @@ using namespace std;
 #define EPSILON 1e-6
 namespace jensen {
 template <class Feature>
-L2HingeSVM<Feature>::L2HingeSVM(vector<Feature>& trainFeatures, Vector& y, int m, int n, int nClasses,
+L2HingeSVM<Feature>::L2HingeSVM(typename FeatureSet<Feature>::type& trainFeatures, Vector& y, int m, int n, int nClasses,
                                 double lambda, int algtype, int maxIter, double eps, int miniBatch, int lbfgsMemory) : Classifiers<Feature>(m, n),
 	trainFeatures(trainFeatures), y(y), nClasses(nClasses),
 	lambda(lambda), algtype(algtype), maxIter(maxIter), eps(eps), miniBatch(miniBatch), lbfgsMemory(lbfgsMemory) {
 }
 
 template <class Feature>
-L2HingeSVM<Feature>::L2HingeSVM(const L2HingeSVM<Feature>& c) : Classifiers<Feature>(c.m, c.n),
+L2HingeSVM<Feature>::L2HingeSVM(const L2HingeSVM<Feature>& c) : Classifiers<Feature>(c),
 	trainFeatures(c.trainFeatures), y(c.y), nClasses(c.nClasses), lambda(c.lambda), algtype(c.algtype),
-	maxIter(c.maxIter), eps(c.eps), miniBatch(c.miniBatch), lbfgsMemory(c.lbfgsMemory) {
+	maxIter(c.maxIter), eps(c.eps), miniBatch(c.miniBatch), lbfgsMemory(c.lbfgsMemory),
+	w(c.w), wMany(c.wMany), alphaMany(c.alphaMany) {
 }
 
 template <class Feature>
@@ -57,72 +59,90 @@ L2HingeSVM<Feature>::~L2HingeSVM(){
 
 template <class Feature>
 void L2HingeSVM<Feature>::train(){         // train L2 regularized logistic regression
+	if (!warmStart || (alphaMany.size() != ((nClasses == 2) ? 1 : nClasses)))
+		alphaMany = vector<Vector>((nClasses == 2) ? 1 : nClasses);
 	if (nClasses == 2) {
-		trainOne(y, w);
+		trainOne(y, w, alphaMany[0]);
 	}
 	else{
+		if ((multiClassMode == MULTICLASS_FUSED) || (multiClassMode == MULTICLASS_SOFTMAX))
+			cout << "Fused and softmax multi-class training are not available for this loss, training the classes one by one\n";
 		vector<Set> yMapping = vector<Set>(nClasses);         // a reverse mapping for indices of a particular label
 		for (int i = 0; i < n; i++)
 			yMapping[y[i]].insert(i);
-		wMany = vector<Vector>(nClasses, Vector(m));
+		if (!warmStart || (wMany.size() != nClasses))
+			wMany = vector<Vector>(nClasses, Vector(m));
+		int T = classThreads(nClasses);
+		int classifierThreads = nThreads;
+		if (T > 1)
+			nThreads = 1;                 // the classes run in parallel, each on one thread
+		#pragma omp parallel for schedule(dynamic, 1) num_threads(T)
 		for (int i = 0; i < nClasses; i++)
 		{
 			Vector yOne(n, -1);
 			for (Set::iterator it = yMapping[i].begin(); it != yMapping[i].end(); it++)
 				yOne[*it] = 1;
-			trainOne(yOne, wMany[i]);
+			trainOne(yOne, wMany[i], alphaMany[i]);
 		}
+		nThreads = classifierThreads;
 	}
 }
 
 template <class Feature>
-void L2HingeSVM<Feature>::trainOne(Vector& yOne, Vector& wcurr){
+void L2HingeSVM<Feature>::setRegularization(double lambda){
+	this->lambda = lambda;
+}
+
+template <class Feature>
+void L2HingeSVM<Feature>::trainOne(Vector& yOne, Vector& wcurr, Vector& alphacurr){
+	Vector x0 = initialPoint(wcurr);
 	L2HingeSVMLoss<Feature> ll(m, trainFeatures, yOne, lambda);
+	ll.setNumThreads(nThreads);
 	if (algtype == 0) {
 		cout<<"*******************************************************************\n";
 		cout<<"Training using Dual Coordinate Descent Algorithm...\n";
-		wcurr = SVCDual(trainFeatures, y, 2, 1, eps, maxIter);
+		wcurr = SVCDual(trainFeatures, yOne, 1, lambda, eps, maxIter, 1, nThreads, &alphacurr);
 	}
 	else if (algtype == 1) {
 		cout<<"*******************************************************************\n";
 		cout<<"Training using LBFGS...\n";
-		wcurr = lbfgsMin(ll, Vector(m, 0), 1, 1e-4, maxIter, lbfgsMemory, eps);
+		wcurr = lbfgsMin(ll, x0, 1, 1e-4, maxIter, lbfgsMemory, eps);
 	}
 	else if (algtype == 2) {
 		cout<<"*******************************************************************\n";
 		cout<<"Training using Gradient Descent with fixed step size...\n";
-		wcurr = gdLineSearch(ll, Vector(m, 0), 1, 1e-5, maxIter, eps);
+		wcurr = gdLineSearch(ll, x0, 1, 1e-5, maxIter, eps);
 	}
 	else if (algtype == 3) {
 		cout<<"*******************************************************************\n";
 		cout<<"Training using Gradient Descent with Barzilia-Borwein Step Length\n";
-		wcurr = gdBarzilaiBorwein(ll, Vector(m, 0), 1, 1e-5, maxIter, eps);
+		wcurr = gdBarzilaiBorwein(ll, x0, 1, 1e-5, maxIter, eps);
 	}
 	// gradientDescentBB(ss, Vector(m, 0), 1, 1e-4, 250);
 	else if (algtype == 4) {
 		cout<<"*******************************************************************\n";
 		cout<<"Training using Conjugate Gradient for Logistic Loss, press enter to continue...\n";
-		wcurr = cg(ll, Vector(m, 0), 1, 1e-5, maxIter, eps);
+		wcurr = cg(ll, x0, 1, 1e-5, maxIter, eps);
 	}
 	else if (algtype == 5) {
 		cout<<"*******************************************************************\n";
 		cout<<"Training using Nesterov's Method\n";
-		wcurr = gdNesterov(ll, Vector(m, 0), 1, 1e-5, maxIter, eps);
+		wcurr = gdNesterov(ll, x0, 1, 1e-5, maxIter, eps);
 	}
 	else if (algtype == 6) {
 		cout<<"*******************************************************************\n";
 		cout<<"Training using Stochastic Gradient Descent\n";
-		wcurr = sgd(ll, Vector(m, 0), n, 1e-4, miniBatch, eps, maxIter);
+		wcurr = sgd(ll, x0, n, 1e-4, miniBatch, eps, maxIter, 1, nThreads, scaledSteps);
 	}
 	else if (algtype == 7) {
 		cout<<"*******************************************************************\n";
 		cout<<"Training using Stochastic Gradient Descent with decaying learning rate\n";
-		wcurr = sgdDecayingLearningRate(ll, Vector(m, 0), n, 0.5*1e-1, miniBatch, eps, maxIter);
+		wcurr = sgdDecayingLearningRate(ll, x0, n, 0.5*1e-1, miniBatch, eps, maxIter, 0.5, 1, nThreads, scaledSteps);
 	}
 	else if (algtype == 8) {
 		cout<<"*******************************************************************\n";
 		cout<<"Training using Adaptive Gradient Algorithm\n";
-		wcurr = sgdAdagrad(ll, Vector(m, 0), n, 1e-2, miniBatch, eps, maxIter);
+		wcurr = sgdAdagrad(ll, x0, n, 1e-2, miniBatch, eps, maxIter, 1, nThreads);
 	}
 }
 
@@ -132,7 +152,7 @@ int L2HingeSVM<Feature>::saveModel(char* model){
 	FILE *fp = fopen(model,"w");
 	if(fp==NULL) return -1;
 
-	fprintf(fp, "algtype %s\n", algtype);
+	fprintf(fp, "algtype %d\n", algtype);
 	fprintf(fp, "nClasses %d\n", nClasses);
 	fprintf(fp, "nFeatures %d\n", m);
 	fprintf(fp, "n %d\n", n);
@@ -166,7 +186,10 @@ int L2HingeSVM<Feature>::loadModel(char* model){
 	char cmd[81];
 	while(1)
 	{
-		fscanf(fp,"%80s",cmd);
+		if (fscanf(fp,"%80s",cmd) != 1) {
+			fclose(fp);
+			return -1;
+		}
 		if(strcmp(cmd,"algtype")==0)
 			fscanf(fp,"%d",&algtype);
 		else if(strcmp(cmd,"nClasses")==0)
@@ -189,13 +212,13 @@ int L2HingeSVM<Feature>::loadModel(char* model){
 	if(nClasses==2) {
 		w = Vector(m, 0);
 		for (int i = 0; i < m; i++)
-			fscanf(fp, "%lf ", w[i]);
+			fscanf(fp, "%lf ", &w[i]);
 	}
 	else{
-		wMany = vector<Vector>(nClasses, Vector());
+		wMany = vector<Vector>(nClasses, Vector(m, 0));
 		for (int i = 0; i < nClasses; i++) {
 			for (int j = 0; j < m; j++) {
-				fscanf(fp, "%lf ", wMany[i][j]);
+				fscanf(fp, "%lf ", &wMany[i][j]);
 			}
 		}
 	}
@@ -219,8 +242,9 @@ double L2HingeSVM<Feature>::predict(const Feature& testFeature, double& val){
 		val = -1e30;
 		double argval = 0;
 		for (int j = 0; j < nClasses; j++) {
-			if (featureProductCheck(wMany[j], testFeature) > val) {
-				val = wMany[j]*testFeature;
+			double score = featureProductCheck(wMany[j], testFeature);
+			if (score > val) {
+				val = score;
 				argval = j;
 			}
 		}
@@ -245,8 +269,9 @@ double L2HingeSVM<Feature>::predict(const Feature& testFeature){
 		val = -1e30;
 		double argval = 0;
 		for (int j = 0; j < nClasses; j++) {
-			if (featureProductCheck(wMany[j], testFeature) > val) {
-				val = wMany[j]*testFeature;
+			double score = featureProductCheck(wMany[j], testFeature);
+			if (score > val) {
+				val = score;
 				argval = j;
 			}
 		}
@@ -254,6 +279,28 @@ double L2HingeSVM<Feature>::predict(const Feature& testFeature){
 	}
 }
 
+template <class Feature>
+int L2HingeSVM<Feature>::classWeightBlock(Vector& block){
+	if (nClasses == 2) {
+		block = w;
+		return 1;
+	}
+	block = classMajorBlock(wMany);
+	return nClasses;
+}
+
+template <class Feature>
+void L2HingeSVM<Feature>::setClassWeightBlock(const Vector& block, const int K, const ProbabilityModel probability){
+	nClasses = (K == 1) ? 2 : K;
+	if (K == 1)
+		w = block;
+	else{
+		wMany = vector<Vector>(nClasses);
+		for (int c = 0; c < nClasses; c++)
+			wMany[c] = classWeights(block, K, c);
+	}
+}
+
 // prob is a vector. The assumption is that prob[0] corresponds to -1 and prob[1] corresponds to +1 in binary
 // classification.
 template <class Feature>
@@ -280,5 +327,6 @@ void L2HingeSVM<Feature>::predictProbability(const Feature& testFeature, Vector&
 }
 
 template class L2HingeSVM<SparseFeature>;
+template class L2HingeSVM<SparseRow>;
 
 }
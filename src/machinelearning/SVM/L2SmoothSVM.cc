@@ -30,6 +30,7 @@ using namespace std;
 #include "L2SmoothSVM.h"
 #include "../../optimization/contAlgorithms/contAlgorithms.h"
 #include "../../optimization/contFunctions/L2SmoothSVMLoss.h"
+#include "../../optimization/contFunctions/L2OneVsRestLoss.h"
 #include "../../representation/Set.h"
 #include <assert.h>
 
@@ -37,15 +38,16 @@ using namespace std;
 #define EPSILON 1e-6
 namespace jensen {
 template <class Feature>
-L2SmoothSVM<Feature>::L2SmoothSVM(vector<Feature>& trainFeatures, Vector& y, int m, int n, int nClasses,
+L2SmoothSVM<Feature>::L2SmoothSVM(typename FeatureSet<Feature>::type& trainFeatures, Vector& y, int m, int n, int nClasses,
                                   double lambda, int algtype, int maxIter, double eps, int miniBatch, int lbfgsMemory) : Classifiers<Feature>(m, n), trainFeatures(trainFeatures), y(y),
 	nClasses(nClasses), lambda(lambda), algtype(algtype), maxIter(maxIter), eps(eps), miniBatch(miniBatch), lbfgsMemory(lbfgsMemory) {
 }
 
 template <class Feature>
-L2SmoothSVM<Feature>::L2SmoothSVM(const L2SmoothSVM<Feature>& c) : Classifiers<Feature>(c.m, c.n),
+L2SmoothSVM<Feature>::L2SmoothSVM(const L2SmoothSVM<Feature>& c) : Classifiers<Feature>(c),
 	trainFeatures(c.trainFeatures), y(c.y), nClasses(c.nClasses), lambda(c.lambda), algtype(c.algtype),
-	maxIter(c.maxIter), eps(c.eps), miniBatch(c.miniBatch), lbfgsMemory(c.lbfgsMemory) {
+	maxIter(c.maxIter), eps(c.eps), miniBatch(c.miniBatch), lbfgsMemory(c.lbfgsMemory),
+	w(c.w), wMany(c.wMany), alphaMany(c.alphaMany) {
 }
 
 template <class Feature>
@@ -54,87 +56,135 @@ L2SmoothSVM<Feature>::~L2SmoothSVM(){
 
 template <class Feature>
 void L2SmoothSVM<Feature>::train(){   // train L2 regularized logistic regression
+	if (!warmStart || (alphaMany.size() != ((nClasses == 2) ? 1 : nClasses)))
+		alphaMany = vector<Vector>((nClasses == 2) ? 1 : nClasses);
 	if (nClasses == 2) {
-		trainOne(y, w);
+		trainOne(y, w, alphaMany[0]);
+	}
+	else if ((multiClassMode == MULTICLASS_FUSED) && fusedSupported()) {
+		trainFused();
 	}
 	else{
+		if (multiClassMode == MULTICLASS_FUSED)
+			cout << "Fused multi-class training needs an l2 regularized loss and a primal solver, training the classes one by one\n";
+		else if (multiClassMode == MULTICLASS_SOFTMAX)
+			cout << "Softmax training is only available for logistic regression, training the classes one by one\n";
 		vector<Set> yMapping = vector<Set>(nClasses); // a reverse mapping for indices of a particular label
 		for (int i = 0; i < n; i++)
 			yMapping[y[i]].insert(i);
-		wMany = vector<Vector>(nClasses, Vector(m));
+		if (!warmStart || (wMany.size() != nClasses))
+			wMany = vector<Vector>(nClasses, Vector(m));
+		int T = classThreads(nClasses);
+		int classifierThreads = nThreads;
+		if (T > 1)
+			nThreads = 1;                 // the classes run in parallel, each on one thread
+		#pragma omp parallel for schedule(dynamic, 1) num_threads(T)
 		for (int i = 0; i < nClasses; i++)
 		{
 			Vector yOne(n, -1);
 			for (Set::iterator it = yMapping[i].begin(); it != yMapping[i].end(); it++)
 				yOne[*it] = 1;
-			trainOne(yOne, wMany[i]);
+			trainOne(yOne, wMany[i], alphaMany[i]);
 		}
+		nThreads = classifierThreads;
 	}
 }
 
 template <class Feature>
-void L2SmoothSVM<Feature>::trainOne(Vector& yOne, Vector& wcurr){
+void L2SmoothSVM<Feature>::setRegularization(double lambda){
+	this->lambda = lambda;
+}
+
+template <class Feature>
+void L2SmoothSVM<Feature>::trainOne(Vector& yOne, Vector& wcurr, Vector& alphacurr){
+	Vector x0 = initialPoint(wcurr);
 	L2SmoothSVMLoss<Feature> ll(m, trainFeatures, yOne, lambda);
+	ll.setNumThreads(nThreads);
 	if (algtype == 0) {
 		cout<<"*******************************************************************\n";
 		cout<<"Training using Dual Coordinate Descent Algorithm...\n";
-		wcurr = SVCDual(trainFeatures, y, 2, 1, eps, maxIter);
+		wcurr = SVCDual(trainFeatures, yOne, 2, lambda, eps, maxIter, 1, nThreads, &alphacurr);
 	}
-	else if (algtype == 1) {
+	else
+		minimizePrimal(ll, x0, wcurr);
+}
+
+// Runs the primal solver selected by algtype (1-9) on a smooth SVM loss (binary, or the fused one-vs-rest loss).
+template <class Feature>
+void L2SmoothSVM<Feature>::minimizePrimal(const ContinuousFunctions& ll, const Vector& x0, Vector& wcurr){
+	if (algtype == 1) {
 		cout<<"*******************************************************************\n";
 		cout<<"Training using LBFGS...\n";
-		wcurr = lbfgsMin(ll, Vector(m, 0), 1, 1e-4, maxIter, lbfgsMemory, eps);
+		wcurr = lbfgsMin(ll, x0, 1, 1e-4, maxIter, lbfgsMemory, eps);
 	}
 	else if (algtype == 2) {
 		cout<<"*******************************************************************\n";
 		cout<<"Training using Gradient Descent with fixed step size...\n";
-		wcurr = gdLineSearch(ll, Vector(m, 0), 1, 1e-5, maxIter, eps);
+		wcurr = gdLineSearch(ll, x0, 1, 1e-5, maxIter, eps);
 	}
 	else if (algtype == 3) {
 		cout<<"*******************************************************************\n";
 		cout<<"Training using Gradient Descent with Barzilia-Borwein Step Length\n";
-		wcurr = gdBarzilaiBorwein(ll, Vector(m, 0), 1, 1e-5, maxIter, eps);
+		wcurr = gdBarzilaiBorwein(ll, x0, 1, 1e-5, maxIter, eps);
 	}
 	// gradientDescentBB(ss, Vector(m, 0), 1, 1e-4, 250);
 	else if (algtype == 4) {
 		cout<<"*******************************************************************\n";
 		cout<<"Training using Conjugate Gradient for Logistic Loss, press enter to continue...\n";
-		wcurr = cg(ll, Vector(m, 0), 1, 1e-5, maxIter, eps);
+		wcurr = cg(ll, x0, 1, 1e-5, maxIter, eps);
 	}
 	else if (algtype == 5) {
 		cout<<"*******************************************************************\n";
 		cout<<"Training using Nesterov's Method\n";
-		wcurr = gdNesterov(ll, Vector(m, 0), 1, 1e-5, maxIter, eps);
+		wcurr = gdNesterov(ll, x0, 1, 1e-5, maxIter, eps);
 	}
 	else if (algtype == 6) {
 		cout<<"*******************************************************************\n";
 		cout<<"Training using Stochastic Gradient Descent\n";
-		wcurr = sgd(ll, Vector(m, 0), n, 1e-4, miniBatch, eps, maxIter);
+		wcurr = sgd(ll, x0, n, 1e-4, miniBatch, eps, maxIter, 1, nThreads, scaledSteps);
 	}
 	else if (algtype == 7) {
 		cout<<"*******************************************************************\n";
 		cout<<"Training using Stochastic Gradient Descent with decaying learning rate\n";
-		wcurr = sgdDecayingLearningRate(ll, Vector(m, 0), n, 0.5*1e-1, miniBatch, eps, maxIter);
+		wcurr = sgdDecayingLearningRate(ll, x0, n, 0.5*1e-1, miniBatch, eps, maxIter, 0.5, 1, nThreads, scaledSteps);
 	}
 	else if (algtype == 8) {
 		cout<<"*******************************************************************\n";
 		cout<<"Training using Adaptive Gradient Algorithm\n";
-		wcurr = sgdAdagrad(ll, Vector(m, 0), n, 1e-2, miniBatch, eps, maxIter);
+		wcurr = sgdAdagrad(ll, x0, n, 1e-2, miniBatch, eps, maxIter, 1, nThreads);
 	}
 	else if (algtype == 9) {
 		cout<<"*******************************************************************\n";
 		cout<<"Training using TRON\n";
-		wcurr = tron(ll, Vector(m, 0), maxIter, eps, 1);
+		wcurr = tron(ll, x0, maxIter, eps, 1);
 	}
 }
 
+template <class Feature>
+bool L2SmoothSVM<Feature>::fusedSupported(){
+	return (algtype >= 1) && (algtype <= 9);
+}
+
+// All classes in one pass over the data per evaluation: the solver runs on the class-major block of the nClasses weight vectors.
+template <class Feature>
+void L2SmoothSVM<Feature>::trainFused(){
+	L2OneVsRestLoss<Feature> ll(m, trainFeatures, y, nClasses, lambda, OVR_SMOOTH_SVM);
+	ll.setNumThreads(nThreads);
+	Vector x0 = (warmStart && (wMany.size() == nClasses)) ? classMajorBlock(wMany) : Vector((long int) m*nClasses, 0);
+	Vector x;
+	minimizePrimal(ll, x0, x);
+	wMany = vector<Vector>(nClasses);
+	for (int c = 0; c < nClasses; c++)
+		wMany[c] = classWeights(x, nClasses, c);
+}
+
 // save the model
 template <class Feature>
 int L2SmoothSVM<Feature>::saveModel(char* model){
 	FILE *fp = fopen(model,"w");
 	if(fp==NULL) return -1;
 
-	fprintf(fp, "algtype %s\n", algtype);
+	fprintf(fp, "algtype %d\n", algtype);
 	fprintf(fp, "nClasses %d\n", nClasses);
 	fprintf(fp, "nFeatures %d\n", m);
 	fprintf(fp, "n %d\n", n);
@@ -168,7 +218,10 @@ int L2SmoothSVM<Feature>::loadModel(char* model){
 	char cmd[81];
 	while(1)
 	{
-		fscanf(fp,"%80s",cmd);
+		if (fscanf(fp,"%80s",cmd) != 1) {
+			fclose(fp);
+			return -1;
+		}
 		if(strcmp(cmd,"algtype")==0)
 			fscanf(fp,"%d",&algtype);
 		else if(strcmp(cmd,"nClasses")==0)
@@ -191,13 +244,13 @@ int L2SmoothSVM<Feature>::loadModel(char* model){
 	if(nClasses==2) {
 		w = Vector(m, 0);
 		for (int i = 0; i < m; i++)
-			fscanf(fp, "%lf ", w[i]);
+			fscanf(fp, "%lf ", &w[i]);
 	}
 	else{
-		wMany = vector<Vector>(nClasses, Vector());
+		wMany = vector<Vector>(nClasses, Vector(m, 0));
 		for (int i = 0; i < nClasses; i++) {
 			for (int j = 0; j < m; j++) {
-				fscanf(fp, "%lf ", wMany[i][j]);
+				fscanf(fp, "%lf ", &wMany[i][j]);
 			}
 		}
 	}
@@ -221,8 +274,9 @@ double L2SmoothSVM<Feature>::predict(const Feature& testFeature, double& val){
 		val = -1e30;
 		double argval = 0;
 		for (int j = 0; j < nClasses; j++) {
-			if (featureProductCheck(wMany[j], testFeature) > val) {
-				val = wMany[j]*testFeature;
+			double score = featureProductCheck(wMany[j], testFeature);
+			if (score > val) {
+				val = score;
 				argval = j;
 			}
 		}
@@ -247,8 +301,9 @@ double L2SmoothSVM<Feature>::predict(const Feature& testFeature){
 		val = -1e30;
 		double argval = 0;
 		for (int j = 0; j < nClasses; j++) {
-			if (featureProductCheck(wMany[j], testFeature) > val) {
-				val = wMany[j]*testFeature;
+			double score = featureProductCheck(wMany[j], testFeature);
+			if (score > val) {
+				val = score;
 				argval = j;
 			}
 		}
@@ -256,6 +311,28 @@ double L2SmoothSVM<Feature>::predict(const Feature& testFeature){
 	}
 }
 
+template <class Feature>
+int L2SmoothSVM<Feature>::classWeightBlock(Vector& block){
+	if (nClasses == 2) {
+		block = w;
+		return 1;
+	}
+	block = classMajorBlock(wMany);
+	return nClasses;
+}
+
+template <class Feature>
+void L2SmoothSVM<Feature>::setClassWeightBlock(const Vector& block, const int K, const ProbabilityModel probability){
+	nClasses = (K == 1) ? 2 : K;
+	if (K == 1)
+		w = block;
+	else{
+		wMany = vector<Vector>(nClasses);
+		for (int c = 0; c < nClasses; c++)
+			wMany[c] = classWeights(block, K, c);
+	}
+}
+
 // prob is a vector. The assumption is that prob[0] corresponds to -1 and prob[1] corresponds to +1 in binary
 // classification.
 template <class Feature>
@@ -282,5 +359,6 @@ void L2SmoothSVM<Feature>::predictProbability(const Feature& testFeature, Vector
 }
 
 template class L2SmoothSVM<SparseFeature>;
+template class L2SmoothSVM<SparseRow>;
 
 }
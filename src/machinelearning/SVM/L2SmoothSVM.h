@@ -28,6 +28,7 @@
 #include "../../representation/Matrix.h"
 #include "../../representation/VectorOperations.h"
 #include "../../representation/MatrixOperations.h"
+#include "../../optimization/contFunctions/ContinuousFunctions.h"
 #include <vector>
 using namespace std;
 
@@ -36,11 +37,12 @@ namespace jensen {
 template <class Feature>
 class L2SmoothSVM : public Classifiers<Feature>{
 protected:
-vector<Feature>& trainFeatures;                 // training features
+typename FeatureSet<Feature>::type& trainFeatures;                 // training features
 Vector& y;             // size of y is number of training examples (n)
 int algtype;                 // the algorithm type used for training, default is the trust region newton.
 vector<Vector> wMany;                 // the weights in the multiclass scenario -- nClasses number of weight vectors.
 Vector w;                 // the weights in the binary scenario.
+vector<Vector> alphaMany;                 // the dual variables of each binary problem (dual coordinate descent), kept for warm starts
 int nClasses;                 // the number of classes
 double lambda;                 // regularization
 int maxIter;                 // maximum number of iterations for the algorithms
@@ -49,14 +51,26 @@ int miniBatch;                 // This is the miniBatch size for Stochastic Grad
 int lbfgsMemory;                 // memory of the LBFGS algorithm.
 using Classifiers<Feature>::m;
 using Classifiers<Feature>::n;
+using Classifiers<Feature>::nThreads;
+using Classifiers<Feature>::warmStart;
+using Classifiers<Feature>::scaledSteps;
+using Classifiers<Feature>::initialPoint;
+using Classifiers<Feature>::multiClassMode;
+using Classifiers<Feature>::classThreads;
+int classWeightBlock(Vector& block);
+void setClassWeightBlock(const Vector& block, const int K, const ProbabilityModel probability);
 public:
-L2SmoothSVM(vector<Feature>& trainFeatures, Vector& y, int m, int n, int nClasses = 2, double lambda = 1,
+L2SmoothSVM(typename FeatureSet<Feature>::type& trainFeatures, Vector& y, int m, int n, int nClasses = 2, double lambda = 1,
             int algtype = 0, int maxIter = 250, double eps = 1e-2, int miniBatch = 100, int lbfgsMemory = 100);
 L2SmoothSVM(const L2SmoothSVM& c);         // copy constructor
 ~L2SmoothSVM();
 
-void trainOne(Vector& yOne, Vector& wcurr);                 // a member function for binary classification.
+void trainOne(Vector& yOne, Vector& wcurr, Vector& alphacurr);                 // a member function for binary classification.
+void minimizePrimal(const ContinuousFunctions& ll, const Vector& x0, Vector& wcurr);                 // the primal solver selected by algtype
+bool fusedSupported();                 // true if the multi-class problem can be trained as one L2OneVsRestLoss
+void trainFused();                 // MULTICLASS_FUSED training
 void train();                 // train
+void setRegularization(double lambda);
 
 int saveModel(char* model);                 // save the model
 int loadModel(char* model);                 // save the model
@@ -28,6 +28,8 @@
                 With L2 Regularizer only:
 
                 12 TRON
+                13 (Stochastic Average Gradient (SAG))
+                14 (SAGA)
 
     reg_type: type of regularization
     			0 (L1)
@@ -47,6 +49,9 @@ using namespace std;
 #include "../../optimization/contAlgorithms/contAlgorithms.h"
 #include "../../optimization/contFunctions/L1LogisticLoss.h"
 #include "../../optimization/contFunctions/L2LogisticLoss.h"
+#include "../../optimization/contFunctions/L2OneVsRestLoss.h"
+#include "../../optimization/contFunctions/L1SoftmaxLoss.h"
+#include "../../optimization/contFunctions/L2SoftmaxLoss.h"
 #include "../../representation/Set.h"
 
 #define EPSILON 1e-6
@@ -55,15 +60,16 @@ using namespace std;
 namespace jensen {
 
 template <class Feature>
-LogisticRegression<Feature>::LogisticRegression(vector<Feature>& trainFeatures, Vector& y, int m, int n, int nClasses,
+LogisticRegression<Feature>::LogisticRegression(typename FeatureSet<Feature>::type& trainFeatures, Vector& y, int m, int n, int nClasses,
                                                     double lambda, int algtype, int reg_type, int maxIter, double eps, int miniBatch, int lbfgsMemory) : Classifiers<Feature>(m, n), trainFeatures(trainFeatures),
-	y(y), nClasses(nClasses), lambda(lambda), algtype(algtype), reg_type(reg_type), maxIter(maxIter), eps(eps), miniBatch(miniBatch), lbfgsMemory(lbfgsMemory) {
+	y(y), nClasses(nClasses), lambda(lambda), algtype(algtype), reg_type(reg_type), maxIter(maxIter), eps(eps), miniBatch(miniBatch), lbfgsMemory(lbfgsMemory), softmax(false) {
 }
 
 template <class Feature>
-LogisticRegression<Feature>::LogisticRegression(const LogisticRegression<Feature>& c) : Classifiers<Feature>(c.m, c.n), nClasses(c.nClasses),
+LogisticRegression<Feature>::LogisticRegression(const LogisticRegression<Feature>& c) : Classifiers<Feature>(c), nClasses(c.nClasses),
 	trainFeatures(c.trainFeatures), y(c.y), lambda(c.lambda), algtype(c.algtype), reg_type(c.reg_type),
-	maxIter(c.maxIter), eps(c.eps), miniBatch(c.miniBatch), lbfgsMemory(c.lbfgsMemory){
+	maxIter(c.maxIter), eps(c.eps), miniBatch(c.miniBatch), lbfgsMemory(c.lbfgsMemory), softmax(c.softmax),
+	w(c.w), wMany(c.wMany), wSparse(c.wSparse), wManySparse(c.wManySparse) {
 }
 
 template <class Feature>
@@ -73,14 +79,31 @@ LogisticRegression<Feature>::~LogisticRegression(){
 
 template <class Feature>
 void LogisticRegression<Feature>::train(){         // train logistic regression
+	softmax = false;
 	if (nClasses == 2) {
 		trainOne(y, w);
 	}
+	else if ((multiClassMode == MULTICLASS_FUSED) && fusedSupported()) {
+		trainFused();
+	}
+	else if ((multiClassMode == MULTICLASS_SOFTMAX) && softmaxSupported()) {
+		trainSoftmax();
+	}
 	else{
+		if (multiClassMode == MULTICLASS_FUSED)
+			cout << "Fused multi-class training needs an l2 regularized loss and a primal solver, training the classes one by one\n";
+		else if (multiClassMode == MULTICLASS_SOFTMAX)
+			cout << "Softmax training is not available for SAG and SAGA, training the classes one by one\n";
 		vector<Set> yMapping = vector<Set>(nClasses);         // a reverse mapping for indices of a particular label
 		for (int i = 0; i < n; i++)
 			yMapping[y[i]].insert(i);
-		wMany = vector<Vector>(nClasses, Vector(m));
+		if (!warmStart || (wMany.size() != nClasses))
+			wMany = vector<Vector>(nClasses, Vector(m));
+		int T = classThreads(nClasses);
+		int classifierThreads = nThreads;
+		if (T > 1)
+			nThreads = 1;                 // the classes run in parallel, each on one thread
+		#pragma omp parallel for schedule(dynamic, 1) num_threads(T)
 		for (int i = 0; i < nClasses; i++)
 		{
 			Vector yOne(n, -1);
@@ -88,13 +111,21 @@ void LogisticRegression<Feature>::train(){         // train logistic regression
 				yOne[*it] = 1;
 			trainOne(yOne, wMany[i]);
 		}
+		nThreads = classifierThreads;
 	}
+	sparsifyWeights();
 }
 
 
 
+template <class Feature>
+void LogisticRegression<Feature>::setRegularization(double lambda){
+	this->lambda = lambda;
+}
+
 template <class Feature>
 void LogisticRegression<Feature>::trainOne(Vector& yOne, Vector& wcurr){
+	Vector x0 = initialPoint(wcurr);
 
 	cout << trainFeatures.size() << " " << yOne.size() << "\n";
 	if (reg_type == 0) {	//L1 Logistic Regression
@@ -102,68 +133,9 @@ void LogisticRegression<Feature>::trainOne(Vector& yOne, Vector& wcurr){
 
 		L1LogisticLoss<Feature> ll(m, trainFeatures, yOne, lambda);
 		L1LogisticLoss<Feature> l(m, trainFeatures, yOne, 0);
-
-		if (algtype == 0) {
-			cout<<"*******************************************************************\n";
-			cout<<"Training with LBFGS...\n";
-			wcurr = lbfgsMin(ll, Vector(m, 0), 1, 1e-4, maxIter, lbfgsMemory, eps);
-		}
-		else if (algtype == 1) {
-			cout<<"*******************************************************************\n";
-			cout<<"Training with Gradient Descent with Line Search...\n";
-			wcurr = gdLineSearch(ll, Vector(m, 0), 1, 1e-5, maxIter, eps);
-		}
-		else if (algtype == 2) {
-			cout<<"*******************************************************************\n";
-			cout<<"Training with Gradient Descent with Barzilia-Borwein Step Length\n";
-			wcurr = gdBarzilaiBorwein(ll, Vector(m, 0), 1, 1e-5, maxIter, eps);
-		}
-		else if (algtype == 3) {
-			cout<<"*******************************************************************\n";
-			cout<<"Training with Nesterov's Method\n";
-			wcurr = gdNesterov(ll, Vector(m, 0), 1, 1e-5, maxIter, eps);
-		}
-		else if (algtype == 4) {
-			cout<<"*******************************************************************\n";
-			cout<<"Training with Conjugate Gradient...\n";
-			wcurr = cg(ll, Vector(m, 0), 1, 1e-5, maxIter, eps);
-		}
-		else if (algtype == 5) {
-			cout<<"*******************************************************************\n";
-			cout<<"Training with Stochastic Gradient Descent\n";
-			wcurr = sgd(ll, Vector(m, 0), n, 1e-4, miniBatch, eps, maxIter);
-		}
-		else if (algtype == 6) {
-			cout<<"*******************************************************************\n";
-			cout<<"Training with Stochastic Gradient Descent with decaying learning rate\n";
-			wcurr = sgdDecayingLearningRate(ll, Vector(m, 0), n, 0.5*1e-1, miniBatch, eps, maxIter);
-		}
-
-		else if (algtype == 7) {
-			cout<<"*******************************************************************\n";
-			cout<<"Training with Adaptive Gradient Algorithm\n";
-			wcurr = sgdAdagrad(ll, Vector(m, 0), n, 1e-2, miniBatch, eps, maxIter);
-		}
-		else if (algtype == 8) {
-			cout<<"*******************************************************************\n";
-			cout<<"Training with LBFGS-OWL...\n";
-			wcurr = lbfgsMinOwl(ll, Vector(m, 0), 1, 1e-4, maxIter, lbfgsMemory, eps);
-		}
-		else if (algtype == 9) {
-			cout<<"*******************************************************************\n";
-			cout<<"Training with Gradient Descent with fixed step size...\n";
-			wcurr = gd(ll, Vector(m, 0), 1e-5, maxIter, eps);
-		}
-		else if (algtype == 10) {
-			cout<<"*******************************************************************\n";
-			cout<<"Training with Stochastic Gradient Descent and Dual Averaging...\n";
-			wcurr = sgdRegularizedDualAveraging(ll, l, Vector(m, 0), n, 1e-1, lambda, miniBatch, eps, maxIter, 0.5);
-		}
-		else if (algtype == 11) {
-			cout<<"*******************************************************************\n";
-			cout<<"Training with Adaptive Gradient Descent and Dual Averaging...\n";
-			wcurr = sgdRegularizedDualAveraging(ll, l, Vector(m, 0), n, 1e-1, lambda, miniBatch, eps, maxIter);
-		}
+		ll.setNumThreads(nThreads);
+		l.setNumThreads(nThreads);
+		minimizeL1(ll, l, x0, wcurr);
 	}
 
 	else if (reg_type == 1){
@@ -171,66 +143,196 @@ void LogisticRegression<Feature>::trainOne(Vector& yOne, Vector& wcurr){
 
 
 		L2LogisticLoss<Feature> ll(m, trainFeatures, yOne, lambda);
-		if (algtype == 0) {
-			cout<<"*******************************************************************\n";
-			cout<<"Training with LBFGS...\n";
-			wcurr = lbfgsMin(ll, Vector(m, 0), 1, 1e-4, maxIter, lbfgsMemory, eps);
-		}
-		else if (algtype == 1) {
-			cout<<"*******************************************************************\n";
-			cout<<"Training with Gradient Descent with Line Search...\n";
-			wcurr = gdLineSearch(ll, Vector(m, 0), 1, 1e-5, maxIter, eps);
-		}
-		else if (algtype == 2) {
-			cout<<"*******************************************************************\n";
-			cout<<"Training with Gradient Descent with Barzilia-Borwein Step Length\n";
-			wcurr = gdBarzilaiBorwein(ll, Vector(m, 0), 1, 1e-5, maxIter, eps);
-		}
-		else if (algtype == 3) {
-			cout<<"*******************************************************************\n";
-			cout<<"Training with Nesterov's Method\n";
-			wcurr = gdNesterov(ll, Vector(m, 0), 1, 1e-5, maxIter, eps);
-		}
-		else if (algtype == 4) {
-			cout<<"*******************************************************************\n";
-			cout<<"Training with Conjugate Gradient...\n";
-			wcurr = cg(ll, Vector(m, 0), 1, 1e-5, maxIter, eps);
-		}
-		else if (algtype == 5) {
-			cout<<"*******************************************************************\n";
-			cout<<"Training with Stochastic Gradient Descent\n";
-			wcurr = sgd(ll, Vector(m, 0), n, 1e-4, miniBatch, eps, maxIter);
-		}
-		else if (algtype == 6) {
-			cout<<"*******************************************************************\n";
-			cout<<"Training with Stochastic Gradient Descent with decaying learning rate\n";
-			wcurr = sgdDecayingLearningRate(ll, Vector(m, 0), n, 0.5*1e-1, miniBatch, eps, maxIter);
-		}
+		ll.setNumThreads(nThreads);
+		minimizeL2(ll, x0, wcurr);
+	}
+}
 
-		else if (algtype == 7) {
-			cout<<"*******************************************************************\n";
-			cout<<"Training with Adaptive Gradient Algorithm\n";
-			wcurr = sgdAdagrad(ll, Vector(m, 0), n, 1e-2, miniBatch, eps, maxIter);
-		}
-		else if (algtype == 12) {
-			cout<<"*******************************************************************\n";
-			cout<<"Training using Trust Region Newton Algorithm...\n";
-			wcurr = tron(ll, Vector(m, 0), maxIter, eps);
-		}
+// Runs the solver selected by algtype on an l1 regularized loss ll, l is the loss without the regularizer (for dual averaging).
+template <class Feature>
+void LogisticRegression<Feature>::minimizeL1(const ContinuousFunctions& ll, const ContinuousFunctions& l, const Vector& x0, Vector& wcurr){
+	if (algtype == 0) {
+		cout<<"*******************************************************************\n";
+		cout<<"Training with LBFGS...\n";
+		wcurr = lbfgsMin(ll, x0, 1, 1e-4, maxIter, lbfgsMemory, eps);
+	}
+	else if (algtype == 1) {
+		cout<<"*******************************************************************\n";
+		cout<<"Training with Gradient Descent with Line Search...\n";
+		wcurr = gdLineSearch(ll, x0, 1, 1e-5, maxIter, eps);
+	}
+	else if (algtype == 2) {
+		cout<<"*******************************************************************\n";
+		cout<<"Training with Gradient Descent with Barzilia-Borwein Step Length\n";
+		wcurr = gdBarzilaiBorwein(ll, x0, 1, 1e-5, maxIter, eps);
+	}
+	else if (algtype == 3) {
+		cout<<"*******************************************************************\n";
+		cout<<"Training with Nesterov's Method\n";
+		wcurr = gdNesterov(ll, x0, 1, 1e-5, maxIter, eps);
+	}
+	else if (algtype == 4) {
+		cout<<"*******************************************************************\n";
+		cout<<"Training with Conjugate Gradient...\n";
+		wcurr = cg(ll, x0, 1, 1e-5, maxIter, eps);
+	}
+	else if (algtype == 5) {
+		cout<<"*******************************************************************\n";
+		cout<<"Training with Stochastic Gradient Descent\n";
+		wcurr = sgd(ll, x0, n, 1e-4, miniBatch, eps, maxIter, 1, nThreads, scaledSteps);
+	}
+	else if (algtype == 6) {
+		cout<<"*******************************************************************\n";
+		cout<<"Training with Stochastic Gradient Descent with decaying learning rate\n";
+		wcurr = sgdDecayingLearningRate(ll, x0, n, 0.5*1e-1, miniBatch, eps, maxIter, 0.5, 1, nThreads, scaledSteps);
+	}
 
+	else if (algtype == 7) {
+		cout<<"*******************************************************************\n";
+		cout<<"Training with Adaptive Gradient Algorithm\n";
+		wcurr = sgdAdagrad(ll, x0, n, 1e-2, miniBatch, eps, maxIter, 1, nThreads);
+	}
+	else if (algtype == 8) {
+		cout<<"*******************************************************************\n";
+		cout<<"Training with LBFGS-OWL...\n";
+		wcurr = lbfgsMinOwl(ll, x0, 1, 1e-4, maxIter, lbfgsMemory, eps);
+	}
+	else if (algtype == 9) {
+		cout<<"*******************************************************************\n";
+		cout<<"Training with Gradient Descent with fixed step size...\n";
+		wcurr = gd(ll, x0, 1e-5, maxIter, eps);
+	}
+	else if (algtype == 10) {
+		cout<<"*******************************************************************\n";
+		cout<<"Training with Stochastic Gradient Descent and Dual Averaging...\n";
+		wcurr = sgdRegularizedDualAveraging(ll, l, x0, n, 1e-1, lambda, miniBatch, eps, maxIter, 0.5);
+	}
+	else if (algtype == 11) {
+		cout<<"*******************************************************************\n";
+		cout<<"Training with Adaptive Gradient Descent and Dual Averaging...\n";
+		wcurr = sgdRegularizedDualAveraging(ll, l, x0, n, 1e-1, lambda, miniBatch, eps, maxIter);
 	}
 }
 
+// Runs the solver selected by algtype on an l2 regularized loss (binary, or the fused one-vs-rest loss).
+template <class Feature>
+void LogisticRegression<Feature>::minimizeL2(const ContinuousFunctions& ll, const Vector& x0, Vector& wcurr){
+	if (algtype == 0) {
+		cout<<"*******************************************************************\n";
+		cout<<"Training with LBFGS...\n";
+		wcurr = lbfgsMin(ll, x0, 1, 1e-4, maxIter, lbfgsMemory, eps);
+	}
+	else if (algtype == 1) {
+		cout<<"*******************************************************************\n";
+		cout<<"Training with Gradient Descent with Line Search...\n";
+		wcurr = gdLineSearch(ll, x0, 1, 1e-5, maxIter, eps);
+	}
+	else if (algtype == 2) {
+		cout<<"*******************************************************************\n";
+		cout<<"Training with Gradient Descent with Barzilia-Borwein Step Length\n";
+		wcurr = gdBarzilaiBorwein(ll, x0, 1, 1e-5, maxIter, eps);
+	}
+	else if (algtype == 3) {
+		cout<<"*******************************************************************\n";
+		cout<<"Training with Nesterov's Method\n";
+		wcurr = gdNesterov(ll, x0, 1, 1e-5, maxIter, eps);
+	}
+	else if (algtype == 4) {
+		cout<<"*******************************************************************\n";
+		cout<<"Training with Conjugate Gradient...\n";
+		wcurr = cg(ll, x0, 1, 1e-5, maxIter, eps);
+	}
+	else if (algtype == 5) {
+		cout<<"*******************************************************************\n";
+		cout<<"Training with Stochastic Gradient Descent\n";
+		wcurr = sgd(ll, x0, n, 1e-4, miniBatch, eps, maxIter, 1, nThreads, scaledSteps);
+	}
+	else if (algtype == 6) {
+		cout<<"*******************************************************************\n";
+		cout<<"Training with Stochastic Gradient Descent with decaying learning rate\n";
+		wcurr = sgdDecayingLearningRate(ll, x0, n, 0.5*1e-1, miniBatch, eps, maxIter, 0.5, 1, nThreads, scaledSteps);
+	}
+
+	else if (algtype == 7) {
+		cout<<"*******************************************************************\n";
+		cout<<"Training with Adaptive Gradient Algorithm\n";
+		wcurr = sgdAdagrad(ll, x0, n, 1e-2, miniBatch, eps, maxIter, 1, nThreads);
+	}
+	else if (algtype == 12) {
+		cout<<"*******************************************************************\n";
+		cout<<"Training using Trust Region Newton Algorithm...\n";
+		wcurr = tron(ll, x0, maxIter, eps);
+	}
+	else if (algtype == 13) {
+		cout<<"*******************************************************************\n";
+		cout<<"Training with the Stochastic Average Gradient Algorithm...\n";
+		wcurr = sgdStochasticAverageGradient(ll, x0, n, 1, eps, maxIter);
+	}
+	else if (algtype == 14) {
+		cout<<"*******************************************************************\n";
+		cout<<"Training with SAGA...\n";
+		wcurr = sgdSAGA(ll, x0, n, 1.0/3, eps, maxIter);
+	}
+}
+
+template <class Feature>
+bool LogisticRegression<Feature>::fusedSupported(){
+	return (reg_type == 1) && (((algtype >= 0) && (algtype <= 7)) || (algtype == 12));
+}
+
+// All classes in one pass over the data per evaluation: the solver runs on the class-major block of the nClasses weight vectors.
+template <class Feature>
+void LogisticRegression<Feature>::trainFused(){
+	L2OneVsRestLoss<Feature> ll(m, trainFeatures, y, nClasses, lambda, OVR_LOGISTIC);
+	ll.setNumThreads(nThreads);
+	Vector x0 = (warmStart && (wMany.size() == nClasses)) ? classMajorBlock(wMany) : Vector((long int) m*nClasses, 0);
+	Vector x;
+	minimizeL2(ll, x0, x);
+	wMany = vector<Vector>(nClasses);
+	for (int c = 0; c < nClasses; c++)
+		wMany[c] = classWeights(x, nClasses, c);
+}
+
+template <class Feature>
+bool LogisticRegression<Feature>::softmaxSupported(){
+	return (reg_type == 0) || fusedSupported();
+}
+
+// A single multinomial model over the m x K block of the class weights, all K scores of a row are computed in one pass.
+template <class Feature>
+void LogisticRegression<Feature>::trainSoftmax(){
+	Vector x0 = (warmStart && (wMany.size() == nClasses)) ? classMajorBlock(wMany) : Vector((long int) m*nClasses, 0);
+	Vector x;
+	if (reg_type == 0) {
+		L1SoftmaxLoss<Feature> ll(m, trainFeatures, y, nClasses, lambda);
+		L1SoftmaxLoss<Feature> l(m, trainFeatures, y, nClasses, 0);
+		ll.setNumThreads(nThreads);
+		l.setNumThreads(nThreads);
+		minimizeL1(ll, l, x0, x);
+	}
+	else{
+		L2SoftmaxLoss<Feature> ll(m, trainFeatures, y, nClasses, lambda);
+		ll.setNumThreads(nThreads);
+		minimizeL2(ll, x0, x);
+	}
+	wMany = vector<Vector>(nClasses);
+	for (int c = 0; c < nClasses; c++)
+		wMany[c] = classWeights(x, nClasses, c);
+	softmax = true;
+}
+
 // save the model
 template <class Feature>
 int LogisticRegression<Feature>::saveModel(char* model){
 	FILE *fp = fopen(model,"w");
 	if(fp==NULL) return -1;
 
-	fprintf(fp, "algtype %s\n", algtype);
+	fprintf(fp, "algtype %d\n", algtype);
 	fprintf(fp, "nClasses %d\n", nClasses);
 	fprintf(fp, "nFeatures %d\n", m);
 	fprintf(fp, "n %d\n", n);
+	if (softmax)
+		fprintf(fp, "softmax 1\n");
 	fprintf(fp, "w\n");
 	if (nClasses == 2) {
 		for(int i=0; i<w.size(); i++)
@@ -261,7 +363,10 @@ int LogisticRegression<Feature>::loadModel(char* model){
 	char cmd[81];
 	while(1)
 	{
-		fscanf(fp,"%80s",cmd);
+		if (fscanf(fp,"%80s",cmd) != 1) {
+			fclose(fp);
+			return -1;
+		}
 		if(strcmp(cmd,"algtype")==0)
 			fscanf(fp,"%d",&algtype);
 		else if(strcmp(cmd,"nClasses")==0)
@@ -270,6 +375,11 @@ int LogisticRegression<Feature>::loadModel(char* model){
 			fscanf(fp,"%d",&m);
 		else if(strcmp(cmd,"n")==0)
 			fscanf(fp,"%d",&n);
+		else if(strcmp(cmd,"softmax")==0) {
+			int flag;
+			fscanf(fp,"%d",&flag);
+			softmax = (flag != 0);
+		}
 		else if(strcmp(cmd,"w")==0)
 		{
 			break;
@@ -284,26 +394,47 @@ int LogisticRegression<Feature>::loadModel(char* model){
 	if(nClasses==2) {
 		w = Vector(m, 0);
 		for (int i = 0; i < m; i++)
-			fscanf(fp, "%f ", w[i]);
+			fscanf(fp, "%lf ", &w[i]);
 	}
 	else{
-		wMany = vector<Vector>(nClasses, Vector());
+		wMany = vector<Vector>(nClasses, Vector(m, 0));
 		for (int i = 0; i < nClasses; i++) {
 			for (int j = 0; j < m; j++) {
-				fscanf(fp, "%f ", wMany[i][j]);
+				fscanf(fp, "%lf ", &wMany[i][j]);
 			}
 		}
 	}
+	sparsifyWeights();
 	if (ferror(fp) != 0 || fclose(fp) != 0) return -1;
 	return 1;
 }
 
 
+template <class Feature>
+void LogisticRegression<Feature>::sparsifyWeights(){
+	if (!(reg_type == 0))
+		return;
+	if (nClasses == 2)
+		wSparse = SparseVector(w);
+	else{
+		wManySparse.resize(nClasses);
+		for (int j = 0; j < nClasses; j++)
+			wManySparse[j] = SparseVector(wMany[j]);
+	}
+}
+
+template <class Feature>
+double LogisticRegression<Feature>::classScore(const int j, const Feature& testFeature){
+	if (reg_type == 0)
+		return featureProductCheck((nClasses == 2) ? wSparse : wManySparse[j], testFeature);
+	return featureProductCheck((nClasses == 2) ? w : wMany[j], testFeature);
+}
+
 template <class Feature>
 double LogisticRegression<Feature>::predict(const Feature& testFeature, double& val){
 	// the assumption here is that train and test datasets have the same number of features
 	if (nClasses == 2) {
-		val = featureProductCheck(w, testFeature);
+		val = classScore(0, testFeature);
 		double argval = 0;
 		if (val > 0)
 			argval = 1;
@@ -315,8 +446,9 @@ double LogisticRegression<Feature>::predict(const Feature& testFeature, double&
 		val = -1e30;
 		double argval = 0;
 		for (int j = 0; j < nClasses; j++) {
-			if (featureProductCheck(wMany[j], testFeature) > val) {
-				val = featureProductCheck(wMany[j], testFeature);
+			double score = classScore(j, testFeature);
+			if (score > val) {
+				val = score;
 				argval = j;
 			}
 		}
@@ -328,7 +460,7 @@ template <class Feature>
 double LogisticRegression<Feature>::predict(const Feature& testFeature){
 	// the assumption here is that train and test datasets have the same number of features
 	if (nClasses == 2) {
-		double val = featureProductCheck(w, testFeature);
+		double val = classScore(0, testFeature);
 		double argval = 0;
 		if (val > 0)
 			argval = 1;
@@ -340,8 +472,9 @@ double LogisticRegression<Feature>::predict(const Feature& testFeature){
 		double val = -1e30;
 		double argval = 0;
 		for (int j = 0; j < nClasses; j++) {
-			if (featureProductCheck(wMany[j], testFeature) > val) {
-				val = featureProductCheck(wMany[j], testFeature);
+			double score = classScore(j, testFeature);
+			if (score > val) {
+				val = score;
 				argval = j;
 			}
 		}
@@ -349,6 +482,35 @@ double LogisticRegression<Feature>::predict(const Feature& testFeature){
 	}
 }
 
+template <class Feature>
+int LogisticRegression<Feature>::classWeightBlock(Vector& block){
+	if (nClasses == 2) {
+		block = w;
+		return 1;
+	}
+	block = classMajorBlock(wMany);
+	return nClasses;
+}
+
+template <class Feature>
+void LogisticRegression<Feature>::setClassWeightBlock(const Vector& block, const int K, const ProbabilityModel probability){
+	nClasses = (K == 1) ? 2 : K;
+	if (K == 1)
+		w = block;
+	else{
+		wMany = vector<Vector>(nClasses);
+		for (int c = 0; c < nClasses; c++)
+			wMany[c] = classWeights(block, K, c);
+	}
+	softmax = (probability == PROBABILITY_SOFTMAX);
+	sparsifyWeights();
+}
+
+template <class Feature>
+ProbabilityModel LogisticRegression<Feature>::probabilityModel(){
+	return softmax ? PROBABILITY_SOFTMAX : PROBABILITY_SIGMOID;
+}
+
 // prob is a vector. The assumption is that prob[0] corresponds to -1 and prob[1] corresponds to +1 in binary
 // classification.
 template <class Feature>
@@ -357,14 +519,19 @@ void LogisticRegression<Feature>::predictProbability(const Feature& testFeature,
 	prob = Vector(nClasses, 0);
 	double val;
 	if (nClasses == 2) {
-		val = featureProductCheck(w, testFeature);
+		val = classScore(0, testFeature);
 		prob[1] = 1/(1+exp(-val));
 		prob[0] = 1 - prob[1];
 	}
+	else if (softmax) {
+		for (int j = 0; j < nClasses; j++)
+			prob[j] = classScore(j, testFeature);
+		softmaxRow(&prob[0], nClasses, 0, &prob[0]);
+	}
 	else{
 		double sum = 0;
 		for (int j = 0; j < nClasses; j++) {
-			val = featureProductCheck(wMany[j], testFeature);
+			val = classScore(j, testFeature);
 			prob[j] = 1/(1 + exp(-val));
 			sum += prob[j];
 		}
@@ -376,6 +543,7 @@ void LogisticRegression<Feature>::predictProbability(const Feature& testFeature,
 
 template class LogisticRegression<SparseFeature>;
 template class LogisticRegression<DenseFeature>;
+template class LogisticRegression<SparseRow>;
 
 
 }
\ No newline at end of file
@@ -6,19 +6,31 @@
  *	    Logistic Regression (Useful if you want to encourage sparsity in the classifier)
         Author: Rishabh Iyer
 
-    algtype: type of algorithm:
-                0 (LBFGS-OWL)
-                1 (LBFGS)
-                2 (Gradient Descent)
-                3 (Stochastic Gradient Descent, Dual Averaging)
-                4 (Adaptive Gradient Descent, Dual Averaging)
-                5 (Gradient Descent with Line Search),
-                6 (Gradient Descent with Barzelie Borwein step size),
-                7 (Nesterov's optimal method),
-                8 (Conjugate Gradient),
-                9 (Stochastic Gradient Descent with fixed step length)
-                10 (Stochastic Gradient Descent with decaying step size)
-                11 (Adaptive Gradient Algorithm (AdaGrad))
+    algtype: type of algorithm (see LogisticRegression.cc):
+
+                With L1 & L2 Regularizer
+
+                0 (LBFGS)
+                1 (Gradient Descent with Line Search),
+                2 (Gradient Descent with Barzelie Borwein step size),
+                3 (Nesterov's optimal method),
+                4 (Conjugate Gradient),
+                5 (Stochastic Gradient Descent with fixed step length)
+                6 (Stochastic Gradient Descent with decaying step size)
+                7 (Adaptive Gradient Algorithm (AdaGrad))
+
+                With L1 regularizer only:
+
+                8 (LBFGS-OWL)
+                9 (Gradient Descent)
+                10 (Stochastic Gradient Descent, Dual Averaging)
+                11 (Adaptive Gradient Descent, Dual Averaging)
+
+                With L2 Regularizer only:
+
+                12 TRON
+                13 (Stochastic Average Gradient (SAG))
+                14 (SAGA)
  *
  */
 
@@ -30,6 +42,7 @@
 #include "../../representation/Matrix.h"
 #include "../../representation/VectorOperations.h"
 #include "../../representation/MatrixOperations.h"
+#include "../../optimization/contFunctions/ContinuousFunctions.h"
 #include <vector>
 using namespace std;
 
@@ -38,13 +51,16 @@ namespace jensen {
 template <class Feature>
 class LogisticRegression : public Classifiers<Feature>{
 protected:
-vector<Feature>& trainFeatures;                 // training features
+typename FeatureSet<Feature>::type& trainFeatures;                 // training features
 Vector& y;             // size of y is number of training examples (n)
 int algtype;                 // the algorithm type used for training, default LBFGS-OWL.
 int reg_type;            // Regularization technique to be used, default L1
 vector<Vector> wMany;                 // the weights in the multiclass scenario -- nClasses number of weight vectors.
 Vector w;                 // the weights in the binary scenario.
+SparseVector wSparse;                 // the non-zeros of w (l_1 models are served from the sparse weights)
+vector<SparseVector> wManySparse;                 // the non-zeros of wMany
 int nClasses;                 // the number of classes
+bool softmax;                 // wMany is a multinomial (softmax) model, else nClasses one-vs-rest models
 double lambda;                 // regularization
 int maxIter;                 // maximum number of iterations for the algorithms
 double eps;                 // stopping criterion for the algorithms
@@ -52,14 +68,32 @@ int miniBatch;                 // This is the miniBatch size for Stochastic Grad
 int lbfgsMemory;                 // memory specification of the lbfgs algorithm.
 using Classifiers<Feature>::m;
 using Classifiers<Feature>::n;
+using Classifiers<Feature>::nThreads;
+using Classifiers<Feature>::warmStart;
+using Classifiers<Feature>::scaledSteps;
+using Classifiers<Feature>::initialPoint;
+using Classifiers<Feature>::multiClassMode;
+using Classifiers<Feature>::classThreads;
+int classWeightBlock(Vector& block);
+void setClassWeightBlock(const Vector& block, const int K, const ProbabilityModel probability);
+ProbabilityModel probabilityModel();                 // the softmax for softmax models
 public:
-LogisticRegression(vector<Feature>& trainFeatures, Vector& y, int m, int n, int nClasses = 2, double lambda = 1,
+LogisticRegression(typename FeatureSet<Feature>::type& trainFeatures, Vector& y, int m, int n, int nClasses = 2, double lambda = 1,
                      int algtype = 0, int reg_type=1, int maxIter = 250, double eps = 1e-2, int miniBatch = 100, int lbfgsMemory = 100);
 LogisticRegression(const LogisticRegression& c);         // copy constructor
 ~LogisticRegression();
 
+void sparsifyWeights();                 // keeps the non-zeros of the weights of l_1 models
+double classScore(const int j, const Feature& testFeature);                 // w^T f (binary) or wMany[j]^T f
 void trainOne(Vector& yOne, Vector& wcurr);                 // a member function for binary classification.
+void minimizeL1(const ContinuousFunctions& ll, const ContinuousFunctions& l, const Vector& x0, Vector& wcurr);                 // the l1 solver selected by algtype
+void minimizeL2(const ContinuousFunctions& ll, const Vector& x0, Vector& wcurr);                 // the l2 solver selected by algtype
+bool fusedSupported();                 // true if the multi-class problem can be trained as one L2OneVsRestLoss
+void trainFused();                 // MULTICLASS_FUSED training
+bool softmaxSupported();
+void trainSoftmax();                 // MULTICLASS_SOFTMAX training (L1SoftmaxLoss or L2SoftmaxLoss)
 void train();                 // train
+void setRegularization(double lambda);
 
 int saveModel(char* model);                 // save the model
 int loadModel(char* model);                 // save the model
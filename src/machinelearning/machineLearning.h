@@ -5,9 +5,12 @@
 #define Jensen_CLASSIFIERS
 
 #include "Classifiers.h"
+#include "ModelFile.h"
 #include "logisticRegression/LogisticRegression.h"
 #include "SVM/L1SmoothSVM.h"
 #include "SVM/L2SmoothSVM.h"
 #include "SVM/L2HingeSVM.h"
+#include "RegularizationPath.h"
+#include "CrossValidation.h"
 
 #endif
@@ -0,0 +1,94 @@
+// Copyright (C) Rishabh Iyer, John T. Halloran, and Kai Wei
+// Licensed under the Open Software License version 3.0
+// See COPYING or http://opensource.org/licenses/OSL-3.0
+/*
+        Jensen: A Convex Optimization And Machine Learning ToolKit
+ *	Backtracking (Armijo) line search along x - alpha*d with quadratic interpolation of the step
+        Author: Rishabh Iyer
+ *
+ */
+
+#include "BacktrackingLineSearch.h"
+#include "../../representation/VectorOperations.h"
+#include "../../utils/utils.h"
+namespace jensen {
+
+BacktrackingLineSearch::BacktrackingLineSearch(const ContinuousFunctions& c, const double gamma) : c(c), gamma(gamma), backtracks(0){
+}
+
+bool orthantProject(const Vector& x, const double alpha, const Vector& d, const Vector& xi, Vector& xp)
+{
+	bool projected = false;
+	xp.resize(x.size());
+	for (int i = 0; i < x.size(); i++) {
+		double xa = x[i] - alpha*d[i];
+		if (sign(xa) != xi[i]) {
+			xp[i] = 0;
+			projected = projected || (xa != 0);
+		}
+		else
+			xp[i] = xa;
+	}
+	return projected;
+}
+
+// Evaluates the trial step alpha, along the direction if possible. Returns true if it computed xnew and the gradient.
+bool BacktrackingLineSearch::trial(const Vector& x, const Vector& d, const Vector* xi, const double alpha, const bool directional,
+                                   Vector& xnew, double& fnew, Vector& gnew) const {
+	if (xi != NULL) {
+		if (orthantProject(x, alpha, d, *xi, xnew) || !directional) {
+			c.eval(xnew, fnew, gnew);
+			return true;
+		}
+	}
+	else if (!directional) {
+		// xnew = x - alpha*d;
+		multiplyAccumulate(xnew, x, alpha, d);
+		c.eval(xnew, fnew, gnew);
+		return true;
+	}
+	fnew = c.evalAlongDirection(alpha);
+	return false;
+}
+
+int BacktrackingLineSearch::search(const Vector& x, const double f, const Vector& d, const double gd, double& alpha, Vector& xnew,
+                                   double& fnew, Vector& gnew){
+	bool directional = (backtracks >= 2) && c.prepareDirection(x, d);
+	bool haveGradient = trial(x, d, NULL, alpha, directional, xnew, fnew, gnew);
+	int evals = 1;
+	backtracks = 0;
+	while (fnew > f - gamma*alpha*gd) {
+		alpha = alpha*alpha*gd/(2*(fnew + gd*alpha - f));
+		backtracks++;
+		if (!directional && (backtracks >= 2))
+			directional = c.prepareDirection(x, d);
+		haveGradient = trial(x, d, NULL, alpha, directional, xnew, fnew, gnew);
+		evals++;
+	}
+	if (!haveGradient) {         // the gradient at the accepted step
+		multiplyAccumulate(xnew, x, alpha, d);
+		c.eval(xnew, fnew, gnew);
+	}
+	return evals;
+}
+
+int BacktrackingLineSearch::searchOrthant(const Vector& x, const double f, const Vector& g, const Vector& d, const double gd,
+                                          const Vector& xi, double& alpha, Vector& xnew, double& fnew, Vector& gnew){
+	bool directional = (backtracks >= 2) && c.prepareDirection(x, d);
+	bool haveGradient = trial(x, d, &xi, alpha, directional, xnew, fnew, gnew);
+	int evals = 1;
+	backtracks = 0;
+	while (fnew > f - gamma*g*(xnew - x)) {
+		alpha = alpha*alpha*gd/(2*(fnew + gd*alpha - f));
+		backtracks++;
+		if (!directional && (backtracks >= 2))
+			directional = c.prepareDirection(x, d);
+		haveGradient = trial(x, d, &xi, alpha, directional, xnew, fnew, gnew);
+		evals++;
+	}
+	if (!haveGradient)         // the gradient at the accepted step (xnew is the unprojected x - alpha*d)
+		c.eval(xnew, fnew, gnew);
+	return evals;
+}
+
+}
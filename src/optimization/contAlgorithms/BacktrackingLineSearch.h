@@ -0,0 +1,51 @@
+// Copyright (C) Rishabh Iyer, John T. Halloran, and Kai Wei
+// Licensed under the Open Software License version 3.0
+// See COPYING or http://opensource.org/licenses/OSL-3.0
+/*
+        Jensen: A Convex Optimization And Machine Learning ToolKit
+ *	Backtracking (Armijo) line search along x - alpha*d with quadratic interpolation of the step, shared
+        by the batch gradient methods (gdLineSearch, cg, lbfgsMin and lbfgsMinOwl).
+
+        The first two trials are full evals, which give the gradient too if the step is accepted. From the
+        second backtracking step on (from the first trial, if the previous search backtracked twice or more),
+        trials are evaluated along the direction in O(n) if the function supports it (prepareDirection), so
+        a search costs two passes over the data (the margins of d and the gradient at the accepted step)
+        however often it backtracks. With an orthant (lbfgsMinOwl) only the trials that stay in the orthant
+        lie on x - alpha*d; projected trials need a full eval.
+        Author: Rishabh Iyer
+ *
+ */
+
+#ifndef BACKTRACKING_LINE_SEARCH_H
+#define BACKTRACKING_LINE_SEARCH_H
+
+#include "../contFunctions/ContinuousFunctions.h"
+#include "../../representation/Vector.h"
+
+namespace jensen {
+
+class BacktrackingLineSearch {
+protected:
+const ContinuousFunctions& c;
+double gamma;                 // sufficient decrease parameter
+int backtracks;                 // backtracking steps of the previous search
+bool trial(const Vector& x, const Vector& d, const Vector* xi, const double alpha, const bool directional, Vector& xnew,
+           double& fnew, Vector& gnew) const;
+public:
+BacktrackingLineSearch(const ContinuousFunctions& c, const double gamma);
+
+// Backtracks from the step alpha until f(x - alpha*d) <= f - gamma*alpha*gd, gd = g^T d > 0 the directional derivative.
+// On return alpha is the accepted step, and xnew, fnew and gnew the point, its value and its gradient. Returns the number
+// of function evaluations.
+int search(const Vector& x, const double f, const Vector& d, const double gd, double& alpha, Vector& xnew, double& fnew,
+           Vector& gnew);
+// As search, with the trial points projected onto the orthant xi and the decrease measured with g on the projected step.
+int searchOrthant(const Vector& x, const double f, const Vector& g, const Vector& d, const double gd, const Vector& xi,
+                  double& alpha, Vector& xnew, double& fnew, Vector& gnew);
+};
+
+// xp = x - alpha*d projected onto the orthant xi. Returns true if a non-zero coordinate had to be set to zero.
+bool orthantProject(const Vector& x, const double alpha, const Vector& d, const Vector& xi, Vector& xp);
+
+}
+#endif
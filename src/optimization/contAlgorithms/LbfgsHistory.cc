@@ -0,0 +1,76 @@
+// Copyright (C) Rishabh Iyer, John T. Halloran, and Kai Wei
+// Licensed under the Open Software License version 3.0
+// See COPYING or http://opensource.org/licenses/OSL-3.0
+/*
+        Jensen: A Convex Optimization And Machine Learning ToolKit
+ *	The correction pairs of L-BFGS in a circular buffer.
+        Author: Rishabh Iyer
+ *
+ */
+
+#include "LbfgsHistory.h"
+#include "../../representation/SimdKernels.h"
+
+using namespace std;
+
+namespace jensen {
+
+LbfgsHistory::LbfgsHistory(int memory, int dim) : memory(memory), dim(dim), count(0), oldest(0),
+	rho(memory, 0), alpha(memory, 0), scale(1) {
+}
+
+bool LbfgsHistory::update(const Vector& xnew, const Vector& x, const Vector& gnew, const Vector& g){
+	double sy = 0, yy = 0;
+	for (int j = 0; j < dim; j++) {
+		double sj = xnew[j] - x[j];
+		double yj = gnew[j] - g[j];
+		sy += sj*yj;
+		yy += yj*yj;
+	}
+	if (!(sy > 0))
+		return false;
+	int slot = (oldest + count) % memory;
+	if (count < memory) {
+		S.resize((long int) (count + 1)*dim);
+		Y.resize((long int) (count + 1)*dim);
+		count++;
+	}
+	else
+		oldest = (oldest + 1) % memory;
+	double* s = &S[(long int) slot*dim];
+	double* y = &Y[(long int) slot*dim];
+	for (int j = 0; j < dim; j++) {
+		s[j] = xnew[j] - x[j];
+		y[j] = gnew[j] - g[j];
+	}
+	rho[slot] = 1/sy;
+	scale = sy/yy;
+	return true;
+}
+
+void LbfgsHistory::direction(const Vector& g, Vector& d) const {
+	d.resize(dim);
+	copy(g.begin(), g.end(), d.begin());
+	double* q = d.data();
+	for (int k = count - 1; k >= 0; k--) {         // newest to oldest
+		int slot = (oldest + k) % memory;
+		alpha[slot] = rho[slot]*dotKernel(&S[(long int) slot*dim], q, dim);
+		axpyKernel(-alpha[slot], &Y[(long int) slot*dim], q, q, dim);
+	}
+	scaleKernel(scale, q, q, dim);
+	for (int k = 0; k < count; k++) {         // oldest to newest
+		int slot = (oldest + k) % memory;
+		double beta = rho[slot]*dotKernel(&Y[(long int) slot*dim], q, dim);
+		axpyKernel(alpha[slot] - beta, &S[(long int) slot*dim], q, q, dim);
+	}
+}
+
+int LbfgsHistory::size() const {
+	return count;
+}
+
+double LbfgsHistory::initialScaling() const {
+	return scale;
+}
+
+}
@@ -0,0 +1,45 @@
+// Copyright (C) Rishabh Iyer, John T. Halloran, and Kai Wei
+// Licensed under the Open Software License version 3.0
+// See COPYING or http://opensource.org/licenses/OSL-3.0
+/*
+        Jensen: A Convex Optimization And Machine Learning ToolKit
+ *	The correction pairs (s, y) of L-BFGS, kept in a circular buffer of fixed capacity. Both s and
+        y live in one contiguous array each (pair k at offset k*dim), the storage grows up to
+        memory*dim during the first iterations and is then overwritten in place, and the two-loop
+        recursion runs in place on the output vector. Nothing is allocated per iteration.
+        Author: Rishabh Iyer
+ *
+ */
+
+#ifndef LBFGS_HISTORY_H
+#define LBFGS_HISTORY_H
+
+#include "../../representation/Vector.h"
+
+namespace jensen {
+
+class LbfgsHistory {
+protected:
+int memory;                 // capacity (number of pairs)
+int dim;                 // dimension of the vectors
+int count;                 // number of pairs stored
+int oldest;                 // slot of the oldest pair
+std::vector<double> S;                 // s_k = x_{k+1} - x_k, pair in slot k at S[k*dim]
+std::vector<double> Y;                 // y_k = g_{k+1} - g_k
+Vector rho;                 // 1/(y_k^T s_k)
+mutable Vector alpha;                 // workspace of the two-loop recursion
+double scale;                 // s^T y / y^T y of the newest pair, the initial Hessian approximation
+public:
+LbfgsHistory(int memory, int dim);
+
+// Stores the pair (xnew - x, gnew - g), replacing the oldest one if the buffer is full. Pairs with
+// s^T y <= 0 (no positive curvature along s) are skipped and false is returned.
+bool update(const Vector& xnew, const Vector& x, const Vector& gnew, const Vector& g);
+// d = H g, with H the L-BFGS approximation of the inverse Hessian (the two-loop recursion).
+void direction(const Vector& g, Vector& d) const;
+int size() const;
+double initialScaling() const;
+};
+
+}
+#endif
@@ -26,6 +26,7 @@
 using namespace std;
 
 #include "cg.h"
+#include "BacktrackingLineSearch.h"
 #include "../../utils/utils.h"
 namespace jensen {
 
@@ -44,21 +45,16 @@ Vector cg(const ContinuousFunctions& c, const Vector& x0, double alpha, const do
 	int funcEval = 1;
 	if (!useinputAlpha)
 		alpha = 1/norm(g);
+	BacktrackingLineSearch lineSearch(c, gamma);
 	while ((gnorm >= TOL) && (funcEval < maxEval) )
 	{
-		xnew = x - alpha*d;
-		c.eval(xnew, fnew, gnew);
-		funcEval++;
 		double gg = g*g;
 		double gd = g*d;
-		// double fgoal = f - gamma*alpha*gd;
-		// Backtracking line search
-		while (fnew > f - gamma*alpha*gd) {
-			alpha = alpha*alpha*gd/(2*(fnew + gd*alpha - f));
-			xnew = x - alpha*d;
-			c.eval(xnew, fnew, gnew);
-			funcEval++;
+		if (gd <= 0) {         // not a descent direction any more, restart with the gradient
+			d = g;
+			gd = gg;
 		}
+		funcEval += lineSearch.search(x, f, d, gd, alpha, xnew, fnew, gnew);
 		double ggnew = gnew*gnew;
 		if (resetAlpha)
 			alpha = min(1, 2*(f - fnew)/ggnew);
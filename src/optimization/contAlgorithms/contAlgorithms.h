@@ -17,14 +17,18 @@
 #include "lbfgsMin.h"
 #include "lbfgsMinOwl.h"
 #include "tron.h"
+#include "newton.h"
 // Stochastic gradient descent
 #include "sgd.h"
 #include "sgdAdagrad.h"
+#include "sgdHogwild.h"
+#include "sgdScaledSteps.h"
 #include "sgdDecayingLearningRate.h"
 #include "sgdLineSearch.h"
 #include "sgdRegularizedDualAveragingAdagrad.h"
 #include "sgdRegularizedDualAveraging.h"
 #include "sgdStochasticAverageGradient.h"
+#include "sgdSAGA.h"
 #include "specialized/L1LRPrimal.h"
 #include "specialized/SVCDual.h"
 #include "specialized/SVRDual.h"
@@ -26,6 +26,7 @@
 using namespace std;
 
 #include "gdLineSearch.h"
+#include "BacktrackingLineSearch.h"
 #include "../../utils/utils.h"
 namespace jensen {
 
@@ -42,21 +43,11 @@ Vector gdLineSearch(const ContinuousFunctions& c, const Vector& x0, double alpha
 	int funcEval = 1;
 	if (!useinputAlpha)
 		alpha = 1/norm(g);
+	BacktrackingLineSearch lineSearch(c, gamma);
 	while ((gnorm >= TOL) && (funcEval < maxEval) )
 	{
-		multiplyAccumulate(xnew, x, alpha, g);
-		c.eval(xnew, fnew, gnew);
-		funcEval++;
-
 		double gg = g*g;
-		// double fgoal = f - gamma*alpha*gg;
-		// Backtracking line search
-		while (fnew > f - gamma*alpha*gg) {
-			alpha = alpha*alpha*gg/(2*(fnew + gg*alpha - f));
-			multiplyAccumulate(xnew, x, alpha, g);
-			c.eval(xnew, fnew, gnew);
-			funcEval++;
-		}
+		funcEval += lineSearch.search(x, f, g, gg, alpha, xnew, fnew, gnew);
 		if (resetAlpha)
 			alpha = min(1, 2*(f - fnew)/gg);
 
@@ -0,0 +1,136 @@
+// Copyright (C) Rishabh Iyer, John T. Halloran, and Kai Wei
+// Licensed under the Open Software License version 3.0
+// See COPYING or http://opensource.org/licenses/OSL-3.0
+/*
+
+
+ *	Newton's method with an explicit hessian and backtracking line search, for problems of small dimension
+        Solves the problem \min_x \phi(x), where \phi is a convex, twice differentiable function.
+        Author: Rishabh Iyer
+ *
+        Input:  Continuous Function: c
+                        Initial starting point x0
+                        back-tracking parameter (gamma)
+                        max number of function evaluations (maxEvals)
+                        Tolerance (TOL), relative to the gradient norm at x0
+                        verbosity
+
+        Output: Output on convergence (x)
+ */
+
+#include <stdio.h>
+#include <math.h>
+#include <algorithm>
+#include <iostream>
+using namespace std;
+
+#include "newton.h"
+#include "tron.h"
+#include "../../representation/DenseLinearAlgebra.h"
+#include "../../utils/utils.h"
+
+#define NEWTON_DAMPING_ROUNDS 30                 // the damping reaches 1e20 times the largest diagonal entry
+
+namespace jensen {
+
+// f, g and the hessian at x, as an m x m row-major array.
+static void evalNewtonSystem(const ContinuousFunctions& c, const Vector& x, double& f, Vector& g, Vector& H){
+	if (c.evalDenseHessian(x, f, g, H))
+		return;
+	c.eval(x, f, g);
+	Matrix hessian = c.evalHessian(x);
+	int m = x.size();
+	H.resize((long int) m*m);
+	for (int i = 0; i < m; i++)
+		for (int j = 0; j < m; j++)
+			H[(long int) i*m + j] = hessian(i, j);
+}
+
+// d = H^{-1} g. If H is not (numerically) positive definite, a multiple of the identity is added to it, increased
+// tenfold (at most NEWTON_DAMPING_ROUNDS times) until the factorization succeeds. Returns false if H or g is not finite
+// or no damping made H positive definite.
+static bool newtonDirection(const Vector& H, const Vector& g, Vector& d){
+	int m = g.size();
+	for (long int k = 0; k < H.size(); k++) {
+		if (!isfinite(H[k]))
+			return false;
+	}
+	for (int j = 0; j < m; j++) {
+		if (!isfinite(g[j]))
+			return false;
+	}
+	double maxDiagonal = 0;
+	for (int j = 0; j < m; j++)
+		maxDiagonal = max(maxDiagonal, fabs(H[(long int) j*m + j]));
+	double damping = 0;
+	Vector L;
+	for (int round = 0; round <= NEWTON_DAMPING_ROUNDS; round++) {
+		L = H;
+		for (int j = 0; j < m; j++)
+			L[(long int) j*m + j] += damping;
+		if (choleskyFactor(L.data(), m) == 0) {
+			d = g;
+			choleskySolve(L.data(), m, d.data());
+			return true;
+		}
+		damping = (damping == 0) ? 1e-10*max(maxDiagonal, 1.0) : 10*damping;
+	}
+	return false;
+}
+
+Vector newton(const ContinuousFunctions& c, const Vector& x0, const double gamma, const int maxEval,
+              const double TOL, int verbosity){
+	if (x0.size() > NEWTON_MAX_DIMENSION) {
+		if (verbosity > 0)
+			printf("newton: %d variables exceed NEWTON_MAX_DIMENSION (%d), using tron\n", (int) x0.size(), NEWTON_MAX_DIMENSION);
+		return tron(c, x0, maxEval, TOL, verbosity);
+	}
+	Vector x(x0);
+	Vector g;
+	Vector H;
+	double f;
+	evalNewtonSystem(c, x, f, g, H);
+	int funcEval = 1;
+	double gnorm0 = norm(g);
+	double gnorm = gnorm0;
+	Vector d;
+	Vector xnew;
+	while ((gnorm > TOL*gnorm0) && (funcEval < maxEval))
+	{
+		if (!newtonDirection(H, g, d))
+			break;
+		double gd = g*d;
+		if (gd <= 0)
+			break;
+		// The trials x - alpha*d only need f: along the direction in O(n) if the function supports it. The full
+		// step is almost always accepted near the optimum.
+		bool directional = c.prepareDirection(x, d);
+		double alpha = 1;
+		double fnew;
+		while (true) {
+			if (directional)
+				fnew = c.evalAlongDirection(alpha);
+			else {
+				// xnew = x - alpha*d;
+				multiplyAccumulate(xnew, x, alpha, d);
+				fnew = c.eval(xnew);
+			}
+			funcEval++;
+			if ((fnew <= f - gamma*alpha*gd) || (funcEval >= maxEval))
+				break;
+			alpha = max(0.1*alpha, alpha*alpha*gd/(2*(fnew + gd*alpha - f)));
+		}
+		if (fnew > f - gamma*alpha*gd)
+			break;
+		multiplyAccumulate(xnew, x, alpha, d);
+		x.swap(xnew);
+		evalNewtonSystem(c, x, f, g, H);
+		funcEval++;
+		gnorm = norm(g);
+		if (verbosity > 0)
+			printf("numIter: %d, alpha: %e, ObjVal: %e, OptCond: %e\n", funcEval, alpha, f, gnorm);
+	}
+	return x;
+}
+
+}
@@ -0,0 +1,44 @@
+// Copyright (C) Rishabh Iyer, John T. Halloran, and Kai Wei
+// Licensed under the Open Software License version 3.0
+// See COPYING or http://opensource.org/licenses/OSL-3.0
+/*
+
+
+ *	Newton's method with an explicit hessian and backtracking line search, for problems of small dimension
+        Solves the problem \min_x \phi(x), where \phi is a convex, twice differentiable function.
+        Every iteration forms the m x m hessian (evalDenseHessian, or evalHessian if the function does not
+        provide it), factors it with a Cholesky factorization and steps along the Newton direction, so it
+        converges in a handful of passes over the data when m is in the hundreds. Above
+        NEWTON_MAX_DIMENSION variables the hessian and its factor (2 m^2 doubles, 256MB at the limit) are
+        not formed and tron is run instead. The iterations stop early if the hessian or the gradient is not
+        finite, or the hessian cannot be made positive definite by damping.
+        Author: Rishabh Iyer
+ *
+        Input:  Continuous Function: c
+                        Initial starting point x0
+                        back-tracking parameter (gamma)
+                        max number of function evaluations (maxEvals)
+                        Tolerance (TOL), relative to the gradient norm at x0
+                        verbosity
+
+        Output: Output on convergence (x)
+ */
+
+#ifndef CA_NEWTON
+#define CA_NEWTON
+
+#include "../contFunctions/ContinuousFunctions.h"
+#include "../../representation/Vector.h"
+#include "../../representation/VectorOperations.h"
+#include "../../representation/Matrix.h"
+#include "../../representation/MatrixOperations.h"
+
+#define NEWTON_MAX_DIMENSION 4096                 // largest m for which the m x m hessian is formed
+
+namespace jensen {
+
+Vector newton(const ContinuousFunctions& c, const Vector& x0, const double gamma = 1e-4, const int maxEval = 100,
+              const double TOL = 1e-3, int verbosity = 1);
+
+}
+#endif
@@ -16,6 +16,7 @@
    max number of epochs (maxEval)
    Tolerance (TOL)
    Verbosity
+   Number of threads (nThreads)
 
    Output: Output on convergence (x)
  */
@@ -29,13 +30,20 @@
 using namespace std;
 
 #include "sgd.h"
+#include "sgdHogwild.h"
+#include "sgdScaledSteps.h"
 
 namespace jensen {
 
 Vector sgd(const ContinuousFunctions& c, const Vector& x0, const int numSamples,
            const double alpha, const int miniBatchSize,
-           const double TOL, const int maxEval, const int verbosity){
-	cout<<"Started Stochastic Gradient Descent\n";
+           const double TOL, const int maxEval, const int verbosity, const int nThreads, const bool scaledSteps){
+	if (useHogwild(c, nThreads))
+		return sgdHogwild(c, x0, numSamples, alpha, miniBatchSize, TOL, maxEval, HOGWILD_FIXED, nThreads, verbosity);
+	if (scaledSteps && c.prepareScaledSteps())         // l_2 regularized: O(nnz) steps on scaled weights
+		return sgdScaledSteps(c, x0, numSamples, alpha, miniBatchSize, TOL, maxEval, false, verbosity);
+	if (verbosity > 0)
+		cout<<"Started Stochastic Gradient Descent\n";
 	Vector x(x0);
 	double f = 1e30;
 	double f0 = 1e30;
@@ -59,7 +67,7 @@ Vector sgd(const ContinuousFunctions& c, const Vector& x0, const int numSamples,
 	std::vector <std::vector<int> > allIndices = std::vector <std::vector<int> >(l-1);
 	for (int i = 0; i < l-1; i++) {
 		startInd = i * miniBatchSize;
-		endInd = min((i+1) * miniBatchSize - 1, numSamples-1);
+		endInd = min((i+1) * miniBatchSize, numSamples);
 		std::vector<int> currIndices(indices.begin() + startInd, indices.begin() + endInd);
 		allIndices[i] = currIndices;
 	}
@@ -85,7 +93,7 @@ Vector sgd(const ContinuousFunctions& c, const Vector& x0, const int numSamples,
 			c.eval(x, f, g);
 			gnorm = norm(g);
 			printf("Epoch: %d, alpha: %e, ObjVal: %e, OptCond: %e\n", epoch, alpha, f, gnorm);
-		} else{
+		} else if (verbosity > 0) {
 			printf("Epoch: %d, alpha: %e, Avg. ObjVal Reduction: %e, Avg. Grad. Reduction: %e\n", epoch, alpha, f0, gnorm);
 		}
 		epoch++;
@@ -95,7 +103,7 @@ Vector sgd(const ContinuousFunctions& c, const Vector& x0, const int numSamples,
 		c.eval(x, f, g);
 		gnorm = norm(g);
 		printf("Epoch: %d, alpha: %e, ObjVal: %e, OptCond: %e\n", epoch, alpha, f, gnorm);
-	} else {
+	} else if (verbosity > 0) {
 		printf("Epoch: %d, alpha: %e, Avg. ObjVal Reduction: %e, Avg. Grad. Reduction: %e\n", epoch, alpha, f0, gnorm);
 	}
 
@@ -16,6 +16,10 @@
                         max number of epochs (maxEval)
                         Tolerance (TOL)
                         Verbosity
+                        Number of threads (nThreads): with an explicit number of more than one, functions supporting
+                        sparse steps are solved with the lock-free parallel sgdHogwild (0 or 1: serial)
+                        Scaled steps (scaledSteps): for losses supporting them (l_2 regularized), O(nnz) steps on
+                        scaled weights with sgdScaledSteps, which has its own step size schedule and stopping rule
 
         Output: Output on convergence (x)
  */
@@ -32,7 +36,8 @@ namespace jensen {
 
 Vector sgd(const ContinuousFunctions& c, const Vector& x0, const int numSamples,
            const double alpha = 0.1, const int miniBatchSize = 1,
-           const double TOL = 1e-3, const int maxEval = 1000, const int verbosity = 1);
+           const double TOL = 1e-3, const int maxEval = 1000, const int verbosity = 1, const int nThreads = 1,
+           const bool scaledSteps = false);
 
 }
 #endif
@@ -16,6 +16,7 @@
    max number of epochs (maxEval)
    Tolerance (TOL)
    Verbosity
+   Number of threads (nThreads)
 
    Output: Output on convergence (x)
  */
@@ -29,13 +30,17 @@
 using namespace std;
 
 #include "sgdAdagrad.h"
+#include "sgdHogwild.h"
 
 namespace jensen {
 
 Vector sgdAdagrad(const ContinuousFunctions& c, const Vector& x0, const int numSamples,
                   const double alpha, const int miniBatchSize,
-                  const double TOL, const int maxEval, const int verbosity){
-	cout<<"Started Stochastic Gradient Descent with AdaGrad\n";
+                  const double TOL, const int maxEval, const int verbosity, const int nThreads){
+	if (useHogwild(c, nThreads))
+		return sgdHogwild(c, x0, numSamples, alpha, miniBatchSize, TOL, maxEval, HOGWILD_ADAGRAD, nThreads, verbosity);
+	if (verbosity > 0)
+		cout<<"Started Stochastic Gradient Descent with AdaGrad\n";
 	Vector x(x0);
 	double f = 1e30;
 	double f0 = 1e30;
@@ -59,7 +64,7 @@ Vector sgdAdagrad(const ContinuousFunctions& c, const Vector& x0, const int numS
 	std::vector <std::vector<int> > allIndices = std::vector <std::vector<int> >(l-1);
 	for (int i = 0; i < l-1; i++) {
 		startInd = i * miniBatchSize;
-		endInd = min((i+1) * miniBatchSize - 1, numSamples-1);
+		endInd = min((i+1) * miniBatchSize, numSamples);
 		std::vector<int> currIndices(indices.begin() + startInd, indices.begin() + endInd);
 		allIndices[i] = currIndices;
 	}
@@ -89,7 +94,7 @@ Vector sgdAdagrad(const ContinuousFunctions& c, const Vector& x0, const int numS
 			c.eval(x, f, g);
 			gnorm = norm(g);
 			printf("Epoch: %d, alpha: %e, ObjVal: %e, OptCond: %e\n", epoch, alpha, f, gnorm);
-		}else{
+		}else if (verbosity > 0) {
 			printf("Epoch: %d, alpha: %e, Avg. ObjVal Reduction: %e, Avg. Grad. Reduction: %e\n", epoch, alpha, f0, gnorm);
 		}
 		epoch++;
@@ -99,7 +104,7 @@ Vector sgdAdagrad(const ContinuousFunctions& c, const Vector& x0, const int numS
 		c.eval(x, f, g);
 		gnorm = norm(g);
 		printf("Epoch: %d, alpha: %e, ObjVal: %e, OptCond: %e\n", epoch, alpha, f, gnorm);
-	} else {
+	} else if (verbosity > 0) {
 		printf("Epoch: %d, alpha: %e, Avg. ObjVal Reduction: %e, Avg. Grad. Reduction: %e\n", epoch, alpha, f0, gnorm);
 	}
 
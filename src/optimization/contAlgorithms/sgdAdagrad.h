@@ -16,6 +16,8 @@
                         max number of epochs (maxEval)
                         Tolerance (TOL)
                         Verbosity
+                        Number of threads (nThreads): with an explicit number of more than one, functions supporting
+                        sparse steps are solved with the lock-free parallel sgdHogwild (0 or 1: serial)
 
         Output: Output on convergence (x)
  */
@@ -31,7 +33,7 @@ namespace jensen {
 
 Vector sgdAdagrad(const ContinuousFunctions& c, const Vector& x0, const int numSamples,
                   const double alpha = 0.1, const int miniBatchSize = 1,
-                  const double TOL = 1e-3, const int maxEval = 1000, const int verbosity = 1);
+                  const double TOL = 1e-3, const int maxEval = 1000, const int verbosity = 1, const int nThreads = 1);
 
 }
 #endif
@@ -18,6 +18,7 @@
    max number of epochs (maxEval)
    power dictating learning rate's decay decayRate
    Verbosity
+   Number of threads (nThreads)
 
    Output: Output on convergence (x)
  */
@@ -31,14 +32,21 @@
 using namespace std;
 
 #include "sgdDecayingLearningRate.h"
+#include "sgdHogwild.h"
+#include "sgdScaledSteps.h"
 
 namespace jensen {
 
 Vector sgdDecayingLearningRate(const ContinuousFunctions& c, const Vector& x0, const int numSamples,
                                const double alpha, const int miniBatchSize,
                                const double TOL, const int maxEval,
-                               const double decayRate, const int verbosity){
-	cout<<"Started Stochastic Gradient Descent with Decaying Learning Rate\n";
+                               const double decayRate, const int verbosity, const int nThreads, const bool scaledSteps){
+	if (useHogwild(c, nThreads))
+		return sgdHogwild(c, x0, numSamples, alpha, miniBatchSize, TOL, maxEval, HOGWILD_DECAYING, nThreads, verbosity);
+	if (scaledSteps && c.prepareScaledSteps())         // l_2 regularized: O(nnz) steps on scaled weights
+		return sgdScaledSteps(c, x0, numSamples, alpha, miniBatchSize, TOL, maxEval, true, verbosity);
+	if (verbosity > 0)
+		cout<<"Started Stochastic Gradient Descent with Decaying Learning Rate\n";
 	Vector x(x0);
 	double f = 1e30;
 	double f0 = 1e30;
@@ -64,7 +72,7 @@ Vector sgdDecayingLearningRate(const ContinuousFunctions& c, const Vector& x0, c
 	std::vector <std::vector<int> > allIndices = std::vector <std::vector<int> >(l-1);
 	for (int i = 0; i < l-1; i++) {
 		startInd = i * miniBatchSize;
-		endInd = min((i+1) * miniBatchSize - 1, numSamples-1);
+		endInd = min((i+1) * miniBatchSize, numSamples);
 		std::vector<int> currIndices(indices.begin() + startInd, indices.begin() + endInd);
 		allIndices[i] = currIndices;
 	}
@@ -91,7 +99,7 @@ Vector sgdDecayingLearningRate(const ContinuousFunctions& c, const Vector& x0, c
 			c.eval(x, f, g);
 			gnorm = norm(g);
 			printf("Epoch: %d, alpha: %e, ObjVal: %e, OptCond: %e\n", epoch, alpha, f, gnorm);
-		}else{
+		}else if (verbosity > 0) {
 			printf("Epoch: %d, alpha: %e, Avg. ObjVal Reduction: %e, Avg. Grad. Reduction: %e\n", epoch, alpha, f0, gnorm);
 		}
 		epoch++;
@@ -101,7 +109,7 @@ Vector sgdDecayingLearningRate(const ContinuousFunctions& c, const Vector& x0, c
 		c.eval(x, f, g);
 		gnorm = norm(g);
 		printf("Epoch: %d, alpha: %e, ObjVal: %e, OptCond: %e\n", epoch, alpha, f, gnorm);
-	} else {
+	} else if (verbosity > 0) {
 		printf("Epoch: %d, alpha: %e, Avg. ObjVal Reduction: %e, Avg. Grad. Reduction: %e\n", epoch, alpha, f0, gnorm);
 	}
 	return x;
@@ -0,0 +1,102 @@
+// Copyright (C) Rishabh Iyer, John T. Halloran, and Kai Wei
+// Licensed under the Open Software License version 3.0
+// See COPYING or http://opensource.org/licenses/OSL-3.0
+/*
+
+
+ *	Lock-free parallel stochastic gradient descent (Hogwild!, Niu et al, 2011)
+   Solves the problem \min_x \phi(x), where \phi is a loss of a linear model supporting sparse steps.
+   Author: Rishabh Iyer
+ *
+   Input:       Continuous Function: c
+   Initial starting point x0
+   Number of training/data instances/samples numSamples
+   step-size parameter (alpha)
+   Number of samples to compute the gradient within an epoch miniBatchSize
+   max number of epochs (maxEval)
+   Tolerance on the norm of the gradient (TOL)
+   step-size rule (rule)
+   Number of threads (nThreads)
+   Verbosity
+
+   Output: Output on convergence (x)
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <algorithm>
+#include <iostream>
+using namespace std;
+
+#include "sgdHogwild.h"
+#include "../../utils/error.h"
+#include "../../utils/Threads.h"
+
+namespace jensen {
+
+bool useHogwild(const ContinuousFunctions& c, const int nThreads){
+	return (asynchronousThreads(nThreads) > 1) && c.prepareSparseSteps();
+}
+
+Vector sgdHogwild(const ContinuousFunctions& c, const Vector& x0, const int numSamples,
+                  const double alpha, const int miniBatchSize,
+                  const double TOL, const int maxEval,
+                  const HogwildRule rule, const int nThreads, const int verbosity){
+	int T = resolveThreads(nThreads);
+	if (!c.prepareSparseSteps())
+		error("ERROR: sgdHogwild needs a function supporting sparse steps");
+	if (verbosity > 0)
+		printf("Started Lock-free Parallel Stochastic Gradient Descent with %d threads\n", T);
+	Vector x(x0);
+	double f = 1e30;
+	Vector g(x.size(), 0.0);
+	double gnorm = 1e2;
+	int epoch = 1;
+	long int miniBatchEval = 0;         // mini-batches of the completed epochs
+	Vector adagradSum((rule == HOGWILD_ADAGRAD) ? x.size() : 0, 1e-5);
+
+	// The samples are split into T blocks, block k is indices[start_k, start_{k+1}) and is reshuffled with its own seed every
+	// epoch. The blocks are distributed over the team the runtime actually starts, which may have fewer than T threads
+	// (dynamic teams, a thread limit, or a call from within a parallel region): every block is still visited once per epoch.
+	std::vector<int> indices(numSamples);
+	for (int i = 0; i < numSamples; i++)
+		indices[i] = i;
+	std::vector<unsigned int> seeds(T);
+	for (int t = 0; t < T; t++)
+		seeds[t] = 1 + t;
+	while ((gnorm >= TOL) && (epoch < maxEval))
+	{
+		#pragma omp parallel num_threads(T)
+		{
+			int team = teamSize();
+			std::vector<int> miniBatch;
+			long int local = 0;                 // mini-batches of this thread in this epoch
+			#pragma omp for schedule(static)
+			for (int k = 0; k < T; k++) {
+				int start = (long int) numSamples*k/T;
+				int end = (long int) numSamples*(k+1)/T;
+				unsigned int& seed = seeds[k];
+				for (int i = end - 1; i > start; i--)
+					swap(indices[i], indices[start + rand_r(&seed) % (i - start + 1)]);
+				for (int b = start; b < end; b += miniBatchSize) {
+					miniBatch.assign(indices.begin() + b, indices.begin() + min(b + miniBatchSize, end));
+					double stepSize = alpha;
+					if (rule == HOGWILD_DECAYING)         // the global count is estimated from the own one
+						stepSize = alpha / (1 + alpha * (miniBatchEval + team*local + 1));
+					c.sparseStochasticStep(x, miniBatch, SparseStepRule(stepSize, (rule == HOGWILD_ADAGRAD) ? &adagradSum : NULL));
+					local++;
+				}
+			}
+		}
+		miniBatchEval += (numSamples + miniBatchSize - 1)/miniBatchSize;
+		if ((TOL > 0) || (verbosity > 0)) {         // the full pass is only needed for the stopping rule or the log
+			c.eval(x, f, g);
+			gnorm = norm(g);
+		}
+		if (verbosity > 0)
+			printf("Epoch: %d, alpha: %e, ObjVal: %e, OptCond: %e\n", epoch, alpha, f, gnorm);
+		epoch++;
+	}
+	return x;
+}
+}
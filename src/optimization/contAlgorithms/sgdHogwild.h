@@ -0,0 +1,53 @@
+// Copyright (C) Rishabh Iyer, John T. Halloran, and Kai Wei
+// Licensed under the Open Software License version 3.0
+// See COPYING or http://opensource.org/licenses/OSL-3.0
+/*
+
+
+ *	Lock-free parallel stochastic gradient descent (Hogwild!, Niu et al, 2011)
+        Solves the problem \min_x \phi(x), where \phi is a loss of a linear model supporting sparse steps
+        (see ContinuousFunctions::prepareSparseSteps). Every thread owns a block of the samples, which it
+        visits in its own random order (with its own random number generator), and applies its mini-batch
+        steps to the shared x without locks. On sparse data the steps rarely touch the same coordinates.
+        The full objective is evaluated after every epoch.
+        Author: Rishabh Iyer
+ *
+        Input:  Continuous Function: c
+                        Initial starting point x0
+                        Number of training/data instances/samples numSamples
+                        step-size parameter (alpha)
+                        Number of samples to compute the gradient within an epoch miniBatchSize
+                        max number of epochs (maxEval)
+                        Tolerance on the norm of the gradient (TOL)
+                        step-size rule (rule)
+                        Number of threads (nThreads, 0: the OpenMP default)
+                        Verbosity
+
+        Output: Output on convergence (x)
+ */
+
+#ifndef CA_SGD_HOGWILD
+#define CA_SGD_HOGWILD
+
+#include "../contFunctions/ContinuousFunctions.h"
+#include "../../representation/Vector.h"
+#include "../../representation/VectorOperations.h"
+
+namespace jensen {
+
+enum HogwildRule {
+	HOGWILD_FIXED = 0,                 // x = x - alpha*g (as sgd)
+	HOGWILD_DECAYING = 1,                 // x = x - alpha/(1 + alpha*t)*g, t the number of mini-batches so far (as sgdDecayingLearningRate)
+	HOGWILD_ADAGRAD = 2                 // x = x - alpha*g./sqrt(G), G the running sum of g.^2 (as sgdAdagrad)
+};
+
+// True if c supports sparse steps and more than one thread was requested explicitly (not with the default 0).
+bool useHogwild(const ContinuousFunctions& c, const int nThreads);
+
+Vector sgdHogwild(const ContinuousFunctions& c, const Vector& x0, const int numSamples,
+                  const double alpha = 0.1, const int miniBatchSize = 1,
+                  const double TOL = 1e-3, const int maxEval = 1000,
+                  const HogwildRule rule = HOGWILD_FIXED, const int nThreads = 0, const int verbosity = 1);
+
+}
+#endif
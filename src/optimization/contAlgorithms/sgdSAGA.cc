@@ -0,0 +1,71 @@
+// Copyright (C) Rishabh Iyer, John T. Halloran, and Kai Wei
+// Licensed under the Open Software License version 3.0
+// See COPYING or http://opensource.org/licenses/OSL-3.0
+/*
+
+
+ *	Stochastic gradient descent using the SAGA algorithm (Defazio et al, 2014).
+        Solves the problem \min_x L(x), where L is an l_2 regularized loss of a linear model.
+        Author: Rishabh Iyer
+ *
+        Input:  Continuous Function: c
+                        Initial starting point x0
+                        Number of training/data instances/samples numSamples
+                        step-size parameter (alpha), in units of 1/L with L the largest Lipschitz constant
+                        of the per sample gradients (1/3 is the step of the convergence proof)
+                        max number of epochs (maxEval)
+                        Tolerance (TOL)
+                        Verbosity
+
+        Output: Output on convergence (x)
+
+        Note: Unlike SAG, the step direction (new minus stored gradient of the example, plus the average
+        of the stored gradients) is an unbiased estimate of the gradient. The memory and the lazy
+        updates are the ones of SAG (see AverageGradientSteps.h): O(n + m) memory, O(nnz) per epoch.
+ */
+
+#include <stdio.h>
+#include <algorithm>
+#include <iostream>
+#include <cstdlib>
+#include <cmath>
+#include "../../utils/utils.h"
+#include "../../utils/error.h"
+using namespace std;
+
+#include "sgdSAGA.h"
+
+namespace jensen {
+
+Vector sgdSAGA(const ContinuousFunctions& c, const Vector& x0, const int numSamples,
+               const double alpha,
+               const double TOL, const int maxEval,
+               const int verbosity){
+	AverageGradientSteps steps(AVERAGE_GRADIENT_SAGA, alpha);
+	if (!c.prepareAverageGradient(steps))
+		error("ERROR: sgdSAGA needs an l2 regularized loss of a linear model");
+	if (verbosity > 0)
+		cout<<"Started Stochastic Gradient Descent using SAGA\n";
+	Vector x(x0);
+	double f;
+	Vector g;
+	double gnorm = 1e2;
+	int epoch = 1;
+
+	while ((gnorm >= TOL) && (epoch < maxEval) )
+	{
+		for(int k = 0; k < numSamples; k++)
+			c.averageGradientStep(x, rand() % numSamples, steps);
+		steps.flush(x);
+		// Evaluate total objective function with learned parameters
+		if ((TOL > 0) || (verbosity > 0)) {
+			c.eval(x, f, g);
+			gnorm = norm(g);
+			if (verbosity > 0)
+				printf("Epoch: %d, alpha: %e, ObjVal: %e, OptCond: %e\n", epoch, steps.stepSize(), f, gnorm);
+		}
+		epoch++;
+	}
+	return x;
+}
+}
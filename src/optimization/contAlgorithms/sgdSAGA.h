@@ -0,0 +1,37 @@
+// Copyright (C) Rishabh Iyer, John T. Halloran, and Kai Wei
+// Licensed under the Open Software License version 3.0
+// See COPYING or http://opensource.org/licenses/OSL-3.0
+/*
+
+
+ *	Stochastic gradient descent using the SAGA algorithm (Defazio et al, 2014).
+        Solves the problem \min_x L(x), where L is an l_2 regularized loss of a linear model.
+        Author: Rishabh Iyer
+ *
+        Input:  Continuous Function: c
+                        Initial starting point x0
+                        Number of training/data instances/samples numSamples
+                        step-size parameter (alpha), in units of 1/L (default 1/3)
+                        max number of epochs (maxEval)
+                        Tolerance (TOL)
+                        Verbosity
+
+        Output: Output on convergence (x)
+ */
+
+#ifndef CA_SGD_SAGA
+#define CA_SGD_SAGA
+
+#include "../contFunctions/ContinuousFunctions.h"
+#include "../../representation/Vector.h"
+#include "../../representation/VectorOperations.h"
+
+namespace jensen {
+
+Vector sgdSAGA(const ContinuousFunctions& c, const Vector& x0, const int numSamples,
+               const double alpha = 1.0/3,
+               const double TOL = 1e-3, const int maxEval = 1000,
+               const int verbosity = 1);
+
+}
+#endif
@@ -0,0 +1,75 @@
+// Copyright (C) Rishabh Iyer, John T. Halloran, and Kai Wei
+// Licensed under the Open Software License version 3.0
+// See COPYING or http://opensource.org/licenses/OSL-3.0
+/*
+
+
+ *	Stochastic gradient descent on scaled weights for l_2 regularized losses of linear models
+        Author: Rishabh Iyer
+ *
+ */
+
+#include <stdio.h>
+#include <algorithm>
+#include <iostream>
+#include <cstdlib>
+#include <cmath>
+#include "../../utils/error.h"
+using namespace std;
+
+#include "sgdScaledSteps.h"
+
+namespace jensen {
+
+Vector sgdScaledSteps(const ContinuousFunctions& c, const Vector& x0, const int numSamples,
+                      const double alpha, const int miniBatchSize,
+                      const double TOL, const int maxEval,
+                      const bool decaying, const int verbosity){
+	if (!c.prepareScaledSteps())
+		error("ERROR: sgdScaledSteps needs a function supporting scaled steps");
+	if (verbosity > 0)
+		cout<<"Started Stochastic Gradient Descent on scaled weights\n";
+	ScaledVector xs(x0);
+	Vector x;
+	double f;
+	Vector g;
+	double loss = 0;                 // the average loss of the rows at their steps in the last epoch
+	double change = 1e2;                 // its relative change from the epoch before
+	int epoch = 1;
+	long int miniBatchEval = 1;
+
+	// create vector of indices and randomly permute
+	std::vector<int> indices;
+	for(int i = 0; i < numSamples; i++) {
+		indices.push_back(i);
+	}
+	std::random_shuffle( indices.begin(), indices.end() );
+
+	std::vector<int> miniBatch;
+	// The stopping rule only uses the losses the steps return, so an epoch stays O(nnz): the O(m) evaluation of the full
+	// objective is only made for the log of verbosity > 1.
+	while ((change >= TOL) && (epoch < maxEval) )
+	{
+		double previousLoss = loss;
+		loss = 0;
+		for (int b = 0; b < numSamples; b += miniBatchSize) {
+			miniBatch.assign(indices.begin() + b, indices.begin() + min(b + miniBatchSize, numSamples));
+			double learningRate = decaying ? alpha / (1 + alpha * miniBatchEval) : alpha;
+			loss += c.scaledStochasticStep(xs, miniBatch, learningRate);
+			miniBatchEval++;
+		}
+		loss /= numSamples;
+		if (epoch > 1)
+			change = fabs(loss - previousLoss)/max(fabs(previousLoss), 1e-300);
+		if (verbosity > 1) {
+			x = xs.value();
+			c.eval(x, f, g);
+			printf("Epoch: %d, alpha: %e, ObjVal: %e, OptCond: %e, Avg. Loss Change: %e\n", epoch, alpha, f, norm(g), change);
+		}
+		else if (verbosity > 0)
+			printf("Epoch: %d, alpha: %e, Avg. Loss: %e, Avg. Loss Change: %e\n", epoch, alpha, loss, change);
+		epoch++;
+	}
+	return xs.value();
+}
+}
@@ -0,0 +1,46 @@
+// Copyright (C) Rishabh Iyer, John T. Halloran, and Kai Wei
+// Licensed under the Open Software License version 3.0
+// See COPYING or http://opensource.org/licenses/OSL-3.0
+/*
+
+
+ *	Stochastic gradient descent on scaled weights for l_2 regularized losses of linear models
+        Solves the problem \min_x \phi(x), where \phi is a loss supporting scaled steps (see
+        ContinuousFunctions::prepareScaledSteps). x is kept as s*v (see ScaledVector.h): the
+        regularizer part of a step, x = (1 - alpha*lambda) x, only changes s, and the loss part only
+        touches the features of the mini-batch. A step hence costs O(nnz of the mini-batch) instead
+        of O(m). Every epoch visits all the mini-batches of one shuffle of the samples; with decaying,
+        the step size is alpha/(1 + alpha*t). The iterations stop when the average loss of the rows (at
+        the step that used them) changes by less than TOL relative to the epoch before, which needs no
+        pass over the full objective; that is only evaluated for the log with verbosity > 1.
+        Author: Rishabh Iyer
+ *
+        Input:  Continuous Function: c
+                        Initial starting point x0
+                        Number of training/data instances/samples numSamples
+                        step-size parameter (alpha)
+                        Number of samples to compute the gradient within an epoch miniBatchSize
+                        max number of epochs (maxEval)
+                        Tolerance on the relative change of the average loss over an epoch (TOL)
+                        decaying step size alpha/(1 + alpha*t), t the number of mini-batches so far (decaying)
+                        Verbosity
+
+        Output: Output on convergence (x)
+ */
+
+#ifndef CA_SGD_SCALED_STEPS
+#define CA_SGD_SCALED_STEPS
+
+#include "../contFunctions/ContinuousFunctions.h"
+#include "../../representation/Vector.h"
+#include "../../representation/VectorOperations.h"
+
+namespace jensen {
+
+Vector sgdScaledSteps(const ContinuousFunctions& c, const Vector& x0, const int numSamples,
+                      const double alpha = 0.1, const int miniBatchSize = 1,
+                      const double TOL = 1e-3, const int maxEval = 1000,
+                      const bool decaying = false, const int verbosity = 1);
+
+}
+#endif
@@ -4,15 +4,14 @@
 /*
 
 
- *	Online optimization with automatic step-size adjustment using AdaGrad (Duchi et al, 2010)
-        Solves the problem \min_x \phi(x), where \phi is a convex (or continuous) function.
+ *	Stochastic gradient descent using the stochastic average gradient algorithm (Le Roux et al, 2012).
+        Solves the problem \min_x L(x), where L is an l_2 regularized loss of a linear model.
         Author: John Halloran
  *
         Input:  Continuous Function: c
                         Initial starting point x0
                         Number of training/data instances/samples numSamples
-                        step-size parameter (alpha)
-                        Number of samples to compute the gradient within an epoch miniBatchSize
+                        step-size parameter (alpha), in units of 1/L
                         max number of epochs (maxEval)
                         Tolerance (TOL)
                         Verbosity
@@ -30,10 +29,9 @@
 namespace jensen {
 
 Vector sgdStochasticAverageGradient(const ContinuousFunctions& c, const Vector& x0, const int numSamples,
-                                    const double alpha = 0.1, const double lambda = 1.0,
-                                    const int miniBatchSize = 1,
+                                    const double alpha = 1.0,
                                     const double TOL = 1e-3, const int maxEval = 1000,
-                                    const double decayRate = 0.5, const int verbosity = 1);
+                                    const int verbosity = 1);
 
 }
 #endif
@@ -55,8 +55,15 @@ static void transpose(const vector<SparseFeature>& features, vector<SparseFeatur
 	}
 }
 
-void L1LRPrimal(vector<SparseFeature>& features, Vector& y, Vector& x, double C, double eps, const int max_newton_iter,  const int verbosity){
-	vector<SparseFeature> invfeatures;
+static void transpose(const SparseDataset& features, SparseDataset& invfeatures)
+{
+	invfeatures = features.transpose();
+}
+
+template <class Data>
+static void L1LRPrimalImpl(Data& features, Vector& y, Vector& x, double C, double eps, const int max_newton_iter,  const int verbosity){
+	typedef typename Data::value_type Feature;
+	Data invfeatures;
 	transpose(features, invfeatures);
 	int n = features.size();
 	int m = invfeatures.size();
@@ -103,10 +110,11 @@ void L1LRPrimal(vector<SparseFeature>& features, Vector& y, Vector& x, double C,
 		xpd[j] = x[j];
 		index[j] = j;
 		xjneg_sum[j] = 0;
-		for (int i = 0; i < invfeatures[j].featureIndex.size(); i++)
+		const Feature& xj = invfeatures[j];
+		for (int i = 0; i < xj.featureIndex.size(); i++)
 		{
-			int ind = invfeatures[j].featureIndex[i];
-			double fval = invfeatures[j].featureVec[i];
+			int ind = xj.featureIndex[i];
+			double fval = xj.featureVec[i];
 			exp_wTx[ind] += x[j]*fval;
 			if(y[ind] == -1)
 				xjneg_sum[j] += C*fval;
@@ -133,10 +141,11 @@ void L1LRPrimal(vector<SparseFeature>& features, Vector& y, Vector& x, double C,
 			Grad[j] = 0;
 
 			double tmp = 0;
-			for (int i = 0; i < invfeatures[j].featureIndex.size(); i++)
+			const Feature& xj = invfeatures[j];
+			for (int i = 0; i < xj.featureIndex.size(); i++)
 			{
-				int ind = invfeatures[j].featureIndex[i];
-				double fval = invfeatures[j].featureVec[i];
+				int ind = xj.featureIndex[i];
+				double fval = xj.featureVec[i];
 				Hdiag[j] += fval*fval*D[ind];
 				tmp += fval*tau[ind];
 			}
@@ -200,10 +209,11 @@ void L1LRPrimal(vector<SparseFeature>& features, Vector& y, Vector& x, double C,
 				H = Hdiag[j];
 
 				G = Grad[j] + (xpd[j]-x[j])*nu;
-				for (int i = 0; i < invfeatures[j].featureIndex.size(); i++)
+				const Feature& xj = invfeatures[j];
+				for (int i = 0; i < xj.featureIndex.size(); i++)
 				{
-					int ind = invfeatures[j].featureIndex[i];
-					double fval = invfeatures[j].featureVec[i];
+					int ind = xj.featureIndex[i];
+					double fval = xj.featureVec[i];
 					G += fval*D[ind]*xTd[ind];
 				}
 
@@ -247,10 +257,10 @@ void L1LRPrimal(vector<SparseFeature>& features, Vector& y, Vector& x, double C,
 
 				xpd[j] += z;
 
-				for (int i = 0; i < invfeatures[j].featureIndex.size(); i++)
+				for (int i = 0; i < xj.featureIndex.size(); i++)
 				{
-					int ind = invfeatures[j].featureIndex[i];
-					double fval = invfeatures[j].featureVec[i];
+					int ind = xj.featureIndex[i];
+					double fval = xj.featureVec[i];
 					xTd[ind] += fval*z;
 				}
 			}
@@ -342,10 +352,11 @@ void L1LRPrimal(vector<SparseFeature>& features, Vector& y, Vector& x, double C,
 			for(int j=0; j<m; j++)
 			{
 				if(x[j]==0) continue;
-				for (int i = 0; i < invfeatures[j].featureIndex.size(); i++)
+				const Feature& xj = invfeatures[j];
+				for (int i = 0; i < xj.featureIndex.size(); i++)
 				{
-					int ind = invfeatures[j].featureIndex[i];
-					double fval = invfeatures[j].featureVec[i];
+					int ind = xj.featureIndex[i];
+					double fval = xj.featureVec[i];
 					exp_wTx[ind] += x[j]*fval;
 				}
 			}
@@ -408,4 +419,12 @@ void L1LRPrimal(vector<SparseFeature>& features, Vector& y, Vector& x, double C,
 
 }
 
+void L1LRPrimal(vector<SparseFeature>& features, Vector& y, Vector& x, double C, double eps, const int max_newton_iter,  const int verbosity){
+	L1LRPrimalImpl(features, y, x, C, eps, max_newton_iter, verbosity);
+}
+
+void L1LRPrimal(SparseDataset& features, Vector& y, Vector& x, double C, double eps, const int max_newton_iter,  const int verbosity){
+	L1LRPrimalImpl(features, y, x, C, eps, max_newton_iter, verbosity);
+}
+
 }
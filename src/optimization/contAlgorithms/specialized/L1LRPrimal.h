@@ -21,10 +21,12 @@
 
 #include "../../../representation/Vector.h"
 #include "../../../representation/SparseFeature.h"
+#include "../../../representation/SparseDataset.h"
 
 namespace jensen {
 
 void L1LRPrimal(std::vector<SparseFeature>& features, Vector& y, Vector& x, double C, double eps, const int max_newton_iter = 100, const int verbosity = 1);
+void L1LRPrimal(SparseDataset& features, Vector& y, Vector& x, double C, double eps, const int max_newton_iter = 100, const int verbosity = 1);
 
 }
 #endif
@@ -9,6 +9,16 @@
                         Vector w: Output weights
                         double C: 1/lambda (regularization)
                         double eps: tolerance
+                        int nThreads: threads of the sweeps (more than one, explicitly: asynchronous; 0 or 1: serial)
+                        Vector* alpha0: the dual variables (optional). If given, the solver is warm started from
+                                them (clipped to the feasible box of this lambda) and they are overwritten with the
+                                dual solution, e.g. to pass it on to the next point of a regularization path.
+
+        With more than one thread every sweep over the active set is run asynchronously in parallel
+        (PASSCoDe-Atomic, Hsieh et al. 2015): each coordinate alpha_i is updated by exactly one thread,
+        which reads w without locking and adds its change of w with atomic updates. Shrinking and the
+        stopping rule are the same as in the serial solver, the shrunk coordinates are moved out of
+        the active set after each sweep.
 
         Output: Output on convergence (x)
  */
@@ -20,9 +30,11 @@
 using namespace std;
 
 #include "SVCDual.h"
+#include "../../../representation/VectorOperations.h"
 #include "../../contFunctions/ContinuousFunctions.h"
 #include "../../contFunctions/L2SmoothSVMLoss.h"
 #include "../../contFunctions/L2HingeSVMLoss.h"
+#include "../../../utils/Threads.h"
 #define L2R_L1LOSS_SVC_DUAL 1
 #define L2R_L2LOSS_SVC_DUAL 2
 #define INF HUGE_VAL
@@ -36,17 +48,78 @@ using namespace std;
 //#endif
 
 namespace jensen {
-Vector SVCDual(vector<SparseFeature>& features, Vector& y, int solver_type, double lambda, double eps, int max_iter, const int verbosity)
+
+// Moves the shrunk coordinates of index[0..active_size) behind the active ones and returns the new active size.
+static int compactActiveSet(vector<int>& index, const vector<char>& shrunk, const int active_size){
+	vector<int> removed;
+	int k = 0;
+	for (int s = 0; s < active_size; s++) {
+		if (shrunk[s])
+			removed.push_back(index[s]);
+		else
+			index[k++] = index[s];
+	}
+	copy(removed.begin(), removed.end(), index.begin() + k);
+	return k;
+}
+
+// One coordinate descent step on alpha_i. Returns false if i is to be shrunk (alpha_i is left unchanged), else the
+// projected gradient is set in PG. With atomicUpdate the change of w is added atomically (w is shared by the threads).
+template <class Feature>
+static inline bool svcCoordinateStep(const Feature& xi, const double yi, double& alphai, const double QDi, const double diag,
+                                     const double C, const double PGmax_old, const double PGmin_old, Vector& w,
+                                     const bool atomicUpdate, double& PG)
 {
+	double G = w*xi;
+	G = G*yi-1;
+	G += alphai*diag;
+
+	PG = 0;
+	if (alphai == 0)
+	{
+		if (G > PGmax_old)
+			return false;
+		else if (G < 0)
+			PG = G;
+	}
+	else if (alphai == C)
+	{
+		if (G < PGmin_old)
+			return false;
+		else if (G > 0)
+			PG = G;
+	}
+	else
+		PG = G;
+
+	if(fabs(PG) > 1.0e-12)
+	{
+		double alpha_old = alphai;
+		alphai = min(max(alphai - G/QDi, 0.0), C);
+		double d = (alphai - alpha_old)*yi;
+		if (atomicUpdate)
+			featureMultiplyAddAtomic(w, d, xi);
+		else
+			featureMultiplyAdd(w, d, xi);
+	}
+	return true;
+}
+
+template <class Data>
+static Vector SVCDualImpl(Data& features, Vector& y, int solver_type, double lambda, double eps, int max_iter, const int verbosity, const int nThreads, Vector* alpha0)
+{
+	typedef typename Data::value_type Feature;
 	int l = features.size(); // number of training examples
 	int w_size = features[0].numFeatures; // dimension of the features
 	Vector w = Vector(w_size, 0);
 	int i, s, iter = 0;
-	double C, d, G;
+	double C;
 	Vector QD(l);
 	vector<int> index(l);
 	Vector alpha(l);
 	int active_size = l;
+	int T = asynchronousThreads(nThreads);
+	vector<char> shrunk((T > 1) ? l : 0);
 	C = 1/lambda;
 	// PG: projected gradient, for shrinking and stopping
 	double PG;
@@ -63,27 +136,28 @@ Vector SVCDual(vector<SparseFeature>& features, Vector& y, int solver_type, doub
 	{
 		diag = 0;
 		upper_bound = C;
-		c = new L2HingeSVMLoss<SparseFeature>(w_size, features, y, lambda);
+		c = new L2HingeSVMLoss<Feature>(w_size, features, y, lambda);
 	}
 	else if (solver_type == L2R_L2LOSS_SVC_DUAL) {
 		diag = 0.5*lambda;
 		upper_bound = INF;
-		c = new L2SmoothSVMLoss<SparseFeature>(w_size, features, y, lambda);
+		c = new L2SmoothSVMLoss<Feature>(w_size, features, y, lambda);
 	}
 	// Initial alpha can be set here. Note that
 	// 0 <= alpha[i] <= upper_bound
+	bool warmStart = (alpha0 != NULL) && (alpha0->size() == l);
 	for(i=0; i<l; i++)
-		alpha[i] = 0;
+		alpha[i] = warmStart ? min(max((*alpha0)[i], 0.0), upper_bound) : 0;
 
 	for(i=0; i<w_size; i++)
 		w[i] = 0;
 	for(i=0; i<l; i++)
 	{
 		QD[i] = 0.5/C;
-
-		for (int j = 0; j < features[i].featureIndex.size(); j++) {
-			double val = features[i].featureVec[j];
-			int ind = features[i].featureIndex[j];
+		const Feature& xi = features[i];
+		for (int j = 0; j < xi.featureIndex.size(); j++) {
+			double val = xi.featureVec[j];
+			int ind = xi.featureIndex[j];
 			QD[i] += val*val;
 			w[ind] += y[i]*alpha[i]*val;
 		}
@@ -101,82 +175,52 @@ Vector SVCDual(vector<SparseFeature>& features, Vector& y, int solver_type, doub
 			swap(index[i], index[j]);
 		}
 
-		for (s=0; s<active_size; s++)
+		if (T == 1)
 		{
-			i = index[s];
-			G = 0;
-
-			for (int j = 0; j < features[i].featureIndex.size(); j++) {
-				double val = features[i].featureVec[j];
-				int ind = features[i].featureIndex[j];
-				G += w[ind]*val;
-			}
-			G = G*y[i]-1;
-
-			C = upper_bound;
-			G += alpha[i]*diag;
-
-			PG = 0;
-			if (alpha[i] == 0)
+			for (s=0; s<active_size; s++)
 			{
-				if (G > PGmax_old)
+				i = index[s];
+				if (!svcCoordinateStep(features[i], y[i], alpha[i], QD[i], diag, upper_bound, PGmax_old, PGmin_old, w, false, PG))
 				{
 					active_size--;
 					swap(index[s], index[active_size]);
 					s--;
 					continue;
 				}
-				else if (G < 0)
-					PG = G;
+				PGmax_new = max(PGmax_new, PG);
+				PGmin_new = min(PGmin_new, PG);
 			}
-			else if (alpha[i] == C)
+		}
+		else
+		{
+			#pragma omp parallel for schedule(dynamic, 64) num_threads(T) reduction(max:PGmax_new) reduction(min:PGmin_new)
+			for (int k = 0; k < active_size; k++)
 			{
-				if (G < PGmin_old)
+				int j = index[k];
+				double PGj;
+				shrunk[k] = !svcCoordinateStep(features[j], y[j], alpha[j], QD[j], diag, upper_bound, PGmax_old, PGmin_old, w, true, PGj);
+				if (!shrunk[k])
 				{
-					active_size--;
-					swap(index[s], index[active_size]);
-					s--;
-					continue;
-				}
-				else if (G > 0)
-					PG = G;
-			}
-			else
-				PG = G;
-
-			PGmax_new = max(PGmax_new, PG);
-			PGmin_new = min(PGmin_new, PG);
-
-			if(fabs(PG) > 1.0e-12)
-			{
-				double alpha_old = alpha[i];
-				alpha[i] = min(max(alpha[i] - G/QD[i], 0.0), C);
-				d = (alpha[i] - alpha_old)*y[i];
-				for (int j = 0; j < features[i].featureIndex.size(); j++) {
-					double val = features[i].featureVec[j];
-					int ind = features[i].featureIndex[j];
-					w[ind] += d*val;
+					PGmax_new = max(PGmax_new, PGj);
+					PGmin_new = min(PGmin_new, PGj);
 				}
 			}
+			active_size = compactActiveSet(index, shrunk, active_size);
 		}
 
 		iter++;
-		if(iter % 10 == 0)
-			// printf(".");
-
-			if(PGmax_new - PGmin_new <= eps)
+		if(PGmax_new - PGmin_new <= eps)
+		{
+			if(active_size == l)
+				break;
+			else
 			{
-				if(active_size == l)
-					break;
-				else
-				{
-					active_size = l;
-					// printf("*");
-					PGmax_old = INF;
-					PGmin_old = -INF;
-					continue;
-				}
+				active_size = l;
+				PGmax_old = INF;
+				PGmin_old = -INF;
+				continue;
 			}
+		}
 		PGmax_old = PGmax_new;
 		PGmin_old = PGmin_new;
 		if (PGmax_old <= 0)
@@ -199,7 +243,7 @@ Vector SVCDual(vector<SparseFeature>& features, Vector& y, int solver_type, doub
 		pval = c->eval(w);
 		// printf("Dual Objective value = %lf, Primal Objective Value = %lf, nSV = %d\n",v/2, pval, nSV);
 		if(verbosity > 0)
-			printf("numIter: %d, ObjVal: %e, Dual ObjVal: %e, nSV: %e\n", iter, pval, v/2, nSV);
+			printf("numIter: %d, ObjVal: %e, Dual ObjVal: %e, nSV: %d\n", iter, pval, v/2, nSV);
 	}
 
 	// printf("\noptimization finished, #iter = %d\n",iter);
@@ -221,7 +265,19 @@ Vector SVCDual(vector<SparseFeature>& features, Vector& y, int solver_type, doub
 	// printf("Objective value = %lf\n",v/2);
 	// printf("nSV = %d\n",nSV);
 	// printf("\noptimization finished, #iter = %d, Dual ObjVal = %e, nSV = %d\n",iter, v/2, nSV);
+	if (alpha0 != NULL)
+		*alpha0 = alpha;
 	delete c;
 	return w;
 }
+
+Vector SVCDual(vector<SparseFeature>& features, Vector& y, int solver_type, double lambda, double eps, int max_iter, const int verbosity, const int nThreads, Vector* alpha0)
+{
+	return SVCDualImpl(features, y, solver_type, lambda, eps, max_iter, verbosity, nThreads, alpha0);
+}
+
+Vector SVCDual(SparseDataset& features, Vector& y, int solver_type, double lambda, double eps, int max_iter, const int verbosity, const int nThreads, Vector* alpha0)
+{
+	return SVCDualImpl(features, y, solver_type, lambda, eps, max_iter, verbosity, nThreads, alpha0);
+}
 }
@@ -22,9 +22,14 @@
 #include "../../../representation/Vector.h"
 #include "../../../representation/VectorOperations.h"
 #include "../../../representation/SparseFeature.h"
+#include "../../../representation/SparseDataset.h"
+#include <cstddef>
 
 namespace jensen {
-Vector SVCDual(std::vector<SparseFeature>& features, Vector& y, int solver_type, double lambda, double eps, int max_iter,  const int verbosity = 1);
+Vector SVCDual(std::vector<SparseFeature>& features, Vector& y, int solver_type, double lambda, double eps, int max_iter,  const int verbosity = 1, const int nThreads = 1,
+              Vector* alpha0 = NULL);
+Vector SVCDual(SparseDataset& features, Vector& y, int solver_type, double lambda, double eps, int max_iter,  const int verbosity = 1, const int nThreads = 1,
+              Vector* alpha0 = NULL);
 
 }
 #endif
@@ -11,6 +11,9 @@
                         max number of iterations (maxiter)
                         Tolerance (TOL)
                         Verbosity
+                        nThreads: threads of the sweeps; with an explicit number of more than one the sweeps
+                        run asynchronously in parallel with atomic updates of w, as in SVCDual (0 or 1: serial)
+                        beta0: the dual variables (optional), warm start and output as alpha0 of SVCDual
 
         Output: Output on convergence (x)
  */
@@ -22,26 +25,112 @@
 using namespace std;
 
 #include "SVRDual.h"
+#include "../../../representation/VectorOperations.h"
 #include "../../contFunctions/ContinuousFunctions.h"
 #include "../../contFunctions/L2SmoothSVRLoss.h"
 #include "../../contFunctions/L2HingeSVRLoss.h"
+#include "../../../utils/Threads.h"
 #define L2R_L1LOSS_SVR_DUAL 1
 #define L2R_L2LOSS_SVR_DUAL 2
 #define INF HUGE_VAL
 
 namespace jensen {
 
-Vector SVRDual(vector<SparseFeature>& features, Vector& y, int solver_type, double lambda, double p, double eps, int max_iter, const int verbosity)
+// Moves the shrunk coordinates of index[0..active_size) behind the active ones and returns the new active size.
+static int compactActiveSet(vector<int>& index, const vector<char>& shrunk, const int active_size){
+	vector<int> removed;
+	int k = 0;
+	for (int s = 0; s < active_size; s++) {
+		if (shrunk[s])
+			removed.push_back(index[s]);
+		else
+			index[k++] = index[s];
+	}
+	copy(removed.begin(), removed.end(), index.begin() + k);
+	return k;
+}
+
+// One coordinate descent step on beta_i. Returns false if i is to be shrunk (beta_i is left unchanged), else the
+// violation of the optimality condition is set. With atomicUpdate the change of w is added atomically.
+template <class Feature>
+static inline bool svrCoordinateStep(const Feature& xi, const double yi, double& betai, const double QDi, const double lambda,
+                                     const double p, const double upper_bound, const double Gmax_old, Vector& w,
+                                     const bool atomicUpdate, double& violation)
+{
+	double G = -yi + lambda*betai;
+	double H = QDi + lambda;
+	G += w*xi;
+
+	double Gp = G+p;
+	double Gn = G-p;
+	violation = 0;
+	if(betai == 0)
+	{
+		if(Gp < 0)
+			violation = -Gp;
+		else if(Gn > 0)
+			violation = Gn;
+		else if(Gp>Gmax_old && Gn<-Gmax_old)
+			return false;
+	}
+	else if(betai >= upper_bound)
+	{
+		if(Gp > 0)
+			violation = Gp;
+		else if(Gp < -Gmax_old)
+			return false;
+	}
+	else if(betai <= -upper_bound)
+	{
+		if(Gn < 0)
+			violation = -Gn;
+		else if(Gn > Gmax_old)
+			return false;
+	}
+	else if(betai > 0)
+		violation = fabs(Gp);
+	else
+		violation = fabs(Gn);
+
+	// obtain Newton direction d
+	double d;
+	if(Gp < H*betai)
+		d = -Gp/H;
+	else if(Gn > H*betai)
+		d = -Gn/H;
+	else
+		d = -betai;
+
+	if(fabs(d) < 1.0e-12)
+		return true;
+
+	double beta_old = betai;
+	betai = min(max(betai+d, -upper_bound), upper_bound);
+	d = betai-beta_old;
+
+	if(d != 0)
+	{
+		if (atomicUpdate)
+			featureMultiplyAddAtomic(w, d, xi);
+		else
+			featureMultiplyAdd(w, d, xi);
+	}
+	return true;
+}
 
+template <class Data>
+static Vector SVRDualImpl(Data& features, Vector& y, int solver_type, double lambda, double p, double eps, int max_iter, const int verbosity, const int nThreads, Vector* beta0)
 {
+	typedef typename Data::value_type Feature;
 	int l = features.size();
 	double C = 1/lambda;
 	int w_size = features[0].numFeatures;
 	int i, s, iter = 0;
 	int active_size = l;
 	vector<int> index(l);
+	int T = asynchronousThreads(nThreads);
+	vector<char> shrunk((T > 1) ? l : 0);
 	Vector w = Vector(w_size, 0);
-	double d, G, H;
 	double pval;
 	double Gmax_old = INF;
 	double Gmax_new, Gnorm1_new;
@@ -56,27 +145,29 @@ Vector SVRDual(vector<SparseFeature>& features, Vector& y, int solver_type, doub
 	{
 		lambda = 0;
 		upper_bound = C;
-		c = new L2HingeSVRLoss<SparseFeature>(w_size, features, y, lambda, p);
+		c = new L2HingeSVRLoss<Feature>(w_size, features, y, lambda, p);
 
 	}
 	else if (solver_type == L2R_L2LOSS_SVR_DUAL) {
 		lambda = 0.5*lambda;
 		upper_bound = INF;
-		c = new L2SmoothSVRLoss<SparseFeature>(w_size, features, y, lambda, p);
+		c = new L2SmoothSVRLoss<Feature>(w_size, features, y, lambda, p);
 	}
 	// Initial beta can be set here. Note that
 	// -upper_bound <= beta[i] <= upper_bound
+	bool warmStart = (beta0 != NULL) && (beta0->size() == l);
 	for(i=0; i<l; i++)
-		beta[i] = 0;
+		beta[i] = warmStart ? min(max((*beta0)[i], -upper_bound), upper_bound) : 0;
 
 	for(i=0; i<w_size; i++)
 		w[i] = 0;
 	for(i=0; i<l; i++)
 	{
 		QD[i] = 0;
-		for (int j = 0; j < features[i].featureIndex.size(); j++) {
-			double val = features[i].featureVec[j];
-			int ind = features[i].featureIndex[j];
+		const Feature& xi = features[i];
+		for (int j = 0; j < xi.featureIndex.size(); j++) {
+			double val = xi.featureVec[j];
+			int ind = xi.featureIndex[j];
 			QD[i] += val*val;
 			w[ind] += beta[i]*val;
 		}
@@ -96,110 +187,54 @@ Vector SVRDual(vector<SparseFeature>& features, Vector& y, int solver_type, doub
 			swap(index[i], index[j]);
 		}
 
-		for(s=0; s<active_size; s++)
+		if (T == 1)
 		{
-			i = index[s];
-			G = -y[i] + lambda*beta[i];
-			H = QD[i] + lambda;
-
-			for (int j = 0; j < features[i].featureIndex.size(); j++) {
-				double val = features[i].featureVec[j];
-				int ind = features[i].featureIndex[j];
-				G += val*w[ind];
-			}
-
-			double Gp = G+p;
-			double Gn = G-p;
-			double violation = 0;
-			if(beta[i] == 0)
+			for(s=0; s<active_size; s++)
 			{
-				if(Gp < 0)
-					violation = -Gp;
-				else if(Gn > 0)
-					violation = Gn;
-				else if(Gp>Gmax_old && Gn<-Gmax_old)
+				i = index[s];
+				double violation;
+				if (!svrCoordinateStep(features[i], y[i], beta[i], QD[i], lambda, p, upper_bound, Gmax_old, w, false, violation))
 				{
 					active_size--;
 					swap(index[s], index[active_size]);
 					s--;
 					continue;
 				}
+				Gmax_new = max(Gmax_new, violation);
+				Gnorm1_new += violation;
 			}
-			else if(beta[i] >= upper_bound)
+		}
+		else
+		{
+			#pragma omp parallel for schedule(dynamic, 64) num_threads(T) reduction(max:Gmax_new) reduction(+:Gnorm1_new)
+			for (int k = 0; k < active_size; k++)
 			{
-				if(Gp > 0)
-					violation = Gp;
-				else if(Gp < -Gmax_old)
+				int j = index[k];
+				double violation;
+				shrunk[k] = !svrCoordinateStep(features[j], y[j], beta[j], QD[j], lambda, p, upper_bound, Gmax_old, w, true, violation);
+				if (!shrunk[k])
 				{
-					active_size--;
-					swap(index[s], index[active_size]);
-					s--;
-					continue;
-				}
-			}
-			else if(beta[i] <= -upper_bound)
-			{
-				if(Gn < 0)
-					violation = -Gn;
-				else if(Gn > Gmax_old)
-				{
-					active_size--;
-					swap(index[s], index[active_size]);
-					s--;
-					continue;
-				}
-			}
-			else if(beta[i] > 0)
-				violation = fabs(Gp);
-			else
-				violation = fabs(Gn);
-
-			Gmax_new = max(Gmax_new, violation);
-			Gnorm1_new += violation;
-
-			// obtain Newton direction d
-			if(Gp < H*beta[i])
-				d = -Gp/H;
-			else if(Gn > H*beta[i])
-				d = -Gn/H;
-			else
-				d = -beta[i];
-
-			if(fabs(d) < 1.0e-12)
-				continue;
-
-			double beta_old = beta[i];
-			beta[i] = min(max(beta[i]+d, -upper_bound), upper_bound);
-			d = beta[i]-beta_old;
-
-			if(d != 0)
-			{
-				for (int j = 0; j < features[i].featureIndex.size(); j++) {
-					double val = features[i].featureVec[j];
-					int ind = features[i].featureIndex[j];
-					w[ind] += d*val;
+					Gmax_new = max(Gmax_new, violation);
+					Gnorm1_new += violation;
 				}
 			}
+			active_size = compactActiveSet(index, shrunk, active_size);
 		}
 
 		if(iter == 0)
 			Gnorm1_init = Gnorm1_new;
 		iter++;
-		if(iter % 10 == 0)
-			// printf(".");
-
-			if(Gnorm1_new <= eps*Gnorm1_init)
+		if(Gnorm1_new <= eps*Gnorm1_init)
+		{
+			if(active_size == l)
+				break;
+			else
 			{
-				if(active_size == l)
-					break;
-				else
-				{
-					active_size = l;
-					// printf("*");
-					Gmax_old = INF;
-					continue;
-				}
+				active_size = l;
+				Gmax_old = INF;
+				continue;
 			}
+		}
 
 		Gmax_old = Gmax_new;
 		double v = 0;
@@ -216,7 +251,7 @@ Vector SVRDual(vector<SparseFeature>& features, Vector& y, int solver_type, doub
 		pval = c->eval(w);
 		// printf("Dual Objective value = %lf, Primal Objective Value = %lf, nSV = %d\n",v/2, pval, nSV);
 		if(verbosity > 0)
-			printf("numIter: %d, ObjVal: %e, Dual ObjVal: %e, nSV: %e\n", iter, pval, v/2, nSV);
+			printf("numIter: %d, ObjVal: %e, Dual ObjVal: %e, nSV: %d\n", iter, pval, v/2, nSV);
 
 	}
 
@@ -239,7 +274,19 @@ Vector SVRDual(vector<SparseFeature>& features, Vector& y, int solver_type, doub
 
 	// printf("Objective value = %lf\n", v);
 	// printf("nSV = %d\n",nSV);
+	if (beta0 != NULL)
+		*beta0 = beta;
 	delete c;
 	return w;
 }
+
+Vector SVRDual(vector<SparseFeature>& features, Vector& y, int solver_type, double lambda, double p, double eps, int max_iter, const int verbosity, const int nThreads, Vector* beta0)
+{
+	return SVRDualImpl(features, y, solver_type, lambda, p, eps, max_iter, verbosity, nThreads, beta0);
+}
+
+Vector SVRDual(SparseDataset& features, Vector& y, int solver_type, double lambda, double p, double eps, int max_iter, const int verbosity, const int nThreads, Vector* beta0)
+{
+	return SVRDualImpl(features, y, solver_type, lambda, p, eps, max_iter, verbosity, nThreads, beta0);
+}
 }
@@ -22,11 +22,16 @@
 #include "../../../representation/Vector.h"
 #include "../../../representation/VectorOperations.h"
 #include "../../../representation/SparseFeature.h"
+#include "../../../representation/SparseDataset.h"
+#include <cstddef>
 
 
 namespace jensen {
 
-Vector SVRDual(std::vector<SparseFeature>& features, Vector& y, int solver_type, double lambda, double p, double eps, int max_iter, const int verbosity = 1);
+Vector SVRDual(std::vector<SparseFeature>& features, Vector& y, int solver_type, double lambda, double p, double eps, int max_iter, const int verbosity = 1, const int nThreads = 1,
+              Vector* beta0 = NULL);
+Vector SVRDual(SparseDataset& features, Vector& y, int solver_type, double lambda, double p, double eps, int max_iter, const int verbosity = 1, const int nThreads = 1,
+              Vector* beta0 = NULL);
 
 }
 #endif
@@ -28,9 +28,32 @@ using namespace std;
 #include "tron.h"
 #include "../../utils/utils.h"
 #include <math.h>
+#include <stdlib.h>
 namespace jensen {
 
-int trcg(double delta, const ContinuousFunctions& c, const Vector& g, const Vector& x, Vector& s, Vector &r, bool* reach_boundary, double eps_cg = 0.1)
+// The product with the hessian at x, estimated from the rows of sample unless it is NULL.
+static void hessianVectorProduct(const ContinuousFunctions& c, const Vector& x, const Vector& v, Vector& Hv,
+                                 const std::vector<int>* sample)
+{
+	if (sample != NULL)
+		c.evalSubsampledHessianVectorProduct(x, v, Hv, *sample);
+	else
+		c.evalHessianVectorProduct(x, v, Hv);
+}
+
+// A uniformly random subset of size of the rows 0..n-1, ascending (selection sampling, one pass and no permutation of n rows).
+static void sampleRows(const int n, const int size, std::vector<int>& rows)
+{
+	rows.resize(size);
+	int chosen = 0;
+	for (int i = 0; i < n && chosen < size; i++) {
+		if ((n - i)*(rand()/(RAND_MAX + 1.0)) < size - chosen)
+			rows[chosen++] = i;
+	}
+}
+
+int trcg(double delta, const ContinuousFunctions& c, const Vector& g, const Vector& x, Vector& s, Vector &r, bool* reach_boundary,
+         const std::vector<int>* sample = NULL, double eps_cg = 0.1)
 {
 	int i;
 	int m = c.size();
@@ -53,7 +76,7 @@ int trcg(double delta, const ContinuousFunctions& c, const Vector& g, const Vect
 		if (norm(r) <= cgtol)
 			break;
 		cg_iter++;
-		c.evalHessianVectorProduct(x, d, Hd);
+		hessianVectorProduct(c, x, d, Hd, sample);
 
 		alpha = rTr/(d*Hd);
 		s += alpha*d;
@@ -89,8 +112,108 @@ int trcg(double delta, const ContinuousFunctions& c, const Vector& g, const Vect
 	return cg_iter;
 }
 
+// u^T M v for a diagonal M.
+static double uTMv(const Vector& u, const Vector& M, const Vector& v)
+{
+	double sum = 0;
+	for (int i = 0; i < u.size(); i++)
+		sum += u[i]*M[i]*v[i];
+	return sum;
+}
+
+// The Jacobi preconditioner of the diagonal diagH of the hessian, damped towards its smallest entry:
+// M = (1 - alpha) min(diagH) + alpha diagH. This adapts LIBLINEAR's M = (1 - alpha) I + alpha diag(H) (with the hessian
+// I + C X^T D X) to the losses here, whose hessian is lambda I + X^T D X and which do not expose lambda: min(diagH) is
+// lambda when some feature has no data and larger otherwise, so M is then damped further towards a multiple of I.
+static void jacobiPreconditioner(const Vector& diagH, Vector& M, const double alpha = 0.01)
+{
+	int m = diagH.size();
+	double dmin = (m > 0) ? diagH[0] : 1;
+	for (int i = 1; i < m; i++)
+		dmin = min(dmin, diagH[i]);
+	if (dmin <= 0)
+		dmin = 1;
+	M.resize(m);
+	for (int i = 0; i < m; i++)
+		M[i] = (1 - alpha)*dmin + alpha*max(diagH[i], 0.0);
+}
+
+// Preconditioned truncated CG: CG on M^{-1/2} H M^{-1/2}, with the trust region ||s||_M <= delta. As in LIBLINEAR, it stops
+// when the decrease of the quadratic model Q(s) = g^T s + s^T H s/2 in the last iteration falls below eps_cg times the
+// average decrease, i.e. j (Q_j - Q_{j-1}) >= eps_cg Q_j (the residual norm depends on the scaling of M).
+int trpcg(double delta, const ContinuousFunctions& c, const Vector& g, const Vector& M, const Vector& x, Vector& s, Vector &r,
+          bool* reach_boundary, const std::vector<int>* sample = NULL, double eps_cg = 0.5)
+{
+	int i;
+	int m = c.size();
+	Vector d(m, 0);
+	Vector z(m, 0);
+	Vector Hd(m, 0);
+	double zTr, znewTrnew, alpha, beta;
+	double Q = 0, newQ;
+
+	*reach_boundary = false;
+	for (i=0; i<m; i++)
+	{
+		s[i] = 0;
+		r[i] = -g[i];
+		z[i] = r[i]/M[i];
+		d[i] = z[i];
+	}
+	zTr = z*r;
+	int cg_iter = 0;
+	if (zTr <= 0)
+		return cg_iter;
+	while (cg_iter < max(m, 5))
+	{
+		cg_iter++;
+		hessianVectorProduct(c, x, d, Hd, sample);
 
-Vector tron(const ContinuousFunctions& c, const Vector& x0, const int maxEval, const double TOL, int verbosity){
+		alpha = zTr/(d*Hd);
+		s += alpha*d;
+		if (sqrt(uTMv(s, M, s)) > delta)
+		{
+			*reach_boundary = true;
+			alpha = -alpha;
+			s += alpha*d;
+
+			double sTMd = uTMv(s, M, d);
+			double sTMs = uTMv(s, M, s);
+			double dTMd = uTMv(d, M, d);
+			double dsq = delta*delta;
+			double rad = sqrt(sTMd*sTMd + dTMd*(dsq-sTMs));
+			if (sTMd >= 0)
+				alpha = (dsq - sTMs)/(sTMd + rad);
+			else
+				alpha = (rad - sTMd)/dTMd;
+			s += d*alpha;
+			alpha = -alpha;
+			r += Hd*alpha;
+			break;
+		}
+		alpha = -alpha;
+		r += Hd*alpha;
+
+		newQ = -0.5*(s*r - s*g);
+		if ((newQ > 0) || (newQ - Q > 0))                 // only with rounding errors, H is positive definite
+			break;
+		if (cg_iter*(newQ - Q) >= eps_cg*newQ)
+			break;
+		Q = newQ;
+
+		for (i=0; i<m; i++)
+			z[i] = r[i]/M[i];
+		znewTrnew = z*r;
+		beta = znewTrnew/zTr;
+		d *= beta;
+		d += z;
+		zTr = znewTrnew;
+	}
+	return cg_iter;
+}
+
+Vector tron(const ContinuousFunctions& c, const Vector& x0, const int maxEval, const double TOL, int verbosity,
+            const bool precondition, const double hessianSample){
 	double eta0 = 1e-4, eta1 = 0.25, eta2 = 0.75;
 
 	// Parameters for updating the trust region size delta.
@@ -109,10 +232,27 @@ Vector tron(const ContinuousFunctions& c, const Vector& x0, const int maxEval, c
 	double gnorm0 = norm(g);
 
 	Vector x(x0);
-	c.eval(x, f, g);
+	Vector M, diagH;
+	bool jacobi = precondition && c.evalHessianDiagonal(x, f, g, diagH);
+	if (jacobi)
+		jacobiPreconditioner(diagH, M);
+	else
+		c.eval(x, f, g);
 	double gnorm = norm(g);
-	delta = gnorm;
+	if (jacobi) {
+		// the norm of g dual to ||.||_M, i.e. ||M^{-1} g||_M
+		delta = 0;
+		for (i = 0; i < m; i++)
+			delta += g[i]*g[i]/M[i];
+		delta = sqrt(delta);
+	}
+	else
+		delta = gnorm;
 	int funcEval = 1;
+	int n = c.length();
+	int sampleSize = (int) ceil(hessianSample*n);
+	bool subsample = (sampleSize < n) && c.prepareHessianSubsample();
+	std::vector<int> rows;
 	Vector xnew;
 	Vector gnew;
 	bool reach_boundary;
@@ -123,18 +263,26 @@ Vector tron(const ContinuousFunctions& c, const Vector& x0, const int maxEval, c
 	// while ((gnorm >= TOL) && (funcEval < maxEval) )
 	while ((funcEval <= maxEval) && search)
 	{
-		cg_iter = trcg(delta, c, g, x, s, r, &reach_boundary);
+		if (subsample)
+			sampleRows(n, max(sampleSize, 1), rows);
+		if (jacobi)
+			cg_iter = trpcg(delta, c, g, M, x, s, r, &reach_boundary, subsample ? &rows : NULL);
+		else
+			cg_iter = trcg(delta, c, g, x, s, r, &reach_boundary, subsample ? &rows : NULL);
 
 		xnew = x + s;
 
 		gs = g*s;
 		prered = -0.5*(gs-s*r);
-		c.eval(xnew, fnew, gnew);
+		if (jacobi)
+			c.evalHessianDiagonal(xnew, fnew, gnew, diagH);
+		else
+			c.eval(xnew, fnew, gnew);
 		// Compute the actual reduction.
 		actred = f - fnew;
 
 		// On the first iteration, adjust the initial step bound.
-		snorm = norm(s);
+		snorm = jacobi ? sqrt(uTMv(s, M, s)) : norm(s);
 		if (funcEval == 1)
 			delta = min(delta, snorm);
 
@@ -167,6 +315,8 @@ Vector tron(const ContinuousFunctions& c, const Vector& x0, const int maxEval, c
 			x = xnew;
 			f = fnew;
 			g = gnew;
+			if (jacobi)
+				jacobiPreconditioner(diagH, M);
 
 			gnorm = norm(g);
 			if (gnorm <= TOL*gnorm0)
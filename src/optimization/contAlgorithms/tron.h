@@ -30,8 +30,12 @@
 
 namespace jensen {
 
+// precondition: diagonal (Jacobi) preconditioned CG with the trust region in the norm of the preconditioner, for the
+// functions providing evalHessianDiagonal (plain CG otherwise).
+// hessianSample: subsampled Newton, the CG steps use the hessian of a random fraction hessianSample of the rows (drawn
+// anew every iteration, see prepareHessianSubsample), the gradient and the function values stay exact (1: the full hessian).
 Vector tron(const ContinuousFunctions& c, const Vector& x0, const int maxEval = 1000,
-            const double TOL = 1e-3, int verbosity = 1);
+            const double TOL = 1e-3, int verbosity = 1, const bool precondition = false, const double hessianSample = 1);
 
 }
 #endif
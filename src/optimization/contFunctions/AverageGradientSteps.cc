@@ -0,0 +1,106 @@
+// Copyright (C) Rishabh Iyer, John T. Halloran, and Kai Wei
+// Licensed under the Open Software License version 3.0
+// See COPYING or http://opensource.org/licenses/OSL-3.0
+/*
+        Jensen: A Convex Optimization And Machine Learning ToolKit
+ *	The state of the stochastic average gradient methods for the losses of linear models.
+        Author: Rishabh Iyer
+ *
+ */
+
+#include <algorithm>
+#include "AverageGradientSteps.h"
+
+using namespace std;
+
+namespace jensen {
+
+AverageGradientSteps::AverageGradientSteps(const AverageGradientMethod method, const double alpha) :
+	method(method), alpha(alpha), eta(0), mu(0), n(0), numSeen(0), A(0), scale(1) {
+}
+
+static double squaredNorm(const SparseFeature& f){
+	double sum = 0;
+	for (int k = 0; k < f.featureVec.size(); k++)
+		sum += f.featureVec[k]*f.featureVec[k];
+	return sum;
+}
+
+static double squaredNorm(const SparseRow& f){
+	double sum = 0;
+	for (int k = 0; k < f.featureVec.size(); k++)
+		sum += f.featureVec[k]*f.featureVec[k];
+	return sum;
+}
+
+static double squaredNorm(const DenseFeature& f){
+	double sum = 0;
+	for (int j = 0; j < f.featureVec.size(); j++)
+		sum += f.featureVec[j]*f.featureVec[j];
+	return sum;
+}
+
+template <class Features>
+void AverageGradientSteps::prepare(const Features& features, const int m, const double lambda, const double curvatureBound){
+	n = features.size();
+	mu = lambda/max(n, 1);
+	double maxNorm = 0;
+	for (int i = 0; i < n; i++)
+		maxNorm = max(maxNorm, squaredNorm(features[i]));
+	eta = alpha/(curvatureBound*maxNorm + mu);
+	numSeen = 0;
+	seen.assign(n, 0);
+	gradMemory.assign(n, 0);
+	d.assign(m, 0);
+	lastA.assign(m, 0);
+	A = 0;
+	scale = 1;
+}
+
+double AverageGradientSteps::margin(Vector& v, const DenseFeature& f){
+	double sum = 0;
+	for (int j = 0; j < f.numFeatures; j++) {
+		catchUp(v, j);
+		sum += v[j]*f.featureVec[j];
+	}
+	return scale*sum;
+}
+
+void AverageGradientSteps::update(Vector& v, const DenseFeature& f, const int i, const double g){
+	double delta = g - gradMemory[i];
+	gradMemory[i] = g;
+	if (method == AVERAGE_GRADIENT_SAG) {
+		if (!seen[i]) {
+			seen[i] = 1;
+			numSeen++;
+		}
+		for (int j = 0; j < f.numFeatures; j++)
+			d[j] += delta*f.featureVec[j];
+		shrink(v, numSeen);
+	}
+	else {
+		shrink(v, n);
+		double c = eta*delta/scale;
+		for (int j = 0; j < f.numFeatures; j++) {
+			catchUp(v, j);
+			v[j] -= c*f.featureVec[j];
+			d[j] += delta*f.featureVec[j];
+		}
+	}
+}
+
+void AverageGradientSteps::flush(Vector& v){
+	for (int j = 0; j < v.size(); j++) {
+		catchUp(v, j);
+		v[j] *= scale;
+		lastA[j] = 0;
+	}
+	A = 0;
+	scale = 1;
+}
+
+template void AverageGradientSteps::prepare(const vector<SparseFeature>&, const int, const double, const double);
+template void AverageGradientSteps::prepare(const vector<DenseFeature>&, const int, const double, const double);
+template void AverageGradientSteps::prepare(const SparseDataset&, const int, const double, const double);
+
+}
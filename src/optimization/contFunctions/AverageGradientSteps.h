@@ -0,0 +1,112 @@
+// Copyright (C) Rishabh Iyer, John T. Halloran, and Kai Wei
+// Licensed under the Open Software License version 3.0
+// See COPYING or http://opensource.org/licenses/OSL-3.0
+/*
+        Jensen: A Convex Optimization And Machine Learning ToolKit
+ *	The state of the stochastic average gradient methods SAG (Le Roux et al, 2012) and SAGA (Defazio
+        et al, 2014) for the l_2 regularized losses of linear models, (1/n) sum_i l_i(x^T f_i) + mu/2 ||x||^2
+        with mu = lambda/n. The gradient of l_i is l_i'(x^T f_i) f_i, hence one scalar g_i is kept per
+        sample together with the sum d = sum_i g_i f_i: O(n + m) memory instead of a gradient per sample.
+
+        A step only touches the coordinates of the sampled row (just-in-time updates). x is kept as
+        scale*v (the shrinking by 1 - eta*mu of every step only changes scale), and the step -eta/n d
+        of a coordinate j outside the row is deferred: d_j does not change until a row containing j
+        is sampled, so the missed steps sum to d_j (A - A_j), where A is the running sum of eta/(n scale)
+        and A_j its value at the last update of j. The vector handed to the loss is v; flush() folds
+        scale and the deferred steps back into it.
+        Author: Rishabh Iyer
+ *
+ */
+
+#ifndef AVERAGE_GRADIENT_STEPS_H
+#define AVERAGE_GRADIENT_STEPS_H
+
+#include <vector>
+#include "../../representation/Vector.h"
+#include "../../representation/SparseFeature.h"
+#include "../../representation/DenseFeature.h"
+#include "../../representation/SparseDataset.h"
+
+namespace jensen {
+
+enum AverageGradientMethod {
+	AVERAGE_GRADIENT_SAG,                 // the step uses the average of the stored gradients
+	AVERAGE_GRADIENT_SAGA                 // unbiased: the new gradient of the sample minus its stored one, plus the average
+};
+
+class AverageGradientSteps {
+protected:
+AverageGradientMethod method;
+double alpha;                 // the step size in units of 1/L, L the largest Lipschitz constant of the l_i
+double eta;                 // the step size
+double mu;                 // lambda/n
+int n;
+int numSeen;                 // SAG averages over the samples seen so far
+std::vector<char> seen;
+Vector gradMemory;                 // g_i
+Vector d;                 // sum_i g_i f_i
+Vector lastA;                 // A_j
+double A;
+double scale;
+void catchUp(Vector& v, const int j) {
+	v[j] -= d[j]*(A - lastA[j]);
+	lastA[j] = A;
+}
+void shrink(Vector& v, const double samples) {
+	scale *= 1 - eta*mu;
+	A += eta/(samples*scale);
+	if (scale < 1e-10)
+		flush(v);
+}
+public:
+AverageGradientSteps(const AverageGradientMethod method, const double alpha);
+// Sizes the memory and sets the step size alpha/L, with L = curvatureBound*max_i ||f_i||^2 + mu and curvatureBound >= l_i''.
+template <class Features>
+void prepare(const Features& features, const int m, const double lambda, const double curvatureBound);
+// Brings the coordinates of f up to date and returns x^T f.
+template <class Feature>
+double margin(Vector& v, const Feature& f) {
+	double sum = 0;
+	for (int k = 0; k < f.featureIndex.size(); k++) {
+		int j = f.featureIndex[k];
+		catchUp(v, j);
+		sum += v[j]*f.featureVec[k];
+	}
+	return scale*sum;
+}
+double margin(Vector& v, const DenseFeature& f);
+// Replaces the stored derivative of sample i (row f, after margin(v, f)) with g and takes the step.
+template <class Feature>
+void update(Vector& v, const Feature& f, const int i, const double g) {
+	double delta = g - gradMemory[i];
+	gradMemory[i] = g;
+	if (method == AVERAGE_GRADIENT_SAG) {
+		if (!seen[i]) {
+			seen[i] = 1;
+			numSeen++;
+		}
+		for (int k = 0; k < f.featureIndex.size(); k++)
+			d[f.featureIndex[k]] += delta*f.featureVec[k];
+		shrink(v, numSeen);
+	}
+	else {
+		shrink(v, n);
+		double c = eta*delta/scale;
+		for (int k = 0; k < f.featureIndex.size(); k++) {
+			int j = f.featureIndex[k];
+			catchUp(v, j);                 // this step with the old d_j
+			v[j] -= c*f.featureVec[k];
+			d[j] += delta*f.featureVec[k];
+		}
+	}
+}
+void update(Vector& v, const DenseFeature& f, const int i, const double g);
+// Applies the deferred steps and the scale to all coordinates, afterwards v = x.
+void flush(Vector& v);
+double stepSize() const {
+	return eta;
+}
+};
+
+}
+#endif
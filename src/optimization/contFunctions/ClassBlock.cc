@@ -0,0 +1,32 @@
+// Copyright (C) Rishabh Iyer, John T. Halloran, and Kai Wei
+// Licensed under the Open Software License version 3.0
+// See COPYING or http://opensource.org/licenses/OSL-3.0
+/*
+        Jensen: A Convex Optimization And Machine Learning ToolKit
+ *	Kernels of the multi-class losses
+        Author: Rishabh Iyer
+ *
+ */
+
+#include "ClassBlock.h"
+namespace jensen {
+
+Vector classWeights(const Vector& x, const int nClasses, const int c){
+	int numFeatures = x.size()/nClasses;
+	Vector w(numFeatures);
+	for (int j = 0; j < numFeatures; j++)
+		w[j] = x[(long int) j*nClasses + c];
+	return w;
+}
+
+Vector classMajorBlock(const std::vector<Vector>& w){
+	int K = w.size();
+	int numFeatures = (K > 0) ? w[0].size() : 0;
+	Vector x((long int) numFeatures*K);
+	for (int c = 0; c < K; c++)
+		for (int j = 0; j < numFeatures; j++)
+			x[(long int) j*K + c] = w[c][j];
+	return x;
+}
+
+}
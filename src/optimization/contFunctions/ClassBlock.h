@@ -0,0 +1,136 @@
+// Copyright (C) Rishabh Iyer, John T. Halloran, and Kai Wei
+// Licensed under the Open Software License version 3.0
+// See COPYING or http://opensource.org/licenses/OSL-3.0
+/*
+        Jensen: A Convex Optimization And Machine Learning ToolKit
+ *	Kernels of the multi-class losses, whose K weight vectors are stored as one m x K block: x[j*K + c]
+        is the weight of feature j in class c, so the K weights a non-zero of a row touches are contiguous
+        and the scores of all classes are computed in a single pass over the row.
+        Author: Rishabh Iyer
+ *
+ */
+
+#ifndef CLASS_BLOCK_H
+#define CLASS_BLOCK_H
+
+#include <math.h>
+#include <vector>
+#include "../../representation/Vector.h"
+#include "../../representation/DenseFeature.h"
+
+namespace jensen {
+
+// s[c] += x_c^T f for the K classes, one pass over the non-zeros of f.
+template <class Feature>
+inline void classScores(const Vector& x, const Feature& f, const int K, double* s){
+	for (int p = 0; p < f.featureIndex.size(); p++) {
+		const double* xj = &x[(long int) f.featureIndex[p]*K];
+		double v = f.featureVec[p];
+		for (int c = 0; c < K; c++)
+			s[c] += xj[c]*v;
+	}
+}
+
+inline void classScores(const Vector& x, const DenseFeature& f, const int K, double* s){
+	for (int j = 0; j < f.featureVec.size(); j++) {
+		const double* xj = &x[(long int) j*K];
+		double v = f.featureVec[j];
+		for (int c = 0; c < K; c++)
+			s[c] += xj[c]*v;
+	}
+}
+
+// g_c += coef[c]*f for the K classes, one pass over the non-zeros of f.
+template <class Feature>
+inline void classUpdate(Vector& g, const Feature& f, const int K, const double* coef){
+	for (int p = 0; p < f.featureIndex.size(); p++) {
+		double* gj = &g[(long int) f.featureIndex[p]*K];
+		double v = f.featureVec[p];
+		for (int c = 0; c < K; c++)
+			gj[c] += coef[c]*v;
+	}
+}
+
+inline void classUpdate(Vector& g, const DenseFeature& f, const int K, const double* coef){
+	for (int j = 0; j < f.featureVec.size(); j++) {
+		double* gj = &g[(long int) j*K];
+		double v = f.featureVec[j];
+		for (int c = 0; c < K; c++)
+			gj[c] += coef[c]*v;
+	}
+}
+
+// g_c += coef[c]*f and d_c += dcoef[c]*f.^2 for the K classes (a gradient and the diagonal of the hessian), one pass over f.
+template <class Feature>
+inline void classUpdateSquares(Vector& g, const double* coef, Vector& d, const double* dcoef, const Feature& f, const int K){
+	for (int p = 0; p < f.featureIndex.size(); p++) {
+		long int j = (long int) f.featureIndex[p]*K;
+		double v = f.featureVec[p];
+		for (int c = 0; c < K; c++) {
+			g[j + c] += coef[c]*v;
+			d[j + c] += dcoef[c]*v*v;
+		}
+	}
+}
+
+inline void classUpdateSquares(Vector& g, const double* coef, Vector& d, const double* dcoef, const DenseFeature& f, const int K){
+	for (int j = 0; j < f.featureVec.size(); j++) {
+		double v = f.featureVec[j];
+		for (int c = 0; c < K; c++) {
+			g[(long int) j*K + c] += coef[c]*v;
+			d[(long int) j*K + c] += dcoef[c]*v*v;
+		}
+	}
+}
+
+// s[c] = x_c^T f for the K columns of a block of numFeatures rows (e.g. a mapped model), the features of f beyond
+// numFeatures are skipped (as in featureProductCheck).
+template <class Feature>
+inline void blockScores(const double* x, const long int numFeatures, const int K, const Feature& f, double* s){
+	for (int c = 0; c < K; c++)
+		s[c] = 0;
+	for (int p = 0; p < f.featureIndex.size(); p++) {
+		int j = f.featureIndex[p];
+		if (j >= numFeatures)
+			continue;
+		const double* xj = x + (long int) j*K;
+		double v = f.featureVec[p];
+		for (int c = 0; c < K; c++)
+			s[c] += xj[c]*v;
+	}
+}
+
+inline void blockScores(const double* x, const long int numFeatures, const int K, const DenseFeature& f, double* s){
+	long int d = (numFeatures < (long int) f.featureVec.size()) ? numFeatures : f.featureVec.size();
+	for (int c = 0; c < K; c++)
+		s[c] = 0;
+	for (long int j = 0; j < d; j++) {
+		const double* xj = x + j*K;
+		double v = f.featureVec[j];
+		for (int c = 0; c < K; c++)
+			s[c] += xj[c]*v;
+	}
+}
+
+// The softmax probabilities p of the K scores s and the loss -log p[label] (computed stably). p may be s.
+inline double softmaxRow(const double* s, const int K, const int label, double* p){
+	double sLabel = s[label];
+	double smax = s[0];
+	for (int c = 1; c < K; c++)
+		smax = (s[c] > smax) ? s[c] : smax;
+	double sum = 0;
+	for (int c = 0; c < K; c++) {
+		p[c] = exp(s[c] - smax);
+		sum += p[c];
+	}
+	for (int c = 0; c < K; c++)
+		p[c] /= sum;
+	return log(sum) + smax - sLabel;
+}
+
+// The weights of class c in a block x, and the block of the K weight vectors w.
+Vector classWeights(const Vector& x, const int nClasses, const int c);
+Vector classMajorBlock(const std::vector<Vector>& w);
+
+}
+#endif
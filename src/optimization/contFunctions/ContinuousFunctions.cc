@@ -11,17 +11,23 @@
  */
 
 #include <iostream>
+#include <algorithm>
 using namespace std;
 
 #include "ContinuousFunctions.h"
+#include "../../utils/error.h"
+#include "../../utils/Threads.h"
 #define EPSILON 1e-6
+#define MIN_ROWS_PER_THREAD 1024
+#define GRADIENT_SLOTS 2                 // buffers per thread, see localGradient
 namespace jensen {
-ContinuousFunctions::ContinuousFunctions(bool isSmooth) : isSmooth(isSmooth){
+ContinuousFunctions::ContinuousFunctions(bool isSmooth) : isSmooth(isSmooth), nThreads(0), localThreads(1){
 	m = 0; n = 0;
 }
-ContinuousFunctions::ContinuousFunctions(bool isSmooth, int m, int n) : isSmooth(isSmooth), m(m), n(n){
+ContinuousFunctions::ContinuousFunctions(bool isSmooth, int m, int n) : isSmooth(isSmooth), m(m), n(n), nThreads(0), localThreads(1){
 }
-ContinuousFunctions::ContinuousFunctions(const ContinuousFunctions& c) : isSmooth(c.isSmooth), m(c.m), n(c.n) {
+ContinuousFunctions::ContinuousFunctions(const ContinuousFunctions& c) : isSmooth(c.isSmooth), m(c.m), n(c.n), nThreads(c.nThreads),
+	localThreads(1) {
 }
 
 ContinuousFunctions::~ContinuousFunctions(){
@@ -71,11 +77,114 @@ void ContinuousFunctions::evalHessianVectorProduct(const Vector& x, const Vector
 	Hxv = hessian*v;
 }
 
+bool ContinuousFunctions::prepareHessianSubsample() const {
+	return false;
+}
+
+void ContinuousFunctions::evalSubsampledHessianVectorProduct(const Vector& x, const Vector& v, Vector& Hxv,
+                                                             const std::vector<int>& rows) const {
+	error("ERROR: evalSubsampledHessianVectorProduct is not supported by this function, check prepareHessianSubsample first");
+}
+
+bool ContinuousFunctions::evalHessianDiagonal(const Vector& x, double& f, Vector& g, Vector& diagH) const {
+	return false;
+}
+
+bool ContinuousFunctions::evalDenseHessian(const Vector& x, double& f, Vector& g, Vector& H) const {
+	return false;
+}
+
+bool ContinuousFunctions::prepareDirection(const Vector& x, const Vector& d) const {
+	return false;
+}
+
+double ContinuousFunctions::evalAlongDirection(const double a) const {
+	error("ERROR: evalAlongDirection is not supported by this function, check prepareDirection first");
+	return 0;
+}
+
+bool ContinuousFunctions::prepareSparseSteps() const {
+	return false;
+}
+
+double ContinuousFunctions::sparseStochasticStep(Vector& x, const std::vector<int>& miniBatch, const SparseStepRule& rule) const {
+	error("ERROR: sparseStochasticStep is not supported by this function, check prepareSparseSteps first");
+	return 0;
+}
+
+bool ContinuousFunctions::prepareScaledSteps() const {
+	return false;
+}
+
+double ContinuousFunctions::scaledStochasticStep(ScaledVector& x, const std::vector<int>& miniBatch, const double alpha) const {
+	error("ERROR: scaledStochasticStep is not supported by this function, check prepareScaledSteps first");
+	return 0;
+}
+
+bool ContinuousFunctions::prepareAverageGradient(AverageGradientSteps& steps) const {
+	return false;
+}
+
+double ContinuousFunctions::averageGradientStep(Vector& x, const int i, AverageGradientSteps& steps) const {
+	error("ERROR: averageGradientStep is not supported by this function, check prepareAverageGradient first");
+	return 0;
+}
+
 double ContinuousFunctions::operator()(const Vector& x) const
 {
 	return eval(x);
 }
 
+void ContinuousFunctions::setNumThreads(int nThreads){
+	this->nThreads = nThreads;
+}
+
+int ContinuousFunctions::getNumThreads() const {
+	return nThreads;
+}
+
+int ContinuousFunctions::numThreads(long int rows) const {
+	return max(1L, min((long int) resolveThreads(nThreads), rows/MIN_ROWS_PER_THREAD));
+}
+
+// The buffer of slot s of thread t is threadGradients[t*GRADIENT_SLOTS + s].
+void ContinuousFunctions::reserveLocalGradients(int T) const {
+	if (threadGradients.size() < T*GRADIENT_SLOTS)
+		threadGradients.resize(T*GRADIENT_SLOTS);
+	localThreads = 1;
+}
+
+// The runtime may start fewer threads than requested (dynamic teams, a thread limit, or a call from within a parallel
+// region, where the nested region gets a single thread): the team size is recorded once per region, and only the buffers
+// of the threads that actually ran are zeroed and later summed.
+Vector& ContinuousFunctions::localGradient(Vector& g, int slot) const {
+	#pragma omp single
+	{
+		localThreads = teamSize();
+		if (threadGradients.size() < localThreads*GRADIENT_SLOTS)
+			threadGradients.resize(localThreads*GRADIENT_SLOTS);
+	}
+	int t = threadNum();
+	if (t == 0)
+		return g;
+	Vector& gt = threadGradients[t*GRADIENT_SLOTS + slot];
+	gt.assign(g.size(), 0);
+	return gt;
+}
+
+// T is the number of threads requested for the region, the buffers summed are those of the team that ran it.
+void ContinuousFunctions::sumLocalGradients(Vector& g, int T, int slot) const {
+	int team = min(T, localThreads);
+	if (team <= 1)
+		return;
+	int size = g.size();
+	#pragma omp parallel for schedule(static) num_threads(team)
+	for (int j = 0; j < size; j++) {
+		for (int t = 1; t < team; t++)
+			g[j] += threadGradients[t*GRADIENT_SLOTS + slot][j];
+	}
+}
+
 int ContinuousFunctions::size() const {  // number of features or dimension size
 	return m;
 }
@@ -17,6 +17,9 @@
 #include "../../representation/Matrix.h"
 #include "../../representation/VectorOperations.h"
 #include "../../representation/MatrixOperations.h"
+#include "SparseSteps.h"
+#include "AverageGradientSteps.h"
+#include "../../representation/ScaledVector.h"
 
 namespace jensen {
 
@@ -24,6 +27,19 @@ class ContinuousFunctions {
 protected:
 int n;                  // The number of convex functions added together, i.e if g(X) = \sum_{i = 1}^n f_i(x)
 int m;                 // Dimension of vectors or features (i.e. size of x in f(x))
+int nThreads;                 // threads of the parallel evaluations (0: the OpenMP default)
+mutable std::vector<Vector> threadGradients;                 // gradient buffers of threads 1, 2, ... (thread 0 accumulates into g)
+mutable int localThreads;                 // the size of the team of the last region that called localGradient
+// Row-partitioned parallel evaluation: numThreads(rows) is the number of threads for a loop over the given number
+// of rows (1 for small loops). Within "#pragma omp parallel num_threads(T)", localGradient(g) is the buffer the calling
+// thread accumulates its rows into (g itself on thread 0, a zeroed buffer otherwise), sumLocalGradients(g, T) then
+// adds the buffers of the threads the region actually ran with to g. reserveLocalGradients(T) has to be called before the
+// parallel region, and every thread of the region has to call localGradient (it synchronizes the team). A loop accumulating two
+// vectors in the same pass (e.g. the gradient and the diagonal of the hessian) uses slot 1 for the second.
+int numThreads(long int rows) const;
+void reserveLocalGradients(int T) const;
+Vector& localGradient(Vector& g, int slot = 0) const;
+void sumLocalGradients(Vector& g, int T, int slot = 0) const;
 public:
 bool isSmooth;
 ContinuousFunctions(bool isSmooth);
@@ -39,8 +55,40 @@ virtual Vector evalStochasticGradient(const Vector& x, std::vector<int>& batch)
 virtual void evalStochastic(const Vector& x, double& f, Vector& g, std::vector<int>& miniBatch) const;                 // stochastic combined evaluation
 virtual Matrix evalHessian(const Vector& x) const;                      // hessianEval
 virtual void evalHessianVectorProduct(const Vector& x, const Vector& v, Vector& Hxv) const;                 // evaluate a product between a hessian and a vector
+// Subsampled Newton: if prepareHessianSubsample returns true, evalSubsampledHessianVectorProduct gives the product with the
+// hessian at x estimated from the rows only (ascending), i.e. the regularizer plus n/|rows| times the sum over the rows, an
+// unbiased estimate of evalHessianVectorProduct. The default returns false.
+virtual bool prepareHessianSubsample() const;
+virtual void evalSubsampledHessianVectorProduct(const Vector& x, const Vector& v, Vector& Hxv, const std::vector<int>& rows) const;
+// Diagonal (Jacobi) preconditioning: if evalHessianDiagonal returns true, it computes f and the gradient as eval(x, f, g) and
+// the diagonal of the hessian at x in the same pass over the data. The default returns false, i.e. no preconditioner.
+virtual bool evalHessianDiagonal(const Vector& x, double& f, Vector& g, Vector& diagH) const;
+// Newton steps on problems of small dimension: if evalDenseHessian returns true, it computes f and the gradient as eval(x, f, g)
+// and the hessian at x as an m x m row-major array in H (H[i*m + j], see DenseLinearAlgebra.h). The default returns false, i.e.
+// the hessian is only available as the Matrix of evalHessian.
+virtual bool evalDenseHessian(const Vector& x, double& f, Vector& g, Vector& H) const;
+// Line searches along x - a*d: if prepareDirection returns true, evalAlongDirection(a) gives f(x - a*d) without a pass over
+// the data (losses of linear models keep the margins of x and d). The default returns false, i.e. use eval(x - a*d).
+virtual bool prepareDirection(const Vector& x, const Vector& d) const;
+virtual double evalAlongDirection(const double a) const;
+// Lock-free stochastic steps (see SparseSteps.h): if prepareSparseSteps returns true, sparseStochasticStep applies the steps of
+// the rows of miniBatch to x in place, touching only their coordinates, and may run concurrently on the same x. It returns the
+// loss of these rows. The default returns false, i.e. the function only supports the dense evalStochastic.
+virtual bool prepareSparseSteps() const;
+virtual double sparseStochasticStep(Vector& x, const std::vector<int>& miniBatch, const SparseStepRule& rule) const;
+// Stochastic gradient steps on scaled weights (see ScaledVector.h): if prepareScaledSteps returns true, the regularizer is
+// lambda/2 ||x||^2 and scaledStochasticStep applies x = x - alpha*g, g the stochastic gradient of miniBatch (as evalStochastic),
+// as a scaling of x plus updates of the coordinates of the rows only. It returns the loss of these rows. The default returns false.
+virtual bool prepareScaledSteps() const;
+virtual double scaledStochasticStep(ScaledVector& x, const std::vector<int>& miniBatch, const double alpha) const;
+// Stochastic average gradient steps (see AverageGradientSteps.h): if prepareAverageGradient returns true, averageGradientStep
+// takes the SAG or SAGA step of sample i, keeping a single scalar per sample, and returns its loss. The default returns false.
+virtual bool prepareAverageGradient(AverageGradientSteps& steps) const;
+virtual double averageGradientStep(Vector& x, const int i, AverageGradientSteps& steps) const;
 double operator()(const Vector& x) const;
 
+void setNumThreads(int nThreads);                 // threads used by eval, the gradients and the hessian vector products
+int getNumThreads() const;
 int size() const;                 // number of features or dimension size (m)
 int length() const;                 // number of convex functions adding up (n)
 };
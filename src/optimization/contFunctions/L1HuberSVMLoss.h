@@ -23,12 +23,12 @@ namespace jensen {
 template <class Feature>
 class L1HuberSVMLoss : public ContinuousFunctions {
 protected:
-std::vector<Feature>& features;                 // size of features is number of trainins examples (n)
+typename FeatureSet<Feature>::type& features;                 // size of features is number of trainins examples (n)
 Vector& y;                 // size of y is number of training examples (n)
 double thresh;
 double lambda;                 // regularization coefficient for L2 regularization
 public:
-L1HuberSVMLoss(int numFeatures, std::vector<Feature>& features, Vector& y, double thresh, double lambda);
+L1HuberSVMLoss(int numFeatures, typename FeatureSet<Feature>::type& features, Vector& y, double thresh, double lambda);
 L1HuberSVMLoss(const L1HuberSVMLoss& c);         // copy constructor
 
 ~L1HuberSVMLoss();
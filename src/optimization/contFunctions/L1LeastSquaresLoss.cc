@@ -21,7 +21,7 @@ using namespace std;
 #define MAX 1e2
 namespace jensen {
 template <class Feature>
-L1LeastSquaresLoss<Feature>::L1LeastSquaresLoss(int m, std::vector<Feature>& features, Vector& y, double lambda) :
+L1LeastSquaresLoss<Feature>::L1LeastSquaresLoss(int m, typename FeatureSet<Feature>::type& features, Vector& y, double lambda) :
 	ContinuousFunctions(true, m, features.size()), features(features), y(y), lambda(lambda)
 {
 	if (n > 0)
@@ -31,7 +31,7 @@ L1LeastSquaresLoss<Feature>::L1LeastSquaresLoss(int m, std::vector<Feature>& fea
 
 template <class Feature>
 L1LeastSquaresLoss<Feature>::L1LeastSquaresLoss(const L1LeastSquaresLoss& l) :
-	ContinuousFunctions(true, l.m, l.n), features(l.features), y(l.y), lambda(l.lambda) {
+	ContinuousFunctions(l), features(l.features), y(l.y), lambda(l.lambda) {
 }
 
 template <class Feature>
@@ -42,6 +42,7 @@ template <class Feature>
 double L1LeastSquaresLoss<Feature>::eval(const Vector& x) const {
 	assert(x.size() == m);
 	double sum = lambda * norm(x, 1);
+	#pragma omp parallel for schedule(static) num_threads(numThreads(n)) reduction(+:sum)
 	for (int i = 0; i < n; i++) {
 		sum += (y[i] - (x*features[i]))*(y[i] - (x*features[i]));
 	}
@@ -52,9 +53,17 @@ template <class Feature>
 Vector L1LeastSquaresLoss<Feature>::evalGradient(const Vector& x) const {
 	assert(x.size() == m);
 	Vector g = Vector(m, 0);
-	for (int i = 0; i < n; i++) {
-		g -= 2*(y[i] - (x*features[i]))*features[i];
+	int T = numThreads(n);
+	reserveLocalGradients(T);
+	#pragma omp parallel num_threads(T)
+	{
+		Vector& gt = localGradient(g);
+		#pragma omp for schedule(static)
+		for (int i = 0; i < n; i++) {
+			featureMultiplySubtract(gt, 2*(y[i] - (x*features[i])), features[i]);
+		}
 	}
+	sumLocalGradients(g, T);
 	for (int i = 0; i < m; i++)
 	{
 		if (x[i] != 0)
@@ -76,13 +85,22 @@ template <class Feature>
 void L1LeastSquaresLoss<Feature>::eval(const Vector& x, double& f, Vector& g) const {
 	assert(x.size() == m);
 	g = Vector(m, 0);
-	f = lambda*norm(x, 1);
+	double sum = lambda*norm(x, 1);
 	double val;
-	for (int i = 0; i < n; i++) {
-		double val = y[i] - (x*features[i]);
-		f += val*val;
-		g -= 2*val*features[i];
+	int T = numThreads(n);
+	reserveLocalGradients(T);
+	#pragma omp parallel num_threads(T) reduction(+:sum)
+	{
+		Vector& gt = localGradient(g);
+		#pragma omp for schedule(static)
+		for (int i = 0; i < n; i++) {
+			double val = y[i] - (x*features[i]);
+			sum += val*val;
+			featureMultiplySubtract(gt, 2*val, features[i]);
+		}
 	}
+	sumLocalGradients(g, T);
+	f = sum;
 	for (int i = 0; i < m; i++)
 	{
 		if (x[i] != 0)
@@ -100,15 +118,44 @@ void L1LeastSquaresLoss<Feature>::eval(const Vector& x, double& f, Vector& g) co
 	return;
 }
 
+template <class Feature>
+bool L1LeastSquaresLoss<Feature>::prepareSparseSteps() const {
+	sparseSteps.prepare(features, m, true);
+	return true;
+}
+
+template <class Feature>
+double L1LeastSquaresLoss<Feature>::sparseStochasticStep(Vector& x, const std::vector<int>& miniBatch, const SparseStepRule& rule) const {
+	double sum = 0;
+	double regScale = lambda*n/miniBatch.size();
+	for (int k = 0; k < miniBatch.size(); k++) {
+		int i = miniBatch[k];
+		double val = y[i] - (x*features[i]);
+		sum += val*val;
+		sparseSteps.apply(x, features[i], -2*val, regScale, rule);
+	}
+	return sum;
+}
+
 template <class Feature>
 Vector L1LeastSquaresLoss<Feature>::evalStochasticGradient(const Vector& x, std::vector<int>& miniBatch) const {
 	assert(x.size() == m);
 	Vector g = Vector(m, 0);
 	double val;
-	for (vector<int>::iterator it = miniBatch.begin(); it != miniBatch.end(); it++) {
-		double val = y[*it] - (x*features[*it]);
-		g -= 2*val*features[*it];
+	int batchSize = miniBatch.size();
+	int T = numThreads(batchSize);
+	reserveLocalGradients(T);
+	#pragma omp parallel num_threads(T)
+	{
+		Vector& gt = localGradient(g);
+		#pragma omp for schedule(static)
+		for (int k = 0; k < batchSize; k++) {
+			int i = miniBatch[k];
+			double val = y[i] - (x*features[i]);
+			featureMultiplySubtract(gt, 2*val, features[i]);
+		}
 	}
+	sumLocalGradients(g, T);
 	for (int i = 0; i < m; i++)
 	{
 		if (x[i] != 0)
@@ -130,14 +177,23 @@ template <class Feature>
 void L1LeastSquaresLoss<Feature>::evalStochastic(const Vector& x, double& f, Vector& g, std::vector<int>& miniBatch) const {
 	assert(x.size() == m);
 	g = Vector(m, 0);
-	f = lambda*norm(x, 1);
-	for (vector<int>::iterator it = miniBatch.begin(); it != miniBatch.end(); it++) {
-		for (vector<int>::iterator it = miniBatch.begin(); it != miniBatch.end(); it++) {
-			double val = y[*it] - (x*features[*it]);
-			f += val*val;
-			g -= 2*val*features[*it];
+	double sum = lambda*norm(x, 1);
+	int batchSize = miniBatch.size();
+	int T = numThreads(batchSize);
+	reserveLocalGradients(T);
+	#pragma omp parallel num_threads(T) reduction(+:sum)
+	{
+		Vector& gt = localGradient(g);
+		#pragma omp for schedule(static)
+		for (int k = 0; k < batchSize; k++) {
+			int i = miniBatch[k];
+			double val = y[i] - (x*features[i]);
+			sum += val*val;
+			featureMultiplySubtract(gt, 2*val, features[i]);
 		}
 	}
+	sumLocalGradients(g, T);
+	f = sum;
 	for (int i = 0; i < m; i++)
 	{
 		if (x[i] != 0)
@@ -156,5 +212,6 @@ void L1LeastSquaresLoss<Feature>::evalStochastic(const Vector& x, double& f, Vec
 }
 template class L1LeastSquaresLoss<SparseFeature>;
 template class L1LeastSquaresLoss<DenseFeature>;
+template class L1LeastSquaresLoss<SparseRow>;
 
 }
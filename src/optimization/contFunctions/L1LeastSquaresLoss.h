@@ -24,11 +24,12 @@ namespace jensen {
 template <class Feature>
 class L1LeastSquaresLoss : public ContinuousFunctions {
 protected:
-std::vector<Feature>& features;                 // size of features is number of trainins examples (n)
+typename FeatureSet<Feature>::type& features;                 // size of features is number of trainins examples (n)
 Vector& y;                 // size of y is number of training examples (n)
 double lambda;                 // regularization parameter
+mutable SparseSteps sparseSteps;                 // feature counts of the lock-free stochastic steps
 public:
-L1LeastSquaresLoss(int numFeatures, std::vector<Feature>& features, Vector& y, double lambda);
+L1LeastSquaresLoss(int numFeatures, typename FeatureSet<Feature>::type& features, Vector& y, double lambda);
 L1LeastSquaresLoss(const L1LeastSquaresLoss& c);         // copy constructor
 
 ~L1LeastSquaresLoss();
@@ -36,6 +37,8 @@ L1LeastSquaresLoss(const L1LeastSquaresLoss& c);         // copy constructor
 double eval(const Vector& x) const;                 // functionEval
 Vector evalGradient(const Vector& x) const;                 // gradientEval
 void eval(const Vector& x, double& f, Vector& gradient) const;                 // combined function and gradient eval
+bool prepareSparseSteps() const;
+double sparseStochasticStep(Vector& x, const std::vector<int>& miniBatch, const SparseStepRule& rule) const;                 // lock-free step on the rows of miniBatch
 Vector evalStochasticGradient(const Vector& x, std::vector<int>& miniBatch) const;                 // stochastic gradient
 void evalStochastic(const Vector& x, double& f, Vector& g, std::vector<int>& miniBatch) const;                 // stochastic evaluation
 };
@@ -20,7 +20,7 @@ using namespace std;
 #define MAX 1e2
 namespace jensen {
 template <class Feature>
-L1LogisticLoss<Feature>::L1LogisticLoss(int m, std::vector<Feature>& features, Vector& y, double lambda) :
+L1LogisticLoss<Feature>::L1LogisticLoss(int m, typename FeatureSet<Feature>::type& features, Vector& y, double lambda) :
 	ContinuousFunctions(true, m, features.size()), features(features), y(y), lambda(lambda)
 {
 	if (n > 0)
@@ -30,7 +30,7 @@ L1LogisticLoss<Feature>::L1LogisticLoss(int m, std::vector<Feature>& features, V
 
 template <class Feature>
 L1LogisticLoss<Feature>::L1LogisticLoss(const L1LogisticLoss& l) :
-	ContinuousFunctions(true, l.m, l.n), features(l.features), y(l.y), lambda(l.lambda) {
+	ContinuousFunctions(l), features(l.features), y(l.y), lambda(l.lambda) {
 }
 
 template <class Feature>
@@ -41,12 +41,13 @@ template <class Feature>
 double L1LogisticLoss<Feature>::eval(const Vector& x) const {
 	assert(x.size() == m);
 	double sum = lambda*norm(x, 1);
+	#pragma omp parallel for schedule(static) num_threads(numThreads(n)) reduction(+:sum)
 	for (int i = 0; i < n; i++) {
 		double preval = y[i]*(x*features[i]);
 		if (preval > MAX)
 			continue;
 		else if (preval < -1*MAX)
-			sum += preval;
+			sum -= preval;
 		else
 			sum += log(1 + exp(-preval));
 	}
@@ -57,15 +58,23 @@ template <class Feature>
 Vector L1LogisticLoss<Feature>::evalGradient(const Vector& x) const {
 	assert(x.size() == m);
 	Vector g = Vector(m, 0);
-	for (int i = 0; i < n; i++) {
-		double preval = y[i]*(x*features[i]);
-		if (preval > MAX)
-			g -= y[i]*features[i];
-		else if (preval < -1*MAX)
-			continue;
-		else
-			g -= (y[i]/(1 + exp(-preval)))*features[i];
+	int T = numThreads(n);
+	reserveLocalGradients(T);
+	#pragma omp parallel num_threads(T)
+	{
+		Vector& gt = localGradient(g);
+		#pragma omp for schedule(static)
+		for (int i = 0; i < n; i++) {
+			double preval = y[i]*(x*features[i]);
+			if (preval > MAX)
+				featureMultiplySubtract(gt, y[i], features[i]);
+			else if (preval < -1*MAX)
+				continue;
+			else
+				featureMultiplySubtract(gt, y[i]/(1 + exp(-preval)), features[i]);
+		}
 	}
+	sumLocalGradients(g, T);
 	for (int i = 0; i < m; i++)
 	{
 		if (x[i] != 0)
@@ -87,22 +96,31 @@ template <class Feature>
 void L1LogisticLoss<Feature>::eval(const Vector& x, double& f, Vector& g) const {
 	assert(x.size() == m);
 	g = Vector(m, 0);
-	f = lambda*norm(x, 1);
+	double sum = lambda*norm(x, 1);
 	double val;
-	for (int i = 0; i < n; i++) {
-		double preval = y[i]*(x*features[i]);
-		if (preval > MAX) {
-			g -= (y[i]/(1 + exp(preval)))*features[i];
-		}
-		else if (preval < -1*MAX) {
-			g -= (y[i]/(1 + exp(preval)))*features[i];
-			f-=preval;
-		}
-		else{
-			f += log(1 + exp(-preval));
-			g -= (y[i]/(1 + exp(preval)))*features[i];
+	int T = numThreads(n);
+	reserveLocalGradients(T);
+	#pragma omp parallel num_threads(T) reduction(+:sum)
+	{
+		Vector& gt = localGradient(g);
+		#pragma omp for schedule(static)
+		for (int i = 0; i < n; i++) {
+			double preval = y[i]*(x*features[i]);
+			if (preval > MAX) {
+				featureMultiplySubtract(gt, y[i]/(1 + exp(preval)), features[i]);
+			}
+			else if (preval < -1*MAX) {
+				featureMultiplySubtract(gt, y[i]/(1 + exp(preval)), features[i]);
+				sum-=preval;
+			}
+			else{
+				sum += log(1 + exp(-preval));
+				featureMultiplySubtract(gt, y[i]/(1 + exp(preval)), features[i]);
+			}
 		}
 	}
+	sumLocalGradients(g, T);
+	f = sum;
 	for (int i = 0; i < m; i++)
 	{
 		if (x[i] != 0)
@@ -121,18 +139,72 @@ void L1LogisticLoss<Feature>::eval(const Vector& x, double& f, Vector& g) const
 }
 
 template <class Feature>
-Vector L1LogisticLoss<Feature>::evalStochasticGradient(const Vector& x, std::vector<int>& miniBatch) const {
-	assert(x.size() == m);
-	Vector g = Vector(m, 0);
-	for (vector<int>::iterator it = miniBatch.begin(); it != miniBatch.end(); it++) {
-		double preval = y[*it]*(x*features[*it]);
+bool L1LogisticLoss<Feature>::prepareDirection(const Vector& x, const Vector& d) const {
+	lineSearch.prepare(features, y, x, d, numThreads(n));
+	return true;
+}
+
+template <class Feature>
+double L1LogisticLoss<Feature>::evalAlongDirection(const double a) const {
+	double sum = lambda*lineSearch.l1Norm(a);
+	#pragma omp parallel for schedule(static) num_threads(numThreads(n)) reduction(+:sum)
+	for (int i = 0; i < n; i++) {
+		double preval = lineSearch.margin(i, a);
 		if (preval > MAX)
-			g -= y[*it]*features[*it];
-		else if (preval < -1*MAX)
 			continue;
+		else if (preval < -1*MAX)
+			sum -= preval;
 		else
-			g -= (y[*it]/(1 + exp(-preval)))*features[*it];
+			sum += log(1 + exp(-preval));
 	}
+	return sum;
+}
+
+template <class Feature>
+bool L1LogisticLoss<Feature>::prepareSparseSteps() const {
+	sparseSteps.prepare(features, m, true);
+	return true;
+}
+
+template <class Feature>
+double L1LogisticLoss<Feature>::sparseStochasticStep(Vector& x, const std::vector<int>& miniBatch, const SparseStepRule& rule) const {
+	double sum = 0;
+	double regScale = lambda*n/miniBatch.size();
+	for (int k = 0; k < miniBatch.size(); k++) {
+		int i = miniBatch[k];
+		double preval = y[i]*(x*features[i]);
+		if (preval < -1*MAX)
+			sum -= preval;
+		else if (preval <= MAX)
+			sum += log(1 + exp(-preval));
+		sparseSteps.apply(x, features[i], -y[i]/(1 + exp(preval)), regScale, rule);
+	}
+	return sum;
+}
+
+template <class Feature>
+Vector L1LogisticLoss<Feature>::evalStochasticGradient(const Vector& x, std::vector<int>& miniBatch) const {
+	assert(x.size() == m);
+	Vector g = Vector(m, 0);
+	int batchSize = miniBatch.size();
+	int T = numThreads(batchSize);
+	reserveLocalGradients(T);
+	#pragma omp parallel num_threads(T)
+	{
+		Vector& gt = localGradient(g);
+		#pragma omp for schedule(static)
+		for (int k = 0; k < batchSize; k++) {
+			int i = miniBatch[k];
+			double preval = y[i]*(x*features[i]);
+			if (preval > MAX)
+				featureMultiplySubtract(gt, y[i], features[i]);
+			else if (preval < -1*MAX)
+				continue;
+			else
+				featureMultiplySubtract(gt, y[i]/(1 + exp(-preval)), features[i]);
+		}
+	}
+	sumLocalGradients(g, T);
 	for (int i = 0; i < m; i++)
 	{
 		if (x[i] != 0)
@@ -154,22 +226,33 @@ template <class Feature>
 void L1LogisticLoss<Feature>::evalStochastic(const Vector& x, double& f, Vector& g, std::vector<int>& miniBatch) const {
 	assert(x.size() == m);
 	g = Vector(m, 0);
-	f = lambda*norm(x, 1);
+	double sum = lambda*norm(x, 1);
 	double val;
-	for (vector<int>::iterator it = miniBatch.begin(); it != miniBatch.end(); it++) {
-		double preval = y[*it]*(x*features[*it]);
-		if (preval > MAX) {
-			g -= (y[*it]/(1 + exp(preval)))*features[*it];
-		}
-		else if (preval < -1*MAX) {
-			g -= (y[*it]/(1 + exp(preval)))*features[*it];
-			f-=preval;
-		}
-		else{
-			f += log(1 + exp(-preval));
-			g -= (y[*it]/(1 + exp(preval)))*features[*it];
+	int batchSize = miniBatch.size();
+	int T = numThreads(batchSize);
+	reserveLocalGradients(T);
+	#pragma omp parallel num_threads(T) reduction(+:sum)
+	{
+		Vector& gt = localGradient(g);
+		#pragma omp for schedule(static)
+		for (int k = 0; k < batchSize; k++) {
+			int i = miniBatch[k];
+			double preval = y[i]*(x*features[i]);
+			if (preval > MAX) {
+				featureMultiplySubtract(gt, y[i]/(1 + exp(preval)), features[i]);
+			}
+			else if (preval < -1*MAX) {
+				featureMultiplySubtract(gt, y[i]/(1 + exp(preval)), features[i]);
+				sum-=preval;
+			}
+			else{
+				sum += log(1 + exp(-preval));
+				featureMultiplySubtract(gt, y[i]/(1 + exp(preval)), features[i]);
+			}
 		}
 	}
+	sumLocalGradients(g, T);
+	f = sum;
 	for (int i = 0; i < m; i++)
 	{
 		if (x[i] != 0)
@@ -188,4 +271,5 @@ void L1LogisticLoss<Feature>::evalStochastic(const Vector& x, double& f, Vector&
 }
 template class L1LogisticLoss<SparseFeature>;
 template class L1LogisticLoss<DenseFeature>;
+template class L1LogisticLoss<SparseRow>;
 }
@@ -15,17 +15,20 @@
 #include "../../representation/Matrix.h"
 #include "../../representation/VectorOperations.h"
 #include "ContinuousFunctions.h"
+#include "LineSearchMargins.h"
 #include "../../utils/utils.h"
 
 namespace jensen {
 template <class Feature>
 class L1LogisticLoss : public ContinuousFunctions {
 protected:
-std::vector<Feature>& features;                 // size of features is number of trainins examples (n)
+typename FeatureSet<Feature>::type& features;                 // size of features is number of trainins examples (n)
 Vector& y;                 // size of y is number of training examples (n)
 double lambda;
+mutable SparseSteps sparseSteps;                 // feature counts of the lock-free stochastic steps
+mutable LineSearchMargins lineSearch;                 // margins along the direction of the current line search
 public:
-L1LogisticLoss(int numFeatures, std::vector<Feature>& features, Vector& y, double lambda);
+L1LogisticLoss(int numFeatures, typename FeatureSet<Feature>::type& features, Vector& y, double lambda);
 L1LogisticLoss(const L1LogisticLoss& c);         // copy constructor
 
 ~L1LogisticLoss();
@@ -33,6 +36,10 @@ L1LogisticLoss(const L1LogisticLoss& c);         // copy constructor
 double eval(const Vector& x) const;                 // functionEval
 Vector evalGradient(const Vector& x) const;                 // gradientEval
 void eval(const Vector& x, double& f, Vector& gradient) const;                 // combined function and gradient eval
+bool prepareDirection(const Vector& x, const Vector& d) const;                 // margins of x and d for a line search along x - a*d
+double evalAlongDirection(const double a) const;                 // f(x - a*d) in O(n + m)
+bool prepareSparseSteps() const;
+double sparseStochasticStep(Vector& x, const std::vector<int>& miniBatch, const SparseStepRule& rule) const;                 // lock-free step on the rows of miniBatch
 Vector evalStochasticGradient(const Vector& x, std::vector<int>& miniBatch) const;                 // stochastic gradient
 void evalStochastic(const Vector& x, double& f, Vector& g, std::vector<int>& miniBatch) const;                 // stochastic evaluation
 };
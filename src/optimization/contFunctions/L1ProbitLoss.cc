@@ -25,7 +25,7 @@ using namespace std;
 
 namespace jensen {
 template <class Feature>
-L1ProbitLoss<Feature>::L1ProbitLoss(int m, std::vector<Feature>& features, Vector& y, double lambda) :
+L1ProbitLoss<Feature>::L1ProbitLoss(int m, typename FeatureSet<Feature>::type& features, Vector& y, double lambda) :
 	ContinuousFunctions(true, m, features.size()), features(features), y(y), lambda(lambda)
 {
 	if (n > 0)
@@ -35,7 +35,7 @@ L1ProbitLoss<Feature>::L1ProbitLoss(int m, std::vector<Feature>& features, Vecto
 
 template <class Feature>
 L1ProbitLoss<Feature>::L1ProbitLoss(const L1ProbitLoss& l) :
-	ContinuousFunctions(true, l.m, l.n), features(l.features), y(l.y), lambda(l.lambda) {
+	ContinuousFunctions(l), features(l.features), y(l.y), lambda(l.lambda) {
 }
 
 template <class Feature>
@@ -46,6 +46,7 @@ template <class Feature>
 double L1ProbitLoss<Feature>::eval(const Vector& x) const {
 	assert(x.size() == m);
 	double sum = lambda*norm(x, 1);
+	#pragma omp parallel for schedule(static) num_threads(numThreads(n)) reduction(+:sum)
 	for (int i = 0; i < n; i++) {
 		double val = y[i]*(x*features[i])/sqrt(2);
 		double probitval = (1/2)*(1 + erf(val))+EPSILON;
@@ -58,12 +59,20 @@ template <class Feature>
 Vector L1ProbitLoss<Feature>::evalGradient(const Vector& x) const {
 	assert(x.size() == m);
 	Vector g = Vector(m, 0);
-	for (int i = 0; i < n; i++) {
-		double val = y[i]*(x*features[i])/sqrt(2);
-		double normval = (1/sqrt(2*M_PI))*exp(-(val*val));
-		double probitval = (1/2)*(1 + erf(val))+EPSILON;
-		g -= features[i]*(y[i]*normval/probitval);
+	int T = numThreads(n);
+	reserveLocalGradients(T);
+	#pragma omp parallel num_threads(T)
+	{
+		Vector& gt = localGradient(g);
+		#pragma omp for schedule(static)
+		for (int i = 0; i < n; i++) {
+			double val = y[i]*(x*features[i])/sqrt(2);
+			double normval = (1/sqrt(2*M_PI))*exp(-(val*val));
+			double probitval = (1/2)*(1 + erf(val))+EPSILON;
+			featureMultiplySubtract(gt, y[i]*normval/probitval, features[i]);
+		}
 	}
+	sumLocalGradients(g, T);
 	for (int i = 0; i < m; i++)
 	{
 		if (x[i] != 0)
@@ -85,14 +94,23 @@ template <class Feature>
 void L1ProbitLoss<Feature>::eval(const Vector& x, double& f, Vector& g) const {
 	assert(x.size() == m);
 	g = Vector(m, 0);
-	f = lambda*norm(x, 1);
-	for (int i = 0; i < n; i++) {
-		double val = y[i]*(x*features[i])/sqrt(2);
-		double normval = (1/sqrt(2*M_PI))*exp(-(val*val));
-		double probitval = 0.5*(1 + erf(val))+EPSILON;
-		g -= features[i]*(y[i]*normval/probitval);
-		f -= log(probitval);
+	double sum = lambda*norm(x, 1);
+	int T = numThreads(n);
+	reserveLocalGradients(T);
+	#pragma omp parallel num_threads(T) reduction(+:sum)
+	{
+		Vector& gt = localGradient(g);
+		#pragma omp for schedule(static)
+		for (int i = 0; i < n; i++) {
+			double val = y[i]*(x*features[i])/sqrt(2);
+			double normval = (1/sqrt(2*M_PI))*exp(-(val*val));
+			double probitval = 0.5*(1 + erf(val))+EPSILON;
+			featureMultiplySubtract(gt, y[i]*normval/probitval, features[i]);
+			sum -= log(probitval);
+		}
 	}
+	sumLocalGradients(g, T);
+	f = sum;
 	for (int i = 0; i < m; i++)
 	{
 		if (x[i] != 0)
@@ -115,12 +133,22 @@ Vector L1ProbitLoss<Feature>::evalStochasticGradient(const Vector& x, std::vecto
 	assert(x.size() == m);
 	Vector g = Vector(m, 0);
 	double val;
-	for (vector<int>::iterator it = miniBatch.begin(); it != miniBatch.end(); it++) {
-		double val = y[*it]*(x*features[*it])/sqrt(2);
-		double normval = (1/sqrt(2*M_PI))*exp(-(val*val));
-		double probitval = (1/2)*(1 + erf(val))+EPSILON;
-		g -= features[*it]*(y[*it]*normval/probitval);
+	int batchSize = miniBatch.size();
+	int T = numThreads(batchSize);
+	reserveLocalGradients(T);
+	#pragma omp parallel num_threads(T)
+	{
+		Vector& gt = localGradient(g);
+		#pragma omp for schedule(static)
+		for (int k = 0; k < batchSize; k++) {
+			int i = miniBatch[k];
+			double val = y[i]*(x*features[i])/sqrt(2);
+			double normval = (1/sqrt(2*M_PI))*exp(-(val*val));
+			double probitval = (1/2)*(1 + erf(val))+EPSILON;
+			featureMultiplySubtract(gt, y[i]*normval/probitval, features[i]);
+		}
 	}
+	sumLocalGradients(g, T);
 	for (int i = 0; i < m; i++)
 	{
 		if (x[i] != 0)
@@ -142,14 +170,25 @@ template <class Feature>
 void L1ProbitLoss<Feature>::evalStochastic(const Vector& x, double& f, Vector& g, std::vector<int>& miniBatch) const {
 	assert(x.size() == m);
 	g = Vector(m, 0);
-	f = lambda*norm(x, 1);
-	for (vector<int>::iterator it = miniBatch.begin(); it != miniBatch.end(); it++) {
-		double val = y[*it]*(x*features[*it])/sqrt(2);
-		double normval = (1/sqrt(2*M_PI))*exp(-(val*val));
-		double probitval = (1/2)*(1 + erf(val))+EPSILON;
-		g -= features[*it]*(y[*it]*normval/probitval);
-		f -= log(probitval);
+	double sum = lambda*norm(x, 1);
+	int batchSize = miniBatch.size();
+	int T = numThreads(batchSize);
+	reserveLocalGradients(T);
+	#pragma omp parallel num_threads(T) reduction(+:sum)
+	{
+		Vector& gt = localGradient(g);
+		#pragma omp for schedule(static)
+		for (int k = 0; k < batchSize; k++) {
+			int i = miniBatch[k];
+			double val = y[i]*(x*features[i])/sqrt(2);
+			double normval = (1/sqrt(2*M_PI))*exp(-(val*val));
+			double probitval = (1/2)*(1 + erf(val))+EPSILON;
+			featureMultiplySubtract(gt, y[i]*normval/probitval, features[i]);
+			sum -= log(probitval);
+		}
 	}
+	sumLocalGradients(g, T);
+	f = sum;
 	for (int i = 0; i < m; i++)
 	{
 		if (x[i] != 0)
@@ -169,5 +208,6 @@ void L1ProbitLoss<Feature>::evalStochastic(const Vector& x, double& f, Vector& g
 
 template class L1ProbitLoss<SparseFeature>;
 template class L1ProbitLoss<DenseFeature>;
+template class L1ProbitLoss<SparseRow>;
 
 }
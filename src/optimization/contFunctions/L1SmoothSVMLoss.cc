@@ -19,7 +19,7 @@ using namespace std;
 #define MAX 1e2
 namespace jensen {
 template <class Feature>
-L1SmoothSVMLoss<Feature>::L1SmoothSVMLoss(int m, std::vector<Feature>& features, Vector& y, double lambda) :
+L1SmoothSVMLoss<Feature>::L1SmoothSVMLoss(int m, typename FeatureSet<Feature>::type& features, Vector& y, double lambda) :
 	ContinuousFunctions(true, m, features.size()), features(features), y(y), lambda(lambda)
 {
 	if (n > 0)
@@ -30,7 +30,7 @@ L1SmoothSVMLoss<Feature>::L1SmoothSVMLoss(int m, std::vector<Feature>& features,
 
 template <class Feature>
 L1SmoothSVMLoss<Feature>::L1SmoothSVMLoss(const L1SmoothSVMLoss& l) :
-	ContinuousFunctions(true, l.m, l.n), features(l.features), y(l.y), lambda(l.lambda) {
+	ContinuousFunctions(l), features(l.features), y(l.y), lambda(l.lambda) {
 }
 
 template <class Feature>
@@ -41,6 +41,7 @@ template <class Feature>
 double L1SmoothSVMLoss<Feature>::eval(const Vector& x) const {
 	assert(x.size() == m);
 	double sum = lambda*norm(x, 1);
+	#pragma omp parallel for schedule(static) num_threads(numThreads(n)) reduction(+:sum)
 	for (int i = 0; i < n; i++) {
 		double preval = y[i]*(x*features[i]);
 		if (1 - preval>= 0) {
@@ -54,12 +55,20 @@ template <class Feature>
 Vector L1SmoothSVMLoss<Feature>::evalGradient(const Vector& x) const {
 	assert(x.size() == m);
 	Vector g = Vector(m, 0);
-	for (int i = 0; i < n; i++) {
-		double preval = y[i]*(x*features[i]);
-		if (1 - preval>= 0) {
-			g -= 2*features[i]*(1 - preval)*y[i];
+	int T = numThreads(n);
+	reserveLocalGradients(T);
+	#pragma omp parallel num_threads(T)
+	{
+		Vector& gt = localGradient(g);
+		#pragma omp for schedule(static)
+		for (int i = 0; i < n; i++) {
+			double preval = y[i]*(x*features[i]);
+			if (1 - preval>= 0) {
+				featureMultiplySubtract(gt, 2*(1 - preval)*y[i], features[i]);
+			}
 		}
 	}
+	sumLocalGradients(g, T);
 	for (int i = 0; i < m; i++)
 	{
 		if (x[i] != 0)
@@ -81,14 +90,23 @@ template <class Feature>
 void L1SmoothSVMLoss<Feature>::eval(const Vector& x, double& f, Vector& g) const {
 	assert(x.size() == m);
 	g = Vector(m, 0);
-	f = lambda*norm(x,1);
-	for (int i = 0; i < n; i++) {
-		double preval = y[i]*(x*features[i]);
-		if (1 - preval>= 0) {
-			f += (1 - preval)*(1 - preval);
-			g -= 2*features[i]*(1 - preval)*y[i];
+	double sum = lambda*norm(x,1);
+	int T = numThreads(n);
+	reserveLocalGradients(T);
+	#pragma omp parallel num_threads(T) reduction(+:sum)
+	{
+		Vector& gt = localGradient(g);
+		#pragma omp for schedule(static)
+		for (int i = 0; i < n; i++) {
+			double preval = y[i]*(x*features[i]);
+			if (1 - preval>= 0) {
+				sum += (1 - preval)*(1 - preval);
+				featureMultiplySubtract(gt, 2*(1 - preval)*y[i], features[i]);
+			}
 		}
 	}
+	sumLocalGradients(g, T);
+	f = sum;
 	for (int i = 0; i < m; i++)
 	{
 		if (x[i] != 0)
@@ -106,16 +124,67 @@ void L1SmoothSVMLoss<Feature>::eval(const Vector& x, double& f, Vector& g) const
 	return;
 }
 
+template <class Feature>
+bool L1SmoothSVMLoss<Feature>::prepareDirection(const Vector& x, const Vector& d) const {
+	lineSearch.prepare(features, y, x, d, numThreads(n));
+	return true;
+}
+
+template <class Feature>
+double L1SmoothSVMLoss<Feature>::evalAlongDirection(const double a) const {
+	double sum = lambda*lineSearch.l1Norm(a);
+	#pragma omp parallel for schedule(static) num_threads(numThreads(n)) reduction(+:sum)
+	for (int i = 0; i < n; i++) {
+		double preval = lineSearch.margin(i, a);
+		if (1 - preval >= 0)
+			sum += (1 - preval)*(1 - preval);
+	}
+	return sum;
+}
+
+template <class Feature>
+bool L1SmoothSVMLoss<Feature>::prepareSparseSteps() const {
+	sparseSteps.prepare(features, m, true);
+	return true;
+}
+
+template <class Feature>
+double L1SmoothSVMLoss<Feature>::sparseStochasticStep(Vector& x, const std::vector<int>& miniBatch, const SparseStepRule& rule) const {
+	double sum = 0;
+	double regScale = lambda*n/miniBatch.size();
+	for (int k = 0; k < miniBatch.size(); k++) {
+		int i = miniBatch[k];
+		double preval = y[i]*(x*features[i]);
+		if (1 - preval >= 0) {
+			sum += (1 - preval)*(1 - preval);
+			sparseSteps.apply(x, features[i], -2*(1 - preval)*y[i], regScale, rule);
+		}
+		else
+			sparseSteps.apply(x, features[i], 0, regScale, rule);
+	}
+	return sum;
+}
+
 template <class Feature>
 Vector L1SmoothSVMLoss<Feature>::evalStochasticGradient(const Vector& x, std::vector<int>& miniBatch) const {
 	assert(x.size() == m);
 	Vector g = Vector(m, 0);
-	for (vector<int>::iterator it = miniBatch.begin(); it != miniBatch.end(); it++) {
-		double preval = y[*it]*(x*features[*it]);
-		if (1 - preval>= 0) {
-			g -= 2*features[*it]*(1 - preval)*y[*it];
+	int batchSize = miniBatch.size();
+	int T = numThreads(batchSize);
+	reserveLocalGradients(T);
+	#pragma omp parallel num_threads(T)
+	{
+		Vector& gt = localGradient(g);
+		#pragma omp for schedule(static)
+		for (int k = 0; k < batchSize; k++) {
+			int i = miniBatch[k];
+			double preval = y[i]*(x*features[i]);
+			if (1 - preval>= 0) {
+				featureMultiplySubtract(gt, 2*(1 - preval)*y[i], features[i]);
+			}
 		}
 	}
+	sumLocalGradients(g, T);
 	for (int i = 0; i < m; i++)
 	{
 		if (x[i] != 0)
@@ -137,15 +206,26 @@ template <class Feature>
 void L1SmoothSVMLoss<Feature>::evalStochastic(const Vector& x, double& f, Vector& g, std::vector<int>& miniBatch) const {
 	assert(x.size() == m);
 	g = Vector(m,0);
-	f = lambda*norm(x,1);
+	double sum = lambda*norm(x,1);
 	double val;
-	for (vector<int>::iterator it = miniBatch.begin(); it != miniBatch.end(); it++) {
-		double preval = y[*it]*(x*features[*it]);
-		if (1 - preval>= 0) {
-			f += (1 - preval)*(1 - preval);
-			g -= 2*features[*it]*(1 - preval)*y[*it];
+	int batchSize = miniBatch.size();
+	int T = numThreads(batchSize);
+	reserveLocalGradients(T);
+	#pragma omp parallel num_threads(T) reduction(+:sum)
+	{
+		Vector& gt = localGradient(g);
+		#pragma omp for schedule(static)
+		for (int k = 0; k < batchSize; k++) {
+			int i = miniBatch[k];
+			double preval = y[i]*(x*features[i]);
+			if (1 - preval>= 0) {
+				sum += (1 - preval)*(1 - preval);
+				featureMultiplySubtract(gt, 2*(1 - preval)*y[i], features[i]);
+			}
 		}
 	}
+	sumLocalGradients(g, T);
+	f = sum;
 	for (int i = 0; i < m; i++)
 	{
 		if (x[i] != 0)
@@ -164,6 +244,7 @@ void L1SmoothSVMLoss<Feature>::evalStochastic(const Vector& x, double& f, Vector
 }
 template class L1SmoothSVMLoss<SparseFeature>;
 template class L1SmoothSVMLoss<DenseFeature>;
+template class L1SmoothSVMLoss<SparseRow>;
 
 
 }
@@ -0,0 +1,188 @@
+// Copyright (C) Rishabh Iyer, John T. Halloran, and Kai Wei
+// Licensed under the Open Software License version 3.0
+// See COPYING or http://opensource.org/licenses/OSL-3.0
+/*
+        Jensen: A Convex Optimization And Machine Learning ToolKit
+ *	Multinomial (softmax) logistic loss with L1 regularization
+        Author: Rishabh Iyer
+ *
+ */
+
+#include <iostream>
+#include <math.h>
+using namespace std;
+
+#include "L1SoftmaxLoss.h"
+#include "../../representation/VectorOperations.h"
+#include <assert.h>
+#define EPSILON 1e-6
+namespace jensen {
+
+template <class Feature>
+L1SoftmaxLoss<Feature>::L1SoftmaxLoss(int numFeatures, typename FeatureSet<Feature>::type& features, Vector& y, int nClasses,
+                                      double lambda) :
+	ContinuousFunctions(true, numFeatures*nClasses, features.size()), features(features), y(y), nClasses(nClasses),
+	numFeatures(numFeatures), lambda(lambda)
+{
+	if (n > 0)
+		assert(features[0].numFeatures == numFeatures);
+	assert(features.size() == y.size());
+}
+
+template <class Feature>
+L1SoftmaxLoss<Feature>::L1SoftmaxLoss(const L1SoftmaxLoss& l) :
+	ContinuousFunctions(l), features(l.features), y(l.y), nClasses(l.nClasses), numFeatures(l.numFeatures), lambda(l.lambda) {
+}
+
+template <class Feature>
+L1SoftmaxLoss<Feature>::~L1SoftmaxLoss(){
+}
+
+// Turns the gradient g of the loss into the pseudo-gradient: g_j + lambda sign(x_j) where x_j != 0, else the
+// subgradient of coordinate j with the smallest magnitude.
+template <class Feature>
+void L1SoftmaxLoss<Feature>::l1PseudoGradient(const Vector& x, Vector& g) const {
+	for (long int j = 0; j < m; j++) {
+		if (x[j] != 0)
+			g[j] += lambda*sign(x[j]);
+		else if (g[j] > lambda)
+			g[j] -= lambda;
+		else if (g[j] < -lambda)
+			g[j] += lambda;
+		else
+			g[j] = 0;
+	}
+}
+
+// Computes the probabilities of all classes at x (one pass over the data), unless they are cached already.
+template <class Feature>
+void L1SoftmaxLoss<Feature>::updateProbabilities(const Vector& x) const {
+	int K = nClasses;
+	if ((prob.size() == (long int) n*K) && (x == cachePoint))
+		return;
+	prob.assign((long int) n*K, 0);
+	rowLoss.resize(n);
+	#pragma omp parallel for schedule(static) num_threads(numThreads(n))
+	for (int i = 0; i < n; i++) {
+		double* p = &prob[(long int) i*K];
+		classScores(x, features[i], K, p);
+		rowLoss[i] = softmaxRow(p, K, (int) y[i], p);
+	}
+	cachePoint = x;
+}
+
+template <class Feature>
+double L1SoftmaxLoss<Feature>::eval(const Vector& x) const {
+	assert(x.size() == m);
+	updateProbabilities(x);
+	double sum = lambda*norm(x, 1);
+	#pragma omp parallel for schedule(static) num_threads(numThreads(n)) reduction(+:sum)
+	for (int i = 0; i < n; i++)
+		sum += rowLoss[i];
+	return sum;
+}
+
+template <class Feature>
+Vector L1SoftmaxLoss<Feature>::evalGradient(const Vector& x) const {
+	double f;
+	Vector g;
+	eval(x, f, g);
+	return g;
+}
+
+template <class Feature>
+void L1SoftmaxLoss<Feature>::eval(const Vector& x, double& f, Vector& g) const {
+	assert(x.size() == m);
+	updateProbabilities(x);
+	g = Vector(m, 0);
+	double sum = lambda*norm(x, 1);
+	int K = nClasses;
+	int T = numThreads(n);
+	reserveLocalGradients(T);
+	#pragma omp parallel num_threads(T) reduction(+:sum)
+	{
+		Vector& gt = localGradient(g);
+		Vector coef(K);
+		#pragma omp for schedule(static)
+		for (int i = 0; i < n; i++) {
+			sum += rowLoss[i];
+			for (int c = 0; c < K; c++)
+				coef[c] = prob[(long int) i*K + c];
+			coef[(int) y[i]] -= 1;
+			classUpdate(gt, features[i], K, coef.data());
+		}
+	}
+	sumLocalGradients(g, T);
+	f = sum;
+	l1PseudoGradient(x, g);
+}
+
+// The hessian of row i is (diag(p_i) - p_i p_i^T) (x) f_i f_i^T: with u = V^T f_i, the K coefficients are p_c (u_c - p_i^T u).
+template <class Feature>
+void L1SoftmaxLoss<Feature>::evalHessianVectorProduct(const Vector& x, const Vector& v, Vector& Hxv) const {  // evaluate a product between a hessian and a vector
+	updateProbabilities(x);
+	Hxv = Vector(m, 0);
+	int K = nClasses;
+	int T = numThreads(n);
+	reserveLocalGradients(T);
+	#pragma omp parallel num_threads(T)
+	{
+		Vector& ht = localGradient(Hxv);
+		Vector u(K);
+		#pragma omp for schedule(static)
+		for (int i = 0; i < n; i++) {
+			const double* p = &prob[(long int) i*K];
+			u.assign(K, 0);
+			classScores(v, features[i], K, u.data());
+			double pu = 0;
+			for (int c = 0; c < K; c++)
+				pu += p[c]*u[c];
+			for (int c = 0; c < K; c++)
+				u[c] = p[c]*(u[c] - pu);
+			classUpdate(ht, features[i], K, u.data());
+		}
+	}
+	sumLocalGradients(Hxv, T);
+}
+
+template <class Feature>
+Vector L1SoftmaxLoss<Feature>::evalStochasticGradient(const Vector& x, std::vector<int>& miniBatch) const {
+	double f;
+	Vector g;
+	evalStochastic(x, f, g, miniBatch);
+	return g;
+}
+
+template <class Feature>
+void L1SoftmaxLoss<Feature>::evalStochastic(const Vector& x, double& f, Vector& g, std::vector<int>& miniBatch) const {
+	assert(x.size() == m);
+	g = Vector(m, 0);
+	double sum = lambda*norm(x, 1);
+	int K = nClasses;
+	int batchSize = miniBatch.size();
+	int T = numThreads(batchSize);
+	reserveLocalGradients(T);
+	#pragma omp parallel num_threads(T) reduction(+:sum)
+	{
+		Vector& gt = localGradient(g);
+		Vector p(K);
+		#pragma omp for schedule(static)
+		for (int k = 0; k < batchSize; k++) {
+			int i = miniBatch[k];
+			p.assign(K, 0);
+			classScores(x, features[i], K, p.data());
+			sum += softmaxRow(p.data(), K, (int) y[i], p.data());
+			p[(int) y[i]] -= 1;
+			classUpdate(gt, features[i], K, p.data());
+		}
+	}
+	sumLocalGradients(g, T);
+	f = sum;
+	l1PseudoGradient(x, g);
+}
+
+template class L1SoftmaxLoss<SparseFeature>;
+template class L1SoftmaxLoss<DenseFeature>;
+template class L1SoftmaxLoss<SparseRow>;
+
+}
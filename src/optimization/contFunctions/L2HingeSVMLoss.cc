@@ -19,7 +19,7 @@ using namespace std;
 #define MAX 1e2
 namespace jensen {
 template <class Feature>
-L2HingeSVMLoss<Feature>::L2HingeSVMLoss(int m, std::vector<Feature>& features, Vector& y, double lambda) :
+L2HingeSVMLoss<Feature>::L2HingeSVMLoss(int m, typename FeatureSet<Feature>::type& features, Vector& y, double lambda) :
 	ContinuousFunctions(true, m, features.size()), features(features), y(y), lambda(lambda)
 {
 	if (n > 0)
@@ -29,7 +29,7 @@ L2HingeSVMLoss<Feature>::L2HingeSVMLoss(int m, std::vector<Feature>& features, V
 
 template <class Feature>
 L2HingeSVMLoss<Feature>::L2HingeSVMLoss(const L2HingeSVMLoss& l) :
-	ContinuousFunctions(true, l.m, l.n), features(l.features), y(l.y), lambda(l.lambda) {
+	ContinuousFunctions(l), features(l.features), y(l.y), lambda(l.lambda) {
 }
 
 template <class Feature>
@@ -40,6 +40,7 @@ template <class Feature>
 double L2HingeSVMLoss<Feature>::eval(const Vector& x) const {
 	assert(x.size() == m);
 	double sum = 0.5*lambda*(x*x);
+	#pragma omp parallel for schedule(static) num_threads(numThreads(n)) reduction(+:sum)
 	for (int i = 0; i < n; i++) {
 		double preval = y[i]*(x*features[i]);
 		if (1 - preval>= 0) {
@@ -53,12 +54,20 @@ template <class Feature>
 Vector L2HingeSVMLoss<Feature>::evalGradient(const Vector& x) const {
 	assert(x.size() == m);
 	Vector g = lambda*x;
-	for (int i = 0; i < n; i++) {
-		double preval = y[i]*(x*features[i]);
-		if (1 - preval>= 0) {
-			g -= features[i]*y[i];
+	int T = numThreads(n);
+	reserveLocalGradients(T);
+	#pragma omp parallel num_threads(T)
+	{
+		Vector& gt = localGradient(g);
+		#pragma omp for schedule(static)
+		for (int i = 0; i < n; i++) {
+			double preval = y[i]*(x*features[i]);
+			if (1 - preval>= 0) {
+				featureMultiplySubtract(gt, y[i], features[i]);
+			}
 		}
 	}
+	sumLocalGradients(g, T);
 	return g;
 }
 
@@ -66,27 +75,111 @@ template <class Feature>
 void L2HingeSVMLoss<Feature>::eval(const Vector& x, double& f, Vector& g) const {
 	assert(x.size() == m);
 	g = lambda*x;
-	f = 0.5*lambda*(x*x);
+	double sum = 0.5*lambda*(x*x);
+	int T = numThreads(n);
+	reserveLocalGradients(T);
+	#pragma omp parallel num_threads(T) reduction(+:sum)
+	{
+		Vector& gt = localGradient(g);
+		#pragma omp for schedule(static)
+		for (int i = 0; i < n; i++) {
+			double preval = y[i]*(x*features[i]);
+			if (1 - preval>= 0) {
+				sum += (1 - preval);
+				featureMultiplySubtract(gt, y[i], features[i]);
+			}
+		}
+	}
+	sumLocalGradients(g, T);
+	f = sum;
+	return;
+}
+
+template <class Feature>
+bool L2HingeSVMLoss<Feature>::prepareDirection(const Vector& x, const Vector& d) const {
+	lineSearch.prepare(features, y, x, d, numThreads(n));
+	return true;
+}
+
+template <class Feature>
+double L2HingeSVMLoss<Feature>::evalAlongDirection(const double a) const {
+	double sum = 0.5*lambda*lineSearch.squaredNorm(a);
+	#pragma omp parallel for schedule(static) num_threads(numThreads(n)) reduction(+:sum)
 	for (int i = 0; i < n; i++) {
+		double preval = lineSearch.margin(i, a);
+		if (1 - preval >= 0)
+			sum += (1 - preval);
+	}
+	return sum;
+}
+
+template <class Feature>
+bool L2HingeSVMLoss<Feature>::prepareSparseSteps() const {
+	sparseSteps.prepare(features, m, false);
+	return true;
+}
+
+template <class Feature>
+double L2HingeSVMLoss<Feature>::sparseStochasticStep(Vector& x, const std::vector<int>& miniBatch, const SparseStepRule& rule) const {
+	double sum = 0;
+	double regScale = lambda*n/miniBatch.size();
+	for (int k = 0; k < miniBatch.size(); k++) {
+		int i = miniBatch[k];
 		double preval = y[i]*(x*features[i]);
-		if (1 - preval>= 0) {
-			f += (1 - preval);
-			g -= features[i]*y[i];
+		if (1 - preval >= 0) {
+			sum += (1 - preval);
+			sparseSteps.apply(x, features[i], -y[i], regScale, rule);
 		}
+		else
+			sparseSteps.apply(x, features[i], 0, regScale, rule);
 	}
-	return;
+	return sum;
+}
+
+template <class Feature>
+bool L2HingeSVMLoss<Feature>::prepareScaledSteps() const {
+	return true;
+}
+
+template <class Feature>
+double L2HingeSVMLoss<Feature>::scaledStochasticStep(ScaledVector& x, const std::vector<int>& miniBatch, const double alpha) const {
+	double sum = 0;
+	Vector coef(miniBatch.size());
+	for (int k = 0; k < miniBatch.size(); k++) {
+		int i = miniBatch[k];
+		double preval = y[i]*(x*features[i]);
+		coef[k] = 0;
+		if (1 - preval >= 0) {
+			sum += (1 - preval);
+			coef[k] = y[i];
+		}
+	}
+	x.scale(1 - alpha*lambda);
+	for (int k = 0; k < miniBatch.size(); k++)
+		x.multiplyAdd(alpha*coef[k], features[miniBatch[k]]);
+	return sum;
 }
 
 template <class Feature>
 Vector L2HingeSVMLoss<Feature>::evalStochasticGradient(const Vector& x, std::vector<int>& miniBatch) const {
 	assert(x.size() == m);
 	Vector g = lambda*x;
-	for (vector<int>::iterator it = miniBatch.begin(); it != miniBatch.end(); it++) {
-		double preval = y[*it]*(x*features[*it]);
-		if (1 - preval>= 0) {
-			g -= features[*it]*y[*it];
+	int batchSize = miniBatch.size();
+	int T = numThreads(batchSize);
+	reserveLocalGradients(T);
+	#pragma omp parallel num_threads(T)
+	{
+		Vector& gt = localGradient(g);
+		#pragma omp for schedule(static)
+		for (int k = 0; k < batchSize; k++) {
+			int i = miniBatch[k];
+			double preval = y[i]*(x*features[i]);
+			if (1 - preval>= 0) {
+				featureMultiplySubtract(gt, y[i], features[i]);
+			}
 		}
 	}
+	sumLocalGradients(g, T);
 	return g;
 }
 
@@ -94,20 +187,32 @@ template <class Feature>
 void L2HingeSVMLoss<Feature>::evalStochastic(const Vector& x, double& f, Vector& g, std::vector<int>& miniBatch) const {
 	assert(x.size() == m);
 	g = lambda*x;
-	f = 0.5*lambda*(x*x);
+	double sum = 0.5*lambda*(x*x);
 	double val;
-	for (vector<int>::iterator it = miniBatch.begin(); it != miniBatch.end(); it++) {
-		double preval = y[*it]*(x*features[*it]);
-		if (1 - preval>= 0) {
-			f += (1 - preval);
-			g -= features[*it]*y[*it];
+	int batchSize = miniBatch.size();
+	int T = numThreads(batchSize);
+	reserveLocalGradients(T);
+	#pragma omp parallel num_threads(T) reduction(+:sum)
+	{
+		Vector& gt = localGradient(g);
+		#pragma omp for schedule(static)
+		for (int k = 0; k < batchSize; k++) {
+			int i = miniBatch[k];
+			double preval = y[i]*(x*features[i]);
+			if (1 - preval>= 0) {
+				sum += (1 - preval);
+				featureMultiplySubtract(gt, y[i], features[i]);
+			}
 		}
 	}
+	sumLocalGradients(g, T);
+	f = sum;
 	return;
 }
 
 template class L2HingeSVMLoss<SparseFeature>;
 template class L2HingeSVMLoss<DenseFeature>;
+template class L2HingeSVMLoss<SparseRow>;
 
 
 }
@@ -20,7 +20,7 @@ using namespace std;
 #define MAX 1e2
 namespace jensen {
 template <class Feature>
-L2HingeSVRLoss<Feature>::L2HingeSVRLoss(int m, std::vector<Feature>& features, Vector& y, double lambda, double p) :
+L2HingeSVRLoss<Feature>::L2HingeSVRLoss(int m, typename FeatureSet<Feature>::type& features, Vector& y, double lambda, double p) :
 	ContinuousFunctions(true, m, features.size()), features(features), y(y), p(p), lambda(lambda)
 {
 	if (n > 0)
@@ -30,7 +30,7 @@ L2HingeSVRLoss<Feature>::L2HingeSVRLoss(int m, std::vector<Feature>& features, V
 
 template <class Feature>
 L2HingeSVRLoss<Feature>::L2HingeSVRLoss(const L2HingeSVRLoss& l) :
-	ContinuousFunctions(true, l.m, l.n), features(l.features), y(l.y), p(l.p), lambda(l.lambda) {
+	ContinuousFunctions(l), features(l.features), y(l.y), p(l.p), lambda(l.lambda) {
 }
 
 template <class Feature>
@@ -41,6 +41,7 @@ template <class Feature>
 double L2HingeSVRLoss<Feature>::eval(const Vector& x) const {
 	assert(x.size() == m);
 	double sum = 0.5*lambda*(x*x);
+	#pragma omp parallel for schedule(static) num_threads(numThreads(n)) reduction(+:sum)
 	for (int i = 0; i < n; i++) {
 		double preval = (x*features[i]) - y[i];
 		if (fabs(preval) - p > 0) {
@@ -54,12 +55,20 @@ template <class Feature>
 Vector L2HingeSVRLoss<Feature>::evalGradient(const Vector& x) const {
 	assert(x.size() == m);
 	Vector g = lambda*x;
-	for (int i = 0; i < n; i++) {
-		double preval = (x*features[i]) - y[i];
-		if (fabs(preval) - p > 0) {
-			g += features[i]*sign(preval);
+	int T = numThreads(n);
+	reserveLocalGradients(T);
+	#pragma omp parallel num_threads(T)
+	{
+		Vector& gt = localGradient(g);
+		#pragma omp for schedule(static)
+		for (int i = 0; i < n; i++) {
+			double preval = (x*features[i]) - y[i];
+			if (fabs(preval) - p > 0) {
+				featureMultiplyAdd(gt, sign(preval), features[i]);
+			}
 		}
 	}
+	sumLocalGradients(g, T);
 	return g;
 }
 
@@ -67,14 +76,23 @@ template <class Feature>
 void L2HingeSVRLoss<Feature>::eval(const Vector& x, double& f, Vector& g) const {
 	assert(x.size() == m);
 	g = lambda*x;
-	f = 0.5*lambda*(x*x);
-	for (int i = 0; i < n; i++) {
-		double preval = (x*features[i]) - y[i];
-		if (fabs(preval) - p > 0) {
-			f += fabs(preval) - p;
-			g += features[i]*sign(preval);
+	double sum = 0.5*lambda*(x*x);
+	int T = numThreads(n);
+	reserveLocalGradients(T);
+	#pragma omp parallel num_threads(T) reduction(+:sum)
+	{
+		Vector& gt = localGradient(g);
+		#pragma omp for schedule(static)
+		for (int i = 0; i < n; i++) {
+			double preval = (x*features[i]) - y[i];
+			if (fabs(preval) - p > 0) {
+				sum += fabs(preval) - p;
+				featureMultiplyAdd(gt, sign(preval), features[i]);
+			}
 		}
 	}
+	sumLocalGradients(g, T);
+	f = sum;
 	return;
 }
 
@@ -82,12 +100,22 @@ template <class Feature>
 Vector L2HingeSVRLoss<Feature>::evalStochasticGradient(const Vector& x, std::vector<int>& miniBatch) const {
 	assert(x.size() == m);
 	Vector g = lambda*x;
-	for (vector<int>::iterator it = miniBatch.begin(); it != miniBatch.end(); it++) {
-		double preval = (x*features[*it]) - y[*it];
-		if (fabs(preval) - p > 0) {
-			g += features[*it]*sign(preval);
+	int batchSize = miniBatch.size();
+	int T = numThreads(batchSize);
+	reserveLocalGradients(T);
+	#pragma omp parallel num_threads(T)
+	{
+		Vector& gt = localGradient(g);
+		#pragma omp for schedule(static)
+		for (int k = 0; k < batchSize; k++) {
+			int i = miniBatch[k];
+			double preval = (x*features[i]) - y[i];
+			if (fabs(preval) - p > 0) {
+				featureMultiplyAdd(gt, sign(preval), features[i]);
+			}
 		}
 	}
+	sumLocalGradients(g, T);
 	return g;
 }
 
@@ -95,17 +123,29 @@ template <class Feature>
 void L2HingeSVRLoss<Feature>::evalStochastic(const Vector& x, double& f, Vector& g, std::vector<int>& miniBatch) const {
 	assert(x.size() == m);
 	g = lambda*x;
-	f = 0.5*lambda*(x*x);
-	for (vector<int>::iterator it = miniBatch.begin(); it != miniBatch.end(); it++) {
-		double preval = (x*features[*it]) - y[*it];
-		if (fabs(preval) - p > 0) {
-			f += fabs(preval) - p;
-			g += features[*it]*sign(preval);
+	double sum = 0.5*lambda*(x*x);
+	int batchSize = miniBatch.size();
+	int T = numThreads(batchSize);
+	reserveLocalGradients(T);
+	#pragma omp parallel num_threads(T) reduction(+:sum)
+	{
+		Vector& gt = localGradient(g);
+		#pragma omp for schedule(static)
+		for (int k = 0; k < batchSize; k++) {
+			int i = miniBatch[k];
+			double preval = (x*features[i]) - y[i];
+			if (fabs(preval) - p > 0) {
+				sum += fabs(preval) - p;
+				featureMultiplyAdd(gt, sign(preval), features[i]);
+			}
 		}
 	}
+	sumLocalGradients(g, T);
+	f = sum;
 	return;
 }
 
 template class L2HingeSVRLoss<SparseFeature>;
 template class L2HingeSVRLoss<DenseFeature>;
+template class L2HingeSVRLoss<SparseRow>;
 }
@@ -19,12 +19,12 @@ namespace jensen {
 template <class Feature>
 class L2HingeSVRLoss : public ContinuousFunctions {
 protected:
-std::vector<Feature>& features;     // size of features is number of trainins examples (n)
+typename FeatureSet<Feature>::type& features;     // size of features is number of trainins examples (n)
 Vector& y;     // size of y is number of training examples (n)
 double p;
 double lambda;
 public:
-L2HingeSVRLoss(int numFeatures, std::vector<Feature>& features, Vector& y, double lambda, double p = 0.1);
+L2HingeSVRLoss(int numFeatures, typename FeatureSet<Feature>::type& features, Vector& y, double lambda, double p = 0.1);
 L2HingeSVRLoss(const L2HingeSVRLoss& c);     // copy constructor
 
 ~L2HingeSVRLoss();
@@ -19,7 +19,7 @@ using namespace std;
 #define MAX 1e2
 namespace jensen {
 template <class Feature>
-L2HuberSVMLoss<Feature>::L2HuberSVMLoss(int m, std::vector<Feature>& features, Vector& y, double thresh, double lambda) :
+L2HuberSVMLoss<Feature>::L2HuberSVMLoss(int m, typename FeatureSet<Feature>::type& features, Vector& y, double thresh, double lambda) :
 	ContinuousFunctions(true, m, features.size()), features(features), y(y), thresh(thresh), lambda(lambda)
 {
 	if (n > 0) {
@@ -30,7 +30,7 @@ L2HuberSVMLoss<Feature>::L2HuberSVMLoss(int m, std::vector<Feature>& features, V
 
 template <class Feature>
 L2HuberSVMLoss<Feature>::L2HuberSVMLoss(const L2HuberSVMLoss& l) :
-	ContinuousFunctions(true, l.m, l.n), features(l.features), y(l.y), thresh(l.thresh), lambda(l.lambda) {
+	ContinuousFunctions(l), features(l.features), y(l.y), thresh(l.thresh), lambda(l.lambda) {
 }
 
 template <class Feature>
@@ -41,6 +41,7 @@ template <class Feature>
 double L2HuberSVMLoss<Feature>::eval(const Vector& x) const {
 	assert(x.size() == m);
 	double sum = 0.5*lambda*(x*x);
+	#pragma omp parallel for schedule(static) num_threads(numThreads(n)) reduction(+:sum)
 	for (int i = 0; i < n; i++) {
 		double val = y[i]*(x*features[i]);
 		if (val <= thresh) {
@@ -57,15 +58,23 @@ template <class Feature>
 Vector L2HuberSVMLoss<Feature>::evalGradient(const Vector& x) const {
 	assert(x.size() == m);
 	Vector g = lambda*x;
-	for (int i = 0; i < n; i++) {
-		double val = y[i]*(x*features[i]);
-		if (val <= thresh) {
-			g -= features[i]*2*(1 - thresh)*y[i];
-		}
-		else if ((val > thresh) && (val < 1)) {
-			g -= features[i]*2*(1 - val)*y[i];
+	int T = numThreads(n);
+	reserveLocalGradients(T);
+	#pragma omp parallel num_threads(T)
+	{
+		Vector& gt = localGradient(g);
+		#pragma omp for schedule(static)
+		for (int i = 0; i < n; i++) {
+			double val = y[i]*(x*features[i]);
+			if (val <= thresh) {
+				featureMultiplySubtract(gt, 2*(1 - thresh)*y[i], features[i]);
+			}
+			else if ((val > thresh) && (val < 1)) {
+				featureMultiplySubtract(gt, 2*(1 - val)*y[i], features[i]);
+			}
 		}
 	}
+	sumLocalGradients(g, T);
 	return g;
 }
 
@@ -73,18 +82,27 @@ template <class Feature>
 void L2HuberSVMLoss<Feature>::eval(const Vector& x, double& f, Vector& g) const {
 	assert(x.size() == m);
 	g = lambda*x;
-	f = 0.5*lambda*(x*x);
-	for (int i = 0; i < n; i++) {
-		double val = y[i]*(x*features[i]);
-		if (val <= thresh) {
-			f += (1 - thresh)*(1 - thresh) + 2*(1 - thresh)*(thresh - val);
-			g -= features[i]*2*(1 - thresh)*y[i];
-		}
-		else if ((val > thresh) && (val <= 1)) {
-			f += (1 - val)*(1 - val);
-			g -= features[i]*2*(1 - val)*y[i];
+	double sum = 0.5*lambda*(x*x);
+	int T = numThreads(n);
+	reserveLocalGradients(T);
+	#pragma omp parallel num_threads(T) reduction(+:sum)
+	{
+		Vector& gt = localGradient(g);
+		#pragma omp for schedule(static)
+		for (int i = 0; i < n; i++) {
+			double val = y[i]*(x*features[i]);
+			if (val <= thresh) {
+				sum += (1 - thresh)*(1 - thresh) + 2*(1 - thresh)*(thresh - val);
+				featureMultiplySubtract(gt, 2*(1 - thresh)*y[i], features[i]);
+			}
+			else if ((val > thresh) && (val <= 1)) {
+				sum += (1 - val)*(1 - val);
+				featureMultiplySubtract(gt, 2*(1 - val)*y[i], features[i]);
+			}
 		}
 	}
+	sumLocalGradients(g, T);
+	f = sum;
 	return;
 }
 
@@ -92,15 +110,25 @@ template <class Feature>
 Vector L2HuberSVMLoss<Feature>::evalStochasticGradient(const Vector& x, std::vector<int>& miniBatch) const {
 	assert(x.size() == m);
 	Vector g = lambda*x;
-	for (vector<int>::iterator it = miniBatch.begin(); it != miniBatch.end(); it++) {
-		double val = y[*it]*(x*features[*it]);
-		if (val <= thresh) {
-			g -= features[*it]*2*(1 - thresh)*y[*it];
-		}
-		else if ((val > thresh) && (val < 1)) {
-			g -= features[*it]*2*(1 - val)*y[*it];
+	int batchSize = miniBatch.size();
+	int T = numThreads(batchSize);
+	reserveLocalGradients(T);
+	#pragma omp parallel num_threads(T)
+	{
+		Vector& gt = localGradient(g);
+		#pragma omp for schedule(static)
+		for (int k = 0; k < batchSize; k++) {
+			int i = miniBatch[k];
+			double val = y[i]*(x*features[i]);
+			if (val <= thresh) {
+				featureMultiplySubtract(gt, 2*(1 - thresh)*y[i], features[i]);
+			}
+			else if ((val > thresh) && (val < 1)) {
+				featureMultiplySubtract(gt, 2*(1 - val)*y[i], features[i]);
+			}
 		}
 	}
+	sumLocalGradients(g, T);
 	return g;
 }
 
@@ -108,23 +136,35 @@ template <class Feature>
 void L2HuberSVMLoss<Feature>::evalStochastic(const Vector& x, double& f, Vector& g, std::vector<int>& miniBatch) const {
 	assert(x.size() == m);
 	g = lambda*x;
-	f = 0.5*lambda*(x*x);
+	double sum = 0.5*lambda*(x*x);
 	double val;
-	for (vector<int>::iterator it = miniBatch.begin(); it != miniBatch.end(); it++) {
-		double val = y[*it]*(x*features[*it]);
-		if (val <= thresh) {
-			f += (1 - thresh)*(1 - thresh) + 2*(1 - thresh)*(thresh - val);
-			g -= features[*it]*2*(1 - thresh)*y[*it];
-		}
-		else if ((val > thresh) && (val < 1)) {
-			f += (1 - val)*(1 - val);
-			g -= features[*it]*2*(1 - val)*y[*it];
+	int batchSize = miniBatch.size();
+	int T = numThreads(batchSize);
+	reserveLocalGradients(T);
+	#pragma omp parallel num_threads(T) reduction(+:sum)
+	{
+		Vector& gt = localGradient(g);
+		#pragma omp for schedule(static)
+		for (int k = 0; k < batchSize; k++) {
+			int i = miniBatch[k];
+			double val = y[i]*(x*features[i]);
+			if (val <= thresh) {
+				sum += (1 - thresh)*(1 - thresh) + 2*(1 - thresh)*(thresh - val);
+				featureMultiplySubtract(gt, 2*(1 - thresh)*y[i], features[i]);
+			}
+			else if ((val > thresh) && (val < 1)) {
+				sum += (1 - val)*(1 - val);
+				featureMultiplySubtract(gt, 2*(1 - val)*y[i], features[i]);
+			}
 		}
 	}
+	sumLocalGradients(g, T);
+	f = sum;
 	return;
 }
 template class L2HuberSVMLoss<SparseFeature>;
 template class L2HuberSVMLoss<DenseFeature>;
+template class L2HuberSVMLoss<SparseRow>;
 
 
 }
@@ -20,12 +20,12 @@ namespace jensen {
 template <class Feature>
 class L2HuberSVMLoss : public ContinuousFunctions {
 protected:
-std::vector<Feature>& features;                 // size of features is number of trainins examples (n)
+typename FeatureSet<Feature>::type& features;                 // size of features is number of trainins examples (n)
 Vector& y;                 // size of y is number of training examples (n)
 double thresh;
 double lambda;                 // regularization coefficient for L2 regularization
 public:
-L2HuberSVMLoss(int numFeatures, std::vector<Feature>& features, Vector& y, double thresh, double lambda);
+L2HuberSVMLoss(int numFeatures, typename FeatureSet<Feature>::type& features, Vector& y, double thresh, double lambda);
 L2HuberSVMLoss(const L2HuberSVMLoss& c);         // copy constructor
 
 ~L2HuberSVMLoss();
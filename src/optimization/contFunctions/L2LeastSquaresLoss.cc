@@ -14,12 +14,13 @@ using namespace std;
 
 #include "L2LeastSquaresLoss.h"
 #include "../../representation/VectorOperations.h"
+#include "../../representation/DenseLinearAlgebra.h"
 #include <assert.h>
 #define EPSILON 1e-6
 #define MAX 1e2
 namespace jensen {
 template <class Feature>
-L2LeastSquaresLoss<Feature>::L2LeastSquaresLoss(int m, std::vector<Feature>& features, Vector& y, double lambda) :
+L2LeastSquaresLoss<Feature>::L2LeastSquaresLoss(int m, typename FeatureSet<Feature>::type& features, Vector& y, double lambda) :
 	ContinuousFunctions(true, m, features.size()), features(features), y(y), lambda(lambda)
 {
 	if (n > 0)
@@ -29,7 +30,7 @@ L2LeastSquaresLoss<Feature>::L2LeastSquaresLoss(int m, std::vector<Feature>& fea
 
 template <class Feature>
 L2LeastSquaresLoss<Feature>::L2LeastSquaresLoss(const L2LeastSquaresLoss& l) :
-	ContinuousFunctions(true, l.m, l.n), features(l.features), y(l.y), lambda(l.lambda) {
+	ContinuousFunctions(l), features(l.features), y(l.y), lambda(l.lambda) {
 }
 
 template <class Feature>
@@ -41,6 +42,7 @@ double L2LeastSquaresLoss<Feature>::eval(const Vector& x) const {
 	assert(x.size() == m);
 	double sum = 0.5*lambda*(x*x);
 	double val;
+	#pragma omp parallel for schedule(static) num_threads(numThreads(n)) reduction(+:sum)
 	for (int i = 0; i < n; i++) {
 		sum += (y[i] - (x*features[i]))*(y[i] - (x*features[i]));
 	}
@@ -52,9 +54,17 @@ Vector L2LeastSquaresLoss<Feature>::evalGradient(const Vector& x) const {
 	assert(x.size() == m);
 	Vector g = lambda*x;
 	double val;
-	for (int i = 0; i < n; i++) {
-		g -= 2*(y[i] - (x*features[i]))*features[i];
+	int T = numThreads(n);
+	reserveLocalGradients(T);
+	#pragma omp parallel num_threads(T)
+	{
+		Vector& gt = localGradient(g);
+		#pragma omp for schedule(static)
+		for (int i = 0; i < n; i++) {
+			featureMultiplySubtract(gt, 2*(y[i] - (x*features[i])), features[i]);
+		}
 	}
+	sumLocalGradients(g, T);
 	return g;
 }
 
@@ -62,25 +72,109 @@ template <class Feature>
 void L2LeastSquaresLoss<Feature>::eval(const Vector& x, double& f, Vector& g) const {
 	assert(x.size() == m);
 	g = lambda*x;
-	f = 0.5*lambda*(x*x);
+	double sum = 0.5*lambda*(x*x);
 	double val;
-	for (int i = 0; i < n; i++) {
-		double val = y[i] - (x*features[i]);
-		f += val*val;
-		g -= 2*val*features[i];
+	int T = numThreads(n);
+	reserveLocalGradients(T);
+	#pragma omp parallel num_threads(T) reduction(+:sum)
+	{
+		Vector& gt = localGradient(g);
+		#pragma omp for schedule(static)
+		for (int i = 0; i < n; i++) {
+			double val = y[i] - (x*features[i]);
+			sum += val*val;
+			featureMultiplySubtract(gt, 2*val, features[i]);
+		}
 	}
+	sumLocalGradients(g, T);
+	f = sum;
 	return;
 }
 
+// The hessian lambda I + 2 X^T X does not depend on x.
+template <class Feature>
+bool L2LeastSquaresLoss<Feature>::evalDenseHessian(const Vector& x, double& f, Vector& g, Vector& H) const {
+	eval(x, f, g);
+	Vector D(n, 2);
+	H.resize((long int) m*m);
+	weightedGram<Feature>(features, D.data(), m, H.data(), numThreads(n));
+	for (int j = 0; j < m; j++)
+		H[(long int) j*m + j] += lambda;
+	return true;
+}
+
+template <class Feature>
+bool L2LeastSquaresLoss<Feature>::prepareSparseSteps() const {
+	sparseSteps.prepare(features, m, false);
+	return true;
+}
+
+template <class Feature>
+double L2LeastSquaresLoss<Feature>::sparseStochasticStep(Vector& x, const std::vector<int>& miniBatch, const SparseStepRule& rule) const {
+	double sum = 0;
+	double regScale = lambda*n/miniBatch.size();
+	for (int k = 0; k < miniBatch.size(); k++) {
+		int i = miniBatch[k];
+		double val = y[i] - (x*features[i]);
+		sum += val*val;
+		sparseSteps.apply(x, features[i], -2*val, regScale, rule);
+	}
+	return sum;
+}
+
+template <class Feature>
+bool L2LeastSquaresLoss<Feature>::prepareScaledSteps() const {
+	return true;
+}
+
+template <class Feature>
+double L2LeastSquaresLoss<Feature>::scaledStochasticStep(ScaledVector& x, const std::vector<int>& miniBatch, const double alpha) const {
+	double sum = 0;
+	Vector coef(miniBatch.size());
+	for (int k = 0; k < miniBatch.size(); k++) {
+		int i = miniBatch[k];
+		double val = y[i] - (x*features[i]);
+		sum += val*val;
+		coef[k] = 2*val;
+	}
+	x.scale(1 - alpha*lambda);
+	for (int k = 0; k < miniBatch.size(); k++)
+		x.multiplyAdd(alpha*coef[k], features[miniBatch[k]]);
+	return sum;
+}
+
+template <class Feature>
+bool L2LeastSquaresLoss<Feature>::prepareAverageGradient(AverageGradientSteps& steps) const {
+	steps.prepare(features, m, lambda, 2);
+	return true;
+}
+
+template <class Feature>
+double L2LeastSquaresLoss<Feature>::averageGradientStep(Vector& x, const int i, AverageGradientSteps& steps) const {
+	double val = y[i] - steps.margin(x, features[i]);
+	steps.update(x, features[i], i, -2*val);
+	return val*val;
+}
+
 template <class Feature>
 Vector L2LeastSquaresLoss<Feature>::evalStochasticGradient(const Vector& x, std::vector<int>& miniBatch) const {
 	assert(x.size() == m);
 	Vector g = lambda*x;
 	double val;
-	for (vector<int>::iterator it = miniBatch.begin(); it != miniBatch.end(); it++) {
-		double val = y[*it] - (x*features[*it]);
-		g -= 2*val*features[*it];
+	int batchSize = miniBatch.size();
+	int T = numThreads(batchSize);
+	reserveLocalGradients(T);
+	#pragma omp parallel num_threads(T)
+	{
+		Vector& gt = localGradient(g);
+		#pragma omp for schedule(static)
+		for (int k = 0; k < batchSize; k++) {
+			int i = miniBatch[k];
+			double val = y[i] - (x*features[i]);
+			featureMultiplySubtract(gt, 2*val, features[i]);
+		}
 	}
+	sumLocalGradients(g, T);
 	return g;
 }
 
@@ -88,17 +182,27 @@ template <class Feature>
 void L2LeastSquaresLoss<Feature>::evalStochastic(const Vector& x, double& f, Vector& g, std::vector<int>& miniBatch) const {
 	assert(x.size() == m);
 	g = lambda*x;
-	f = 0.5*lambda*(x*x);
-	for (vector<int>::iterator it = miniBatch.begin(); it != miniBatch.end(); it++) {
-		for (vector<int>::iterator it = miniBatch.begin(); it != miniBatch.end(); it++) {
-			double val = y[*it] - (x*features[*it]);
-			f += val*val;
-			g -= 2*val*features[*it];
+	double sum = 0.5*lambda*(x*x);
+	int batchSize = miniBatch.size();
+	int T = numThreads(batchSize);
+	reserveLocalGradients(T);
+	#pragma omp parallel num_threads(T) reduction(+:sum)
+	{
+		Vector& gt = localGradient(g);
+		#pragma omp for schedule(static)
+		for (int k = 0; k < batchSize; k++) {
+			int i = miniBatch[k];
+			double val = y[i] - (x*features[i]);
+			sum += val*val;
+			featureMultiplySubtract(gt, 2*val, features[i]);
 		}
 	}
+	sumLocalGradients(g, T);
+	f = sum;
 	return;
 }
 template class L2LeastSquaresLoss<SparseFeature>;
 template class L2LeastSquaresLoss<DenseFeature>;
+template class L2LeastSquaresLoss<SparseRow>;
 
 }
@@ -20,11 +20,12 @@ namespace jensen {
 template <class Feature>
 class L2LeastSquaresLoss : public ContinuousFunctions {
 protected:
-std::vector<Feature>& features;                 // size of features is number of trainins examples (n)
+typename FeatureSet<Feature>::type& features;                 // size of features is number of trainins examples (n)
 Vector& y;                 // size of y is number of training examples (n)
 double lambda;                 // regularization parameter
+mutable SparseSteps sparseSteps;                 // feature counts of the lock-free stochastic steps
 public:
-L2LeastSquaresLoss(int numFeatures, std::vector<Feature>& features, Vector& y, double lambda);
+L2LeastSquaresLoss(int numFeatures, typename FeatureSet<Feature>::type& features, Vector& y, double lambda);
 L2LeastSquaresLoss(const L2LeastSquaresLoss& c);         // copy constructor
 
 ~L2LeastSquaresLoss();
@@ -32,6 +33,13 @@ L2LeastSquaresLoss(const L2LeastSquaresLoss& c);         // copy constructor
 double eval(const Vector& x) const;                 // functionEval
 Vector evalGradient(const Vector& x) const;                 // gradientEval
 void eval(const Vector& x, double& f, Vector& gradient) const;                 // combined function and gradient eval
+bool evalDenseHessian(const Vector& x, double& f, Vector& g, Vector& H) const;                 // eval(x, f, g) and the m x m hessian
+bool prepareSparseSteps() const;
+double sparseStochasticStep(Vector& x, const std::vector<int>& miniBatch, const SparseStepRule& rule) const;                 // lock-free step on the rows of miniBatch
+bool prepareScaledSteps() const;
+double scaledStochasticStep(ScaledVector& x, const std::vector<int>& miniBatch, const double alpha) const;                 // O(nnz) step on scaled weights
+bool prepareAverageGradient(AverageGradientSteps& steps) const;
+double averageGradientStep(Vector& x, const int i, AverageGradientSteps& steps) const;                 // SAG/SAGA step on sample i
 Vector evalStochasticGradient(const Vector& x, std::vector<int>& miniBatch) const;                 // stochastic gradient
 void evalStochastic(const Vector& x, double& f, Vector& g, std::vector<int>& miniBatch) const;                 // stochastic evaluation
 };
@@ -12,30 +12,15 @@ using namespace std;
 
 #include "L2LogisticLoss.h"
 #include "../../representation/VectorOperations.h"
+#include "../../representation/DenseLinearAlgebra.h"
 #include <assert.h>
 #define EPSILON 1e-6
 #define MAX 1e2
 namespace jensen {
 
-void UpdateHessianVectorProd(vector<SparseFeature>& features, Vector& Hxv, Vector& w, int n){
-	for (int i = 0; i < n; i++) {
-		for (int j = 0; j < features[i].featureIndex.size(); j++) {
-			Hxv[features[i].featureIndex[j]] += w[i]*features[i].featureVec[j];
-		}
-	}
-}
-
-void UpdateHessianVectorProd(vector<DenseFeature>& features, Vector& Hxv, Vector& w, int n){
-	for (int i = 0; i < n; i++) {
-		for (int j = 0; j < features[i].featureVec.size(); j++) {
-			Hxv[j] += w[i]*features[i].featureVec[j];
-		}
-	}
-}
-
 template <class Feature>
-L2LogisticLoss<Feature>::L2LogisticLoss(int m, std::vector<Feature>& features, Vector& y, double lambda) :
-	ContinuousFunctions(true, m, features.size()), features(features), y(y), lambda(lambda)
+L2LogisticLoss<Feature>::L2LogisticLoss(int m, typename FeatureSet<Feature>::type& features, Vector& y, double lambda) :
+	ContinuousFunctions(true, m, features.size()), features(features), y(y), lambda(lambda), curvatureValid(false)
 {
 	if (n > 0)
 		assert(features[0].numFeatures == m);
@@ -43,23 +28,38 @@ L2LogisticLoss<Feature>::L2LogisticLoss(int m, std::vector<Feature>& features, V
 }
 template <class Feature>
 L2LogisticLoss<Feature>::L2LogisticLoss(const L2LogisticLoss& l) :
-	ContinuousFunctions(true, l.m, l.n), features(l.features), y(l.y), lambda(l.lambda) {
+	ContinuousFunctions(l), features(l.features), y(l.y), lambda(l.lambda), curvatureValid(false) {
 }
 
 template <class Feature>
 L2LogisticLoss<Feature>::~L2LogisticLoss(){
 }
 
+// Computes the margins at x, unless they are cached already.
+template <class Feature>
+void L2LogisticLoss<Feature>::updateMargins(const Vector& x) const {
+	if ((margins.size() == n) && (x == cachePoint))
+		return;
+	margins.resize(n);
+	#pragma omp parallel for schedule(static) num_threads(numThreads(n))
+	for (int i = 0; i < n; i++)
+		margins[i] = y[i]*(x*features[i]);
+	cachePoint = x;
+	curvatureValid = false;
+}
+
 template <class Feature>
 double L2LogisticLoss<Feature>::eval(const Vector& x) const {
 	assert(x.size() == m);
-	double sum = 0.5*lambda*(x*x);;
+	updateMargins(x);
+	double sum = 0.5*lambda*(x*x);
+	#pragma omp parallel for schedule(static) num_threads(numThreads(n)) reduction(+:sum)
 	for (int i = 0; i < n; i++) {
-		double preval = y[i]*(x*features[i]);
+		double preval = margins[i];
 		if (preval > MAX)
 			continue;
 		else if (preval < -1*MAX)
-			sum += preval;
+			sum -= preval;
 		else
 			sum += log(1 + exp(-preval));
 	}
@@ -69,69 +69,275 @@ double L2LogisticLoss<Feature>::eval(const Vector& x) const {
 template <class Feature>
 Vector L2LogisticLoss<Feature>::evalGradient(const Vector& x) const {
 	assert(x.size() == m);
+	updateMargins(x);
 	Vector g = lambda*x;
-	for (int i = 0; i < n; i++) {
-		double preval = y[i]*(x*features[i]);
-		if (preval > MAX)
-			g -= y[i]*features[i];
-		else if (preval < -1*MAX)
-			continue;
-		else
-			g -= (y[i]/(1 + exp(-preval)))*features[i];
+	int T = numThreads(n);
+	reserveLocalGradients(T);
+	#pragma omp parallel num_threads(T)
+	{
+		Vector& gt = localGradient(g);
+		#pragma omp for schedule(static)
+		for (int i = 0; i < n; i++) {
+			double preval = margins[i];
+			if (preval > MAX)
+				featureMultiplySubtract(gt, y[i], features[i]);
+			else if (preval < -1*MAX)
+				continue;
+			else
+				featureMultiplySubtract(gt, y[i]/(1 + exp(-preval)), features[i]);
+		}
 	}
+	sumLocalGradients(g, T);
 	return g;
 }
 
 template <class Feature>
 void L2LogisticLoss<Feature>::eval(const Vector& x, double& f, Vector& g) const {
 	assert(x.size() == m);
+	updateMargins(x);
+	curvature.resize(n);
 	g = lambda*x;
-	f = 0.5*lambda*(x*x);
-	double val;
-	for (int i = 0; i < n; i++) {
-		double preval = y[i]*(x*features[i]);
-		if (preval > MAX) {
-			g -= (y[i]/(1 + exp(preval)))*features[i];
-		}
-		else if (preval < -1*MAX) {
-			g -= (y[i]/(1 + exp(preval)))*features[i];
-			f-=preval;
-		}
-		else{
-			f += log(1 + exp(-preval));
-			g -= (y[i]/(1 + exp(preval)))*features[i];
+	double sum = 0.5*lambda*(x*x);
+	int T = numThreads(n);
+	reserveLocalGradients(T);
+	#pragma omp parallel num_threads(T) reduction(+:sum)
+	{
+		Vector& gt = localGradient(g);
+		#pragma omp for schedule(static)
+		for (int i = 0; i < n; i++) {
+			double preval = margins[i];
+			double sigma = 1/(1 + exp(preval));
+			curvature[i] = sigma*(1 - sigma);
+			if (preval > MAX) {
+				featureMultiplySubtract(gt, y[i]*sigma, features[i]);
+			}
+			else if (preval < -1*MAX) {
+				featureMultiplySubtract(gt, y[i]*sigma, features[i]);
+				sum-=preval;
+			}
+			else{
+				sum += log(1 + exp(-preval));
+				featureMultiplySubtract(gt, y[i]*sigma, features[i]);
+			}
 		}
 	}
+	sumLocalGradients(g, T);
+	f = sum;
+	curvatureValid = true;
 	return;
 }
 
 template <class Feature>
 void L2LogisticLoss<Feature>::evalHessianVectorProduct(const Vector& x, const Vector& v, Vector& Hxv) const {  // evaluate a product between a hessian and a vector
-	Vector w(n, 0);
-	Hxv = Vector(m, 0);
-	for (int i = 0; i < n; i++) {
-		double val = y[i]*(x*features[i]);
-		double z = 1/(1 + exp(-val));
-		double D = z*(1 - z);
-		w[i] = D*(v*features[i]);
+	updateMargins(x);
+	int T = numThreads(n);
+	if (!curvatureValid) {
+		curvature.resize(n);
+		#pragma omp parallel for schedule(static) num_threads(T)
+		for (int i = 0; i < n; i++) {
+			double sigma = 1/(1 + exp(margins[i]));
+			curvature[i] = sigma*(1 - sigma);
+		}
+		curvatureValid = true;
+	}
+	scalarMultiplication(v, lambda, Hxv);
+	reserveLocalGradients(T);
+	#pragma omp parallel num_threads(T)
+	{
+		Vector& ht = localGradient(Hxv);
+		#pragma omp for schedule(static)
+		for (int i = 0; i < n; i++)
+			featureMultiplyAdd(ht, curvature[i]*(v*features[i]), features[i]);
 	}
-	UpdateHessianVectorProd(features, Hxv, w, n);
-	Hxv += v;
+	sumLocalGradients(Hxv, T);
 }
 
 template <class Feature>
-Vector L2LogisticLoss<Feature>::evalStochasticGradient(const Vector& x, std::vector<int>& miniBatch) const {
+bool L2LogisticLoss<Feature>::prepareHessianSubsample() const {
+	return true;
+}
+
+template <class Feature>
+void L2LogisticLoss<Feature>::evalSubsampledHessianVectorProduct(const Vector& x, const Vector& v, Vector& Hxv,
+                                                                 const std::vector<int>& rows) const {
+	updateMargins(x);
+	scalarMultiplication(v, lambda, Hxv);
+	int size = rows.size();
+	double scale = (double) n/max(size, 1);
+	int T = numThreads(size);
+	reserveLocalGradients(T);
+	#pragma omp parallel num_threads(T)
+	{
+		Vector& ht = localGradient(Hxv);
+		#pragma omp for schedule(static)
+		for (int k = 0; k < size; k++) {
+			int i = rows[k];
+			double sigma = 1/(1 + exp(margins[i]));
+			featureMultiplyAdd(ht, scale*sigma*(1 - sigma)*(v*features[i]), features[i]);
+		}
+	}
+	sumLocalGradients(Hxv, T);
+}
+
+// As eval(x, f, g), with the diagonal lambda + sum_i sigma_i (1 - sigma_i) f_ij^2 of the hessian accumulated in the same pass.
+template <class Feature>
+bool L2LogisticLoss<Feature>::evalHessianDiagonal(const Vector& x, double& f, Vector& g, Vector& diagH) const {
 	assert(x.size() == m);
-	Vector g = lambda*x;
-	for (vector<int>::iterator it = miniBatch.begin(); it != miniBatch.end(); it++) {
-		double preval = y[*it]*(x*features[*it]);
+	updateMargins(x);
+	curvature.resize(n);
+	g = lambda*x;
+	diagH.assign(m, lambda);
+	double sum = 0.5*lambda*(x*x);
+	int T = numThreads(n);
+	reserveLocalGradients(T);
+	#pragma omp parallel num_threads(T) reduction(+:sum)
+	{
+		Vector& gt = localGradient(g);
+		Vector& dt = localGradient(diagH, 1);
+		#pragma omp for schedule(static)
+		for (int i = 0; i < n; i++) {
+			double preval = margins[i];
+			double sigma = 1/(1 + exp(preval));
+			curvature[i] = sigma*(1 - sigma);
+			if (preval < -1*MAX)
+				sum -= preval;
+			else if (preval <= MAX)
+				sum += log(1 + exp(-preval));
+			featureMultiplyAddSquares(gt, -y[i]*sigma, dt, curvature[i], features[i]);
+		}
+	}
+	sumLocalGradients(g, T);
+	sumLocalGradients(diagH, T, 1);
+	f = sum;
+	curvatureValid = true;
+	return true;
+}
+
+// eval(x, f, g) leaves the curvature sigma_i (1 - sigma_i) at x, the diagonal D of the hessian X^T D X + lambda I.
+template <class Feature>
+bool L2LogisticLoss<Feature>::evalDenseHessian(const Vector& x, double& f, Vector& g, Vector& H) const {
+	eval(x, f, g);
+	H.resize((long int) m*m);
+	weightedGram<Feature>(features, curvature.data(), m, H.data(), numThreads(n));
+	for (int j = 0; j < m; j++)
+		H[(long int) j*m + j] += lambda;
+	return true;
+}
+
+template <class Feature>
+bool L2LogisticLoss<Feature>::prepareDirection(const Vector& x, const Vector& d) const {
+	updateMargins(x);                 // usually cached by the eval at x
+	lineSearch.prepare(features, y, x, d, margins, numThreads(n));
+	return true;
+}
+
+// The margins of the trial point are kept, so the eval of the accepted point only needs the pass over X^T.
+template <class Feature>
+double L2LogisticLoss<Feature>::evalAlongDirection(const double a) const {
+	double sum = 0.5*lambda*lineSearch.squaredNorm(a);
+	#pragma omp parallel for schedule(static) num_threads(numThreads(n)) reduction(+:sum)
+	for (int i = 0; i < n; i++) {
+		double preval = lineSearch.margin(i, a);
+		margins[i] = preval;
 		if (preval > MAX)
-			g -= y[*it]*features[*it];
-		else if (preval < -1*MAX)
 			continue;
+		else if (preval < -1*MAX)
+			sum -= preval;
 		else
-			g -= (y[*it]/(1 + exp(-preval)))*features[*it];
+			sum += log(1 + exp(-preval));
+	}
+	multiplyAccumulate(cachePoint, lineSearch.x, a, lineSearch.d);
+	curvatureValid = false;
+	return sum;
+}
+
+template <class Feature>
+bool L2LogisticLoss<Feature>::prepareSparseSteps() const {
+	sparseSteps.prepare(features, m, false);
+	return true;
+}
+
+template <class Feature>
+double L2LogisticLoss<Feature>::sparseStochasticStep(Vector& x, const std::vector<int>& miniBatch, const SparseStepRule& rule) const {
+	double sum = 0;
+	double regScale = lambda*n/miniBatch.size();
+	for (int k = 0; k < miniBatch.size(); k++) {
+		int i = miniBatch[k];
+		double preval = y[i]*(x*features[i]);
+		if (preval < -1*MAX)
+			sum -= preval;
+		else if (preval <= MAX)
+			sum += log(1 + exp(-preval));
+		sparseSteps.apply(x, features[i], -y[i]/(1 + exp(preval)), regScale, rule);
+	}
+	return sum;
+}
+
+template <class Feature>
+bool L2LogisticLoss<Feature>::prepareScaledSteps() const {
+	return true;
+}
+
+template <class Feature>
+double L2LogisticLoss<Feature>::scaledStochasticStep(ScaledVector& x, const std::vector<int>& miniBatch, const double alpha) const {
+	double sum = 0;
+	Vector coef(miniBatch.size());
+	for (int k = 0; k < miniBatch.size(); k++) {
+		int i = miniBatch[k];
+		double preval = y[i]*(x*features[i]);
+		if (preval < -1*MAX)
+			sum -= preval;
+		else if (preval <= MAX)
+			sum += log(1 + exp(-preval));
+		coef[k] = y[i]/(1 + exp(preval));
 	}
+	x.scale(1 - alpha*lambda);
+	for (int k = 0; k < miniBatch.size(); k++)
+		x.multiplyAdd(alpha*coef[k], features[miniBatch[k]]);
+	return sum;
+}
+
+template <class Feature>
+bool L2LogisticLoss<Feature>::prepareAverageGradient(AverageGradientSteps& steps) const {
+	steps.prepare(features, m, lambda, 0.25);
+	return true;
+}
+
+template <class Feature>
+double L2LogisticLoss<Feature>::averageGradientStep(Vector& x, const int i, AverageGradientSteps& steps) const {
+	double preval = y[i]*steps.margin(x, features[i]);
+	double sum = 0;
+	if (preval < -1*MAX)
+		sum -= preval;
+	else if (preval <= MAX)
+		sum += log(1 + exp(-preval));
+	steps.update(x, features[i], i, -y[i]/(1 + exp(preval)));
+	return sum;
+}
+
+template <class Feature>
+Vector L2LogisticLoss<Feature>::evalStochasticGradient(const Vector& x, std::vector<int>& miniBatch) const {
+	assert(x.size() == m);
+	Vector g = lambda*x;
+	int batchSize = miniBatch.size();
+	int T = numThreads(batchSize);
+	reserveLocalGradients(T);
+	#pragma omp parallel num_threads(T)
+	{
+		Vector& gt = localGradient(g);
+		#pragma omp for schedule(static)
+		for (int k = 0; k < batchSize; k++) {
+			int i = miniBatch[k];
+			double preval = y[i]*(x*features[i]);
+			if (preval > MAX)
+				featureMultiplySubtract(gt, y[i], features[i]);
+			else if (preval < -1*MAX)
+				continue;
+			else
+				featureMultiplySubtract(gt, y[i]/(1 + exp(-preval)), features[i]);
+		}
+	}
+	sumLocalGradients(g, T);
 	return g;
 }
 
@@ -139,27 +345,38 @@ template <class Feature>
 void L2LogisticLoss<Feature>::evalStochastic(const Vector& x, double& f, Vector& g, std::vector<int>& miniBatch) const {
 	assert(x.size() == m);
 	g = lambda*x;
-	f = 0.5*lambda*(x*x);
-	double val;
-	for (vector<int>::iterator it = miniBatch.begin(); it != miniBatch.end(); it++) {
-		double preval = y[*it]*(x*features[*it]);
-		if (preval > MAX) {
-			g -= (y[*it]/(1 + exp(preval)))*features[*it];
-		}
-		else if (preval < -1*MAX) {
-			g -= (y[*it]/(1 + exp(preval)))*features[*it];
-			f-=preval;
-		}
-		else{
-			f += log(1 + exp(-preval));
-			g -= (y[*it]/(1 + exp(preval)))*features[*it];
+	double sum = 0.5*lambda*(x*x);
+	int batchSize = miniBatch.size();
+	int T = numThreads(batchSize);
+	reserveLocalGradients(T);
+	#pragma omp parallel num_threads(T) reduction(+:sum)
+	{
+		Vector& gt = localGradient(g);
+		#pragma omp for schedule(static)
+		for (int k = 0; k < batchSize; k++) {
+			int i = miniBatch[k];
+			double preval = y[i]*(x*features[i]);
+			if (preval > MAX) {
+				featureMultiplySubtract(gt, y[i]/(1 + exp(preval)), features[i]);
+			}
+			else if (preval < -1*MAX) {
+				featureMultiplySubtract(gt, y[i]/(1 + exp(preval)), features[i]);
+				sum-=preval;
+			}
+			else{
+				sum += log(1 + exp(-preval));
+				featureMultiplySubtract(gt, y[i]/(1 + exp(preval)), features[i]);
+			}
 		}
 	}
+	sumLocalGradients(g, T);
+	f = sum;
 	return;
 }
 
 template class L2LogisticLoss<SparseFeature>;
 template class L2LogisticLoss<DenseFeature>;
+template class L2LogisticLoss<SparseRow>;
 
 
 }
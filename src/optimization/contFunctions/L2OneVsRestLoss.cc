@@ -0,0 +1,285 @@
+// Copyright (C) Rishabh Iyer, John T. Halloran, and Kai Wei
+// Licensed under the Open Software License version 3.0
+// See COPYING or http://opensource.org/licenses/OSL-3.0
+/*
+        Jensen: A Convex Optimization And Machine Learning ToolKit
+ *	One-vs-rest multi-class loss with L2 regularization
+        Author: Rishabh Iyer
+ *
+ */
+
+#include <iostream>
+#include <math.h>
+using namespace std;
+
+#include "L2OneVsRestLoss.h"
+#include "../../representation/VectorOperations.h"
+#include <assert.h>
+#define EPSILON 1e-6
+#define MAX 1e2
+namespace jensen {
+
+template <class Feature>
+L2OneVsRestLoss<Feature>::L2OneVsRestLoss(int numFeatures, typename FeatureSet<Feature>::type& features, Vector& y, int nClasses,
+                                          double lambda, OneVsRestLossType type) :
+	ContinuousFunctions(true, numFeatures*nClasses, features.size()), features(features), y(y), nClasses(nClasses),
+	numFeatures(numFeatures), lambda(lambda), type(type), curvatureValid(false)
+{
+	if (n > 0)
+		assert(features[0].numFeatures == numFeatures);
+	assert(features.size() == y.size());
+}
+
+template <class Feature>
+L2OneVsRestLoss<Feature>::L2OneVsRestLoss(const L2OneVsRestLoss& l) :
+	ContinuousFunctions(l), features(l.features), y(l.y), nClasses(l.nClasses), numFeatures(l.numFeatures), lambda(l.lambda),
+	type(l.type), curvatureValid(false) {
+}
+
+template <class Feature>
+L2OneVsRestLoss<Feature>::~L2OneVsRestLoss(){
+}
+
+// Computes the scores of all classes at x, unless they are cached already.
+template <class Feature>
+void L2OneVsRestLoss<Feature>::updateScores(const Vector& x) const {
+	int K = nClasses;
+	if ((scores.size() == (long int) n*K) && (x == cachePoint))
+		return;
+	scores.assign((long int) n*K, 0);
+	#pragma omp parallel for schedule(static) num_threads(numThreads(n))
+	for (int i = 0; i < n; i++)
+		classScores(x, features[i], K, &scores[(long int) i*K]);
+	cachePoint = x;
+	curvatureValid = false;
+}
+
+template <class Feature>
+double L2OneVsRestLoss<Feature>::rowLoss(const int i, const double* s, double* coef) const {
+	double sum = 0;
+	for (int c = 0; c < nClasses; c++) {
+		double yc = (y[i] == c) ? 1 : -1;
+		double preval = yc*s[c];
+		if (type == OVR_LOGISTIC) {
+			if (preval < -1*MAX)
+				sum -= preval;
+			else if (preval <= MAX)
+				sum += log(1 + exp(-preval));
+			coef[c] = -yc/(1 + exp(preval));
+		}
+		else if (1 - preval >= 0) {
+			sum += (1 - preval)*(1 - preval);
+			coef[c] = -2*(1 - preval)*yc;
+		}
+		else
+			coef[c] = 0;
+	}
+	return sum;
+}
+
+template <class Feature>
+void L2OneVsRestLoss<Feature>::rowCurvature(const int i, const double* s, double* d) const {
+	for (int c = 0; c < nClasses; c++) {
+		double preval = ((y[i] == c) ? 1 : -1)*s[c];
+		if (type == OVR_LOGISTIC) {
+			double sigma = 1/(1 + exp(preval));
+			d[c] = sigma*(1 - sigma);
+		}
+		else
+			d[c] = (1 - preval >= 0) ? 2 : 0;
+	}
+}
+
+template <class Feature>
+void L2OneVsRestLoss<Feature>::updateCurvature() const {
+	int K = nClasses;
+	curvature.resize((long int) n*K);
+	#pragma omp parallel for schedule(static) num_threads(numThreads(n))
+	for (int i = 0; i < n; i++)
+		rowCurvature(i, &scores[(long int) i*K], &curvature[(long int) i*K]);
+	curvatureValid = true;
+}
+
+template <class Feature>
+double L2OneVsRestLoss<Feature>::eval(const Vector& x) const {
+	assert(x.size() == m);
+	updateScores(x);
+	double sum = 0.5*lambda*(x*x);
+	#pragma omp parallel num_threads(numThreads(n)) reduction(+:sum)
+	{
+		Vector coef(nClasses);
+		#pragma omp for schedule(static)
+		for (int i = 0; i < n; i++)
+			sum += rowLoss(i, &scores[(long int) i*nClasses], coef.data());
+	}
+	return sum;
+}
+
+template <class Feature>
+Vector L2OneVsRestLoss<Feature>::evalGradient(const Vector& x) const {
+	double f;
+	Vector g;
+	eval(x, f, g);
+	return g;
+}
+
+template <class Feature>
+void L2OneVsRestLoss<Feature>::eval(const Vector& x, double& f, Vector& g) const {
+	assert(x.size() == m);
+	updateScores(x);
+	g = lambda*x;
+	double sum = 0.5*lambda*(x*x);
+	int T = numThreads(n);
+	reserveLocalGradients(T);
+	#pragma omp parallel num_threads(T) reduction(+:sum)
+	{
+		Vector& gt = localGradient(g);
+		Vector coef(nClasses);
+		#pragma omp for schedule(static)
+		for (int i = 0; i < n; i++) {
+			sum += rowLoss(i, &scores[(long int) i*nClasses], coef.data());
+			classUpdate(gt, features[i], nClasses, coef.data());
+		}
+	}
+	sumLocalGradients(g, T);
+	f = sum;
+}
+
+template <class Feature>
+void L2OneVsRestLoss<Feature>::evalHessianVectorProduct(const Vector& x, const Vector& v, Vector& Hxv) const {  // evaluate a product between a hessian and a vector
+	updateScores(x);
+	if (!curvatureValid)
+		updateCurvature();
+	scalarMultiplication(v, lambda, Hxv);
+	int K = nClasses;
+	int T = numThreads(n);
+	reserveLocalGradients(T);
+	#pragma omp parallel num_threads(T)
+	{
+		Vector& ht = localGradient(Hxv);
+		Vector coef(K);
+		#pragma omp for schedule(static)
+		for (int i = 0; i < n; i++) {
+			const double* d = &curvature[(long int) i*K];
+			bool active = false;
+			for (int c = 0; c < K; c++)
+				active = active || (d[c] != 0);
+			if (!active)
+				continue;
+			coef.assign(K, 0);
+			classScores(v, features[i], K, coef.data());
+			for (int c = 0; c < K; c++)
+				coef[c] *= d[c];
+			classUpdate(ht, features[i], K, coef.data());
+		}
+	}
+	sumLocalGradients(Hxv, T);
+}
+
+template <class Feature>
+bool L2OneVsRestLoss<Feature>::prepareHessianSubsample() const {
+	return true;
+}
+
+template <class Feature>
+void L2OneVsRestLoss<Feature>::evalSubsampledHessianVectorProduct(const Vector& x, const Vector& v, Vector& Hxv,
+                                                                  const std::vector<int>& rows) const {
+	updateScores(x);
+	if (!curvatureValid)
+		updateCurvature();
+	scalarMultiplication(v, lambda, Hxv);
+	int K = nClasses;
+	int size = rows.size();
+	double scale = (double) n/max(size, 1);
+	int T = numThreads(size);
+	reserveLocalGradients(T);
+	#pragma omp parallel num_threads(T)
+	{
+		Vector& ht = localGradient(Hxv);
+		Vector coef(K);
+		#pragma omp for schedule(static)
+		for (int k = 0; k < size; k++) {
+			int i = rows[k];
+			const double* d = &curvature[(long int) i*K];
+			coef.assign(K, 0);
+			classScores(v, features[i], K, coef.data());
+			for (int c = 0; c < K; c++)
+				coef[c] *= scale*d[c];
+			classUpdate(ht, features[i], K, coef.data());
+		}
+	}
+	sumLocalGradients(Hxv, T);
+}
+
+// As eval(x, f, g), with the curvatures of the rows (kept for the hessian vector products) and the diagonal of the hessian
+// accumulated in the same pass.
+template <class Feature>
+bool L2OneVsRestLoss<Feature>::evalHessianDiagonal(const Vector& x, double& f, Vector& g, Vector& diagH) const {
+	assert(x.size() == m);
+	updateScores(x);
+	int K = nClasses;
+	curvature.resize((long int) n*K);
+	g = lambda*x;
+	diagH.assign(m, lambda);
+	double sum = 0.5*lambda*(x*x);
+	int T = numThreads(n);
+	reserveLocalGradients(T);
+	#pragma omp parallel num_threads(T) reduction(+:sum)
+	{
+		Vector& gt = localGradient(g);
+		Vector& dt = localGradient(diagH, 1);
+		Vector coef(K);
+		#pragma omp for schedule(static)
+		for (int i = 0; i < n; i++) {
+			const double* s = &scores[(long int) i*K];
+			double* d = &curvature[(long int) i*K];
+			sum += rowLoss(i, s, coef.data());
+			rowCurvature(i, s, d);
+			classUpdateSquares(gt, coef.data(), dt, d, features[i], K);
+		}
+	}
+	sumLocalGradients(g, T);
+	sumLocalGradients(diagH, T, 1);
+	f = sum;
+	curvatureValid = true;
+	return true;
+}
+
+template <class Feature>
+Vector L2OneVsRestLoss<Feature>::evalStochasticGradient(const Vector& x, std::vector<int>& miniBatch) const {
+	double f;
+	Vector g;
+	evalStochastic(x, f, g, miniBatch);
+	return g;
+}
+
+template <class Feature>
+void L2OneVsRestLoss<Feature>::evalStochastic(const Vector& x, double& f, Vector& g, std::vector<int>& miniBatch) const {
+	assert(x.size() == m);
+	g = lambda*x;
+	double sum = 0.5*lambda*(x*x);
+	int batchSize = miniBatch.size();
+	int T = numThreads(batchSize);
+	reserveLocalGradients(T);
+	#pragma omp parallel num_threads(T) reduction(+:sum)
+	{
+		Vector& gt = localGradient(g);
+		Vector s(nClasses), coef(nClasses);
+		#pragma omp for schedule(static)
+		for (int k = 0; k < batchSize; k++) {
+			int i = miniBatch[k];
+			s.assign(nClasses, 0);
+			classScores(x, features[i], nClasses, s.data());
+			sum += rowLoss(i, s.data(), coef.data());
+			classUpdate(gt, features[i], nClasses, coef.data());
+		}
+	}
+	sumLocalGradients(g, T);
+	f = sum;
+}
+
+template class L2OneVsRestLoss<SparseFeature>;
+template class L2OneVsRestLoss<DenseFeature>;
+template class L2OneVsRestLoss<SparseRow>;
+
+}
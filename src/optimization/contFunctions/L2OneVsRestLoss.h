@@ -0,0 +1,68 @@
+// Copyright (C) Rishabh Iyer, John T. Halloran, and Kai Wei
+// Licensed under the Open Software License version 3.0
+// See COPYING or http://opensource.org/licenses/OSL-3.0
+/*
+        Jensen: A Convex Optimization And Machine Learning ToolKit
+ *	One-vs-rest multi-class loss with L2 regularization: the sum over the classes c of the binary
+        logistic (or smooth SVM) losses of w_c on the labels y_ic = (y_i == c) ? 1 : -1. The problems
+        of the classes are independent, but are optimized jointly over x = (w_0, ..., w_{K-1}) so that
+        every evaluation reads each row once and computes the margins of all K classes together.
+
+        x is an m x K block (see ClassBlock.h): x[j*K + c] is the weight of feature j in class c. The
+        labels y are the class indices 0..K-1.
+        Author: Rishabh Iyer
+ *
+ */
+
+#ifndef L2_ONE_VS_REST_LOSS_H
+#define L2_ONE_VS_REST_LOSS_H
+
+#include "../../representation/Vector.h"
+#include "../../representation/Matrix.h"
+#include "../../representation/VectorOperations.h"
+#include "ContinuousFunctions.h"
+#include "ClassBlock.h"
+namespace jensen {
+
+enum OneVsRestLossType {
+	OVR_LOGISTIC = 0,                 // log(1 + exp(-z))
+	OVR_SMOOTH_SVM = 1                 // max(0, 1 - z)^2
+};
+
+template <class Feature>
+class L2OneVsRestLoss : public ContinuousFunctions {
+protected:
+typename FeatureSet<Feature>::type& features;                 // size of features is number of trainins examples (n)
+Vector& y;                 // the class of each training example, in 0..nClasses-1
+int nClasses;                 // K
+int numFeatures;                 // dimension of the features (m/K)
+double lambda;
+OneVsRestLossType type;
+mutable Vector cachePoint;                 // the point the scores were computed at
+mutable Vector scores;                 // w_c^T f_i at cachePoint, scores[i*K + c]
+mutable Vector curvature;                 // the second derivatives of the losses at the scores
+mutable bool curvatureValid;
+void updateScores(const Vector& x) const;
+double rowLoss(const int i, const double* s, double* coef) const;                 // loss of row i, coef[c]: derivative wrt s[c]
+void rowCurvature(const int i, const double* s, double* d) const;                 // d[c]: second derivative of the loss of row i wrt s[c]
+void updateCurvature() const;
+public:
+L2OneVsRestLoss(int numFeatures, typename FeatureSet<Feature>::type& features, Vector& y, int nClasses, double lambda,
+                OneVsRestLossType type = OVR_LOGISTIC);
+L2OneVsRestLoss(const L2OneVsRestLoss& c);         // copy constructor
+
+~L2OneVsRestLoss();
+
+double eval(const Vector& x) const;                 // functionEval
+Vector evalGradient(const Vector& x) const;                 // gradientEval
+void eval(const Vector& x, double& f, Vector& gradient) const;                 // combined function and gradient eval
+void evalHessianVectorProduct(const Vector& x, const Vector& v, Vector& Hxv) const;                 // evaluate a product between a hessian and a vector
+bool evalHessianDiagonal(const Vector& x, double& f, Vector& g, Vector& diagH) const;                 // eval(x, f, g) and the diagonal of the hessian
+bool prepareHessianSubsample() const;
+void evalSubsampledHessianVectorProduct(const Vector& x, const Vector& v, Vector& Hxv, const std::vector<int>& rows) const;                 // the hessian of the rows, scaled by n/|rows|
+Vector evalStochasticGradient(const Vector& x, std::vector<int>& miniBatch) const;                 // stochastic gradient
+void evalStochastic(const Vector& x, double& f, Vector& g, std::vector<int>& miniBatch) const;                 // stochastic evaluation
+};
+
+}
+#endif
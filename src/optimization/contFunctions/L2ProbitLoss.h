@@ -20,11 +20,11 @@ namespace jensen {
 template <class Feature>
 class L2ProbitLoss : public ContinuousFunctions {
 protected:
-std::vector<Feature>& features;                 // size of features is number of trainins examples (n)
+typename FeatureSet<Feature>::type& features;                 // size of features is number of trainins examples (n)
 Vector& y;                 // size of y is number of training examples (n)
 double lambda;
 public:
-L2ProbitLoss(int numFeatures, std::vector<Feature>& features, Vector& y, double lambda);
+L2ProbitLoss(int numFeatures, typename FeatureSet<Feature>::type& features, Vector& y, double lambda);
 L2ProbitLoss(const L2ProbitLoss& c);         // copy constructor
 
 ~L2ProbitLoss();
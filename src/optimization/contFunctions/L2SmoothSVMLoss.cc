@@ -14,28 +14,14 @@ using namespace std;
 
 #include "L2SmoothSVMLoss.h"
 #include "../../representation/VectorOperations.h"
+#include "../../representation/DenseLinearAlgebra.h"
 #include <assert.h>
 #define EPSILON 1e-6
 #define MAX 1e2
 namespace jensen {
-static void UpdateHessianVectorProd_L2rL2SVM(vector<SparseFeature>& features, Vector& Hxv, Vector& w, int n, int* I){
-	for (int i = 0; i < n; i++) {
-		for (int j = 0; j < features[I[i]].featureIndex.size(); j++) {
-			Hxv[features[I[i]].featureIndex[j]] += w[i]*features[I[i]].featureVec[j];
-		}
-	}
-}
-
-static void UpdateHessianVectorProd_L2rL2SVM(vector<DenseFeature>& features, Vector& Hxv, Vector& w, int n, int* I){
-	for (int i = 0; i < n; i++) {
-		for (int j = 0; j < features[I[i]].featureVec.size(); j++) {
-			Hxv[j] += w[i]*features[I[i]].featureVec[j];
-		}
-	}
-}
 
 template <class Feature>
-L2SmoothSVMLoss<Feature>::L2SmoothSVMLoss(int m, std::vector<Feature>& features, Vector& y, double lambda) :
+L2SmoothSVMLoss<Feature>::L2SmoothSVMLoss(int m, typename FeatureSet<Feature>::type& features, Vector& y, double lambda) :
 	ContinuousFunctions(true, m, features.size()), features(features), y(y), lambda(lambda)
 {
 	if (n > 0)
@@ -47,7 +33,7 @@ L2SmoothSVMLoss<Feature>::L2SmoothSVMLoss(int m, std::vector<Feature>& features,
 
 template <class Feature>
 L2SmoothSVMLoss<Feature>::L2SmoothSVMLoss(const L2SmoothSVMLoss& l) :
-	ContinuousFunctions(true, l.m, l.n), features(l.features), y(l.y), lambda(l.lambda)
+	ContinuousFunctions(l), features(l.features), y(l.y), lambda(l.lambda)
 {
 	I = new int[y.size()];
 	for(int i = 0; i < y.size(); i++) I[i] = 0;
@@ -59,15 +45,39 @@ L2SmoothSVMLoss<Feature>::~L2SmoothSVMLoss()
 	delete[] I;
 }
 
+// Computes the margins and the active set I at x, unless they are cached already.
+template <class Feature>
+void L2SmoothSVMLoss<Feature>::updateMargins(const Vector& x) const {
+	if ((margins.size() == n) && (x == cachePoint))
+		return;
+	margins.resize(n);
+	#pragma omp parallel for schedule(static) num_threads(numThreads(n))
+	for (int i = 0; i < n; i++)
+		margins[i] = y[i]*(x*features[i]);
+	updateActiveSet();
+	cachePoint = x;
+}
+
+template <class Feature>
+void L2SmoothSVMLoss<Feature>::updateActiveSet() const {
+	sizeI = 0;
+	for (int i = 0; i < n; i++) {
+		if (1 - margins[i] >= 0) {
+			I[sizeI] = i;
+			sizeI++;
+		}
+	}
+}
+
 template <class Feature>
 double L2SmoothSVMLoss<Feature>::eval(const Vector& x) const {
 	assert(x.size() == m);
+	updateMargins(x);
 	double sum = 0.5*lambda*(x*x);
-	for (int i = 0; i < n; i++) {
-		double preval = y[i]*(x*features[i]);
-		if (1 - preval>= 0) {
-			sum += (1 - preval)*(1 - preval);
-		}
+	#pragma omp parallel for schedule(static) num_threads(numThreads(sizeI)) reduction(+:sum)
+	for (int k = 0; k < sizeI; k++) {
+		double preval = margins[I[k]];
+		sum += (1 - preval)*(1 - preval);
 	}
 	return sum;
 }
@@ -75,61 +85,239 @@ double L2SmoothSVMLoss<Feature>::eval(const Vector& x) const {
 template <class Feature>
 Vector L2SmoothSVMLoss<Feature>::evalGradient(const Vector& x) const {
 	assert(x.size() == m);
+	updateMargins(x);
 	Vector g = lambda*x;
-	sizeI = 0;
-	for (int i = 0; i < n; i++) {
-		double preval = y[i]*(x*features[i]);
-		if (1 - preval>= 0) {
-			I[sizeI] = i;
-			sizeI++;
-			g -= 2*features[i]*(1 - preval)*y[i];
+	int T = numThreads(sizeI);
+	reserveLocalGradients(T);
+	#pragma omp parallel num_threads(T)
+	{
+		Vector& gt = localGradient(g);
+		#pragma omp for schedule(static)
+		for (int k = 0; k < sizeI; k++) {
+			int i = I[k];
+			featureMultiplySubtract(gt, 2*(1 - margins[i])*y[i], features[i]);
 		}
 	}
+	sumLocalGradients(g, T);
 	return g;
 }
 
 template <class Feature>
 void L2SmoothSVMLoss<Feature>::eval(const Vector& x, double& f, Vector& g) const {
 	assert(x.size() == m);
+	updateMargins(x);
 	g = lambda*x;
-	f = 0.5*lambda*(x*x);
-	sizeI = 0;
-	for (int i = 0; i < n; i++) {
-		double preval = y[i]*(x*features[i]);
-		if (1 - preval>= 0) {
-			I[sizeI] = i;
-			sizeI++;
-			f += (1 - preval)*(1 - preval);
-			g -= 2*features[i]*(1 - preval)*y[i];
+	double sum = 0.5*lambda*(x*x);
+	int T = numThreads(sizeI);
+	reserveLocalGradients(T);
+	#pragma omp parallel num_threads(T) reduction(+:sum)
+	{
+		Vector& gt = localGradient(g);
+		#pragma omp for schedule(static)
+		for (int k = 0; k < sizeI; k++) {
+			int i = I[k];
+			double preval = margins[i];
+			sum += (1 - preval)*(1 - preval);
+			featureMultiplySubtract(gt, 2*(1 - preval)*y[i], features[i]);
 		}
 	}
+	sumLocalGradients(g, T);
+	f = sum;
 	return;
 }
 
 template <class Feature>
 void L2SmoothSVMLoss<Feature>::evalHessianVectorProduct(const Vector& x, const Vector& v, Vector& Hxv) const {  // evaluate a product between a hessian and a vector
-	// double xTs = 0;
-	Vector w(n, 0);
-	Hxv = Vector(m, 0);
-	for (int i = 0; i < sizeI; i++) {
-		w[i] = 2 * v * features[I[i]];
-		// xTs = 2 * v * features[I[i]];
-		// Hxv += (xTs * features[I[i]]);
+	updateMargins(x);
+	scalarMultiplication(v, lambda, Hxv);
+	int T = numThreads(sizeI);
+	reserveLocalGradients(T);
+	#pragma omp parallel num_threads(T)
+	{
+		Vector& ht = localGradient(Hxv);
+		#pragma omp for schedule(static)
+		for (int k = 0; k < sizeI; k++)
+			featureMultiplyAdd(ht, 2*(v*features[I[k]]), features[I[k]]);
 	}
-	UpdateHessianVectorProd_L2rL2SVM(features, Hxv, w, sizeI, I);
-	Hxv += v;
+	sumLocalGradients(Hxv, T);
+}
+
+template <class Feature>
+bool L2SmoothSVMLoss<Feature>::prepareHessianSubsample() const {
+	return true;
+}
+
+template <class Feature>
+void L2SmoothSVMLoss<Feature>::evalSubsampledHessianVectorProduct(const Vector& x, const Vector& v, Vector& Hxv,
+                                                                  const std::vector<int>& rows) const {
+	updateMargins(x);
+	scalarMultiplication(v, lambda, Hxv);
+	int size = rows.size();
+	double scale = (double) n/max(size, 1);
+	int T = numThreads(size);
+	reserveLocalGradients(T);
+	#pragma omp parallel num_threads(T)
+	{
+		Vector& ht = localGradient(Hxv);
+		#pragma omp for schedule(static)
+		for (int k = 0; k < size; k++) {
+			int i = rows[k];
+			if (1 - margins[i] >= 0)
+				featureMultiplyAdd(ht, 2*scale*(v*features[i]), features[i]);
+		}
+	}
+	sumLocalGradients(Hxv, T);
+}
+
+// As eval(x, f, g), with the diagonal lambda + 2 sum_{i in I} f_ij^2 of the (generalized) hessian accumulated in the same pass.
+template <class Feature>
+bool L2SmoothSVMLoss<Feature>::evalHessianDiagonal(const Vector& x, double& f, Vector& g, Vector& diagH) const {
+	assert(x.size() == m);
+	updateMargins(x);
+	g = lambda*x;
+	diagH.assign(m, lambda);
+	double sum = 0.5*lambda*(x*x);
+	int T = numThreads(sizeI);
+	reserveLocalGradients(T);
+	#pragma omp parallel num_threads(T) reduction(+:sum)
+	{
+		Vector& gt = localGradient(g);
+		Vector& dt = localGradient(diagH, 1);
+		#pragma omp for schedule(static)
+		for (int k = 0; k < sizeI; k++) {
+			int i = I[k];
+			double preval = margins[i];
+			sum += (1 - preval)*(1 - preval);
+			featureMultiplyAddSquares(gt, -2*(1 - preval)*y[i], dt, 2, features[i]);
+		}
+	}
+	sumLocalGradients(g, T);
+	sumLocalGradients(diagH, T, 1);
+	f = sum;
+	return true;
+}
+
+// The (generalized) hessian lambda I + 2 X_I^T X_I, the Gram matrix of the rows in I.
+template <class Feature>
+bool L2SmoothSVMLoss<Feature>::evalDenseHessian(const Vector& x, double& f, Vector& g, Vector& H) const {
+	eval(x, f, g);
+	Vector D(n, 0);
+	for (int k = 0; k < sizeI; k++)
+		D[I[k]] = 2;
+	H.resize((long int) m*m);
+	weightedGram<Feature>(features, D.data(), m, H.data(), numThreads(n));
+	for (int j = 0; j < m; j++)
+		H[(long int) j*m + j] += lambda;
+	return true;
+}
+
+template <class Feature>
+bool L2SmoothSVMLoss<Feature>::prepareDirection(const Vector& x, const Vector& d) const {
+	updateMargins(x);                 // usually cached by the eval at x
+	lineSearch.prepare(features, y, x, d, margins, numThreads(n));
+	return true;
+}
+
+// The margins and the active set of the trial point are kept, so the eval of the accepted point only needs the pass over X^T.
+template <class Feature>
+double L2SmoothSVMLoss<Feature>::evalAlongDirection(const double a) const {
+	double sum = 0.5*lambda*lineSearch.squaredNorm(a);
+	#pragma omp parallel for schedule(static) num_threads(numThreads(n)) reduction(+:sum)
+	for (int i = 0; i < n; i++) {
+		double preval = lineSearch.margin(i, a);
+		margins[i] = preval;
+		if (1 - preval >= 0)
+			sum += (1 - preval)*(1 - preval);
+	}
+	updateActiveSet();
+	multiplyAccumulate(cachePoint, lineSearch.x, a, lineSearch.d);
+	return sum;
+}
+
+template <class Feature>
+bool L2SmoothSVMLoss<Feature>::prepareSparseSteps() const {
+	sparseSteps.prepare(features, m, false);
+	return true;
+}
+
+template <class Feature>
+double L2SmoothSVMLoss<Feature>::sparseStochasticStep(Vector& x, const std::vector<int>& miniBatch, const SparseStepRule& rule) const {
+	double sum = 0;
+	double regScale = lambda*n/miniBatch.size();
+	for (int k = 0; k < miniBatch.size(); k++) {
+		int i = miniBatch[k];
+		double preval = y[i]*(x*features[i]);
+		if (1 - preval >= 0) {
+			sum += (1 - preval)*(1 - preval);
+			sparseSteps.apply(x, features[i], -2*(1 - preval)*y[i], regScale, rule);
+		}
+		else
+			sparseSteps.apply(x, features[i], 0, regScale, rule);
+	}
+	return sum;
+}
+
+template <class Feature>
+bool L2SmoothSVMLoss<Feature>::prepareScaledSteps() const {
+	return true;
+}
+
+template <class Feature>
+double L2SmoothSVMLoss<Feature>::scaledStochasticStep(ScaledVector& x, const std::vector<int>& miniBatch, const double alpha) const {
+	double sum = 0;
+	Vector coef(miniBatch.size());
+	for (int k = 0; k < miniBatch.size(); k++) {
+		int i = miniBatch[k];
+		double preval = y[i]*(x*features[i]);
+		coef[k] = 0;
+		if (1 - preval >= 0) {
+			sum += (1 - preval)*(1 - preval);
+			coef[k] = 2*(1 - preval)*y[i];
+		}
+	}
+	x.scale(1 - alpha*lambda);
+	for (int k = 0; k < miniBatch.size(); k++)
+		x.multiplyAdd(alpha*coef[k], features[miniBatch[k]]);
+	return sum;
+}
+
+template <class Feature>
+bool L2SmoothSVMLoss<Feature>::prepareAverageGradient(AverageGradientSteps& steps) const {
+	steps.prepare(features, m, lambda, 2);
+	return true;
+}
+
+template <class Feature>
+double L2SmoothSVMLoss<Feature>::averageGradientStep(Vector& x, const int i, AverageGradientSteps& steps) const {
+	double preval = y[i]*steps.margin(x, features[i]);
+	if (1 - preval >= 0) {
+		steps.update(x, features[i], i, -2*(1 - preval)*y[i]);
+		return (1 - preval)*(1 - preval);
+	}
+	steps.update(x, features[i], i, 0);
+	return 0;
 }
 
 template <class Feature>
 Vector L2SmoothSVMLoss<Feature>::evalStochasticGradient(const Vector& x, std::vector<int>& miniBatch) const {
 	assert(x.size() == m);
 	Vector g = lambda*x;
-	for (vector<int>::iterator it = miniBatch.begin(); it != miniBatch.end(); it++) {
-		double preval = y[*it]*(x*features[*it]);
-		if (1 - preval>= 0) {
-			g -= 2*features[*it]*(1 - preval)*y[*it];
+	int batchSize = miniBatch.size();
+	int T = numThreads(batchSize);
+	reserveLocalGradients(T);
+	#pragma omp parallel num_threads(T)
+	{
+		Vector& gt = localGradient(g);
+		#pragma omp for schedule(static)
+		for (int k = 0; k < batchSize; k++) {
+			int i = miniBatch[k];
+			double preval = y[i]*(x*features[i]);
+			if (1 - preval>= 0) {
+				featureMultiplySubtract(gt, 2*(1 - preval)*y[i], features[i]);
+			}
 		}
 	}
+	sumLocalGradients(g, T);
 	return g;
 }
 
@@ -137,20 +325,31 @@ template <class Feature>
 void L2SmoothSVMLoss<Feature>::evalStochastic(const Vector& x, double& f, Vector& g, std::vector<int>& miniBatch) const {
 	assert(x.size() == m);
 	g = lambda*x;
-	f = 0.5*lambda*(x*x);
-	double val;
-	for (vector<int>::iterator it = miniBatch.begin(); it != miniBatch.end(); it++) {
-		double preval = y[*it]*(x*features[*it]);
-		if (1 - preval>= 0) {
-			f += (1 - preval)*(1 - preval);
-			g -= 2*features[*it]*(1 - preval)*y[*it];
+	double sum = 0.5*lambda*(x*x);
+	int batchSize = miniBatch.size();
+	int T = numThreads(batchSize);
+	reserveLocalGradients(T);
+	#pragma omp parallel num_threads(T) reduction(+:sum)
+	{
+		Vector& gt = localGradient(g);
+		#pragma omp for schedule(static)
+		for (int k = 0; k < batchSize; k++) {
+			int i = miniBatch[k];
+			double preval = y[i]*(x*features[i]);
+			if (1 - preval>= 0) {
+				sum += (1 - preval)*(1 - preval);
+				featureMultiplySubtract(gt, 2*(1 - preval)*y[i], features[i]);
+			}
 		}
 	}
+	sumLocalGradients(g, T);
+	f = sum;
 	return;
 }
 
 template class L2SmoothSVMLoss<SparseFeature>;
 template class L2SmoothSVMLoss<DenseFeature>;
+template class L2SmoothSVMLoss<SparseRow>;
 
 
 }
@@ -4,6 +4,8 @@
 /*
    Jensen: A Convex Optimization And Machine Learning ToolKit
  *	Smooth SVM Loss with L2 regularization
+   The margins and the set I of examples with margin below one at the last evaluated point are
+   cached, so a Hessian vector product at that point costs one pass over X_I and one over X_I^T.
    Author: Rishabh Iyer
  *
  */
@@ -15,25 +17,44 @@
 #include "../../representation/Matrix.h"
 #include "../../representation/VectorOperations.h"
 #include "ContinuousFunctions.h"
+#include "LineSearchMargins.h"
 namespace jensen {
 
 template <class Feature>
 class L2SmoothSVMLoss : public ContinuousFunctions {
 protected:
-std::vector<Feature>& features;     // size of features is number of trainins examples (n)
+typename FeatureSet<Feature>::type& features;     // size of features is number of trainins examples (n)
 Vector& y;     // size of y is number of training examples (n)
 double lambda;
-int* I;
+mutable SparseSteps sparseSteps;                 // feature counts of the lock-free stochastic steps
+int* I;     // the examples with y_i x^T f_i <= 1 at cachePoint
+mutable Vector cachePoint;     // the point the margins were computed at
+mutable Vector margins;     // y_i x^T f_i at cachePoint
+void updateMargins(const Vector& x) const;
+void updateActiveSet() const;
 
+mutable LineSearchMargins lineSearch;     // margins along the direction of the current line search
 public:
-L2SmoothSVMLoss(int numFeatures, std::vector<Feature>& features, Vector& y, double lambda);
+L2SmoothSVMLoss(int numFeatures, typename FeatureSet<Feature>::type& features, Vector& y, double lambda);
 L2SmoothSVMLoss(const L2SmoothSVMLoss& c);     // copy constructor
 
 ~L2SmoothSVMLoss();
 double eval(const Vector& x) const;     // functionEval
 Vector evalGradient(const Vector& x) const;     // gradientEval
 void eval(const Vector& x, double& f, Vector& gradient) const;     // combined function and gradient eval
+bool prepareDirection(const Vector& x, const Vector& d) const;     // margins of x and d for a line search along x - a*d
+double evalAlongDirection(const double a) const;     // f(x - a*d) in O(n + m)
 void evalHessianVectorProduct(const Vector& x, const Vector& v, Vector& Hxv) const;     // evaluate a product between a hessian and a vector
+bool evalHessianDiagonal(const Vector& x, double& f, Vector& g, Vector& diagH) const;                 // eval(x, f, g) and the diagonal of the hessian
+bool evalDenseHessian(const Vector& x, double& f, Vector& g, Vector& H) const;                 // eval(x, f, g) and the m x m hessian
+bool prepareHessianSubsample() const;
+void evalSubsampledHessianVectorProduct(const Vector& x, const Vector& v, Vector& Hxv, const std::vector<int>& rows) const;                 // the hessian of the rows, scaled by n/|rows|
+bool prepareSparseSteps() const;
+double sparseStochasticStep(Vector& x, const std::vector<int>& miniBatch, const SparseStepRule& rule) const;                 // lock-free step on the rows of miniBatch
+bool prepareScaledSteps() const;
+double scaledStochasticStep(ScaledVector& x, const std::vector<int>& miniBatch, const double alpha) const;                 // O(nnz) step on scaled weights
+bool prepareAverageGradient(AverageGradientSteps& steps) const;
+double averageGradientStep(Vector& x, const int i, AverageGradientSteps& steps) const;                 // SAG/SAGA step on sample i
 Vector evalStochasticGradient(const Vector& x, std::vector<int>& miniBatch) const;     // stochastic gradient
 void evalStochastic(const Vector& x, double& f, Vector& g, std::vector<int>& miniBatch) const;     // stochastic evaluation
 mutable int sizeI;
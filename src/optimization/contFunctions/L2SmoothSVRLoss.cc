@@ -19,7 +19,7 @@ using namespace std;
 #define MAX 1e2
 namespace jensen {
 template <class Feature>
-L2SmoothSVRLoss<Feature>::L2SmoothSVRLoss(int m, std::vector<Feature>& features, Vector& y, double lambda, double p) :
+L2SmoothSVRLoss<Feature>::L2SmoothSVRLoss(int m, typename FeatureSet<Feature>::type& features, Vector& y, double lambda, double p) :
 	ContinuousFunctions(true, m, features.size()), features(features), y(y), p(p), lambda(lambda)
 {
 	if (n > 0)
@@ -29,7 +29,7 @@ L2SmoothSVRLoss<Feature>::L2SmoothSVRLoss(int m, std::vector<Feature>& features,
 
 template <class Feature>
 L2SmoothSVRLoss<Feature>::L2SmoothSVRLoss(const L2SmoothSVRLoss& l) :
-	ContinuousFunctions(true, l.m, l.n), features(l.features), y(l.y), p(l.p), lambda(l.lambda) {
+	ContinuousFunctions(l), features(l.features), y(l.y), p(l.p), lambda(l.lambda) {
 }
 
 template <class Feature>
@@ -40,6 +40,7 @@ template <class Feature>
 double L2SmoothSVRLoss<Feature>::eval(const Vector& x) const {
 	assert(x.size() == m);
 	double sum = 0.5*lambda*(x*x);
+	#pragma omp parallel for schedule(static) num_threads(numThreads(n)) reduction(+:sum)
 	for (int i = 0; i < n; i++) {
 		double preval = (x*features[i]) - y[i];
 		if (preval < -p) {
@@ -56,14 +57,23 @@ template <class Feature>
 Vector L2SmoothSVRLoss<Feature>::evalGradient(const Vector& x) const {
 	assert(x.size() == m);
 	Vector g = lambda*x;
-	for (int i = 0; i < n; i++) {
-		double preval = (x*features[i]) - y[i];
-		if (preval < -p) {
-			g += 2*features[i]*(preval + p);
+	int T = numThreads(n);
+	reserveLocalGradients(T);
+	#pragma omp parallel num_threads(T)
+	{
+		Vector& gt = localGradient(g);
+		#pragma omp for schedule(static)
+		for (int i = 0; i < n; i++) {
+			double preval = (x*features[i]) - y[i];
+			if (preval < -p) {
+				featureMultiplyAdd(gt, 2*(preval + p), features[i]);
+			}
+			else if (preval > p) {
+				featureMultiplyAdd(gt, 2*(preval - p), features[i]);
+			}
 		}
-		else if (preval > p) {}
-		g += 2*features[i]*(preval - p);
 	}
+	sumLocalGradients(g, T);
 	return g;
 }
 
@@ -71,18 +81,27 @@ template <class Feature>
 void L2SmoothSVRLoss<Feature>::eval(const Vector& x, double& f, Vector& g) const {
 	assert(x.size() == m);
 	g = lambda*x;
-	f = 0.5*lambda*(x*x);
-	for (int i = 0; i < n; i++) {
-		double preval = (x*features[i]) - y[i];
-		if (preval < -p) {
-			f += (preval + p)*(preval + p);
-			g += 2*features[i]*(preval + p);
-		}
-		else if (preval > p) {
-			f += (preval - p)*(preval - p);
-			g += 2*features[i]*(preval - p);
+	double sum = 0.5*lambda*(x*x);
+	int T = numThreads(n);
+	reserveLocalGradients(T);
+	#pragma omp parallel num_threads(T) reduction(+:sum)
+	{
+		Vector& gt = localGradient(g);
+		#pragma omp for schedule(static)
+		for (int i = 0; i < n; i++) {
+			double preval = (x*features[i]) - y[i];
+			if (preval < -p) {
+				sum += (preval + p)*(preval + p);
+				featureMultiplyAdd(gt, 2*(preval + p), features[i]);
+			}
+			else if (preval > p) {
+				sum += (preval - p)*(preval - p);
+				featureMultiplyAdd(gt, 2*(preval - p), features[i]);
+			}
 		}
 	}
+	sumLocalGradients(g, T);
+	f = sum;
 	return;
 }
 
@@ -90,15 +109,25 @@ template <class Feature>
 Vector L2SmoothSVRLoss<Feature>::evalStochasticGradient(const Vector& x, std::vector<int>& miniBatch) const {
 	assert(x.size() == m);
 	Vector g = lambda*x;
-	for (vector<int>::iterator it = miniBatch.begin(); it != miniBatch.end(); it++) {
-		double preval = (x*features[*it]) - y[*it];
-		if (preval < -p) {
-			g += 2*features[*it]*(preval + p);;
-		}
-		else if (preval > p) {
-			g += 2*features[*it]*(preval - p);
+	int batchSize = miniBatch.size();
+	int T = numThreads(batchSize);
+	reserveLocalGradients(T);
+	#pragma omp parallel num_threads(T)
+	{
+		Vector& gt = localGradient(g);
+		#pragma omp for schedule(static)
+		for (int k = 0; k < batchSize; k++) {
+			int i = miniBatch[k];
+			double preval = (x*features[i]) - y[i];
+			if (preval < -p) {
+				featureMultiplyAdd(gt, 2*(preval + p), features[i]);
+			}
+			else if (preval > p) {
+				featureMultiplyAdd(gt, 2*(preval - p), features[i]);
+			}
 		}
 	}
+	sumLocalGradients(g, T);
 	return g;
 }
 
@@ -106,21 +135,33 @@ template <class Feature>
 void L2SmoothSVRLoss<Feature>::evalStochastic(const Vector& x, double& f, Vector& g, std::vector<int>& miniBatch) const {
 	assert(x.size() == m);
 	g = lambda*x;
-	f = 0.5*lambda*(x*x);
-	for (vector<int>::iterator it = miniBatch.begin(); it != miniBatch.end(); it++) {
-		double preval = (x*features[*it]) - y[*it];
-		if (preval < -p) {
-			f += (preval + p)*(preval + p);
-			g += 2*features[*it]*(preval + p);
-		}
-		else if (preval > p) {
-			f += (preval - p)*(preval - p);
-			g += 2*features[*it]*(preval - p);
+	double sum = 0.5*lambda*(x*x);
+	int batchSize = miniBatch.size();
+	int T = numThreads(batchSize);
+	reserveLocalGradients(T);
+	#pragma omp parallel num_threads(T) reduction(+:sum)
+	{
+		Vector& gt = localGradient(g);
+		#pragma omp for schedule(static)
+		for (int k = 0; k < batchSize; k++) {
+			int i = miniBatch[k];
+			double preval = (x*features[i]) - y[i];
+			if (preval < -p) {
+				sum += (preval + p)*(preval + p);
+				featureMultiplyAdd(gt, 2*(preval + p), features[i]);
+			}
+			else if (preval > p) {
+				sum += (preval - p)*(preval - p);
+				featureMultiplyAdd(gt, 2*(preval - p), features[i]);
+			}
 		}
 	}
+	sumLocalGradients(g, T);
+	f = sum;
 	return;
 }
 
 template class L2SmoothSVRLoss<SparseFeature>;
 template class L2SmoothSVRLoss<DenseFeature>;
+template class L2SmoothSVRLoss<SparseRow>;
 }
@@ -0,0 +1,240 @@
+// Copyright (C) Rishabh Iyer, John T. Halloran, and Kai Wei
+// Licensed under the Open Software License version 3.0
+// See COPYING or http://opensource.org/licenses/OSL-3.0
+/*
+        Jensen: A Convex Optimization And Machine Learning ToolKit
+ *	Multinomial (softmax) logistic loss with L2 regularization
+        Author: Rishabh Iyer
+ *
+ */
+
+#include <iostream>
+#include <math.h>
+using namespace std;
+
+#include "L2SoftmaxLoss.h"
+#include "../../representation/VectorOperations.h"
+#include <assert.h>
+#define EPSILON 1e-6
+namespace jensen {
+
+template <class Feature>
+L2SoftmaxLoss<Feature>::L2SoftmaxLoss(int numFeatures, typename FeatureSet<Feature>::type& features, Vector& y, int nClasses,
+                                      double lambda) :
+	ContinuousFunctions(true, numFeatures*nClasses, features.size()), features(features), y(y), nClasses(nClasses),
+	numFeatures(numFeatures), lambda(lambda)
+{
+	if (n > 0)
+		assert(features[0].numFeatures == numFeatures);
+	assert(features.size() == y.size());
+}
+
+template <class Feature>
+L2SoftmaxLoss<Feature>::L2SoftmaxLoss(const L2SoftmaxLoss& l) :
+	ContinuousFunctions(l), features(l.features), y(l.y), nClasses(l.nClasses), numFeatures(l.numFeatures), lambda(l.lambda) {
+}
+
+template <class Feature>
+L2SoftmaxLoss<Feature>::~L2SoftmaxLoss(){
+}
+
+// Computes the probabilities of all classes at x (one pass over the data), unless they are cached already.
+template <class Feature>
+void L2SoftmaxLoss<Feature>::updateProbabilities(const Vector& x) const {
+	int K = nClasses;
+	if ((prob.size() == (long int) n*K) && (x == cachePoint))
+		return;
+	prob.assign((long int) n*K, 0);
+	rowLoss.resize(n);
+	#pragma omp parallel for schedule(static) num_threads(numThreads(n))
+	for (int i = 0; i < n; i++) {
+		double* p = &prob[(long int) i*K];
+		classScores(x, features[i], K, p);
+		rowLoss[i] = softmaxRow(p, K, (int) y[i], p);
+	}
+	cachePoint = x;
+}
+
+template <class Feature>
+double L2SoftmaxLoss<Feature>::eval(const Vector& x) const {
+	assert(x.size() == m);
+	updateProbabilities(x);
+	double sum = 0.5*lambda*(x*x);
+	#pragma omp parallel for schedule(static) num_threads(numThreads(n)) reduction(+:sum)
+	for (int i = 0; i < n; i++)
+		sum += rowLoss[i];
+	return sum;
+}
+
+template <class Feature>
+Vector L2SoftmaxLoss<Feature>::evalGradient(const Vector& x) const {
+	double f;
+	Vector g;
+	eval(x, f, g);
+	return g;
+}
+
+template <class Feature>
+void L2SoftmaxLoss<Feature>::eval(const Vector& x, double& f, Vector& g) const {
+	assert(x.size() == m);
+	updateProbabilities(x);
+	g = lambda*x;
+	double sum = 0.5*lambda*(x*x);
+	int K = nClasses;
+	int T = numThreads(n);
+	reserveLocalGradients(T);
+	#pragma omp parallel num_threads(T) reduction(+:sum)
+	{
+		Vector& gt = localGradient(g);
+		Vector coef(K);
+		#pragma omp for schedule(static)
+		for (int i = 0; i < n; i++) {
+			sum += rowLoss[i];
+			for (int c = 0; c < K; c++)
+				coef[c] = prob[(long int) i*K + c];
+			coef[(int) y[i]] -= 1;
+			classUpdate(gt, features[i], K, coef.data());
+		}
+	}
+	sumLocalGradients(g, T);
+	f = sum;
+}
+
+// The hessian of row i is (diag(p_i) - p_i p_i^T) (x) f_i f_i^T: with u = V^T f_i, the K coefficients are p_c (u_c - p_i^T u).
+template <class Feature>
+void L2SoftmaxLoss<Feature>::evalHessianVectorProduct(const Vector& x, const Vector& v, Vector& Hxv) const {  // evaluate a product between a hessian and a vector
+	updateProbabilities(x);
+	scalarMultiplication(v, lambda, Hxv);
+	int K = nClasses;
+	int T = numThreads(n);
+	reserveLocalGradients(T);
+	#pragma omp parallel num_threads(T)
+	{
+		Vector& ht = localGradient(Hxv);
+		Vector u(K);
+		#pragma omp for schedule(static)
+		for (int i = 0; i < n; i++) {
+			const double* p = &prob[(long int) i*K];
+			u.assign(K, 0);
+			classScores(v, features[i], K, u.data());
+			double pu = 0;
+			for (int c = 0; c < K; c++)
+				pu += p[c]*u[c];
+			for (int c = 0; c < K; c++)
+				u[c] = p[c]*(u[c] - pu);
+			classUpdate(ht, features[i], K, u.data());
+		}
+	}
+	sumLocalGradients(Hxv, T);
+}
+
+template <class Feature>
+bool L2SoftmaxLoss<Feature>::prepareHessianSubsample() const {
+	return true;
+}
+
+template <class Feature>
+void L2SoftmaxLoss<Feature>::evalSubsampledHessianVectorProduct(const Vector& x, const Vector& v, Vector& Hxv,
+                                                                const std::vector<int>& rows) const {
+	updateProbabilities(x);
+	scalarMultiplication(v, lambda, Hxv);
+	int K = nClasses;
+	int size = rows.size();
+	double scale = (double) n/max(size, 1);
+	int T = numThreads(size);
+	reserveLocalGradients(T);
+	#pragma omp parallel num_threads(T)
+	{
+		Vector& ht = localGradient(Hxv);
+		Vector u(K);
+		#pragma omp for schedule(static)
+		for (int k = 0; k < size; k++) {
+			int i = rows[k];
+			const double* p = &prob[(long int) i*K];
+			u.assign(K, 0);
+			classScores(v, features[i], K, u.data());
+			double pu = 0;
+			for (int c = 0; c < K; c++)
+				pu += p[c]*u[c];
+			for (int c = 0; c < K; c++)
+				u[c] = scale*p[c]*(u[c] - pu);
+			classUpdate(ht, features[i], K, u.data());
+		}
+	}
+	sumLocalGradients(Hxv, T);
+}
+
+// As eval(x, f, g), with the diagonal lambda + sum_i p_ic (1 - p_ic) f_ij^2 of the hessian accumulated in the same pass.
+template <class Feature>
+bool L2SoftmaxLoss<Feature>::evalHessianDiagonal(const Vector& x, double& f, Vector& g, Vector& diagH) const {
+	assert(x.size() == m);
+	updateProbabilities(x);
+	g = lambda*x;
+	diagH.assign(m, lambda);
+	double sum = 0.5*lambda*(x*x);
+	int K = nClasses;
+	int T = numThreads(n);
+	reserveLocalGradients(T);
+	#pragma omp parallel num_threads(T) reduction(+:sum)
+	{
+		Vector& gt = localGradient(g);
+		Vector& dt = localGradient(diagH, 1);
+		Vector coef(K), dcoef(K);
+		#pragma omp for schedule(static)
+		for (int i = 0; i < n; i++) {
+			sum += rowLoss[i];
+			for (int c = 0; c < K; c++) {
+				double p = prob[(long int) i*K + c];
+				coef[c] = p;
+				dcoef[c] = p*(1 - p);
+			}
+			coef[(int) y[i]] -= 1;
+			classUpdateSquares(gt, coef.data(), dt, dcoef.data(), features[i], K);
+		}
+	}
+	sumLocalGradients(g, T);
+	sumLocalGradients(diagH, T, 1);
+	f = sum;
+	return true;
+}
+
+template <class Feature>
+Vector L2SoftmaxLoss<Feature>::evalStochasticGradient(const Vector& x, std::vector<int>& miniBatch) const {
+	double f;
+	Vector g;
+	evalStochastic(x, f, g, miniBatch);
+	return g;
+}
+
+template <class Feature>
+void L2SoftmaxLoss<Feature>::evalStochastic(const Vector& x, double& f, Vector& g, std::vector<int>& miniBatch) const {
+	assert(x.size() == m);
+	g = lambda*x;
+	double sum = 0.5*lambda*(x*x);
+	int K = nClasses;
+	int batchSize = miniBatch.size();
+	int T = numThreads(batchSize);
+	reserveLocalGradients(T);
+	#pragma omp parallel num_threads(T) reduction(+:sum)
+	{
+		Vector& gt = localGradient(g);
+		Vector p(K);
+		#pragma omp for schedule(static)
+		for (int k = 0; k < batchSize; k++) {
+			int i = miniBatch[k];
+			p.assign(K, 0);
+			classScores(x, features[i], K, p.data());
+			sum += softmaxRow(p.data(), K, (int) y[i], p.data());
+			p[(int) y[i]] -= 1;
+			classUpdate(gt, features[i], K, p.data());
+		}
+	}
+	sumLocalGradients(g, T);
+	f = sum;
+}
+
+template class L2SoftmaxLoss<SparseFeature>;
+template class L2SoftmaxLoss<DenseFeature>;
+template class L2SoftmaxLoss<SparseRow>;
+
+}
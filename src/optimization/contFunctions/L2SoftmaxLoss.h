@@ -0,0 +1,53 @@
+// Copyright (C) Rishabh Iyer, John T. Halloran, and Kai Wei
+// Licensed under the Open Software License version 3.0
+// See COPYING or http://opensource.org/licenses/OSL-3.0
+/*
+        Jensen: A Convex Optimization And Machine Learning ToolKit
+ *	Multinomial (softmax) logistic loss with L2 regularization:
+        sum_i [log(sum_c exp(w_c^T f_i)) - w_{y_i}^T f_i] + lambda/2 ||x||^2, over the m x K block
+        x = (w_0, ..., w_{K-1}) (see ClassBlock.h). The labels y are the class indices 0..K-1.
+        Author: Rishabh Iyer
+ *
+ */
+
+#ifndef L2_SOFTMAX_LOSS_H
+#define L2_SOFTMAX_LOSS_H
+
+#include "../../representation/Vector.h"
+#include "../../representation/Matrix.h"
+#include "../../representation/VectorOperations.h"
+#include "ContinuousFunctions.h"
+#include "ClassBlock.h"
+namespace jensen {
+
+template <class Feature>
+class L2SoftmaxLoss : public ContinuousFunctions {
+protected:
+typename FeatureSet<Feature>::type& features;                 // size of features is number of trainins examples (n)
+Vector& y;                 // the class of each training example, in 0..nClasses-1
+int nClasses;                 // K
+int numFeatures;                 // dimension of the features (m/K)
+double lambda;
+mutable Vector cachePoint;                 // the point the probabilities were computed at
+mutable Vector prob;                 // the softmax probabilities at cachePoint, prob[i*K + c]
+mutable Vector rowLoss;                 // -log prob[i*K + y_i]
+void updateProbabilities(const Vector& x) const;
+public:
+L2SoftmaxLoss(int numFeatures, typename FeatureSet<Feature>::type& features, Vector& y, int nClasses, double lambda);
+L2SoftmaxLoss(const L2SoftmaxLoss& c);         // copy constructor
+
+~L2SoftmaxLoss();
+
+double eval(const Vector& x) const;                 // functionEval
+Vector evalGradient(const Vector& x) const;                 // gradientEval
+void eval(const Vector& x, double& f, Vector& gradient) const;                 // combined function and gradient eval
+void evalHessianVectorProduct(const Vector& x, const Vector& v, Vector& Hxv) const;                 // evaluate a product between a hessian and a vector
+bool evalHessianDiagonal(const Vector& x, double& f, Vector& g, Vector& diagH) const;                 // eval(x, f, g) and the diagonal of the hessian
+bool prepareHessianSubsample() const;
+void evalSubsampledHessianVectorProduct(const Vector& x, const Vector& v, Vector& Hxv, const std::vector<int>& rows) const;                 // the hessian of the rows, scaled by n/|rows|
+Vector evalStochasticGradient(const Vector& x, std::vector<int>& miniBatch) const;                 // stochastic gradient
+void evalStochastic(const Vector& x, double& f, Vector& g, std::vector<int>& miniBatch) const;                 // stochastic evaluation
+};
+
+}
+#endif
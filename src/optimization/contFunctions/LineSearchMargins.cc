@@ -0,0 +1,60 @@
+// Copyright (C) Rishabh Iyer, John T. Halloran, and Kai Wei
+// Licensed under the Open Software License version 3.0
+// See COPYING or http://opensource.org/licenses/OSL-3.0
+/*
+        Jensen: A Convex Optimization And Machine Learning ToolKit
+ *	The margins of a linear model along the ray x - a*d.
+        Author: Rishabh Iyer
+ *
+ */
+
+#include "LineSearchMargins.h"
+#include "../../representation/SparseFeature.h"
+#include "../../representation/DenseFeature.h"
+#include "../../representation/SparseDataset.h"
+
+using namespace std;
+
+namespace jensen {
+
+template <class Features>
+void LineSearchMargins::prepare(const Features& features, const Vector& y, const Vector& x, const Vector& d, int nThreads){
+	int n = features.size();
+	xMargins.resize(n);
+	dMargins.resize(n);
+	#pragma omp parallel for schedule(static) num_threads(nThreads)
+	for (int i = 0; i < n; i++) {
+		xMargins[i] = y[i]*(x*features[i]);
+		dMargins[i] = y[i]*(d*features[i]);
+	}
+	this->x = x;
+	this->d = d;
+	xx = x*x;
+	xd = x*d;
+	dd = d*d;
+}
+
+template <class Features>
+void LineSearchMargins::prepare(const Features& features, const Vector& y, const Vector& x, const Vector& d,
+                                const Vector& xMargins, int nThreads){
+	int n = features.size();
+	this->xMargins = xMargins;
+	dMargins.resize(n);
+	#pragma omp parallel for schedule(static) num_threads(nThreads)
+	for (int i = 0; i < n; i++)
+		dMargins[i] = y[i]*(d*features[i]);
+	this->x = x;
+	this->d = d;
+	xx = x*x;
+	xd = x*d;
+	dd = d*d;
+}
+
+template void LineSearchMargins::prepare(const vector<SparseFeature>&, const Vector&, const Vector&, const Vector&, int);
+template void LineSearchMargins::prepare(const vector<DenseFeature>&, const Vector&, const Vector&, const Vector&, int);
+template void LineSearchMargins::prepare(const SparseDataset&, const Vector&, const Vector&, const Vector&, int);
+template void LineSearchMargins::prepare(const vector<SparseFeature>&, const Vector&, const Vector&, const Vector&, const Vector&, int);
+template void LineSearchMargins::prepare(const vector<DenseFeature>&, const Vector&, const Vector&, const Vector&, const Vector&, int);
+template void LineSearchMargins::prepare(const SparseDataset&, const Vector&, const Vector&, const Vector&, const Vector&, int);
+
+}
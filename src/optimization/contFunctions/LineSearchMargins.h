@@ -0,0 +1,53 @@
+// Copyright (C) Rishabh Iyer, John T. Halloran, and Kai Wei
+// Licensed under the Open Software License version 3.0
+// See COPYING or http://opensource.org/licenses/OSL-3.0
+/*
+        Jensen: A Convex Optimization And Machine Learning ToolKit
+ *	The margins of a linear model along the ray x - a*d. With y_i x^T f_i and y_i d^T f_i computed
+        once, the margins at any step size a are y_i x^T f_i - a y_i d^T f_i, so the losses can
+        evaluate trial step sizes of a line search in O(n + m) without a pass over the data.
+        Author: Rishabh Iyer
+ *
+ */
+
+#ifndef LINE_SEARCH_MARGINS_H
+#define LINE_SEARCH_MARGINS_H
+
+#include <math.h>
+#include "../../representation/Vector.h"
+#include "../../representation/VectorOperations.h"
+
+namespace jensen {
+
+class LineSearchMargins {
+public:
+Vector x;                 // the start point
+Vector d;                 // the search direction
+Vector xMargins;                 // y_i x^T f_i
+Vector dMargins;                 // y_i d^T f_i
+double xx, xd, dd;
+
+// Computes both margins in one pass over the features, with nThreads threads.
+template <class Features>
+void prepare(const Features& features, const Vector& y, const Vector& x, const Vector& d, int nThreads = 1);
+// Computes the margins of d only, xMargins are known already (e.g. cached by the last eval at x).
+template <class Features>
+void prepare(const Features& features, const Vector& y, const Vector& x, const Vector& d, const Vector& xMargins,
+             int nThreads = 1);
+
+double margin(const int i, const double a) const {
+	return xMargins[i] - a*dMargins[i];
+}
+double squaredNorm(const double a) const {                 // |x - a*d|_2^2
+	return xx - 2*a*xd + a*a*dd;
+}
+double l1Norm(const double a) const {                 // |x - a*d|_1
+	double sum = 0;
+	for (int j = 0; j < x.size(); j++)
+		sum += fabs(x[j] - a*d[j]);
+	return sum;
+}
+};
+
+}
+#endif
@@ -0,0 +1,49 @@
+// Copyright (C) Rishabh Iyer, John T. Halloran, and Kai Wei
+// Licensed under the Open Software License version 3.0
+// See COPYING or http://opensource.org/licenses/OSL-3.0
+/*
+        Jensen: A Convex Optimization And Machine Learning ToolKit
+ *	Sparse stochastic steps for the losses of linear models.
+        Author: Rishabh Iyer
+ *
+ */
+
+#include "SparseSteps.h"
+
+using namespace std;
+
+namespace jensen {
+
+static void countRow(Vector& counts, const SparseFeature& f){
+	for (int k = 0; k < f.featureIndex.size(); k++)
+		counts[f.featureIndex[k]]++;
+}
+
+static void countRow(Vector& counts, const SparseRow& f){
+	for (int k = 0; k < f.featureIndex.size(); k++)
+		counts[f.featureIndex[k]]++;
+}
+
+static void countRow(Vector& counts, const DenseFeature& f){
+	for (int j = 0; j < f.numFeatures; j++)
+		counts[j]++;
+}
+
+template <class Features>
+void SparseSteps::prepare(const Features& features, const int m, const bool l1Regularizer){
+	l1 = l1Regularizer;
+	if (prepared(m))
+		return;
+	Vector counts(m, 0);
+	for (int i = 0; i < features.size(); i++)
+		countRow(counts, features[i]);
+	inverseCounts.resize(m);
+	for (int j = 0; j < m; j++)
+		inverseCounts[j] = (counts[j] > 0) ? 1/counts[j] : 0;
+}
+
+template void SparseSteps::prepare(const vector<SparseFeature>&, const int, const bool);
+template void SparseSteps::prepare(const vector<DenseFeature>&, const int, const bool);
+template void SparseSteps::prepare(const SparseDataset&, const int, const bool);
+
+}
@@ -0,0 +1,76 @@
+// Copyright (C) Rishabh Iyer, John T. Halloran, and Kai Wei
+// Licensed under the Open Software License version 3.0
+// See COPYING or http://opensource.org/licenses/OSL-3.0
+/*
+        Jensen: A Convex Optimization And Machine Learning ToolKit
+ *	Sparse stochastic steps for the losses of linear models, as used by the lock-free (Hogwild)
+        solvers. A step for row i only touches the coordinates j present in f_i: the gradient of the
+        loss term is l_i'(x^T f_i) f_i, and the regularizer of coordinate j is spread over the d_j rows
+        containing j (weight 1/d_j), so that the mini-batch steps of an epoch apply the regularizer as
+        often as the dense stochastic gradient steps do. Several threads may step on the same x without
+        locks.
+        Author: Rishabh Iyer
+ *
+ */
+
+#ifndef SPARSE_STEPS_H
+#define SPARSE_STEPS_H
+
+#include <math.h>
+#include "../../representation/Vector.h"
+#include "../../representation/SparseFeature.h"
+#include "../../representation/DenseFeature.h"
+#include "../../representation/SparseDataset.h"
+
+namespace jensen {
+
+struct SparseStepRule {
+	double alpha;                 // the step size
+	Vector* adagradSum;                 // running sums of the squared gradient coordinates (NULL: a plain SGD step)
+	SparseStepRule(double alpha, Vector* adagradSum = NULL) : alpha(alpha), adagradSum(adagradSum) {
+	}
+};
+
+class SparseSteps {
+protected:
+Vector inverseCounts;                 // 1/d_j, d_j the number of rows containing feature j
+bool l1;                 // l_1 (else l_2) regularizer
+// The loss part is a gradient step, the regularizer part the proximal step of its share on coordinate j, which is stable
+// for any step size even when d_j is small.
+void update(Vector& x, const int j, const double gLoss, const double regScale, const SparseStepRule& rule) const {
+	double step = rule.alpha;
+	if (rule.adagradSum != NULL) {
+		double& G = (*rule.adagradSum)[j];
+		G += gLoss*gLoss;
+		step /= sqrt(G);
+	}
+	double xj = x[j] - step*gLoss;
+	double shrink = step*regScale*inverseCounts[j];
+	if (l1)
+		x[j] = (xj > shrink) ? xj - shrink : ((xj < -shrink) ? xj + shrink : 0);
+	else
+		x[j] = xj/(1 + shrink);
+}
+public:
+SparseSteps() : l1(false) {
+}
+bool prepared(const int m) const {
+	return inverseCounts.size() == m;
+}
+// Counts the rows containing each of the m features.
+template <class Features>
+void prepare(const Features& features, const int m, const bool l1Regularizer);
+// A step on the coordinates j of f: x_j -= alpha*coef*f_j, then the proximal step of regScale/d_j r(x_j), with regScale = lambda n / |miniBatch|.
+template <class Feature>
+void apply(Vector& x, const Feature& f, const double coef, const double regScale, const SparseStepRule& rule) const {
+	for (int k = 0; k < f.featureIndex.size(); k++)
+		update(x, f.featureIndex[k], coef*f.featureVec[k], regScale, rule);
+}
+void apply(Vector& x, const DenseFeature& f, const double coef, const double regScale, const SparseStepRule& rule) const {
+	for (int j = 0; j < f.numFeatures; j++)
+		update(x, j, coef*f.featureVec[j], regScale, rule);
+}
+};
+
+}
+#endif
@@ -8,6 +8,8 @@
 #include "ContinuousFunctions.h"
 #include "L2LogisticLoss.h"
 #include "L2SmoothSVMLoss.h"
+#include "L2OneVsRestLoss.h"
+#include "L2SoftmaxLoss.h"
 #include "L2SmoothSVRLoss.h"
 #include "L2HuberSVMLoss.h"
 #include "L2LeastSquaresLoss.h"
@@ -15,6 +17,7 @@
 #include "L2HingeSVMLoss.h"
 #include "L2HingeSVRLoss.h"
 #include "L1LogisticLoss.h"
+#include "L1SoftmaxLoss.h"
 #include "L1SmoothSVMLoss.h"
 #include "L1HuberSVMLoss.h"
 #include "L1LeastSquaresLoss.h"
@@ -0,0 +1,159 @@
+// Copyright (C) Rishabh Iyer, John T. Halloran, and Kai Wei
+// Licensed under the Open Software License version 3.0
+// See COPYING or http://opensource.org/licenses/OSL-3.0
+/*
+        Jensen: A Convex Optimization And Machine Learning ToolKit
+ *	Dense Gram and Cholesky kernels on contiguous row-major matrices
+        Author: Rishabh Iyer
+ *
+ */
+
+#include <math.h>
+#include <string.h>
+#include <algorithm>
+#include <vector>
+using namespace std;
+
+#include "DenseLinearAlgebra.h"
+#include "SimdKernels.h"
+#include "../utils/Threads.h"
+
+#define GRAM_PANEL_ROWS 128                 // rows unpacked at a time
+#define GRAM_TILE 64                 // the tiles of G are GRAM_TILE x GRAM_TILE (32KB)
+
+namespace jensen {
+
+// p = f as a dense row of length m (the features beyond m are dropped).
+template <class Feature>
+static inline void unpackRow(const Feature& f, const int m, double* p){
+	memset(p, 0, sizeof(double)*m);
+	for (int k = 0; k < f.featureIndex.size(); k++) {
+		int j = f.featureIndex[k];
+		if (j < m)
+			p[j] += f.featureVec[k];
+	}
+}
+
+static inline void unpackRow(const DenseFeature& f, const int m, double* p){
+	int d = min(m, (int) f.featureVec.size());
+	memcpy(p, f.featureVec.data(), sizeof(double)*d);
+	memset(p + d, 0, sizeof(double)*(m - d));
+}
+
+// The upper triangle of the tile [i0, i0 + GRAM_TILE) x [j0, j0 + GRAM_TILE) of G += sum_r weight[r] p_r p_r^T, for the R
+// rows p_r of the panel. The rows are taken four at a time (a rank 4 update), so every entry of the tile is loaded and stored
+// once per four rows.
+static void gramTile(const double* panel, const double* weight, const int R, const int m, const int i0, const int j0, double* G){
+	int i1 = min(i0 + GRAM_TILE, m);
+	int j1 = min(j0 + GRAM_TILE, m);
+	int r = 0;
+	for (; r + 4 <= R; r += 4) {
+		const double* p0 = panel + (long int) r*m;
+		const double* p1 = p0 + m;
+		const double* p2 = p1 + m;
+		const double* p3 = p2 + m;
+		for (int i = i0; i < i1; i++) {
+			double a0 = weight[r]*p0[i];
+			double a1 = weight[r + 1]*p1[i];
+			double a2 = weight[r + 2]*p2[i];
+			double a3 = weight[r + 3]*p3[i];
+			if ((a0 == 0) && (a1 == 0) && (a2 == 0) && (a3 == 0))
+				continue;
+			double* g = G + (long int) i*m;
+			for (int j = max(j0, i); j < j1; j++)
+				g[j] += a0*p0[j] + a1*p1[j] + a2*p2[j] + a3*p3[j];
+		}
+	}
+	for (; r < R; r++) {
+		const double* p = panel + (long int) r*m;
+		for (int i = i0; i < i1; i++) {
+			double a = weight[r]*p[i];
+			if (a == 0)
+				continue;
+			double* g = G + (long int) i*m;
+			for (int j = max(j0, i); j < j1; j++)
+				g[j] += a*p[j];
+		}
+	}
+}
+
+template <class Feature>
+void weightedGram(const typename FeatureSet<Feature>::type& rows, const double* D, const int m, double* G, int nThreads){
+	memset(G, 0, sizeof(double)*m*m);
+	std::vector<int> active;
+	for (int i = 0; i < rows.size(); i++) {
+		if (D[i] != 0)
+			active.push_back(i);
+	}
+	int numActive = active.size();
+	int numBlocks = (m + GRAM_TILE - 1)/GRAM_TILE;
+	std::vector<int> tileRow, tileColumn;                 // the tiles of the upper triangle
+	for (int bi = 0; bi < numBlocks; bi++) {
+		for (int bj = bi; bj < numBlocks; bj++) {
+			tileRow.push_back(bi*GRAM_TILE);
+			tileColumn.push_back(bj*GRAM_TILE);
+		}
+	}
+	int numTiles = tileRow.size();
+	int T = max(1, min(resolveThreads(nThreads), numTiles));
+	std::vector<double> panel((long int) GRAM_PANEL_ROWS*m);
+	double weight[GRAM_PANEL_ROWS];
+	#pragma omp parallel num_threads(T)
+	{
+		for (int r0 = 0; r0 < numActive; r0 += GRAM_PANEL_ROWS) {
+			int R = min(GRAM_PANEL_ROWS, numActive - r0);
+			#pragma omp for schedule(static)
+			for (int r = 0; r < R; r++) {
+				unpackRow(rows[active[r0 + r]], m, &panel[(long int) r*m]);
+				weight[r] = D[active[r0 + r]];
+			}
+			#pragma omp for schedule(dynamic)
+			for (int t = 0; t < numTiles; t++)
+				gramTile(panel.data(), weight, R, m, tileRow[t], tileColumn[t], G);
+		}
+	}
+	for (int i = 1; i < m; i++) {
+		for (int j = 0; j < i; j++)
+			G[(long int) i*m + j] = G[(long int) j*m + i];
+	}
+}
+
+// Row by row (Cholesky-Banachiewicz): L_ij = (A_ij - L_i[0..j)^T L_j[0..j)) / L_jj, so every inner product runs over two
+// contiguous row prefixes.
+int choleskyFactor(double* A, const int m){
+	for (int i = 0; i < m; i++) {
+		double* Li = A + (long int) i*m;
+		for (int j = 0; j < i; j++) {
+			const double* Lj = A + (long int) j*m;
+			Li[j] = (Li[j] - dotKernel(Li, Lj, j))/Lj[j];
+		}
+		double d = Li[i] - dotKernel(Li, Li, i);
+		if (!(d > 0))
+			return i + 1;
+		Li[i] = sqrt(d);
+	}
+	return 0;
+}
+
+void choleskySolve(const double* L, const int m, double* b){
+	// L y = b, forward along the rows
+	for (int i = 0; i < m; i++) {
+		const double* Li = L + (long int) i*m;
+		b[i] = (b[i] - dotKernel(Li, b, i))/Li[i];
+	}
+	// L^T x = y, backward: once x_i is known, it is removed from the earlier equations along row i of L
+	for (int i = m - 1; i >= 0; i--) {
+		const double* Li = L + (long int) i*m;
+		b[i] /= Li[i];
+		axpyKernel(-b[i], Li, b, b, i);
+	}
+}
+
+template void weightedGram<SparseFeature>(const FeatureSet<SparseFeature>::type& rows, const double* D, const int m, double* G,
+                                          int nThreads);
+template void weightedGram<DenseFeature>(const FeatureSet<DenseFeature>::type& rows, const double* D, const int m, double* G,
+                                         int nThreads);
+template void weightedGram<SparseRow>(const FeatureSet<SparseRow>::type& rows, const double* D, const int m, double* G,
+                                      int nThreads);
+
+}
@@ -0,0 +1,42 @@
+// Copyright (C) Rishabh Iyer, John T. Halloran, and Kai Wei
+// Licensed under the Open Software License version 3.0
+// See COPYING or http://opensource.org/licenses/OSL-3.0
+/*
+        Jensen: A Convex Optimization And Machine Learning ToolKit
+ *	Dense kernels on m x m matrices stored row-major in one contiguous array (A[i*m + j]), for
+        second order methods on problems of small dimension: the weighted Gram matrix X^T D X of a
+        set of rows, and the Cholesky factorization and solve of a symmetric positive definite matrix.
+
+        The Gram matrix is built by panels of rows, unpacked into a dense buffer, and tiles of the
+        upper triangle: a tile of G stays in cache while a panel streams through it, and the tiles
+        are distributed over the threads, so no thread ever writes to the same entries (no
+        reduction, the result does not depend on the number of threads).
+        Author: Rishabh Iyer
+ *
+ */
+
+#ifndef DENSE_LINEAR_ALGEBRA_H
+#define DENSE_LINEAR_ALGEBRA_H
+
+#include "Vector.h"
+#include "SparseFeature.h"
+#include "DenseFeature.h"
+#include "SparseDataset.h"
+
+namespace jensen {
+
+// G = sum_i D[i] f_i f_i^T (m x m, row-major) over the rows f_i, using nThreads threads (0: all cores). Rows with
+// D[i] = 0 are skipped, and the features of a row beyond m are ignored.
+template <class Feature>
+void weightedGram(const typename FeatureSet<Feature>::type& rows, const double* D, const int m, double* G, int nThreads = 0);
+
+// In place Cholesky factorization A = L L^T of a symmetric positive definite m x m matrix: the lower triangle of A is
+// overwritten by L (the upper triangle is not read). Returns 0 on success, or i + 1 if the leading minor of order
+// i + 1 is not positive definite.
+int choleskyFactor(double* A, const int m);
+
+// Solves L L^T x = b in place (b is overwritten by x) with the factor of choleskyFactor.
+void choleskySolve(const double* L, const int m, double* b);
+
+}
+#endif
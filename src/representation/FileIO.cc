@@ -8,13 +8,18 @@
 #include <sys/types.h>
 #include <iostream>
 #include <string.h>
+#include <ctype.h>
 #include <time.h>
 #include <fstream>
 #include <sstream>
 #include <stdexcept>
 #include <algorithm>
 #include "assert.h"
+#include <stdint.h>
+#include <limits.h>
 #include "../utils/error.h"
+#include "../utils/MappedFile.h"
+#include "SparseTextParser.h"
 
 using namespace std;
 
@@ -125,13 +130,24 @@ vector<vector<float> > readKernelfromFileDouble(char* graphFile, int n){
 
 // Helper Function to read in the Feature based functions.
 int line2words(char *s, struct SparseFeature & Feature, int & max_feat_idx){
-	int digitwrd;
-	float featureval;
-	int pos = 0;
+	const char* p = s;
+	const char* end = s + strlen(s);
 	int numUniqueWords = 0;
 	max_feat_idx = 0;
-	while (sscanf(s,"%d %f %n",&digitwrd, &featureval, &pos) == 2) {
-		s += pos;
+	while (true) {
+		int digitwrd;
+		double featureval;
+		while ((p < end) && isspace(*p))
+			p++;
+		const char* q = scanInt(p, end, digitwrd);
+		if ((q == NULL) || (q == end) || !isspace(*q))
+			break;
+		while ((q < end) && isspace(*q))
+			q++;
+		q = scanDouble(q, end, featureval);
+		if (q == NULL)
+			break;
+		p = q;
 		numUniqueWords++;
 		if (digitwrd < 0) {
 			cout << "The input feature graph is not right: " << " some feature index is <0, please make sure the feature indices being above 0\n";
@@ -140,10 +156,6 @@ int line2words(char *s, struct SparseFeature & Feature, int & max_feat_idx){
 		if (digitwrd > max_feat_idx) {
 			max_feat_idx = digitwrd;
 		}
-		/*if (featureval < 0){
-		   cout << "The input feature graph has a feature value being negative, please make sure that the feature graph has all feature value >= 0\n";
-		   }*/
-		//assert(featureval >= 0);
 		Feature.featureIndex.push_back(digitwrd);
 		Feature.featureVec.push_back(featureval);
 	}
@@ -152,89 +164,170 @@ int line2words(char *s, struct SparseFeature & Feature, int & max_feat_idx){
 
 // A specific implementation to read in a feature file, with number of features in first line.
 std::vector<struct SparseFeature> readFeatureVectorSparse(char* featureFile, int& n, int &numFeatures){
-	// read the feature based function
-	std::vector<struct SparseFeature> feats;
-	// feats.resize(n);
-	ifstream iFile;
-	FILE *fp = NULL;
-	char line[300000]; //stores information in each line of input
+	SparseDataset data;
+	Vector noLabels;
 	printf("Reading feature File from %s...\n", featureFile);
-	if ((fp = fopen(featureFile, "rt")) == NULL) {
-		printf("Error: Cannot open file %s", featureFile);
-		exit(-1);
-	}
-	long int lineno = 0;
-	// read in the first line of the file, and skip it.
-	//fgets(line,sizeof(line),fp);
-	int pos = 0;
-	n = 0;
-	numFeatures = 0;
-	//sscanf(line,"%d %d %n",&n,&numFeatures, &pos);
-	//cout<<"n = "<<n<<" and "<< "numFeatures = "<<numFeatures<<"\n";
-	int max_feat_idx;
-	while ( fgets(line,sizeof(line),fp) != NULL) {
-		feats.push_back(SparseFeature());
-		feats[lineno].index = lineno;
-		feats[lineno].numUniqueFeatures = line2words(line, feats[lineno], max_feat_idx); //line2words transforms input with fmt digwords:featurevals into initialization of structure "Feature"
-		//feats[lineno].numFeatures = numFeatures;
-		if (max_feat_idx > numFeatures) {
-			numFeatures = max_feat_idx;
-		}
-		lineno++;
-	}
-	fclose(fp);
-	n = lineno;
-	numFeatures++;
+	parseSparseText(featureFile, INDEX_VALUE_FORMAT, data, noLabels, n, numFeatures);
 	printf("The input feature file has %d instances and the dimension of the features is %d\n", n, numFeatures);
-	for (int idx = 0; idx < n; idx++) {
-		feats[idx].numFeatures = numFeatures;
-	}
-
 	cout<<"done with reading the feature based file\n";
-	return feats;
+	return data.toSparseFeatures();
 }
 
 // Read labels and features stored in LIBSVM format.
 void readFeatureLabelsLibSVM( const char* fname, std::vector<struct SparseFeature>& features, Vector& y, int& n, int &numFeatures)
 {
-	features = std::vector<struct SparseFeature>();
-	FILE* file;
+	SparseDataset data;
+	readFeatureLabelsLibSVM(fname, data, y, n, numFeatures);
+	features = data.toSparseFeatures();
+}
+
+void readFeatureLabelsLibSVM( const char* fname, SparseDataset& features, Vector& y, int& n, int &numFeatures)
+{
 	printf("Reading feature File from %s...\n", fname);
-	if ((file = fopen(fname, "rt")) == NULL) {
-		printf("Error: Cannot open file %s", fname);
-		exit(-1);
+	parseSparseText(fname, LIBSVM_FORMAT, features, y, n, numFeatures);
+	printf("The input feature file has %d instances and the dimension of the features is %d\n", n, numFeatures);
+}
+
+struct DatasetFileHeader {
+	char magic[8];
+	int32_t version;
+	int32_t reserved;
+	int64_t n;
+	int64_t m;
+	int64_t nnz;
+	int64_t rowPtrOffset;
+	int64_t indexOffset;
+	int64_t valueOffset;
+	int64_t labelOffset;
+	int64_t normOffset;
+	int64_t fileSize;
+};
+
+static const char datasetMagic[8] = {'J', 'E', 'N', 'S', 'E', 'N', 'D', 'S'};
+
+static int64_t alignOffset(int64_t offset){
+	return (offset + 63) & ~((int64_t) 63);
+}
+
+static void writeSection(FILE* fp, int64_t offset, const void* ptr, size_t size, const char* fname){
+	if (fseek(fp, offset, SEEK_SET) != 0 || (size > 0 && fwrite(ptr, 1, size, fp) != size))
+		error("ERROR: cannot write to file %s", fname);
+}
+
+// Whether count entries of the given size starting at offset lie after the header and within the file, at an offset aligned
+// for the entries (compared without forming offset + count*size, which a corrupt header could overflow).
+static bool sectionFits(const int64_t offset, const int64_t count, const int64_t size, const int64_t fileSize){
+	return (offset >= (int64_t) sizeof(DatasetFileHeader)) && (offset <= fileSize) && (offset % size == 0) && (count >= 0)
+	       && (count <= (fileSize - offset)/size);
+}
+
+void writeDatasetBinary(const char* fname, const SparseDataset& features, const Vector& y)
+{
+	assert(features.size() == y.size());
+	if (features.isRowView()) {         // the file stores the CSR arrays, so the rows of a view are gathered first
+		writeDatasetBinary(fname, SparseDataset(features.toSparseFeatures()), y);
+		return;
 	}
-	float label; bool init = true;
-	char tmp[ 1024 ];
-	numFeatures = 0;
-	n = 0;
-	struct SparseFeature feature;
-	while( fscanf( file, "%s", tmp ) == 1 ) {
-		int index; float value;
-		if( sscanf( tmp, "%d:%f", &index, &value ) == 2 ) {
-			feature.featureIndex.push_back(index); feature.featureVec.push_back(value);
-			if (index > numFeatures)
-				numFeatures = index;
-		}else{
-			if( !init ) {
-				y.push_back(label);
-				features.push_back(feature);
-				feature = SparseFeature();
-				n++;
-			}
-			assert(sscanf( tmp, "%f", &label ) == 1);
-			init = false;
-		}
+	assert(sizeof(long int) == sizeof(int64_t));
+	int n = features.size();
+	int64_t nnz = features.nnz();
+	DatasetFileHeader h;
+	memset(&h, 0, sizeof(h));
+	memcpy(h.magic, datasetMagic, sizeof(h.magic));
+	h.version = JENSEN_DATASET_VERSION;
+	h.n = n;
+	h.m = features.numFeatures();
+	h.nnz = nnz;
+	h.rowPtrOffset = alignOffset(sizeof(h));
+	h.indexOffset = alignOffset(h.rowPtrOffset + (n + 1)*sizeof(int64_t));
+	h.valueOffset = alignOffset(h.indexOffset + nnz*sizeof(int32_t));
+	h.labelOffset = alignOffset(h.valueOffset + nnz*sizeof(double));
+	h.normOffset = alignOffset(h.labelOffset + n*sizeof(double));
+	h.fileSize = h.normOffset + n*sizeof(double);
+
+	Vector norms(n);
+	for (int i = 0; i < n; i++)
+		norms[i] = features.squaredNorm(i);
+
+	printf("Writing binary dataset to %s...\n", fname);
+	FILE* fp;
+	if ((fp = fopen(fname, "wb")) == NULL)
+		error("ERROR: cannot open file %s", fname);
+	writeSection(fp, 0, &h, sizeof(h), fname);
+	writeSection(fp, h.rowPtrOffset, features.rowPointers(), (n + 1)*sizeof(int64_t), fname);
+	writeSection(fp, h.indexOffset, features.indices(), nnz*sizeof(int32_t), fname);
+	writeSection(fp, h.valueOffset, features.data(), nnz*sizeof(double), fname);
+	writeSection(fp, h.labelOffset, y.data(), n*sizeof(double), fname);
+	writeSection(fp, h.normOffset, norms.data(), n*sizeof(double), fname);
+	if (ferror(fp) != 0 || fclose(fp) != 0)
+		error("ERROR: cannot write to file %s", fname);
+}
+
+bool isDatasetBinary(const char* fname)
+{
+	FILE* fp;
+	if ((fp = fopen(fname, "rb")) == NULL)
+		return false;
+	char magic[8];
+	bool isBinary = (fread(magic, 1, sizeof(magic), fp) == sizeof(magic)) && (memcmp(magic, datasetMagic, sizeof(magic)) == 0);
+	fclose(fp);
+	return isBinary;
+}
+
+void readDatasetBinary(const char* fname, SparseDataset& features, Vector& y, int& n, int &numFeatures)
+{
+	assert(sizeof(long int) == sizeof(int64_t));
+	printf("Mapping binary dataset from %s...\n", fname);
+	std::shared_ptr<MappedFile> mapping(new MappedFile(fname));
+	const char* base = mapping->data();
+	DatasetFileHeader h;
+	if (mapping->size() < sizeof(h))
+		error("ERROR: %s is not a binary dataset", fname);
+	memcpy(&h, base, sizeof(h));
+	if (memcmp(h.magic, datasetMagic, sizeof(h.magic)) != 0)
+		error("ERROR: %s is not a binary dataset", fname);
+	if (h.version != JENSEN_DATASET_VERSION)
+		error("ERROR: %s has binary dataset version %d, expected version %d", fname, h.version, JENSEN_DATASET_VERSION);
+	if (h.fileSize != (int64_t) mapping->size())
+		error("ERROR: %s is truncated (%ld bytes, expected %ld)", fname, (long) mapping->size(), (long) h.fileSize);
+	if ((h.n < 0) || (h.n >= INT_MAX) || (h.m < 0) || (h.m > INT_MAX))
+		error("ERROR: %s is not a binary dataset (n = %ld, m = %ld)", fname, (long) h.n, (long) h.m);
+	if (!sectionFits(h.rowPtrOffset, h.n + 1, sizeof(int64_t), h.fileSize)
+	    || !sectionFits(h.indexOffset, h.nnz, sizeof(int32_t), h.fileSize)
+	    || !sectionFits(h.valueOffset, h.nnz, sizeof(double), h.fileSize)
+	    || !sectionFits(h.labelOffset, h.n, sizeof(double), h.fileSize)
+	    || !sectionFits(h.normOffset, h.n, sizeof(double), h.fileSize))
+		error("ERROR: %s is not a binary dataset (a section lies outside the file)", fname);
+	// the rows and their indices are used without bounds checks, so they are checked once here
+	const long int* rowPtr = (const long int*) (base + h.rowPtrOffset);
+	const int* indices = (const int*) (base + h.indexOffset);
+	if ((rowPtr[0] != 0) || (rowPtr[h.n] != h.nnz))
+		error("ERROR: %s is not a binary dataset (the rows hold %ld non-zeros, expected %ld)", fname, (long) rowPtr[h.n],
+		      (long) h.nnz);
+	for (long int i = 0; i < h.n; i++) {
+		if (rowPtr[i+1] < rowPtr[i])
+			error("ERROR: %s is not a binary dataset (row %ld ends before it starts)", fname, i);
 	}
-	y.push_back(label);
-	features.push_back(feature);
-	n++;
-	numFeatures++;
-	printf("The input feature file has %d instances and the dimension of the features is %d\n", n, numFeatures);
-	for (int idx = 0; idx < features.size(); idx++) {
-		features[idx].numFeatures = numFeatures;
+	for (long int p = 0; p < h.nnz; p++) {
+		if ((indices[p] < 0) || (indices[p] >= h.m))
+			error("ERROR: %s is not a binary dataset (feature index %d is not below %ld)", fname, indices[p], (long) h.m);
 	}
-	fclose(file);
+
+	n = h.n;
+	numFeatures = h.m;
+	const double* labels = (const double*) (base + h.labelOffset);
+	y = Vector(labels, labels + n);
+	features = SparseDataset(mapping, n, numFeatures, rowPtr, indices, (const double*) (base + h.valueOffset),
+	                         (const double*) (base + h.normOffset));
+	printf("The input feature file has %d instances and the dimension of the features is %d\n", n, numFeatures);
+}
+
+void readDataset(const char* fname, SparseDataset& features, Vector& y, int& n, int &numFeatures)
+{
+	if (isDatasetBinary(fname))
+		readDatasetBinary(fname, features, y, n, numFeatures);
+	else
+		readFeatureLabelsLibSVM(fname, features, y, n, numFeatures);
 }
 
 
@@ -250,44 +343,8 @@ void readFeatureVectorSparseCrossValidate(char* featureFile, char* labelFile,
                                           Vector &testLabels)
 {
 	// read the feature based function
-	std::vector<struct SparseFeature> feats;
-	// feats.resize(n);
-	ifstream iFile;
-	FILE *fp = NULL;
-	char line[300000]; //stores information in each line of input
-	printf("Reading feature File from %s...\n", featureFile);
-	if ((fp = fopen(featureFile, "rt")) == NULL) {
-		printf("Error: Cannot open file %s", featureFile);
-		exit(-1);
-	}
-	long int lineno = 0;
-	// read in the first line of the file, and skip it.
-	//fgets(line,sizeof(line),fp);
-	int pos = 0;
-	int n = 0;
-	numFeatures = 0;
-	//sscanf(line,"%d %d %n",&n,&numFeatures, &pos);
-	//cout<<"n = "<<n<<" and "<< "numFeatures = "<<numFeatures<<"\n";
-	int max_feat_idx;
-	while ( fgets(line,sizeof(line),fp) != NULL) {
-		feats.push_back(SparseFeature());
-		feats[lineno].index = lineno;
-		feats[lineno].numUniqueFeatures = line2words(line, feats[lineno], max_feat_idx); //line2words transforms input with fmt digwords:featurevals into initialization of structure "Feature"
-		//feats[lineno].numFeatures = numFeatures;
-		if (max_feat_idx > numFeatures) {
-			numFeatures = max_feat_idx;
-		}
-		lineno++;
-	}
-	fclose(fp);
-	n = lineno;
-	numFeatures++;
-	printf("The input feature file has %d instances and the dimension of the features is %d\n", n, numFeatures);
-	for (int idx = 0; idx < n; idx++) {
-		feats[idx].numFeatures = numFeatures;
-	}
-
-	cout<<"Done with reading the feature based file.\n";
+	int n;
+	std::vector<struct SparseFeature> feats = readFeatureVectorSparse(featureFile, n, numFeatures);
 
 	// Split into testing and training data
 	// First gather labels
@@ -9,6 +9,7 @@
 
 #include "Vector.h"
 #include "SparseFeature.h"
+#include "SparseDataset.h"
 
 
 namespace jensen {
@@ -31,6 +32,27 @@ std::vector<struct SparseFeature> readFeatureVectorSparse(char* featureFile, int
 
 void readFeatureLabelsLibSVM( const char* fname, std::vector<struct SparseFeature>& features, Vector& y, int& n, int &numFeatures);
 
+void readFeatureLabelsLibSVM( const char* fname, SparseDataset& features, Vector& y, int& n, int &numFeatures);
+
+// Binary dataset format (version JENSEN_DATASET_VERSION): a fixed size header (magic "JENSENDS", version,
+// n, m, nnz and the byte offset of every section) followed by the CSR row pointers (int64, n+1),
+// feature indices (int32, nnz), feature values (double, nnz), labels (double, n) and squared row
+// norms (double, n), each section aligned to 64 bytes. Stored in native (little endian) byte order.
+#define JENSEN_DATASET_VERSION 1
+
+void writeDatasetBinary(const char* fname, const SparseDataset& features, const Vector& y);
+
+// Memory-maps a binary dataset: the CSR arrays and the row norms are served directly from the mapping
+// (no copy, shared through the page cache), only the labels are copied into y. The sections, row
+// pointers and feature indices are checked against the header first; exits with an error if they
+// do not fit it.
+void readDatasetBinary(const char* fname, SparseDataset& features, Vector& y, int& n, int &numFeatures);
+
+bool isDatasetBinary(const char* fname);
+
+// Reads either a binary dataset or a LIBSVM text file, depending on the contents of fname.
+void readDataset(const char* fname, SparseDataset& features, Vector& y, int& n, int &numFeatures);
+
 void readFeatureVectorSparseCrossValidate(char* featureFile, char* labelFile,
                                           int& numTrainingInstances, int& numFeatures,
                                           float percentTrain,
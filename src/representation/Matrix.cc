@@ -10,91 +10,148 @@
 
 #include "Vector.h"
 #include "Matrix.h"
+#include "../utils/error.h"
 #include <assert.h>
+#include <stdlib.h>
+#include <string.h>
+#include <algorithm>
 #include <iostream>
 namespace jensen {
 
-Matrix::Matrix() : m(0), n(0){
+#define MATRIX_ALIGNMENT 64                 // bytes, a cache line (and an AVX-512 register)
+
+static int paddedStride(const int n){
+	int d = MATRIX_ALIGNMENT/sizeof(double);
+	return ((n + d - 1)/d)*d;
 }
 
-Matrix::Matrix(int m, int n) : m(m), n(n){
-	matrix.reserve(n);
-	for (int i = 0; i < m; i++) {
-		Vector v(n, 0);
-		matrix.push_back(v);
-	}
+static double* allocateRows(const long int doubles){
+	if (doubles == 0)
+		return NULL;
+	void* p = NULL;
+	if (posix_memalign(&p, MATRIX_ALIGNMENT, sizeof(double)*doubles) != 0)
+		error("ERROR: Unable to allocate the matrix");
+	return (double*) p;
 }
 
-Matrix::Matrix(int m, int n, int val) : m(m), n(n){
-	matrix.reserve(n);
-	for (int i = 0; i < m; i++) {
-		Vector v(n, val);
-		matrix.push_back(v);
-	}
+MatrixRow& MatrixRow::operator=(const Vector& v){
+	assert(v.size() == n);
+	memcpy(p, v.data(), sizeof(double)*n);
+	return *this;
+}
+
+MatrixRow& MatrixRow::operator=(const ConstMatrixRow& r){
+	assert(r.size() == n);
+	memmove(p, r.data(), sizeof(double)*n);
+	return *this;
+}
+
+Matrix::Matrix() : matrix(NULL), m(0), n(0), rowStride(0), capacity(0){
 }
 
-Matrix::Matrix(int m, int n, bool) : m(m), n(n){        // Identity Matrix constructor
-	matrix.reserve(n);
+Matrix::Matrix(int m, int n) : matrix(NULL), m(m), n(n), rowStride(paddedStride(n)), capacity(m){
+	matrix = allocateRows((long int) m*rowStride);
+	memset(matrix, 0, sizeof(double)*m*rowStride);
+}
+
+Matrix::Matrix(int m, int n, int val) : matrix(NULL), m(m), n(n), rowStride(paddedStride(n)), capacity(m){
+	matrix = allocateRows((long int) m*rowStride);
+	memset(matrix, 0, sizeof(double)*m*rowStride);
+	for (int i = 0; i < m; i++)
+		std::fill(matrix + (long int) i*rowStride, matrix + (long int) i*rowStride + n, (double) val);
+}
+
+Matrix::Matrix(int m, int n, bool) : matrix(NULL), m(m), n(n), rowStride(paddedStride(n)), capacity(m){        // Identity Matrix constructor
 	assert(m == n);         // works only for square matrices
-	for (int i = 0; i < m; i++) {
-		Vector v(n, 0);
-		v[i] = 1;
-		matrix.push_back(v);
-	}
+	matrix = allocateRows((long int) m*rowStride);
+	memset(matrix, 0, sizeof(double)*m*rowStride);
+	for (int i = 0; i < m; i++)
+		matrix[(long int) i*rowStride + i] = 1;
 }
 
-Matrix::Matrix(const Matrix& M) : m(M.m), n(M.n){
-	matrix.reserve(n);
-	Vector v(n, 0);
-	for (int i = 0; i < m; i++) {
-		for (int j = 0; j < n; j++) {
-			v[j] = M(i, j);
-		}
-		matrix.push_back(v);
-	}
+Matrix::Matrix(const Matrix& M) : matrix(NULL), m(M.m), n(M.n), rowStride(M.rowStride), capacity(M.m){
+	matrix = allocateRows((long int) m*rowStride);
+	memcpy(matrix, M.matrix, sizeof(double)*m*rowStride);
+}
+
+Matrix::~Matrix(){
+	free(matrix);
+}
+
+Matrix& Matrix::operator=(const Matrix& M){
+	Matrix copy(M);
+	swap(copy);
+	return *this;
+}
+
+void Matrix::swap(Matrix& M){
+	std::swap(matrix, M.matrix);
+	std::swap(m, M.m);
+	std::swap(n, M.n);
+	std::swap(rowStride, M.rowStride);
+	std::swap(capacity, M.capacity);
+}
+
+// Grows the buffer to hold at least the given number of rows (doubling, so push_back is amortized O(n)).
+void Matrix::reserveRows(const int rows){
+	if (rows <= capacity)
+		return;
+	int newCapacity = std::max(rows, 2*capacity);
+	double* p = allocateRows((long int) newCapacity*rowStride);
+	if (m > 0)
+		memcpy(p, matrix, sizeof(double)*m*rowStride);
+	free(matrix);
+	matrix = p;
+	capacity = newCapacity;
 }
 
 double& Matrix::operator()(const int i, const int j){         // Access to element
-	return matrix[i][j];
+	return matrix[(long int) i*rowStride + j];
 }
 
 const double& Matrix::operator()(const int i, const int j) const {        // Const Access to element
-	return matrix[i][j];
+	return matrix[(long int) i*rowStride + j];
 }
 
-Vector& Matrix::operator[](const int i){         // Row access
-	return matrix[i];
+MatrixRow Matrix::operator[](const int i){         // Row access
+	return MatrixRow(matrix + (long int) i*rowStride, n);
 }
 
-const Vector& Matrix::operator[](const int i) const {        // Row access
-	return matrix[i];
+ConstMatrixRow Matrix::operator[](const int i) const {        // Row access
+	return ConstMatrixRow(matrix + (long int) i*rowStride, n);
 }
 
 Vector Matrix::operator()(const int i) const {        // Column Access (this is one is value only and const)
-	Vector v(n, 0);
-	for (int j = 0; j < n; j++)
+	Vector v(m, 0);
+	for (int j = 0; j < m; j++)
 	{
-		v[j] = matrix[j][i];
+		v[j] = matrix[(long int) j*rowStride + i];
 	}
 	return v;
 }
 
 void Matrix::push_back(const Vector& v){         // Add a row
 	if (m == 0) {
-		matrix.push_back(v);
-		m++;
-		n = v.size();
+		if (v.size() != n) {         // the first row sets the number of columns
+			free(matrix);
+			matrix = NULL;
+			capacity = 0;
+			n = v.size();
+			rowStride = paddedStride(n);
+		}
 	}
-	else{
+	else
 		assert(v.size() == n);
-		matrix.push_back(v);
-		m++;
-	}
+	reserveRows(m + 1);
+	double* row = matrix + (long int) m*rowStride;
+	memcpy(row, v.data(), sizeof(double)*n);
+	memset(row + n, 0, sizeof(double)*(rowStride - n));
+	m++;
 }
 
 void Matrix::remove(int i){
 	assert((i >= 0) && (i < m));
-	matrix.erase(matrix.begin()+i);
+	memmove(matrix + (long int) i*rowStride, matrix + (long int) (i + 1)*rowStride, sizeof(double)*(m - i - 1)*rowStride);
 	m--;
 }
 
@@ -110,4 +167,16 @@ int Matrix::size() const {
 	return m*n;
 }
 
+int Matrix::stride() const {
+	return rowStride;
+}
+
+double* Matrix::data(){
+	return matrix;
+}
+
+const double* Matrix::data() const {
+	return matrix;
+}
+
 }
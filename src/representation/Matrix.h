@@ -4,6 +4,11 @@
 /*
         Jensen: A Convex Optimization And Machine Learning ToolKit
  *	Matrix class
+        The entries are stored row-major in one buffer aligned to 64 bytes: row i starts at
+        data() + i*stride(), the stride being the number of columns rounded up to a multiple of 8
+        doubles, so every row starts on a cache line (the padding is zero). Rows are accessed through
+        views (MatrixRow, ConstMatrixRow) on the buffer, which index, copy to and from a Vector and
+        give the raw pointer to the kernels of SimdKernels.h.
         Author: Rishabh Iyer
  *
  */
@@ -15,27 +20,97 @@
 
 namespace jensen {
 
+// A read only view of a row of a Matrix (valid until the matrix is resized or destroyed).
+class ConstMatrixRow {
+protected:
+const double* p;
+int n;
+public:
+ConstMatrixRow(const double* p, const int n) : p(p), n(n) {
+}
+const double& operator[](const int j) const {
+	return p[j];
+}
+int size() const {
+	return n;
+}
+const double* data() const {
+	return p;
+}
+const double* begin() const {
+	return p;
+}
+const double* end() const {
+	return p + n;
+}
+operator Vector() const {                 // a copy of the row
+	return Vector(p, p + n);
+}
+};
+
+// A view of a row of a Matrix (valid until the matrix is resized or destroyed).
+class MatrixRow {
+protected:
+double* p;
+int n;
+public:
+MatrixRow(double* p, const int n) : p(p), n(n) {
+}
+double& operator[](const int j) const {
+	return p[j];
+}
+int size() const {
+	return n;
+}
+double* data() const {
+	return p;
+}
+double* begin() const {
+	return p;
+}
+double* end() const {
+	return p + n;
+}
+operator Vector() const {                 // a copy of the row
+	return Vector(p, p + n);
+}
+operator ConstMatrixRow() const {
+	return ConstMatrixRow(p, n);
+}
+MatrixRow& operator=(const Vector& v);                 // copies v into the row (of the same size)
+MatrixRow& operator=(const ConstMatrixRow& r);
+};
+
 class Matrix {
 protected:
-std::vector<std::vector<double> > matrix;
+double* matrix;                 // aligned row-major storage of capacity rows
 int m;
 int n;
+int rowStride;
+int capacity;                 // rows allocated
+void reserveRows(const int rows);
 public:
 Matrix();
 Matrix(int m, int n);
 Matrix(int m, int n, int val);
 Matrix(int m, int n, bool);
 Matrix(const Matrix& M);
+~Matrix();
+Matrix& operator=(const Matrix& M);
+void swap(Matrix& M);
 double& operator()(const int i, const int j);         // point access
 const double& operator()(const int i, const int j) const;         // const point access
-Vector& operator[](const int i);         // row access
-const Vector& operator[](const int i) const;         // const row access
+MatrixRow operator[](const int i);         // row access
+ConstMatrixRow operator[](const int i) const;         // const row access
 Vector operator()(const int i) const;         // const column access (read only)
-void push_back(const Vector& v);         // add a row at the end
-void remove(int i);         // delete a row at position i (i starts from 0)
+void push_back(const Vector& v);         // add a row at the end (amortized O(n))
+void remove(int i);         // delete a row at position i (i starts from 0), moves the rows after it up with one memmove
 int numRows() const;
 int numColumns() const;
 int size() const;
+int stride() const;         // doubles between the starts of consecutive rows
+double* data();
+const double* data() const;
 };
 
 }
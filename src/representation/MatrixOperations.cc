@@ -9,81 +9,154 @@
 #include "Vector.h"
 #include "MatrixOperations.h"
 #include "VectorOperations.h"
+#include "SimdKernels.h"
 #include <assert.h>
+#include <math.h>
+#include <algorithm>
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+using namespace std;
+
+#define MATRIX_PARALLEL_WORK 100000                 // multiply-adds below which the products run sequentially
+#define MV_ROW_BLOCK 256                 // rows of a block of A x (the unit of work of a thread)
+#define MV_COLUMN_BLOCK 4096                 // columns of a block of A x and x A (32KB of x, resp. of the result)
+#define MM_ROW_BLOCK 64                 // the blocks of C = A*B are MM_ROW_BLOCK x MM_COLUMN_BLOCK
+#define MM_COLUMN_BLOCK 256
+#define MM_DEPTH_BLOCK 128                 // rows of the tiles of B (MM_DEPTH_BLOCK x MM_COLUMN_BLOCK, 256KB)
 
 namespace jensen {
-// z = x + y
-Matrix matrixAddition(const Matrix& A, const Matrix& B)
+
+// C = A + a*B, row by row (a = 1 or -1).
+static Matrix matrixAxpy(const Matrix& A, const double a, const Matrix& B)
 {
 	assert((A.numRows() == B.numRows()) && (A.numColumns() == B.numColumns()));
 	Matrix C(A.numRows(), A.numColumns());
 	for (int i = 0; i < A.numRows(); i++)
-	{
-		for (int j = 0; j < A.numColumns(); j++)
-		{
-			C(i, j) = A(i, j) + B(i, j);
-		}
-	}
+		axpyKernel(a, B[i].data(), A[i].data(), C[i].data(), A.numColumns());
 	return C;
 }
 
+// z = x + y
+Matrix matrixAddition(const Matrix& A, const Matrix& B)
+{
+	return matrixAxpy(A, 1, B);
+}
+
 Matrix matrixSubtraction(const Matrix& A, const Matrix& B)
 {
-	assert((A.numRows() == B.numRows()) && (A.numColumns() == B.numColumns()));
-	Matrix C(A.numRows(), A.numColumns());
-	for (int i = 0; i < A.numRows(); i++)
-	{
-		for (int j = 0; j < A.numColumns(); j++)
-		{
-			C(i, j) = A(i, j) - B(i, j);
-		}
-	}
-	return C;
+	return matrixAxpy(A, -1, B);
 }
 
 // z = A*x
+// Blocks of MV_ROW_BLOCK rows are distributed over the threads, and every block is swept by blocks of MV_COLUMN_BLOCK
+// columns, so the part of x in use stays in cache however long the rows are.
 Vector leftMatrixVectorProduct(const Matrix& A, const Vector& x)
 {
 	assert(A.numColumns() == x.size());
-	Vector z(x.size(), 0);
-	for (int i = 0; i < x.size(); i++)
-	{
-		z[i] = x*A[i];
+	int m = A.numRows();
+	int n = A.numColumns();
+	Vector z(m, 0);
+	int numBlocks = (m + MV_ROW_BLOCK - 1)/MV_ROW_BLOCK;
+	#pragma omp parallel for schedule(static) if ((long int) m*n > MATRIX_PARALLEL_WORK)
+	for (int b = 0; b < numBlocks; b++) {
+		int i1 = min(m, (b + 1)*MV_ROW_BLOCK);
+		for (int j0 = 0; j0 < n; j0 += MV_COLUMN_BLOCK) {
+			int len = min(n - j0, MV_COLUMN_BLOCK);
+			for (int i = b*MV_ROW_BLOCK; i < i1; i++)
+				z[i] += dotKernel(A[i].data() + j0, x.data() + j0, len);
+		}
 	}
 	return z;
 }
 
 // z = x*A
+// z = sum_i x_i A_i along the (contiguous) rows. The threads own disjoint blocks of MV_COLUMN_BLOCK columns of z, so
+// there is no reduction and the result does not depend on the number of threads.
 Vector rightMatrixVectorProduct(const Matrix& A, const Vector& x)
 {
 	assert(A.numRows() == x.size());
-	Vector z(A.numColumns(), 0);
-	for (int i = 0; i < A.numColumns(); i++)
-	{
-		for (int j = 0; j < A.numRows(); j++) {
-			z[i]+=A(j, i)*x[j];
+	int m = A.numRows();
+	int n = A.numColumns();
+	Vector z(n, 0);
+	int numBlocks = (n + MV_COLUMN_BLOCK - 1)/MV_COLUMN_BLOCK;
+	#pragma omp parallel for schedule(static) if ((long int) m*n > MATRIX_PARALLEL_WORK)
+	for (int b = 0; b < numBlocks; b++) {
+		int j0 = b*MV_COLUMN_BLOCK;
+		int len = min(n - j0, MV_COLUMN_BLOCK);
+		for (int i = 0; i < m; i++) {
+			if (x[i] != 0)
+				axpyKernel(x[i], A[i].data() + j0, z.data() + j0, z.data() + j0, len);
 		}
 	}
 	return z;
 }
 
 // C = A*B
+// Every block of C (MM_ROW_BLOCK x MM_COLUMN_BLOCK, the unit of work of a thread) is accumulated over tiles of
+// MM_DEPTH_BLOCK rows of B, which stay in cache while all the rows of the block of C are updated with them: C_i += A_ik B_k
+// on the contiguous parts of the rows. Each entry of C is summed over k in increasing order, whatever the number of threads.
 Matrix matrixMatrixProduct(const Matrix& A, const Matrix& B)
 {
 	assert(A.numColumns() == B.numRows());
+	int m = A.numRows();
 	int dsize = A.numColumns();
-	Matrix C(A.numRows(), B.numColumns());
-	for (int i = 0; i < A.numRows(); i++)
-	{
-		for (int j = 0; j < B.numColumns(); j++) {
-			for (int k = 0; k < dsize; k++) {
-				C(i, j) += A(i, k)*B(k, j);
+	int n = B.numColumns();
+	Matrix C(m, n);
+	int rowBlocks = (m + MM_ROW_BLOCK - 1)/MM_ROW_BLOCK;
+	int columnBlocks = (n + MM_COLUMN_BLOCK - 1)/MM_COLUMN_BLOCK;
+	#pragma omp parallel for schedule(dynamic) if ((double) m*n*dsize > MATRIX_PARALLEL_WORK)
+	for (int t = 0; t < rowBlocks*columnBlocks; t++) {
+		int i0 = (t/columnBlocks)*MM_ROW_BLOCK;
+		int i1 = min(m, i0 + MM_ROW_BLOCK);
+		int j0 = (t%columnBlocks)*MM_COLUMN_BLOCK;
+		int len = min(n - j0, MM_COLUMN_BLOCK);
+		for (int k0 = 0; k0 < dsize; k0 += MM_DEPTH_BLOCK) {
+			int k1 = min(dsize, k0 + MM_DEPTH_BLOCK);
+			for (int i = i0; i < i1; i++) {
+				double* c = C[i].data() + j0;
+				for (int k = k0; k < k1; k++) {
+					double a = A(i, k);
+					if (a != 0)
+						axpyKernel(a, B[k].data() + j0, c, c, len);
+				}
 			}
 		}
 	}
 	return C;
 }
 
+// C = a*A
+Matrix matrixScalarProduct(const Matrix& A, const double a)
+{
+	Matrix C(A.numRows(), A.numColumns());
+	for (int i = 0; i < A.numRows(); i++)
+		scaleKernel(a, A[i].data(), C[i].data(), A.numColumns());
+	return C;
+}
+
+// The norm of the entries (as norm(Vector)): l_1, l_2 (Frobenius), l_{\infty} (type 3), l_0 the number of non-zeros
+double norm(const Matrix& A, const int type)
+{
+	double val = 0;
+	for (int i = 0; i < A.numRows(); i++) {
+		const double* a = A[i].data();
+		if (type == 1)
+			val += sumAbsKernel(a, A.numColumns());
+		else if (type == 2)
+			val += sumSquaresKernel(a, A.numColumns());
+		else {
+			for (int j = 0; j < A.numColumns(); j++) {
+				if (type == 0)
+					val += (a[j] != 0);
+				else if (type == 3)
+					val = max(val, fabs(a[j]));
+			}
+		}
+	}
+	return (type == 2) ? sqrt(val) : val;
+}
+
 const Matrix operator+(const Matrix& A, const Matrix &B){
 	Matrix C = matrixAddition(A, B);
 	return C;
@@ -108,23 +181,16 @@ const Matrix operator*(const Matrix& A, const Matrix& B){
 	return C;
 }
 const Matrix operator*(const Matrix& A, const double a){
-	Matrix C(A.numRows(), A.numColumns());
-	for (int i = 0; i < A.numRows(); i++)
-	{
-		for (int j = 0; j < A.numColumns(); j++)
-		{
-			C(i, j) = A(i, j) + a;
-		}
-	}
+	Matrix C = matrixScalarProduct(A, a);
 	return C;
 }
 
 // x == y
 bool operator== (const Matrix& A, const Matrix& B){
-	if ( (A.numRows() != B.numRows()) && (A.numColumns() == B.numColumns()) )
+	if ( (A.numRows() != B.numRows()) || (A.numColumns() != B.numColumns()) )
 		return false;
 	for (int i = 0; i < A.numRows(); i++) {
-		if (A[i] != B[i])
+		if (!std::equal(A[i].begin(), A[i].end(), B[i].begin()))
 			return false;
 	}
 	return true;
@@ -139,10 +205,10 @@ bool operator< (const Matrix& A, const Matrix& B){
 	assert((A.numRows() == B.numRows()) && (A.numColumns() == B.numColumns()));
 	for (int i = 0; i < A.numRows(); i++)
 	{
-		if (A[i] < B[i])
-			continue;
-		else
-			return false;
+		for (int j = 0; j < A.numColumns(); j++) {
+			if (A(i, j) >= B(i, j))
+				return false;
+		}
 	}
 	return true;
 }
@@ -151,10 +217,10 @@ bool operator<= (const Matrix& A, const Matrix& B){
 	assert((A.numRows() == B.numRows()) && (A.numColumns() == B.numColumns()));
 	for (int i = 0; i < A.numRows(); i++)
 	{
-		if (A[i] <= B[i])
-			continue;
-		else
-			return false;
+		for (int j = 0; j < A.numColumns(); j++) {
+			if (A(i, j) > B(i, j))
+				return false;
+		}
 	}
 	return true;
 }
@@ -163,10 +229,10 @@ bool operator> (const Matrix& A, const Matrix& B){
 	assert((A.numRows() == B.numRows()) && (A.numColumns() == B.numColumns()));
 	for (int i = 0; i < A.numRows(); i++)
 	{
-		if (A[i] > B[i])
-			continue;
-		else
-			return false;
+		for (int j = 0; j < A.numColumns(); j++) {
+			if (A(i, j) <= B(i, j))
+				return false;
+		}
 	}
 	return true;
 }
@@ -175,10 +241,10 @@ bool operator>= (const Matrix& A, const Matrix& B){
 	assert((A.numRows() == B.numRows()) && (A.numColumns() == B.numColumns()));
 	for (int i = 0; i < A.numRows(); i++)
 	{
-		if (A[i] >= B[i])
-			continue;
-		else
-			return false;
+		for (int j = 0; j < A.numColumns(); j++) {
+			if (A(i, j) < B(i, j))
+				return false;
+		}
 	}
 	return true;
 }
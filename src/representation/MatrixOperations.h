@@ -3,7 +3,8 @@
 // See COPYING or http://opensource.org/licenses/OSL-3.0
 /*
    Common Matrix Operations like addition, subtraction and matrix and vector multiplication etc.
-   Implemented on the Vector and Matrix.
+   Implemented on the Vector and Matrix. The products are blocked for the cache, use the kernels of SimdKernels.h on the
+   contiguous rows and run with OpenMP on large matrices; their results do not depend on the number of threads.
    Author: Rishabh Iyer
  */
 
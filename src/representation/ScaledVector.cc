@@ -0,0 +1,66 @@
+// Copyright (C) Rishabh Iyer, John T. Halloran, and Kai Wei
+// Licensed under the Open Software License version 3.0
+// See COPYING or http://opensource.org/licenses/OSL-3.0
+/*
+        Jensen: A Convex Optimization And Machine Learning ToolKit
+ *	A vector kept as x = scale*v.
+        Author: Rishabh Iyer
+ *
+ */
+
+#include <cmath>
+#include "ScaledVector.h"
+#include "VectorOperations.h"
+
+namespace jensen {
+
+ScaledVector::ScaledVector(const Vector& x) : v(x), s(1) {
+}
+
+void ScaledVector::normalize(){
+	scalarMultiplication(v, s, v);
+	s = 1;
+}
+
+void ScaledVector::scale(const double c){
+	if (c == 0) {
+		v.assign(v.size(), 0);
+		s = 1;
+		return;
+	}
+	s *= c;
+	if (fabs(s) < 1e-10)                 // keep v and 1/s representable
+		normalize();
+}
+
+double ScaledVector::operator*(const SparseFeature& f) const {
+	return s*(v*f);
+}
+
+double ScaledVector::operator*(const DenseFeature& f) const {
+	return s*(v*f);
+}
+
+double ScaledVector::operator*(const SparseRow& f) const {
+	return s*(v*f);
+}
+
+void ScaledVector::multiplyAdd(const double a, const SparseFeature& f){
+	featureMultiplyAdd(v, a/s, f);
+}
+
+void ScaledVector::multiplyAdd(const double a, const DenseFeature& f){
+	featureMultiplyAdd(v, a/s, f);
+}
+
+void ScaledVector::multiplyAdd(const double a, const SparseRow& f){
+	featureMultiplyAdd(v, a/s, f);
+}
+
+Vector ScaledVector::value() const {
+	Vector x;
+	scalarMultiplication(v, s, x);
+	return x;
+}
+
+}
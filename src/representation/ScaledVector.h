@@ -0,0 +1,41 @@
+// Copyright (C) Rishabh Iyer, John T. Halloran, and Kai Wei
+// Licensed under the Open Software License version 3.0
+// See COPYING or http://opensource.org/licenses/OSL-3.0
+/*
+        Jensen: A Convex Optimization And Machine Learning ToolKit
+ *	A vector kept as x = scale*v, so that x = c*x costs O(1) and x += a*f only touches the non-zeros
+        of f. Used by the stochastic gradient steps of l_2 regularized losses on sparse data, where the
+        shrinking by the regularizer is the only dense part of a step.
+        Author: Rishabh Iyer
+ *
+ */
+
+#ifndef SCALED_VECTOR_H
+#define SCALED_VECTOR_H
+
+#include "Vector.h"
+#include "SparseFeature.h"
+#include "DenseFeature.h"
+#include "SparseDataset.h"
+
+namespace jensen {
+
+class ScaledVector {
+protected:
+Vector v;
+double s;
+void normalize();                 // folds the scale into v
+public:
+ScaledVector(const Vector& x);
+void scale(const double c);                 // x = c*x
+double operator*(const SparseFeature& f) const;                 // x^T f
+double operator*(const DenseFeature& f) const;
+double operator*(const SparseRow& f) const;
+void multiplyAdd(const double a, const SparseFeature& f);                 // x = x + a*f
+void multiplyAdd(const double a, const DenseFeature& f);
+void multiplyAdd(const double a, const SparseRow& f);
+Vector value() const;                 // x
+};
+
+}
+#endif
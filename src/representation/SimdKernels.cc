@@ -0,0 +1,515 @@
+// Copyright (C) Rishabh Iyer, John T. Halloran, and Kai Wei
+// Licensed under the Open Software License version 3.0
+// See COPYING or http://opensource.org/licenses/OSL-3.0
+/*
+        Jensen: A Convex Optimization And Machine Learning ToolKit
+ *	Dense and sparse kernels on arrays of doubles with runtime instruction set dispatch.
+        This file is compiled with -ffp-contract=off, so that the elementwise kernels never fuse
+        a multiply and an add, and hence round exactly like the scalar loops.
+        Author: Rishabh Iyer
+ *
+ */
+
+#include <math.h>
+#include "SimdKernels.h"
+
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#define JENSEN_X86_SIMD
+#include <immintrin.h>
+#endif
+
+namespace jensen {
+
+/////////////////////////////////////// scalar ///////////////////////////////////////
+
+static double dotScalar(const double* x, const double* y, long int n){
+	double d = 0;
+	for (long int i = 0; i < n; i++)
+		d += x[i]*y[i];
+	return d;
+}
+
+static double sumSquaresScalar(const double* x, long int n){
+	double s = 0;
+	for (long int i = 0; i < n; i++)
+		s += x[i]*x[i];
+	return s;
+}
+
+static double sumAbsScalar(const double* x, long int n){
+	double s = 0;
+	for (long int i = 0; i < n; i++)
+		s += fabs(x[i]);
+	return s;
+}
+
+static void axpyScalar(const double a, const double* x, const double* y, double* z, long int n){
+	for (long int i = 0; i < n; i++)
+		z[i] = y[i] + a*x[i];
+}
+
+static void scaleScalar(const double a, const double* x, double* z, long int n){
+	for (long int i = 0; i < n; i++)
+		z[i] = a*x[i];
+}
+
+static double sparseDotSequential(const double* x, const int* index, const double* val, long int nnz){
+	double d = 0;
+	for (long int k = 0; k < nnz; k++)
+		d += x[index[k]]*val[k];
+	return d;
+}
+
+// Four independent accumulators hide the latency of the loads of x.
+static double sparseDotScalar(const double* x, const int* index, const double* val, long int nnz){
+	double d0 = 0, d1 = 0, d2 = 0, d3 = 0;
+	long int k = 0;
+	for (; k + 4 <= nnz; k += 4) {
+		d0 += x[index[k]]*val[k];
+		d1 += x[index[k+1]]*val[k+1];
+		d2 += x[index[k+2]]*val[k+2];
+		d3 += x[index[k+3]]*val[k+3];
+	}
+	for (; k < nnz; k++)
+		d0 += x[index[k]]*val[k];
+	return (d0 + d1) + (d2 + d3);
+}
+
+// The updates are applied in order, so repeated indices accumulate exactly like the plain loop.
+static void sparseAxpyScalar(const double a, const int* index, const double* val, double* y, long int nnz){
+	long int k = 0;
+	for (; k + 4 <= nnz; k += 4) {
+		y[index[k]] += a*val[k];
+		y[index[k+1]] += a*val[k+1];
+		y[index[k+2]] += a*val[k+2];
+		y[index[k+3]] += a*val[k+3];
+	}
+	for (; k < nnz; k++)
+		y[index[k]] += a*val[k];
+}
+
+#ifdef JENSEN_X86_SIMD
+
+/////////////////////////////////////// SSE2 ///////////////////////////////////////
+
+__attribute__((target("sse2")))
+static inline double horizontalSum(__m128d v){
+	return _mm_cvtsd_f64(_mm_add_sd(v, _mm_unpackhi_pd(v, v)));
+}
+
+__attribute__((target("sse2")))
+static double dotSSE2(const double* x, const double* y, long int n){
+	__m128d s0 = _mm_setzero_pd(), s1 = _mm_setzero_pd();
+	long int i = 0;
+	for (; i + 4 <= n; i += 4) {
+		s0 = _mm_add_pd(s0, _mm_mul_pd(_mm_loadu_pd(x + i), _mm_loadu_pd(y + i)));
+		s1 = _mm_add_pd(s1, _mm_mul_pd(_mm_loadu_pd(x + i + 2), _mm_loadu_pd(y + i + 2)));
+	}
+	double d = horizontalSum(_mm_add_pd(s0, s1));
+	for (; i < n; i++)
+		d += x[i]*y[i];
+	return d;
+}
+
+__attribute__((target("sse2")))
+static double sumSquaresSSE2(const double* x, long int n){
+	__m128d s0 = _mm_setzero_pd(), s1 = _mm_setzero_pd();
+	long int i = 0;
+	for (; i + 4 <= n; i += 4) {
+		__m128d a = _mm_loadu_pd(x + i), b = _mm_loadu_pd(x + i + 2);
+		s0 = _mm_add_pd(s0, _mm_mul_pd(a, a));
+		s1 = _mm_add_pd(s1, _mm_mul_pd(b, b));
+	}
+	double s = horizontalSum(_mm_add_pd(s0, s1));
+	for (; i < n; i++)
+		s += x[i]*x[i];
+	return s;
+}
+
+__attribute__((target("sse2")))
+static double sumAbsSSE2(const double* x, long int n){
+	const __m128d mask = _mm_castsi128_pd(_mm_set1_epi64x(0x7fffffffffffffffLL));
+	__m128d s0 = _mm_setzero_pd(), s1 = _mm_setzero_pd();
+	long int i = 0;
+	for (; i + 4 <= n; i += 4) {
+		s0 = _mm_add_pd(s0, _mm_and_pd(_mm_loadu_pd(x + i), mask));
+		s1 = _mm_add_pd(s1, _mm_and_pd(_mm_loadu_pd(x + i + 2), mask));
+	}
+	double s = horizontalSum(_mm_add_pd(s0, s1));
+	for (; i < n; i++)
+		s += fabs(x[i]);
+	return s;
+}
+
+__attribute__((target("sse2")))
+static void axpySSE2(const double a, const double* x, const double* y, double* z, long int n){
+	const __m128d va = _mm_set1_pd(a);
+	long int i = 0;
+	for (; i + 2 <= n; i += 2)
+		_mm_storeu_pd(z + i, _mm_add_pd(_mm_loadu_pd(y + i), _mm_mul_pd(va, _mm_loadu_pd(x + i))));
+	for (; i < n; i++)
+		z[i] = y[i] + a*x[i];
+}
+
+__attribute__((target("sse2")))
+static void scaleSSE2(const double a, const double* x, double* z, long int n){
+	const __m128d va = _mm_set1_pd(a);
+	long int i = 0;
+	for (; i + 2 <= n; i += 2)
+		_mm_storeu_pd(z + i, _mm_mul_pd(va, _mm_loadu_pd(x + i)));
+	for (; i < n; i++)
+		z[i] = a*x[i];
+}
+
+/////////////////////////////////////// AVX2 ///////////////////////////////////////
+
+__attribute__((target("avx2,fma")))
+static inline double horizontalSum(__m256d v){
+	__m128d s = _mm_add_pd(_mm256_castpd256_pd128(v), _mm256_extractf128_pd(v, 1));
+	return _mm_cvtsd_f64(_mm_add_sd(s, _mm_unpackhi_pd(s, s)));
+}
+
+__attribute__((target("avx2,fma")))
+static double dotAVX2(const double* x, const double* y, long int n){
+	__m256d s0 = _mm256_setzero_pd(), s1 = _mm256_setzero_pd(), s2 = _mm256_setzero_pd(), s3 = _mm256_setzero_pd();
+	long int i = 0;
+	for (; i + 16 <= n; i += 16) {
+		s0 = _mm256_fmadd_pd(_mm256_loadu_pd(x + i), _mm256_loadu_pd(y + i), s0);
+		s1 = _mm256_fmadd_pd(_mm256_loadu_pd(x + i + 4), _mm256_loadu_pd(y + i + 4), s1);
+		s2 = _mm256_fmadd_pd(_mm256_loadu_pd(x + i + 8), _mm256_loadu_pd(y + i + 8), s2);
+		s3 = _mm256_fmadd_pd(_mm256_loadu_pd(x + i + 12), _mm256_loadu_pd(y + i + 12), s3);
+	}
+	for (; i + 4 <= n; i += 4)
+		s0 = _mm256_fmadd_pd(_mm256_loadu_pd(x + i), _mm256_loadu_pd(y + i), s0);
+	double d = horizontalSum(_mm256_add_pd(_mm256_add_pd(s0, s1), _mm256_add_pd(s2, s3)));
+	for (; i < n; i++)
+		d += x[i]*y[i];
+	return d;
+}
+
+__attribute__((target("avx2,fma")))
+static double sumSquaresAVX2(const double* x, long int n){
+	__m256d s0 = _mm256_setzero_pd(), s1 = _mm256_setzero_pd(), s2 = _mm256_setzero_pd(), s3 = _mm256_setzero_pd();
+	long int i = 0;
+	for (; i + 16 <= n; i += 16) {
+		__m256d a = _mm256_loadu_pd(x + i), b = _mm256_loadu_pd(x + i + 4);
+		__m256d c = _mm256_loadu_pd(x + i + 8), d = _mm256_loadu_pd(x + i + 12);
+		s0 = _mm256_fmadd_pd(a, a, s0);
+		s1 = _mm256_fmadd_pd(b, b, s1);
+		s2 = _mm256_fmadd_pd(c, c, s2);
+		s3 = _mm256_fmadd_pd(d, d, s3);
+	}
+	for (; i + 4 <= n; i += 4) {
+		__m256d a = _mm256_loadu_pd(x + i);
+		s0 = _mm256_fmadd_pd(a, a, s0);
+	}
+	double s = horizontalSum(_mm256_add_pd(_mm256_add_pd(s0, s1), _mm256_add_pd(s2, s3)));
+	for (; i < n; i++)
+		s += x[i]*x[i];
+	return s;
+}
+
+__attribute__((target("avx2,fma")))
+static double sumAbsAVX2(const double* x, long int n){
+	const __m256d mask = _mm256_castsi256_pd(_mm256_set1_epi64x(0x7fffffffffffffffLL));
+	__m256d s0 = _mm256_setzero_pd(), s1 = _mm256_setzero_pd();
+	long int i = 0;
+	for (; i + 8 <= n; i += 8) {
+		s0 = _mm256_add_pd(s0, _mm256_and_pd(_mm256_loadu_pd(x + i), mask));
+		s1 = _mm256_add_pd(s1, _mm256_and_pd(_mm256_loadu_pd(x + i + 4), mask));
+	}
+	double s = horizontalSum(_mm256_add_pd(s0, s1));
+	for (; i < n; i++)
+		s += fabs(x[i]);
+	return s;
+}
+
+__attribute__((target("avx2,fma")))
+static void axpyAVX2(const double a, const double* x, const double* y, double* z, long int n){
+	const __m256d va = _mm256_set1_pd(a);
+	long int i = 0;
+	for (; i + 4 <= n; i += 4)
+		_mm256_storeu_pd(z + i, _mm256_add_pd(_mm256_loadu_pd(y + i), _mm256_mul_pd(va, _mm256_loadu_pd(x + i))));
+	for (; i < n; i++)
+		z[i] = y[i] + a*x[i];
+}
+
+__attribute__((target("avx2,fma")))
+static void scaleAVX2(const double a, const double* x, double* z, long int n){
+	const __m256d va = _mm256_set1_pd(a);
+	long int i = 0;
+	for (; i + 4 <= n; i += 4)
+		_mm256_storeu_pd(z + i, _mm256_mul_pd(va, _mm256_loadu_pd(x + i)));
+	for (; i < n; i++)
+		z[i] = a*x[i];
+}
+
+// Gathers only pay off for rows of a few vectors, shorter rows use the unrolled scalar loop.
+#define MIN_GATHER_NNZ 16
+
+__attribute__((target("avx2,fma")))
+static double sparseDotAVX2(const double* x, const int* index, const double* val, long int nnz){
+	if (nnz < MIN_GATHER_NNZ)
+		return sparseDotScalar(x, index, val, nnz);
+	__m256d s0 = _mm256_setzero_pd(), s1 = _mm256_setzero_pd();
+	long int k = 0;
+	for (; k + 8 <= nnz; k += 8) {
+		__m256d x0 = _mm256_i32gather_pd(x, _mm_loadu_si128((const __m128i*) (index + k)), 8);
+		__m256d x1 = _mm256_i32gather_pd(x, _mm_loadu_si128((const __m128i*) (index + k + 4)), 8);
+		s0 = _mm256_fmadd_pd(x0, _mm256_loadu_pd(val + k), s0);
+		s1 = _mm256_fmadd_pd(x1, _mm256_loadu_pd(val + k + 4), s1);
+	}
+	for (; k + 4 <= nnz; k += 4)
+		s0 = _mm256_fmadd_pd(_mm256_i32gather_pd(x, _mm_loadu_si128((const __m128i*) (index + k)), 8), _mm256_loadu_pd(val + k), s0);
+	double d = horizontalSum(_mm256_add_pd(s0, s1));
+	for (; k < nnz; k++)
+		d += x[index[k]]*val[k];
+	return d;
+}
+
+// There is no scatter in AVX2: the products are formed four at a time and added in order, so repeated
+// indices accumulate exactly like the scalar loop. (The AVX-512 scatter was not faster than these stores.)
+__attribute__((target("avx2,fma")))
+static void sparseAxpyAVX2(const double a, const int* index, const double* val, double* y, long int nnz){
+	const __m256d va = _mm256_set1_pd(a);
+	double p[4];
+	long int k = 0;
+	for (; k + 4 <= nnz; k += 4) {
+		_mm256_storeu_pd(p, _mm256_mul_pd(va, _mm256_loadu_pd(val + k)));
+		y[index[k]] += p[0];
+		y[index[k+1]] += p[1];
+		y[index[k+2]] += p[2];
+		y[index[k+3]] += p[3];
+	}
+	for (; k < nnz; k++)
+		y[index[k]] += a*val[k];
+}
+
+/////////////////////////////////////// AVX-512 ///////////////////////////////////////
+
+__attribute__((target("avx512f")))
+static double dotAVX512(const double* x, const double* y, long int n){
+	__m512d s0 = _mm512_setzero_pd(), s1 = _mm512_setzero_pd(), s2 = _mm512_setzero_pd(), s3 = _mm512_setzero_pd();
+	long int i = 0;
+	for (; i + 32 <= n; i += 32) {
+		s0 = _mm512_fmadd_pd(_mm512_loadu_pd(x + i), _mm512_loadu_pd(y + i), s0);
+		s1 = _mm512_fmadd_pd(_mm512_loadu_pd(x + i + 8), _mm512_loadu_pd(y + i + 8), s1);
+		s2 = _mm512_fmadd_pd(_mm512_loadu_pd(x + i + 16), _mm512_loadu_pd(y + i + 16), s2);
+		s3 = _mm512_fmadd_pd(_mm512_loadu_pd(x + i + 24), _mm512_loadu_pd(y + i + 24), s3);
+	}
+	for (; i + 8 <= n; i += 8)
+		s0 = _mm512_fmadd_pd(_mm512_loadu_pd(x + i), _mm512_loadu_pd(y + i), s0);
+	if (i < n) {
+		__mmask8 k = (__mmask8) ((1u << (n - i)) - 1);
+		s1 = _mm512_fmadd_pd(_mm512_maskz_loadu_pd(k, x + i), _mm512_maskz_loadu_pd(k, y + i), s1);
+	}
+	return _mm512_reduce_add_pd(_mm512_add_pd(_mm512_add_pd(s0, s1), _mm512_add_pd(s2, s3)));
+}
+
+__attribute__((target("avx512f")))
+static double sumSquaresAVX512(const double* x, long int n){
+	__m512d s0 = _mm512_setzero_pd(), s1 = _mm512_setzero_pd(), s2 = _mm512_setzero_pd(), s3 = _mm512_setzero_pd();
+	long int i = 0;
+	for (; i + 32 <= n; i += 32) {
+		__m512d a = _mm512_loadu_pd(x + i), b = _mm512_loadu_pd(x + i + 8);
+		__m512d c = _mm512_loadu_pd(x + i + 16), d = _mm512_loadu_pd(x + i + 24);
+		s0 = _mm512_fmadd_pd(a, a, s0);
+		s1 = _mm512_fmadd_pd(b, b, s1);
+		s2 = _mm512_fmadd_pd(c, c, s2);
+		s3 = _mm512_fmadd_pd(d, d, s3);
+	}
+	for (; i + 8 <= n; i += 8) {
+		__m512d a = _mm512_loadu_pd(x + i);
+		s0 = _mm512_fmadd_pd(a, a, s0);
+	}
+	if (i < n) {
+		__m512d a = _mm512_maskz_loadu_pd((__mmask8) ((1u << (n - i)) - 1), x + i);
+		s1 = _mm512_fmadd_pd(a, a, s1);
+	}
+	return _mm512_reduce_add_pd(_mm512_add_pd(_mm512_add_pd(s0, s1), _mm512_add_pd(s2, s3)));
+}
+
+__attribute__((target("avx512f")))
+static double sumAbsAVX512(const double* x, long int n){
+	__m512d s0 = _mm512_setzero_pd(), s1 = _mm512_setzero_pd();
+	long int i = 0;
+	for (; i + 16 <= n; i += 16) {
+		s0 = _mm512_add_pd(s0, _mm512_abs_pd(_mm512_loadu_pd(x + i)));
+		s1 = _mm512_add_pd(s1, _mm512_abs_pd(_mm512_loadu_pd(x + i + 8)));
+	}
+	for (; i + 8 <= n; i += 8)
+		s0 = _mm512_add_pd(s0, _mm512_abs_pd(_mm512_loadu_pd(x + i)));
+	if (i < n)
+		s1 = _mm512_add_pd(s1, _mm512_abs_pd(_mm512_maskz_loadu_pd((__mmask8) ((1u << (n - i)) - 1), x + i)));
+	return _mm512_reduce_add_pd(_mm512_add_pd(s0, s1));
+}
+
+__attribute__((target("avx512f")))
+static void axpyAVX512(const double a, const double* x, const double* y, double* z, long int n){
+	const __m512d va = _mm512_set1_pd(a);
+	long int i = 0;
+	for (; i + 8 <= n; i += 8)
+		_mm512_storeu_pd(z + i, _mm512_add_pd(_mm512_loadu_pd(y + i), _mm512_mul_pd(va, _mm512_loadu_pd(x + i))));
+	if (i < n) {
+		__mmask8 k = (__mmask8) ((1u << (n - i)) - 1);
+		_mm512_mask_storeu_pd(z + i, k, _mm512_add_pd(_mm512_maskz_loadu_pd(k, y + i), _mm512_mul_pd(va, _mm512_maskz_loadu_pd(k, x + i))));
+	}
+}
+
+__attribute__((target("avx512f")))
+static void scaleAVX512(const double a, const double* x, double* z, long int n){
+	const __m512d va = _mm512_set1_pd(a);
+	long int i = 0;
+	for (; i + 8 <= n; i += 8)
+		_mm512_storeu_pd(z + i, _mm512_mul_pd(va, _mm512_loadu_pd(x + i)));
+	if (i < n) {
+		__mmask8 k = (__mmask8) ((1u << (n - i)) - 1);
+		_mm512_mask_storeu_pd(z + i, k, _mm512_mul_pd(va, _mm512_maskz_loadu_pd(k, x + i)));
+	}
+}
+
+__attribute__((target("avx512f")))
+static double sparseDotAVX512(const double* x, const int* index, const double* val, long int nnz){
+	if (nnz < MIN_GATHER_NNZ)
+		return sparseDotScalar(x, index, val, nnz);
+	__m512d s0 = _mm512_setzero_pd(), s1 = _mm512_setzero_pd();
+	long int k = 0;
+	for (; k + 16 <= nnz; k += 16) {
+		__m512d x0 = _mm512_i32gather_pd(_mm256_loadu_si256((const __m256i*) (index + k)), x, 8);
+		__m512d x1 = _mm512_i32gather_pd(_mm256_loadu_si256((const __m256i*) (index + k + 8)), x, 8);
+		s0 = _mm512_fmadd_pd(x0, _mm512_loadu_pd(val + k), s0);
+		s1 = _mm512_fmadd_pd(x1, _mm512_loadu_pd(val + k + 8), s1);
+	}
+	for (; k + 8 <= nnz; k += 8)
+		s0 = _mm512_fmadd_pd(_mm512_i32gather_pd(_mm256_loadu_si256((const __m256i*) (index + k)), x, 8), _mm512_loadu_pd(val + k), s0);
+	if (k < nnz) {
+		int tail[8] = {0, 0, 0, 0, 0, 0, 0, 0};
+		for (long int t = k; t < nnz; t++)
+			tail[t - k] = index[t];
+		__mmask8 m = (__mmask8) ((1u << (nnz - k)) - 1);
+		__m512d xt = _mm512_mask_i32gather_pd(_mm512_setzero_pd(), m, _mm256_loadu_si256((const __m256i*) tail), x, 8);
+		s1 = _mm512_fmadd_pd(xt, _mm512_maskz_loadu_pd(m, val + k), s1);
+	}
+	return _mm512_reduce_add_pd(_mm512_add_pd(s0, s1));
+}
+
+#endif
+
+/////////////////////////////////////// dispatch ///////////////////////////////////////
+
+struct KernelTable {
+	double (*dot)(const double*, const double*, long int);
+	double (*sumSquares)(const double*, long int);
+	double (*sumAbs)(const double*, long int);
+	void (*axpy)(const double, const double*, const double*, double*, long int);
+	void (*scale)(const double, const double*, double*, long int);
+	double (*sparseDot)(const double*, const int*, const double*, long int);
+	void (*sparseAxpy)(const double, const int*, const double*, double*, long int);
+};
+
+// SSE2 has no gather, it uses the unrolled scalar loops for the sparse kernels.
+static const KernelTable scalarKernels = {dotScalar, sumSquaresScalar, sumAbsScalar, axpyScalar, scaleScalar,
+	                                  sparseDotScalar, sparseAxpyScalar};
+#ifdef JENSEN_X86_SIMD
+static const KernelTable sse2Kernels = {dotSSE2, sumSquaresSSE2, sumAbsSSE2, axpySSE2, scaleSSE2,
+	                                sparseDotScalar, sparseAxpyScalar};
+static const KernelTable avx2Kernels = {dotAVX2, sumSquaresAVX2, sumAbsAVX2, axpyAVX2, scaleAVX2,
+	                                sparseDotAVX2, sparseAxpyAVX2};
+static const KernelTable avx512Kernels = {dotAVX512, sumSquaresAVX512, sumAbsAVX512, axpyAVX512, scaleAVX512,
+	                                  sparseDotAVX512, sparseAxpyAVX2};
+#endif
+
+// The table starts out scalar, so that kernels called during static initialization are safe.
+static KernelTable kernels = scalarKernels;
+static SimdLevel currentLevel = SIMD_SCALAR;
+#ifdef JENSEN_REPRODUCIBLE
+static bool reproducible = true;
+#else
+static bool reproducible = false;
+#endif
+
+SimdLevel detectSimdLevel(){
+#ifdef JENSEN_X86_SIMD
+	__builtin_cpu_init();
+	if (__builtin_cpu_supports("avx512f"))
+		return SIMD_AVX512;
+	if (__builtin_cpu_supports("avx2") && __builtin_cpu_supports("fma"))
+		return SIMD_AVX2;
+	if (__builtin_cpu_supports("sse2"))
+		return SIMD_SSE2;
+#endif
+	return SIMD_SCALAR;
+}
+
+SimdLevel getSimdLevel(){
+	return currentLevel;
+}
+
+void setSimdLevel(SimdLevel level){
+	SimdLevel supported = detectSimdLevel();
+	if (level > supported)
+		level = supported;
+	currentLevel = level;
+	kernels = scalarKernels;
+#ifdef JENSEN_X86_SIMD
+	if (level == SIMD_SSE2)
+		kernels = sse2Kernels;
+	else if (level == SIMD_AVX2)
+		kernels = avx2Kernels;
+	else if (level == SIMD_AVX512)
+		kernels = avx512Kernels;
+#endif
+}
+
+const char* simdLevelName(SimdLevel level){
+	switch (level) {
+	case SIMD_SSE2: return "SSE2";
+	case SIMD_AVX2: return "AVX2";
+	case SIMD_AVX512: return "AVX-512";
+	default: return "scalar";
+	}
+}
+
+void setReproducibleKernels(bool r){
+	reproducible = r;
+}
+
+bool reproducibleKernels(){
+	return reproducible;
+}
+
+static struct SimdInit {
+	SimdInit(){
+		setSimdLevel(detectSimdLevel());
+	}
+} simdInit;
+
+double dotKernel(const double* x, const double* y, long int n){
+	return reproducible ? dotScalar(x, y, n) : kernels.dot(x, y, n);
+}
+
+double sumSquaresKernel(const double* x, long int n){
+	return reproducible ? sumSquaresScalar(x, n) : kernels.sumSquares(x, n);
+}
+
+double sumAbsKernel(const double* x, long int n){
+	return reproducible ? sumAbsScalar(x, n) : kernels.sumAbs(x, n);
+}
+
+void axpyKernel(const double a, const double* x, const double* y, double* z, long int n){
+	kernels.axpy(a, x, y, z, n);
+}
+
+void scaleKernel(const double a, const double* x, double* z, long int n){
+	kernels.scale(a, x, z, n);
+}
+
+double sparseDotKernel(const double* x, const int* index, const double* val, long int nnz){
+	return reproducible ? sparseDotSequential(x, index, val, nnz) : kernels.sparseDot(x, index, val, nnz);
+}
+
+void sparseAxpyKernel(const double a, const int* index, const double* val, double* y, long int nnz){
+	kernels.sparseAxpy(a, index, val, y, nnz);
+}
+
+}
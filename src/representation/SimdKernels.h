@@ -0,0 +1,48 @@
+// Copyright (C) Rishabh Iyer, John T. Halloran, and Kai Wei
+// Licensed under the Open Software License version 3.0
+// See COPYING or http://opensource.org/licenses/OSL-3.0
+/*
+        Jensen: A Convex Optimization And Machine Learning ToolKit
+ *	Dense and sparse kernels on arrays of doubles with SSE2, AVX2 and AVX-512 implementations
+        (the sparse dot product gathers the dense operand). The widest
+        instruction set supported by the CPU (checked with CPUID) is selected at startup, the
+        scalar loops are kept as a fallback.
+
+        The elementwise kernels give the same bits on every instruction set. The reductions
+        (dot products and norms) use several accumulators and hence round differently from the
+        sequential scalar loop. If bitwise reproducible results are required, call
+        setReproducibleKernels(true) (or build with -DJENSEN_REPRODUCIBLE=ON) and the reductions
+        are computed in the sequential order.
+        Author: Rishabh Iyer
+ *
+ */
+
+#ifndef SIMD_KERNELS_H
+#define SIMD_KERNELS_H
+
+namespace jensen {
+
+enum SimdLevel {
+	SIMD_SCALAR = 0,
+	SIMD_SSE2 = 1,
+	SIMD_AVX2 = 2,                 // AVX2 and FMA
+	SIMD_AVX512 = 3                 // AVX-512F
+};
+
+SimdLevel detectSimdLevel();                 // the widest instruction set supported by this CPU
+SimdLevel getSimdLevel();                 // the instruction set currently in use
+void setSimdLevel(SimdLevel level);                 // use a narrower instruction set (capped at detectSimdLevel())
+const char* simdLevelName(SimdLevel level);
+void setReproducibleKernels(bool reproducible);
+bool reproducibleKernels();
+
+double dotKernel(const double* x, const double* y, long int n);                 // sum_i x[i]*y[i]
+double sumSquaresKernel(const double* x, long int n);                 // sum_i x[i]^2
+double sumAbsKernel(const double* x, long int n);                 // sum_i |x[i]|
+void axpyKernel(const double a, const double* x, const double* y, double* z, long int n);                 // z = y + a*x (z may alias y)
+void scaleKernel(const double a, const double* x, double* z, long int n);                 // z = a*x (z may alias x)
+double sparseDotKernel(const double* x, const int* index, const double* val, long int nnz);                 // sum_k x[index[k]]*val[k]
+void sparseAxpyKernel(const double a, const int* index, const double* val, double* y, long int nnz);                 // y[index[k]] += a*val[k] (repeated indices are allowed)
+
+}
+#endif
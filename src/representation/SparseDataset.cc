@@ -0,0 +1,262 @@
+// Copyright (C) Rishabh Iyer, John T. Halloran, and Kai Wei
+// Licensed under the Open Software License version 3.0
+// See COPYING or http://opensource.org/licenses/OSL-3.0
+/*
+        Jensen: A Convex Optimization And Machine Learning ToolKit
+ *	A sparse dataset stored in compressed sparse row (CSR) format
+        Author: Rishabh Iyer
+ *
+ */
+
+#include "SparseDataset.h"
+#include <assert.h>
+
+namespace jensen {
+
+SparseDataset::SparseDataset() : rowPtr(1, 0), n(0), m(0), rowView(false){
+	resetPointers();
+}
+
+SparseDataset::SparseDataset(int numFeatures) : rowPtr(1, 0), n(0), m(numFeatures), rowView(false){
+	resetPointers();
+}
+
+SparseDataset::SparseDataset(const std::vector<SparseFeature>& features) : rowPtr(1, 0), n(0), m(0), rowView(false){
+	long int nnz = 0;
+	for (int i = 0; i < features.size(); i++)
+		nnz += features[i].featureIndex.size();
+	reserve(features.size(), nnz);
+	resetPointers();
+	for (int i = 0; i < features.size(); i++)
+		push_back(features[i]);
+}
+
+SparseDataset::SparseDataset(int numFeatures, std::vector<long int>& rowPtr, std::vector<int>& colIndex,
+                             std::vector<double>& values) : m(numFeatures), rowView(false){
+	assert(rowPtr.size() > 0);
+	assert(colIndex.size() == values.size());
+	assert(rowPtr.back() == colIndex.size());
+	this->rowPtr.swap(rowPtr);
+	this->colIndex.swap(colIndex);
+	this->values.swap(values);
+	n = this->rowPtr.size() - 1;
+	resetPointers();
+}
+
+SparseDataset::SparseDataset(std::shared_ptr<MappedFile> mapping, int n, int m, const long int* rowPtr, const int* colIndex,
+                             const double* values, const double* norms) : rowPtrData(rowPtr), rowEndData(rowPtr + 1),
+	colIndexData(colIndex), valuesData(values), normsData(norms), n(n), m(m), mapping(mapping), rowView(false){
+}
+
+SparseDataset::SparseDataset(const SparseDataset& D, const std::vector<int>& rows) : rowPtr(rows.size()), rowEnd(rows.size()),
+	n(rows.size()), m(D.m), mapping(D.mapping), rowView(true){
+	for (int k = 0; k < n; k++) {
+		assert((rows[k] >= 0) && (rows[k] < D.n));
+		rowPtr[k] = D.rowPtrData[rows[k]];
+		rowEnd[k] = D.rowEndData[rows[k]];
+	}
+	if (D.normsData != NULL) {
+		norms.resize(n);
+		for (int k = 0; k < n; k++)
+			norms[k] = D.normsData[rows[k]];
+	}
+	resetPointers();
+	colIndexData = D.colIndexData;
+	valuesData = D.valuesData;
+}
+
+SparseDataset::SparseDataset(const SparseDataset& D) : rowPtr(D.rowPtr), colIndex(D.colIndex), values(D.values), norms(D.norms),
+	rowEnd(D.rowEnd), n(D.n), m(D.m), mapping(D.mapping), rowView(D.rowView){
+	copyPointers(D);
+}
+
+SparseDataset& SparseDataset::operator=(const SparseDataset& D){
+	if (this == &D)
+		return *this;
+	rowPtr = D.rowPtr;
+	colIndex = D.colIndex;
+	values = D.values;
+	norms = D.norms;
+	rowEnd = D.rowEnd;
+	n = D.n;
+	m = D.m;
+	mapping = D.mapping;
+	rowView = D.rowView;
+	copyPointers(D);
+	return *this;
+}
+
+void SparseDataset::resetPointers(){
+	rowPtrData = rowPtr.data();
+	rowEndData = rowView ? rowEnd.data() : rowPtrData + 1;
+	normsData = norms.empty() ? NULL : norms.data();
+	if (!rowView) {
+		colIndexData = colIndex.data();
+		valuesData = values.data();
+	}
+}
+
+// After copying the members of D: a mapped dataset shares the mapped arrays, a row view shares the non-zeros of its parent.
+void SparseDataset::copyPointers(const SparseDataset& D){
+	if (mapping && !rowView) {
+		rowPtrData = D.rowPtrData;
+		rowEndData = D.rowEndData;
+		colIndexData = D.colIndexData;
+		valuesData = D.valuesData;
+		normsData = D.normsData;
+		return;
+	}
+	resetPointers();
+	if (rowView) {
+		colIndexData = D.colIndexData;
+		valuesData = D.valuesData;
+	}
+}
+
+void SparseDataset::detach(){
+	if (!mapping && !rowView)
+		return;
+	std::vector<long int> ptr;
+	std::vector<int> ind;
+	std::vector<double> val;
+	ptr.reserve(n + 1);
+	ptr.push_back(0);
+	ind.reserve(nnz());
+	val.reserve(nnz());
+	for (int i = 0; i < n; i++) {
+		ind.insert(ind.end(), colIndexData + rowPtrData[i], colIndexData + rowEndData[i]);
+		val.insert(val.end(), valuesData + rowPtrData[i], valuesData + rowEndData[i]);
+		ptr.push_back(ind.size());
+	}
+	if ((normsData != NULL) && norms.empty())
+		norms.assign(normsData, normsData + n);
+	rowPtr.swap(ptr);
+	colIndex.swap(ind);
+	values.swap(val);
+	rowEnd.clear();
+	rowView = false;
+	mapping.reset();
+	resetPointers();
+}
+
+void SparseDataset::reserve(long int numRows, long int numNonZeros){
+	detach();
+	rowPtr.reserve(numRows + 1);
+	colIndex.reserve(numNonZeros);
+	values.reserve(numNonZeros);
+	resetPointers();
+}
+
+void SparseDataset::push_back(const SparseRow& f){         // Add a row
+	assert(f.featureIndex.size() == f.featureVec.size());
+	detach();
+	colIndex.insert(colIndex.end(), f.featureIndex.begin(), f.featureIndex.end());
+	values.insert(values.end(), f.featureVec.begin(), f.featureVec.end());
+	rowPtr.push_back(colIndex.size());
+	if (!norms.empty()) {
+		double s = 0;
+		for (int j = 0; j < f.featureVec.size(); j++)
+			s += f.featureVec[j]*f.featureVec[j];
+		norms.push_back(s);
+	}
+	n++;
+	if (f.numFeatures > m)
+		m = f.numFeatures;
+	resetPointers();
+}
+
+double SparseDataset::squaredNorm(const int i) const {
+	if (normsData != NULL)
+		return normsData[i];
+	double s = 0;
+	for (long int k = rowPtrData[i]; k < rowEndData[i]; k++)
+		s += valuesData[k]*valuesData[k];
+	return s;
+}
+
+void SparseDataset::computeNorms(){
+	if (normsData != NULL)
+		return;
+	detach();
+	norms.resize(n);
+	for (int i = 0; i < n; i++)
+		norms[i] = squaredNorm(i);
+	resetPointers();
+}
+
+// Counting sort of the non-zeros by their feature index, i.e. the CSC layout of the data.
+SparseDataset SparseDataset::transpose() const {
+	std::vector<long int> colPtr(m + 1, 0);
+	std::vector<int> rowIndex(nnz());
+	std::vector<double> colValues(nnz());
+	for (int i = 0; i < n; i++)
+		for (long int k = rowPtrData[i]; k < rowEndData[i]; k++)
+			colPtr[colIndexData[k] + 1]++;
+	for (int j = 0; j < m; j++)
+		colPtr[j + 1] += colPtr[j];
+	std::vector<long int> next(colPtr.begin(), colPtr.end() - 1);
+	for (int i = 0; i < n; i++) {
+		for (long int k = rowPtrData[i]; k < rowEndData[i]; k++) {
+			long int pos = next[colIndexData[k]]++;
+			rowIndex[pos] = i;
+			colValues[pos] = valuesData[k];
+		}
+	}
+	return SparseDataset(n, colPtr, rowIndex, colValues);
+}
+
+std::vector<SparseFeature> SparseDataset::toSparseFeatures() const {
+	std::vector<SparseFeature> features(n);
+	for (int i = 0; i < n; i++) {
+		features[i].index = i;
+		features[i].numUniqueFeatures = rowEndData[i] - rowPtrData[i];
+		features[i].featureIndex.assign(colIndexData + rowPtrData[i], colIndexData + rowEndData[i]);
+		features[i].featureVec.assign(valuesData + rowPtrData[i], valuesData + rowEndData[i]);
+		features[i].numFeatures = m;
+	}
+	return features;
+}
+
+int SparseDataset::size() const {
+	return n;
+}
+
+int SparseDataset::numFeatures() const {
+	return m;
+}
+
+long int SparseDataset::nnz() const {
+	if (!rowView)
+		return rowPtrData[n];
+	long int count = 0;
+	for (int i = 0; i < n; i++)
+		count += rowEndData[i] - rowPtrData[i];
+	return count;
+}
+
+bool SparseDataset::isMapped() const {
+	return (bool) mapping;
+}
+
+bool SparseDataset::isRowView() const {
+	return rowView;
+}
+
+const long int* SparseDataset::rowPointers() const {
+	assert(!rowView);
+	return rowPtrData;
+}
+
+const int* SparseDataset::indices() const {
+	return colIndexData;
+}
+
+const double* SparseDataset::data() const {
+	return valuesData;
+}
+
+const double* SparseDataset::rowNorms() const {
+	return normsData;
+}
+
+}
@@ -0,0 +1,136 @@
+// Copyright (C) Rishabh Iyer, John T. Halloran, and Kai Wei
+// Licensed under the Open Software License version 3.0
+// See COPYING or http://opensource.org/licenses/OSL-3.0
+/*
+        Jensen: A Convex Optimization And Machine Learning ToolKit
+ *	A sparse dataset stored in compressed sparse row (CSR) format: one row-pointer array,
+        one index array and one value array for the whole groundset. Rows are handed out as
+        SparseRow views, which carry the same fields as a SparseFeature but do not own any memory.
+
+        A row view (SparseDataset(D, rows)) is a dataset made of a subset of the rows of D, e.g. the
+        training set of a cross-validation fold. It only stores where its rows start and end, the
+        non-zeros are read from D, which must outlive the view and not be modified. Modifying a view
+        copies its rows into a dataset of its own.
+ *
+ */
+
+#ifndef SPARSE_DATASET_H
+#define SPARSE_DATASET_H
+
+#include <vector>
+#include <memory>
+#include <stddef.h>
+#include "SparseFeature.h"
+#include "../utils/MappedFile.h"
+
+namespace jensen {
+
+template <class T>
+struct ArrayView {         // read only view over a contiguous array
+	const T* ptr;
+	int len;
+	ArrayView() : ptr(NULL), len(0) {
+	}
+	ArrayView(const T* ptr, int len) : ptr(ptr), len(len) {
+	}
+	int size() const {
+		return len;
+	}
+	const T& operator[](const int i) const {
+		return ptr[i];
+	}
+	const T* begin() const {
+		return ptr;
+	}
+	const T* end() const {
+		return ptr + len;
+	}
+};
+
+struct SparseRow {         // A view of a single row of a SparseDataset (or of a SparseFeature)
+	long int index;          // index of the item
+	int numUniqueFeatures;          // number of non-zero enteries in the feature vector
+	ArrayView<int> featureIndex;          // Indices which are non-zero (generally sparse)
+	ArrayView<double> featureVec;          // score of the features present.
+	int numFeatures;
+	SparseRow() : index(0), numUniqueFeatures(0), numFeatures(0) {
+	}
+	SparseRow(const SparseFeature& f) : index(f.index), numUniqueFeatures(f.featureIndex.size()),
+		featureIndex(f.featureIndex.data(), f.featureIndex.size()),
+		featureVec(f.featureVec.data(), f.featureVec.size()), numFeatures(f.numFeatures) {
+	}
+};
+
+class SparseDataset {
+protected:
+std::vector<long int> rowPtr;                 // size n+1, row i spans [rowPtr[i], rowPtr[i+1])
+std::vector<int> colIndex;                 // size nnz, the feature indices of all rows
+std::vector<double> values;                 // size nnz, the feature values of all rows
+std::vector<double> norms;                 // squared l_2 norms of the rows (empty if not computed)
+std::vector<long int> rowEnd;                 // row views only: row i spans [rowPtr[i], rowEnd[i]) of the parent arrays
+const long int* rowPtrData;                 // the arrays that are actually read: either the vectors above
+const long int* rowEndData;                 // rowPtrData + 1, except for row views
+const int* colIndexData;                 // or a region of a memory-mapped binary dataset file.
+const double* valuesData;
+const double* normsData;
+int n;                 // number of rows
+int m;                 // number of features (dimension)
+std::shared_ptr<MappedFile> mapping;                 // keeps a mapped file alive (NULL if the data is owned)
+bool rowView;                 // the non-zeros belong to another dataset (see above)
+void resetPointers();
+void copyPointers(const SparseDataset& D);
+void detach();                 // copy mapped arrays (or the rows of a view) into owned storage before modifying them
+public:
+typedef SparseRow value_type;
+SparseDataset();
+SparseDataset(int numFeatures);
+SparseDataset(const std::vector<SparseFeature>& features);
+SparseDataset(int numFeatures, std::vector<long int>& rowPtr, std::vector<int>& colIndex, std::vector<double>& values);         // takes over the arrays (swap)
+SparseDataset(std::shared_ptr<MappedFile> mapping, int n, int m, const long int* rowPtr, const int* colIndex,
+              const double* values, const double* norms);         // a view of arrays inside a mapped file (no copy)
+SparseDataset(const SparseDataset& D, const std::vector<int>& rows);         // a view of the given rows of D (no copy of the non-zeros)
+SparseDataset(const SparseDataset& D);
+SparseDataset& operator=(const SparseDataset& D);
+
+void reserve(long int numRows, long int numNonZeros);
+void push_back(const SparseRow& f);         // add a row at the end
+SparseRow operator[](const int i) const {         // row access (a view, valid as long as the dataset is not modified)
+	long int start = rowPtrData[i];
+	SparseRow r;
+	r.index = i;
+	r.numUniqueFeatures = rowEndData[i] - start;
+	r.featureIndex = ArrayView<int>(colIndexData + start, r.numUniqueFeatures);
+	r.featureVec = ArrayView<double>(valuesData + start, r.numUniqueFeatures);
+	r.numFeatures = m;
+	return r;
+}
+double squaredNorm(const int i) const;         // squared l_2 norm of row i (stored or computed)
+void computeNorms();
+SparseDataset transpose() const;         // the column (CSC) layout of the same data, as a dataset with m rows
+std::vector<SparseFeature> toSparseFeatures() const;
+
+int size() const;                 // number of rows (n)
+int numFeatures() const;                 // dimension of the rows (m)
+long int nnz() const;                 // total number of non-zeros
+bool isMapped() const;                 // true if the arrays live in a memory-mapped file
+bool isRowView() const;                 // true for a view of the rows of another dataset
+const long int* rowPointers() const;                 // the CSR arrays (not available for row views)
+const int* indices() const;
+const double* data() const;
+const double* rowNorms() const;                 // NULL if the norms are not available
+};
+
+// The container holding a training set of a given feature type: SparseRow views are served by
+// a SparseDataset, all other feature types are stored in a std::vector.
+template <class Feature>
+struct FeatureSet {
+	typedef std::vector<Feature> type;
+};
+
+template <>
+struct FeatureSet<SparseRow> {
+	typedef SparseDataset type;
+};
+
+}
+#endif
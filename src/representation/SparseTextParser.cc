@@ -0,0 +1,293 @@
+// Copyright (C) Rishabh Iyer, John T. Halloran, and Kai Wei
+// Licensed under the Open Software License version 3.0
+// See COPYING or http://opensource.org/licenses/OSL-3.0
+/*
+        Jensen: A Convex Optimization And Machine Learning ToolKit
+ *	A parallel parser for sparse text data files.
+        Author: Rishabh Iyer
+ *
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <limits.h>
+#include <string>
+#include <algorithm>
+#include "SparseTextParser.h"
+#include "../utils/error.h"
+#include "../utils/MappedFile.h"
+#include "../utils/Threads.h"
+
+using namespace std;
+
+namespace jensen {
+
+#define MIN_CHUNK_BYTES (1 << 16)
+#define CHUNKS_PER_THREAD 4
+
+static const double powersOfTen[] = {1e0, 1e1, 1e2, 1e3, 1e4, 1e5, 1e6, 1e7, 1e8, 1e9, 1e10, 1e11,
+	                             1e12, 1e13, 1e14, 1e15, 1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22};
+
+static inline bool isDigit(const char c){
+	return (c >= '0') && (c <= '9');
+}
+
+static inline bool isBlank(const char c){
+	return (c == ' ') || (c == '\t') || (c == '\r') || (c == '\v') || (c == '\f');
+}
+
+static inline const char* skipBlanks(const char* p, const char* end){
+	while ((p < end) && isBlank(*p))
+		p++;
+	return p;
+}
+
+const char* scanInt(const char* p, const char* end, int& value){
+	bool negative = false;
+	if ((p < end) && ((*p == '+') || (*p == '-'))) {
+		negative = (*p == '-');
+		p++;
+	}
+	if ((p == end) || !isDigit(*p))
+		return NULL;
+	long int v = 0;
+	while ((p < end) && isDigit(*p)) {
+		v = 10*v + (*p - '0');
+		if (v > INT_MAX)
+			return NULL;
+		p++;
+	}
+	value = negative ? -v : v;
+	return p;
+}
+
+// Rare cases (long mantissas, large exponents, inf/nan): copy the token and let strtod round it.
+static const char* scanDoubleSlow(const char* p, const char* end, double& value){
+	const char* q = p;
+	while ((q < end) && !isBlank(*q) && (*q != '\n') && (*q != ':'))
+		q++;
+	string token(p, q);
+	char* stop;
+	value = strtod(token.c_str(), &stop);
+	if (stop == token.c_str())
+		return NULL;
+	return p + (stop - token.c_str());
+}
+
+const char* scanDouble(const char* p, const char* end, double& value){
+	const char* start = p;
+	bool negative = false;
+	if ((p < end) && ((*p == '+') || (*p == '-'))) {
+		negative = (*p == '-');
+		p++;
+	}
+	unsigned long long mantissa = 0;
+	int significant = 0;          // digits kept in the mantissa
+	int exponent = 0;
+	bool truncated = false;
+	bool anyDigit = false;
+	for (; (p < end) && isDigit(*p); p++) {
+		anyDigit = true;
+		if ((mantissa == 0) && (*p == '0'))
+			continue;
+		if (significant < 19) {
+			mantissa = 10*mantissa + (*p - '0');
+			significant++;
+		}
+		else {
+			exponent++;
+			truncated = true;
+		}
+	}
+	if ((p < end) && (*p == '.')) {
+		p++;
+		for (; (p < end) && isDigit(*p); p++) {
+			anyDigit = true;
+			if ((mantissa == 0) && (*p == '0')) {
+				exponent--;
+				continue;
+			}
+			if (significant < 19) {
+				mantissa = 10*mantissa + (*p - '0');
+				significant++;
+				exponent--;
+			}
+			else
+				truncated = true;
+		}
+	}
+	if (!anyDigit)
+		return scanDoubleSlow(start, end, value);
+	if ((p < end) && ((*p == 'e') || (*p == 'E'))) {
+		const char* q = p + 1;
+		bool negativeExponent = false;
+		if ((q < end) && ((*q == '+') || (*q == '-'))) {
+			negativeExponent = (*q == '-');
+			q++;
+		}
+		if ((q < end) && isDigit(*q)) {
+			int e = 0;
+			for (; (q < end) && isDigit(*q); q++) {
+				if (e < 100000)
+					e = 10*e + (*q - '0');
+			}
+			exponent += negativeExponent ? -e : e;
+			p = q;
+		}
+	}
+	if (mantissa == 0) {
+		value = negative ? -0.0 : 0.0;
+		return p;
+	}
+	if (truncated || (significant > 15) || (exponent < -22) || (exponent > 22))
+		return scanDoubleSlow(start, end, value);
+	// Both the mantissa (< 2^53) and the power of ten are exact doubles, so one rounding gives the correct result.
+	double v = (double) mantissa;
+	v = (exponent < 0) ? v/powersOfTen[-exponent] : v*powersOfTen[exponent];
+	value = negative ? -v : v;
+	return p;
+}
+
+struct ParsedChunk {
+	vector<long int> rowEnd;          // number of non-zeros of the chunk up to the end of each row
+	vector<int> colIndex;
+	vector<double> values;
+	Vector labels;
+	int maxIndex;
+	long int lines;          // lines scanned in the chunk
+	long int errorLine;          // line of the first error within the chunk (-1 if none)
+	const char* errorMessage;
+	ParsedChunk() : maxIndex(-1), lines(0), errorLine(-1), errorMessage(NULL) {
+	}
+};
+
+static inline bool endOfToken(const char* p, const char* eol){
+	return (p == eol) || isBlank(*p);
+}
+
+// Parses the line [p, eol) into the chunk, returns an error message or NULL.
+static const char* parseLine(const char* p, const char* eol, SparseTextFormat format, ParsedChunk& c){
+	p = skipBlanks(p, eol);
+	if (format == LIBSVM_FORMAT) {
+		if ((p == eol) || (*p == '#'))
+			return NULL;
+		double label;
+		p = scanDouble(p, eol, label);
+		if ((p == NULL) || !endOfToken(p, eol))
+			return "cannot read the label";
+		c.labels.push_back(label);
+	}
+	while (true) {
+		p = skipBlanks(p, eol);
+		if ((p == eol) || ((format == LIBSVM_FORMAT) && (*p == '#')))
+			break;
+		int index;
+		double value;
+		p = scanInt(p, eol, index);
+		if (p == NULL)
+			return "cannot read a feature index";
+		if (index < 0)
+			return "negative feature index";
+		if (format == LIBSVM_FORMAT) {
+			if ((p == eol) || (*p != ':'))
+				return "expected index:value";
+			p++;
+		}
+		else {
+			if ((p == eol) || !isBlank(*p))
+				return "expected index value";
+			p = skipBlanks(p, eol);
+		}
+		p = scanDouble(p, eol, value);
+		if ((p == NULL) || !endOfToken(p, eol))
+			return "cannot read a feature value";
+		c.colIndex.push_back(index);
+		c.values.push_back(value);
+		if (index > c.maxIndex)
+			c.maxIndex = index;
+	}
+	c.rowEnd.push_back(c.colIndex.size());
+	return NULL;
+}
+
+static void parseChunk(const char* p, const char* end, SparseTextFormat format, ParsedChunk& c){
+	c.colIndex.reserve((end - p)/16);
+	c.values.reserve((end - p)/16);
+	while (p < end) {
+		const char* eol = (const char*) memchr(p, '\n', end - p);
+		if (eol == NULL)
+			eol = end;
+		c.lines++;
+		const char* message = parseLine(p, eol, format, c);
+		if (message != NULL) {
+			c.errorLine = c.lines;
+			c.errorMessage = message;
+			return;
+		}
+		p = eol + 1;
+	}
+}
+
+void parseSparseText(const char* fname, SparseTextFormat format, SparseDataset& features, Vector& y,
+                     int& n, int& numFeatures, int nThreads){
+	MappedFile file(fname);
+	const char* data = file.data();
+	long int size = file.size();
+	nThreads = resolveThreads(nThreads);
+	int nChunks = max(1L, min((long int) CHUNKS_PER_THREAD*nThreads, size/MIN_CHUNK_BYTES));
+
+	// Chunk k covers [start[k], start[k+1]), every chunk begins at the start of a line.
+	vector<long int> start(nChunks + 1);
+	start[0] = 0;
+	start[nChunks] = size;
+	for (int k = 1; k < nChunks; k++) {
+		long int pos = max(start[k-1], (long int) ((double) size*k/nChunks));
+		while ((pos < size) && (pos > 0) && (data[pos-1] != '\n'))
+			pos++;
+		start[k] = pos;
+	}
+
+	vector<ParsedChunk> chunks(nChunks);
+	#pragma omp parallel for schedule(dynamic, 1) num_threads(nThreads)
+	for (int k = 0; k < nChunks; k++)
+		parseChunk(data + start[k], data + start[k+1], format, chunks[k]);
+
+	long int lines = 0;
+	for (int k = 0; k < nChunks; k++) {
+		if (chunks[k].errorLine >= 0)
+			error("ERROR: %s, line %ld: %s", fname, lines + chunks[k].errorLine, chunks[k].errorMessage);
+		lines += chunks[k].lines;
+	}
+
+	// Merge the chunks into one CSR buffer, each chunk is copied to its offset in parallel.
+	vector<long int> rowOffset(nChunks + 1, 0), nnzOffset(nChunks + 1, 0);
+	int maxIndex = 0;
+	for (int k = 0; k < nChunks; k++) {
+		rowOffset[k+1] = rowOffset[k] + chunks[k].rowEnd.size();
+		nnzOffset[k+1] = nnzOffset[k] + chunks[k].colIndex.size();
+		maxIndex = max(maxIndex, chunks[k].maxIndex);
+	}
+	if (rowOffset[nChunks] > INT_MAX)
+		error("ERROR: %s has too many rows (%ld)", fname, rowOffset[nChunks]);
+	n = rowOffset[nChunks];
+	numFeatures = maxIndex + 1;
+	vector<long int> rowPtr(n + 1);
+	vector<int> colIndex(nnzOffset[nChunks]);
+	vector<double> values(nnzOffset[nChunks]);
+	y.resize((format == LIBSVM_FORMAT) ? n : 0);
+	rowPtr[0] = 0;
+	#pragma omp parallel for schedule(dynamic, 1) num_threads(nThreads)
+	for (int k = 0; k < nChunks; k++) {
+		ParsedChunk& c = chunks[k];
+		for (long int i = 0; i < c.rowEnd.size(); i++)
+			rowPtr[rowOffset[k] + i + 1] = nnzOffset[k] + c.rowEnd[i];
+		copy(c.colIndex.begin(), c.colIndex.end(), colIndex.begin() + nnzOffset[k]);
+		copy(c.values.begin(), c.values.end(), values.begin() + nnzOffset[k]);
+		copy(c.labels.begin(), c.labels.end(), y.begin() + rowOffset[k]);
+		c = ParsedChunk();         // release the chunk buffers
+	}
+	features = SparseDataset(numFeatures, rowPtr, colIndex, values);
+}
+
+}
@@ -0,0 +1,40 @@
+// Copyright (C) Rishabh Iyer, John T. Halloran, and Kai Wei
+// Licensed under the Open Software License version 3.0
+// See COPYING or http://opensource.org/licenses/OSL-3.0
+/*
+        Jensen: A Convex Optimization And Machine Learning ToolKit
+ *	A parallel parser for sparse text data files. The file is memory-mapped and split at line
+        boundaries into chunks, the chunks are tokenized concurrently (one OpenMP thread per chunk,
+        no sscanf and no limit on the line length) and the results are merged into one CSR buffer.
+        Author: Rishabh Iyer
+ *
+ */
+
+#ifndef SPARSE_TEXT_PARSER_H
+#define SPARSE_TEXT_PARSER_H
+
+#include "Vector.h"
+#include "SparseDataset.h"
+
+namespace jensen {
+
+enum SparseTextFormat {
+	LIBSVM_FORMAT,                 // "label index:value index:value ...", blank lines and # comments are skipped
+	INDEX_VALUE_FORMAT                 // "index value index value ...", every line is a row (labels are stored separately)
+};
+
+// Parses fname into features (and the labels into y, for LIBSVM_FORMAT). n is the number of rows and
+// numFeatures is one more than the largest feature index. nThreads <= 0 uses all available threads.
+// Exits with an error that names the offending line if the file is malformed.
+void parseSparseText(const char* fname, SparseTextFormat format, SparseDataset& features, Vector& y,
+                     int& n, int& numFeatures, int nThreads = 0);
+
+// Scans a (decimal or scientific) number in [p, end), returns the position after it or NULL if there is no
+// number at p. Exact for up to 15 significant digits and powers of ten up to 1e22, falls back to strtod otherwise.
+const char* scanDouble(const char* p, const char* end, double& value);
+
+// Scans a signed integer that fits in an int, returns the position after it or NULL.
+const char* scanInt(const char* p, const char* end, int& value);
+
+}
+#endif
@@ -0,0 +1,46 @@
+// Copyright (C) Rishabh Iyer, John T. Halloran, and Kai Wei
+// Licensed under the Open Software License version 3.0
+// See COPYING or http://opensource.org/licenses/OSL-3.0
+/*
+        Jensen: A Convex Optimization And Machine Learning ToolKit
+ *	A sparse vector with its non-zeros sorted by index.
+        Author: Rishabh Iyer
+ *
+ */
+
+#include <assert.h>
+#include "SparseVector.h"
+
+namespace jensen {
+
+SparseVector::SparseVector() : numFeatures(0) {
+}
+
+SparseVector::SparseVector(int numFeatures) : numFeatures(numFeatures) {
+}
+
+SparseVector::SparseVector(const Vector& x) : numFeatures(x.size()) {
+	for (int j = 0; j < x.size(); j++) {
+		if (x[j] != 0)
+			push_back(j, x[j]);
+	}
+}
+
+int SparseVector::nnz() const {
+	return index.size();
+}
+
+void SparseVector::push_back(int j, double v){
+	assert(index.empty() || (j > index.back()));
+	index.push_back(j);
+	value.push_back(v);
+}
+
+Vector SparseVector::dense() const {
+	Vector x(numFeatures, 0);
+	for (int k = 0; k < index.size(); k++)
+		x[index[k]] = value[k];
+	return x;
+}
+
+}
@@ -0,0 +1,33 @@
+// Copyright (C) Rishabh Iyer, John T. Halloran, and Kai Wei
+// Licensed under the Open Software License version 3.0
+// See COPYING or http://opensource.org/licenses/OSL-3.0
+/*
+        Jensen: A Convex Optimization And Machine Learning ToolKit
+ *	A sparse vector with its non-zeros sorted by index, e.g. the weights of an l_1 regularized model.
+        The operations with Vector, SparseFeature, DenseFeature and SparseRow are in VectorOperations.h.
+        Author: Rishabh Iyer
+ *
+ */
+
+#ifndef SPARSE_VECTOR_H
+#define SPARSE_VECTOR_H
+
+#include <vector>
+#include "Vector.h"
+
+namespace jensen {
+
+struct SparseVector {
+	std::vector<int> index;                 // indices of the non-zeros, increasing
+	std::vector<double> value;                 // values of the non-zeros
+	int numFeatures;                 // dimension
+	SparseVector();
+	SparseVector(int numFeatures);
+	SparseVector(const Vector& x);                 // the non-zeros of x
+	int nnz() const;
+	void push_back(int j, double v);                 // appends a non-zero, j has to exceed the last index
+	Vector dense() const;
+};
+
+}
+#endif
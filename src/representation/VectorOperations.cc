@@ -11,7 +11,9 @@
 #include <cmath>
 #include <iostream>
 #include <assert.h>
+#include <algorithm>
 #include "../utils/utils.h"
+#include "SimdKernels.h"
 
 namespace jensen {
 double sum(const Vector& x)
@@ -28,11 +30,8 @@ double sum(const Vector& x)
 void vectorAddition(const Vector& x, const Vector& y, Vector& z)
 {
 	// assert(n == y.size());
-	z = Vector(x.size(), 0);
-	for (int i = 0; i < x.size(); i++)
-	{
-		z[i] = x[i] + y[i];
-	}
+	z.resize(x.size());
+	axpyKernel(1, y.data(), x.data(), z.data(), x.size());
 	return;
 }
 
@@ -59,6 +58,18 @@ void vectorFeatureAddition(const Vector& x, const DenseFeature& f, Vector& z)
 	return;
 }
 
+void vectorFeatureAddition(const Vector& x, const SparseRow& f, Vector& z)
+{
+	// assert(x.size() == f.numFeatures);
+	z = Vector(x);
+	for (int i = 0; i < f.featureIndex.size(); i++)
+	{
+		int j = f.featureIndex[i];
+		z[j] += f.featureVec[i];
+	}
+	return;
+}
+
 void vectorScalarAddition(const Vector& x, const double a, Vector& z)
 {
 	z = Vector(x.size(), 0);
@@ -73,11 +84,8 @@ void vectorScalarAddition(const Vector& x, const double a, Vector& z)
 void vectorSubtraction(const Vector& x, const Vector& y, Vector& z)
 {
 	// assert(x.size() == y.size());
-	z = Vector(x.size(), 0);
-	for (int i = 0; i < x.size(); i++)
-	{
-		z[i] = x[i] - y[i];
-	}
+	z.resize(x.size());
+	axpyKernel(-1, y.data(), x.data(), z.data(), x.size());
 	return;
 }
 
@@ -104,6 +112,18 @@ void vectorFeatureSubtraction(const Vector& x, const DenseFeature& f, Vector& z)
 	return;
 }
 
+void vectorFeatureSubtraction(const Vector& x, const SparseRow& f, Vector& z)
+{
+	// assert(x.size() == f.numFeatures);
+	z = Vector(x);
+	for (int i = 0; i < f.featureIndex.size(); i++)
+	{
+		int j = f.featureIndex[i];
+		z[j] -= f.featureVec[i];
+	}
+	return;
+}
+
 void vectorScalarSubtraction(const Vector& x, const double a, Vector& z)
 {
 	z = Vector(x.size(), 0);
@@ -153,11 +173,8 @@ Vector elementPower(const Vector& x, const double a)
 // z = a*x (a scalar)
 void scalarMultiplication(const Vector& x, const double a, Vector& z)
 {
-	z = Vector(x.size(), 0);
-	for (int i = 0; i < x.size(); i++)
-	{
-		z[i] = a*x[i];
-	}
+	z.resize(x.size());
+	scaleKernel(a, x.data(), z.data(), x.size());
 	return;
 }
 
@@ -181,43 +198,72 @@ void scalarMultiplication(const DenseFeature& f, const double a, DenseFeature& g
 	return;
 }
 
-double innerProduct(const Vector& x, const Vector& y)
+void scalarMultiplication(const SparseRow& f, const double a, SparseFeature& g)
 {
-	// assert(x.size() == y.size());
-	double d = 0;
-	for (int i = 0; i < x.size(); i++)
+	g.index = f.index;
+	g.numUniqueFeatures = f.numUniqueFeatures;
+	g.numFeatures = f.numFeatures;
+	g.featureIndex.assign(f.featureIndex.begin(), f.featureIndex.end());
+	g.featureVec.resize(f.featureVec.size());
+	for (int i = 0; i < f.featureVec.size(); i++)
 	{
-		d += x[i]*y[i];
+		g.featureVec[i] = a*f.featureVec[i];
 	}
-	return d;
+	return;
+}
+
+double innerProduct(const Vector& x, const Vector& y)
+{
+	// assert(x.size() == y.size());
+	return dotKernel(x.data(), y.data(), x.size());
 }
 
 double featureProduct(const Vector& x, const SparseFeature& f)
+{
+	// assert(x.size() == f.numFeatures);
+	return sparseDotKernel(x.data(), f.featureIndex.data(), f.featureVec.data(), f.featureIndex.size());
+}
+
+double featureProduct(const Vector& x, const DenseFeature& f)
+{
+	// assert(x.size() == f.featureVec.size());
+	return dotKernel(x.data(), f.featureVec.data(), f.featureVec.size());
+}
+
+double featureProduct(const Vector& x, const SparseRow& f)
+{
+	// assert(x.size() == f.numFeatures);
+	return sparseDotKernel(x.data(), f.featureIndex.begin(), f.featureVec.begin(), f.featureIndex.size());
+}
+// An implementation of a feature-vector product, in the case when the feature dimension exceeds that of x.
+double featureProductCheck(const Vector& x, const SparseFeature& f)
 {
 	// assert(x.size() == f.numFeatures);
 	double d = 0;
 	for (int i = 0; i < f.featureIndex.size(); i++)
 	{
 		int j = f.featureIndex[i];
-		d += x[j]*f.featureVec[i];
+		if (j < x.size())
+			d += x[j]*f.featureVec[i];
 	}
 	return d;
 }
 
-double featureProduct(const Vector& x, const DenseFeature& f)
+// An implementation of a feature-vector product, in the case when the feature dimension exceeds that of x.
+double featureProductCheck(const Vector& x, const DenseFeature& f)
 {
 	// assert(x.size() == f.featureVec.size());
 	double d = 0;
-	for (int i = 0; i < f.featureVec.size(); i++)
+	for (int i = 0; i < x.size(); i++)
 	{
 		d += x[i]*f.featureVec[i];
 	}
 	return d;
 }
+
 // An implementation of a feature-vector product, in the case when the feature dimension exceeds that of x.
-double featureProductCheck(const Vector& x, const SparseFeature& f)
+double featureProductCheck(const Vector& x, const SparseRow& f)
 {
-	// assert(x.size() == f.numFeatures);
 	double d = 0;
 	for (int i = 0; i < f.featureIndex.size(); i++)
 	{
@@ -228,18 +274,44 @@ double featureProductCheck(const Vector& x, const SparseFeature& f)
 	return d;
 }
 
-// An implementation of a feature-vector product, in the case when the feature dimension exceeds that of x.
-double featureProductCheck(const Vector& x, const DenseFeature& f)
+// s^T f for sorted feature indices. Each index of f is searched from the position of the previous one, so the cost is
+// O(nnz(f) log nnz(s)) for the short rows against the many non-zeros of a model.
+template <class Index, class Value>
+static inline double sparseVectorProduct(const SparseVector& s, const Index fIndex, const Value fVal, const long int nnz)
 {
-	// assert(x.size() == f.featureVec.size());
 	double d = 0;
-	for (int i = 0; i < x.size(); i++)
+	std::vector<int>::const_iterator begin = s.index.begin(), pos = begin, end = s.index.end();
+	for (long int k = 0; (k < nnz) && (pos != end); k++)
 	{
-		d += x[i]*f.featureVec[i];
+		pos = std::lower_bound(pos, end, fIndex[k]);
+		if ((pos != end) && (*pos == fIndex[k]))
+			d += s.value[pos - begin]*fVal[k];
 	}
 	return d;
 }
 
+double featureProductCheck(const SparseVector& s, const SparseFeature& f)
+{
+	return sparseVectorProduct(s, f.featureIndex.data(), f.featureVec.data(), f.featureIndex.size());
+}
+
+double featureProductCheck(const SparseVector& s, const DenseFeature& f)
+{
+	double d = 0;
+	for (int k = 0; k < s.index.size(); k++)
+	{
+		int j = s.index[k];
+		if (j < f.featureVec.size())
+			d += s.value[k]*f.featureVec[j];
+	}
+	return d;
+}
+
+double featureProductCheck(const SparseVector& s, const SparseRow& f)
+{
+	return sparseVectorProduct(s, f.featureIndex.begin(), f.featureVec.begin(), f.featureIndex.size());
+}
+
 void outerProduct(const Vector& x, const Vector& y, Matrix& m)
 {
 	for (int i = 0; i < x.size(); i++)
@@ -256,20 +328,107 @@ void outerProduct(const Vector& x, const Vector& y, Matrix& m)
 void multiplyAccumulate(Vector& z, const Vector& x, const double alpha, const Vector& g)
 {
 	// assert(x.size() == g.size());
-	z = Vector(x.size(), 0);
-	for (int i = 0; i < x.size(); i++) {
-		z[i] = x[i] - alpha*g[i];
-	}
+	z.resize(x.size());
+	axpyKernel(-alpha, g.data(), x.data(), z.data(), x.size());
 }
 
 // x = x - alpha*g
 void multiplyAccumulate(Vector& x, const double alpha, const Vector& g){
 	// assert(x.size() == g.size());
-	for (int i = 0; i < x.size(); i++) {
-		x[i] -= alpha*g[i];
+	axpyKernel(-alpha, g.data(), x.data(), x.data(), x.size());
+}
+
+// x = x - alpha*s
+void multiplyAccumulate(Vector& x, const double alpha, const SparseVector& s){
+	// assert(x.size() == s.numFeatures);
+	sparseAxpyKernel(-alpha, s.index.data(), s.value.data(), x.data(), s.index.size());
+}
+
+// x = x + a*f
+void featureMultiplyAdd(Vector& x, const double a, const SparseFeature& f){
+	// assert(x.size() == f.numFeatures);
+	sparseAxpyKernel(a, f.featureIndex.data(), f.featureVec.data(), x.data(), f.featureIndex.size());
+}
+
+void featureMultiplyAdd(Vector& x, const double a, const DenseFeature& f){
+	// assert(x.size() == f.featureVec.size());
+	axpyKernel(a, f.featureVec.data(), x.data(), x.data(), x.size());
+}
+
+void featureMultiplyAdd(Vector& x, const double a, const SparseRow& f){
+	// assert(x.size() == f.numFeatures);
+	sparseAxpyKernel(a, f.featureIndex.begin(), f.featureVec.begin(), x.data(), f.featureIndex.size());
+}
+
+// x = x - a*f
+void featureMultiplySubtract(Vector& x, const double a, const SparseFeature& f){
+	// assert(x.size() == f.numFeatures);
+	sparseAxpyKernel(-a, f.featureIndex.data(), f.featureVec.data(), x.data(), f.featureIndex.size());
+}
+
+void featureMultiplySubtract(Vector& x, const double a, const DenseFeature& f){
+	// assert(x.size() == f.featureVec.size());
+	axpyKernel(-a, f.featureVec.data(), x.data(), x.data(), x.size());
+}
+
+void featureMultiplySubtract(Vector& x, const double a, const SparseRow& f){
+	// assert(x.size() == f.numFeatures);
+	sparseAxpyKernel(-a, f.featureIndex.begin(), f.featureVec.begin(), x.data(), f.featureIndex.size());
+}
+
+// x = x + a*f and d = d + b*f.^2
+template <class Index, class Value>
+static inline void sparseAxpySquares(const double a, const double b, const Index index, const Value val, double* x, double* d,
+                                     long int nnz){
+	for (long int k = 0; k < nnz; k++) {
+		double v = val[k];
+		x[index[k]] += a*v;
+		d[index[k]] += b*v*v;
+	}
+}
+
+void featureMultiplyAddSquares(Vector& x, const double a, Vector& d, const double b, const SparseFeature& f){
+	sparseAxpySquares(a, b, f.featureIndex.data(), f.featureVec.data(), x.data(), d.data(), f.featureIndex.size());
+}
+
+void featureMultiplyAddSquares(Vector& x, const double a, Vector& d, const double b, const DenseFeature& f){
+	for (int j = 0; j < f.featureVec.size(); j++) {
+		double v = f.featureVec[j];
+		x[j] += a*v;
+		d[j] += b*v*v;
 	}
 }
 
+void featureMultiplyAddSquares(Vector& x, const double a, Vector& d, const double b, const SparseRow& f){
+	sparseAxpySquares(a, b, f.featureIndex.begin(), f.featureVec.begin(), x.data(), d.data(), f.featureIndex.size());
+}
+
+// x = x + a*f, each element updated atomically (the other elements may change concurrently).
+template <class Index, class Value>
+static inline void atomicSparseAxpy(const double a, const Index index, const Value val, double* x, long int nnz){
+	for (long int k = 0; k < nnz; k++) {
+		double delta = a*val[k];
+		#pragma omp atomic
+		x[index[k]] += delta;
+	}
+}
+
+void featureMultiplyAddAtomic(Vector& x, const double a, const SparseFeature& f){
+	atomicSparseAxpy(a, f.featureIndex.data(), f.featureVec.data(), x.data(), f.featureIndex.size());
+}
+
+void featureMultiplyAddAtomic(Vector& x, const double a, const DenseFeature& f){
+	for (int j = 0; j < f.featureVec.size(); j++) {
+		double delta = a*f.featureVec[j];
+		#pragma omp atomic
+		x[j] += delta;
+	}
+}
+
+void featureMultiplyAddAtomic(Vector& x, const double a, const SparseRow& f){
+	atomicSparseAxpy(a, f.featureIndex.begin(), f.featureVec.begin(), x.data(), f.featureIndex.size());
+}
+
 int argMax(Vector& x) {
     double maxVal = 0.0;
     int maxIndex = -1;
@@ -285,25 +444,29 @@ int argMax(Vector& x) {
 
 double norm(const Vector& x, const int type)
 {
+	if (type == 1)         // l_1 norm
+		return sumAbsKernel(x.data(), x.size());
+	else if (type == 2)         // l_2 norm
+		return sqrt(sumSquaresKernel(x.data(), x.size()));
 	double val = 0;
 	for (int i = 0; i < x.size(); i++)
 	{
 		if (type == 0)         // l_0 norm
 			val+= (x[i]==0);
-		else if (type == 1)         // l_1 norm
-			val+= std::abs(x[i]);
-		else if (type == 2)         // l_2 norm
-			val+= pow(x[i], 2);
 		else if (type == 3)         // l_{\infty} norm
 		{
 			if (val < x[i])
 				val = x[i];
 		}
 	}
-	if (type == 2)
-		return sqrt(val);
-	else
-		return val;
+	return val;
+}
+
+double norm(const SparseVector& s, const int type)
+{
+	if (type == 0)         // number of non-zeros
+		return s.nnz();
+	return norm(s.value, type);
 }
 
 Vector abs(const Vector& x){
@@ -369,6 +532,12 @@ const Vector operator+(const Vector& x, const DenseFeature &f){
 	return z;
 }
 
+const Vector operator+(const Vector& x, const SparseRow &f){
+	Vector z;
+	vectorFeatureAddition(x, f, z);
+	return z;
+}
+
 const Vector operator+(const Vector& x, const double a){
 	Vector z;
 	vectorScalarAddition(x, a, z);
@@ -393,6 +562,12 @@ const Vector operator-(const Vector& x, const DenseFeature &f){
 	return z;
 }
 
+const Vector operator-(const Vector& x, const SparseRow &f){
+	Vector z;
+	vectorFeatureSubtraction(x, f, z);
+	return z;
+}
+
 const Vector operator-(const Vector& x, const double a){
 	Vector z;
 	vectorScalarSubtraction(x, a, z);
@@ -414,6 +589,11 @@ const double operator*(const Vector& x, const DenseFeature &f){
 	return d;
 }
 
+const double operator*(const Vector& x, const SparseRow &f){
+	double d = featureProduct(x, f);
+	return d;
+}
+
 const Vector operator*(const Vector& x, const double a){
 	Vector z;
 	scalarMultiplication(x, a, z);
@@ -426,6 +606,49 @@ const Vector operator*(const double a, const Vector& x){
 	return z;
 }
 
+const double operator*(const Vector& x, const SparseVector& s){
+	// assert(x.size() == s.numFeatures);
+	return sparseDotKernel(x.data(), s.index.data(), s.value.data(), s.index.size());
+}
+
+const double operator*(const SparseVector& s, const Vector& x){
+	return x*s;
+}
+
+const double operator*(const SparseVector& s, const SparseFeature& f){
+	return featureProductCheck(s, f);
+}
+
+const double operator*(const SparseVector& s, const DenseFeature& f){
+	return featureProductCheck(s, f);
+}
+
+const double operator*(const SparseVector& s, const SparseRow& f){
+	return featureProductCheck(s, f);
+}
+
+const SparseVector operator*(const SparseVector& s, const double a){
+	SparseVector z(s);
+	scaleKernel(a, s.value.data(), z.value.data(), s.value.size());
+	return z;
+}
+
+const SparseVector operator*(const double a, const SparseVector& s){
+	return s*a;
+}
+
+const Vector operator+(const Vector& x, const SparseVector& s){
+	Vector z(x);
+	z += s;
+	return z;
+}
+
+const Vector operator-(const Vector& x, const SparseVector& s){
+	Vector z(x);
+	z -= s;
+	return z;
+}
+
 const SparseFeature operator*(const SparseFeature& f, const double a){
 	SparseFeature g;
 	scalarMultiplication(f, a, g);
@@ -450,22 +673,27 @@ const DenseFeature operator*(const double a, const DenseFeature& f){
 	return g;
 }
 
+const SparseFeature operator*(const SparseRow& f, const double a){
+	SparseFeature g;
+	scalarMultiplication(f, a, g);
+	return g;
+}
+
+const SparseFeature operator*(const double a, const SparseRow& f){
+	SparseFeature g;
+	scalarMultiplication(f, a, g);
+	return g;
+}
+
 Vector& operator+=(Vector& x, const Vector &y){
 	// assert(x.size() == y.size());
-	for (int i = 0; i < x.size(); i++)
-	{
-		x[i] += y[i];
-	}
+	axpyKernel(1, y.data(), x.data(), x.data(), x.size());
 	return x;
 }
 
 Vector& operator+=(Vector& x, const SparseFeature &f){
 	// assert(x.size() == f.numFeatures);
-	for (int i = 0; i < f.featureIndex.size(); i++)
-	{
-		int j = f.featureIndex[i];
-		x[j] += f.featureVec[i];
-	}
+	sparseAxpyKernel(1, f.featureIndex.data(), f.featureVec.data(), x.data(), f.featureIndex.size());
 	return x;
 }
 
@@ -478,6 +706,12 @@ Vector& operator+=(Vector& x, const DenseFeature &f){
 	return x;
 }
 
+Vector& operator+=(Vector& x, const SparseRow &f){
+	// assert(x.size() == f.numFeatures);
+	sparseAxpyKernel(1, f.featureIndex.begin(), f.featureVec.begin(), x.data(), f.featureIndex.size());
+	return x;
+}
+
 Vector& operator+=(Vector& x, const double a){
 	for (int i = 0; i < x.size(); i++)
 	{
@@ -488,20 +722,13 @@ Vector& operator+=(Vector& x, const double a){
 
 Vector& operator-=(Vector& x, const Vector &y){
 	// assert(x.size() == y.size());
-	for (int i = 0; i < x.size(); i++)
-	{
-		x[i] -= y[i];
-	}
+	axpyKernel(-1, y.data(), x.data(), x.data(), x.size());
 	return x;
 }
 
 Vector& operator-=(Vector& x, const SparseFeature &f){
 	// assert(x.size() == f.numFeatures);
-	for (int i = 0; i < f.featureIndex.size(); i++)
-	{
-		int j = f.featureIndex[i];
-		x[j] -= f.featureVec[i];
-	}
+	sparseAxpyKernel(-1, f.featureIndex.data(), f.featureVec.data(), x.data(), f.featureIndex.size());
 	return x;
 }
 
@@ -514,6 +741,12 @@ Vector& operator-=(Vector& x, const DenseFeature &f){
 	return x;
 }
 
+Vector& operator-=(Vector& x, const SparseRow &f){
+	// assert(x.size() == f.numFeatures);
+	sparseAxpyKernel(-1, f.featureIndex.begin(), f.featureVec.begin(), x.data(), f.featureIndex.size());
+	return x;
+}
+
 Vector& operator-=(Vector& x, const double a){
 	for (int i = 0; i < x.size(); i++)
 	{
@@ -522,11 +755,18 @@ Vector& operator-=(Vector& x, const double a){
 	return x;
 }
 
+Vector& operator+=(Vector& x, const SparseVector& s){
+	sparseAxpyKernel(1, s.index.data(), s.value.data(), x.data(), s.index.size());
+	return x;
+}
+
+Vector& operator-=(Vector& x, const SparseVector& s){
+	sparseAxpyKernel(-1, s.index.data(), s.value.data(), x.data(), s.index.size());
+	return x;
+}
+
 Vector& operator*=(Vector& x, const double a){
-	for (int i = 0; i < x.size(); i++)
-	{
-		x[i] *= a;
-	}
+	scaleKernel(a, x.data(), x.data(), x.size());
 	return x;
 }
 
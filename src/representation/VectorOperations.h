@@ -14,17 +14,21 @@
 #include "Vector.h"
 #include "Matrix.h"
 #include "SparseFeature.h"
+#include "SparseDataset.h"
 #include "DenseFeature.h"
+#include "SparseVector.h"
 #include <iostream>
 namespace jensen {
 double sum(const Vector& x);
 void vectorAddition(const Vector& x, const Vector& y, Vector& z);
 void vectorFeatureAddition(const Vector& x, const SparseFeature& f, Vector& z);
 void vectorFeatureAddition(const Vector& x, const DenseFeature& f, Vector& z);
+void vectorFeatureAddition(const Vector& x, const SparseRow& f, Vector& z);
 void vectorScalarAddition(const Vector& x, const double a, Vector& z);
 void vectorSubtraction(const Vector& x, const Vector& y, Vector& z);
 void vectorFeatureSubtraction(const Vector& x, const SparseFeature& f, Vector& z);
 void vectorFeatureSubtraction(const Vector& x, const DenseFeature& f, Vector& z);
+void vectorFeatureSubtraction(const Vector& x, const SparseRow& f, Vector& z);
 void vectorScalarSubtraction(const Vector& x, const double a, Vector& z);
 void elementMultiplication(const Vector& x, const Vector& y, Vector& z);
 Vector elementMultiplication(const Vector& x, const Vector& y);
@@ -33,11 +37,21 @@ void elementPower(const Vector& x, const double a, Vector& z);
 void scalarMultiplication(const Vector& x, const double a, Vector& z);
 void scalarMultiplication(const SparseFeature& f, const double a, SparseFeature& g);
 void scalarMultiplication(const DenseFeature& f, const double a, DenseFeature& g);
+void scalarMultiplication(const SparseRow& f, const double a, SparseFeature& g);
 double innerProduct(const Vector& x, const Vector& y);
 double featureProduct(const Vector& x, const SparseFeature& f);
 double featureProduct(const Vector& x, const DenseFeature& f);
+double featureProduct(const Vector& x, const SparseRow& f);
 double featureProductCheck(const Vector& x, const SparseFeature& f);
 double featureProductCheck(const Vector& x, const DenseFeature& f);
+double featureProductCheck(const Vector& x, const SparseRow& f);
+// Sparse vectors (see SparseVector.h). The products with the sparse features merge the two index lists (the feature
+// indices have to be sorted) and skip features beyond the dimension, as featureProductCheck.
+double featureProductCheck(const SparseVector& s, const SparseFeature& f);
+double featureProductCheck(const SparseVector& s, const DenseFeature& f);
+double featureProductCheck(const SparseVector& s, const SparseRow& f);
+void multiplyAccumulate(Vector& x, const double alpha, const SparseVector& s);                 // x = x - alpha*s
+double norm(const SparseVector& s, const int type = 2);                 // l_1, l_2, l_{\infty} (type 3); l_0 is the number of non-zeros
 void outerProduct(const Vector& x, const Vector& y, Matrix& m);
 int argMax(Vector& x);
 double norm(const Vector& x, const int type = 2);               // default is l_2 norm
@@ -48,36 +62,69 @@ void abs(const Vector& x, Vector& absx);
 void sign(const Vector& x, Vector& sx);
 void multiplyAccumulate(Vector& z, const Vector& x, const double alpha, const Vector& g);
 void multiplyAccumulate(Vector& x, const double alpha, const Vector& g);
+// Fused x += a*f and x -= a*f, without forming the scaled feature.
+void featureMultiplyAdd(Vector& x, const double a, const SparseFeature& f);
+void featureMultiplyAdd(Vector& x, const double a, const DenseFeature& f);
+void featureMultiplyAdd(Vector& x, const double a, const SparseRow& f);
+void featureMultiplySubtract(Vector& x, const double a, const SparseFeature& f);
+void featureMultiplySubtract(Vector& x, const double a, const DenseFeature& f);
+void featureMultiplySubtract(Vector& x, const double a, const SparseRow& f);
+// Fused x += a*f and d += b*f.^2 (e.g. a gradient and the diagonal of the hessian) in one pass over the non-zeros.
+void featureMultiplyAddSquares(Vector& x, const double a, Vector& d, const double b, const SparseFeature& f);
+void featureMultiplyAddSquares(Vector& x, const double a, Vector& d, const double b, const DenseFeature& f);
+void featureMultiplyAddSquares(Vector& x, const double a, Vector& d, const double b, const SparseRow& f);
+// x += a*f with an atomic add per non-zero, for several threads updating a shared x.
+void featureMultiplyAddAtomic(Vector& x, const double a, const SparseFeature& f);
+void featureMultiplyAddAtomic(Vector& x, const double a, const DenseFeature& f);
+void featureMultiplyAddAtomic(Vector& x, const double a, const SparseRow& f);
 
 template <size_t N> Vector assign(double (&array)[N]);
 
 const Vector operator+(const Vector& x, const Vector &y);
 const Vector operator+(const Vector& x, const SparseFeature& f);
 const Vector operator+(const Vector& x, const DenseFeature& f);
+const Vector operator+(const Vector& x, const SparseRow& f);
 const Vector operator+(const Vector& x, const double a);
 const Vector operator-(const Vector& x, const Vector &y);
 const Vector operator-(const Vector& x, const SparseFeature& f);
 const Vector operator-(const Vector& x, const DenseFeature& f);
+const Vector operator-(const Vector& x, const SparseRow& f);
 const Vector operator-(const Vector& x, const double a);
 const double operator*(const Vector& x, const Vector &y);
 const double operator*(const Vector& x, const SparseFeature &f);
 const double operator*(const Vector& x, const DenseFeature &f);
+const double operator*(const Vector& x, const SparseRow &f);
 const Vector operator*(const Vector& x, const double a);
 const Vector operator*(const double a, const Vector& x);
+const double operator*(const Vector& x, const SparseVector& s);
+const double operator*(const SparseVector& s, const Vector& x);
+const double operator*(const SparseVector& s, const SparseFeature& f);
+const double operator*(const SparseVector& s, const DenseFeature& f);
+const double operator*(const SparseVector& s, const SparseRow& f);
+const SparseVector operator*(const SparseVector& s, const double a);
+const SparseVector operator*(const double a, const SparseVector& s);
+const Vector operator+(const Vector& x, const SparseVector& s);
+const Vector operator-(const Vector& x, const SparseVector& s);
 
 const SparseFeature operator*(const SparseFeature& f, const double a);
 const SparseFeature operator*(const double a, const SparseFeature& f);
 const DenseFeature operator*(const DenseFeature& f, const double a);
 const DenseFeature operator*(const double a, const DenseFeature& f);
+const SparseFeature operator*(const SparseRow& f, const double a);
+const SparseFeature operator*(const double a, const SparseRow& f);
 
 Vector& operator+=(Vector& x, const Vector &y);
 Vector& operator+=(Vector& x, const SparseFeature &f);
 Vector& operator+=(Vector& x, const DenseFeature &f);
+Vector& operator+=(Vector& x, const SparseRow &f);
 Vector& operator+=(Vector& x, const double a);
 Vector& operator-=(Vector& x, const Vector &y);
 Vector& operator-=(Vector& x, const SparseFeature &f);
 Vector& operator-=(Vector& x, const DenseFeature &f);
+Vector& operator-=(Vector& x, const SparseRow &f);
 Vector& operator-=(Vector& x, const double a);
+Vector& operator+=(Vector& x, const SparseVector& s);
+Vector& operator-=(Vector& x, const SparseVector& s);
 Vector& operator*=(Vector& x, const double a);
 bool operator== (const Vector& x, const Vector& y);
 bool operator!= (const Vector& x, const Vector& y);
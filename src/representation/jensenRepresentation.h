@@ -7,7 +7,13 @@
 #include "Vector.h"
 #include "Matrix.h"
 #include "SparseFeature.h"
+#include "SparseVector.h"
+#include "SparseDataset.h"
+#include "SimdKernels.h"
 #include "VectorOperations.h"
+#include "ScaledVector.h"
 #include "MatrixOperations.h"
+#include "DenseLinearAlgebra.h"
 #include "FileIO.h"
+#include "SparseTextParser.h"
 #endif
@@ -0,0 +1,47 @@
+// Copyright (C) Rishabh Iyer, John T. Halloran, and Kai Wei
+// Licensed under the Open Software License version 3.0
+// See COPYING or http://opensource.org/licenses/OSL-3.0
+/*
+        A read-only memory mapping of a whole file.
+ */
+
+#include "MappedFile.h"
+#include "error.h"
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <sys/types.h>
+#include <fcntl.h>
+#include <unistd.h>
+
+namespace jensen {
+
+MappedFile::MappedFile(const char* fname) : addr(NULL), length(0){
+	int fd = open(fname, O_RDONLY);
+	if (fd < 0)
+		error("ERROR: cannot open file %s", fname);
+	struct stat statebuf;
+	if (fstat(fd, &statebuf) == -1)
+		error("ERROR: cannot stat file %s", fname);
+	length = statebuf.st_size;
+	if (length > 0) {
+		addr = mmap(NULL, length, PROT_READ, MAP_SHARED, fd, 0);
+		if (addr == MAP_FAILED)
+			error("ERROR: cannot map file %s", fname);
+	}
+	close(fd);         // the mapping stays valid after the descriptor is closed
+}
+
+MappedFile::~MappedFile(){
+	if (addr != NULL)
+		munmap(addr, length);
+}
+
+const char* MappedFile::data() const {
+	return (const char*) addr;
+}
+
+size_t MappedFile::size() const {
+	return length;
+}
+
+}
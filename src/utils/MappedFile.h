@@ -0,0 +1,31 @@
+// Copyright (C) Rishabh Iyer, John T. Halloran, and Kai Wei
+// Licensed under the Open Software License version 3.0
+// See COPYING or http://opensource.org/licenses/OSL-3.0
+/*
+        A read-only memory mapping of a whole file. The pages are shared with the page cache
+        (and hence with every other process mapping the same file) and are unmapped when the
+        object is destroyed.
+ */
+
+#ifndef Jensen_MAPPED_FILE_H
+#define Jensen_MAPPED_FILE_H
+
+#include <stddef.h>
+
+namespace jensen {
+
+class MappedFile {
+protected:
+void* addr;
+size_t length;
+MappedFile(const MappedFile&);                 // not copyable
+MappedFile& operator=(const MappedFile&);
+public:
+MappedFile(const char* fname);                 // maps fname, exits with an error if that fails
+~MappedFile();
+const char* data() const;
+size_t size() const;
+};
+
+}
+#endif
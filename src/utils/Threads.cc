@@ -0,0 +1,47 @@
+// Copyright (C) Rishabh Iyer, John T. Halloran, and Kai Wei
+// Licensed under the Open Software License version 3.0
+// See COPYING or http://opensource.org/licenses/OSL-3.0
+/*
+        The thread policy of the library.
+ */
+
+#include "Threads.h"
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+
+namespace jensen {
+
+int resolveThreads(const int nThreads){
+#ifdef _OPENMP
+	return (nThreads > 0) ? nThreads : omp_get_max_threads();
+#else
+	return 1;
+#endif
+}
+
+int asynchronousThreads(const int nThreads){
+#ifdef _OPENMP
+	return (nThreads > 1) ? nThreads : 1;
+#else
+	return 1;
+#endif
+}
+
+int teamSize(){
+#ifdef _OPENMP
+	return omp_get_num_threads();
+#else
+	return 1;
+#endif
+}
+
+int threadNum(){
+#ifdef _OPENMP
+	return omp_get_thread_num();
+#else
+	return 0;
+#endif
+}
+
+}
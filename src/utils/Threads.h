@@ -0,0 +1,27 @@
+// Copyright (C) Rishabh Iyer, John T. Halloran, and Kai Wei
+// Licensed under the Open Software License version 3.0
+// See COPYING or http://opensource.org/licenses/OSL-3.0
+/*
+        The thread policy of the library. Every nThreads argument follows one convention: a positive
+        value is the number of threads requested, 0 all cores. The runtime may start a parallel region
+        with fewer threads than requested (dynamic teams, a thread limit, or a region nested in another,
+        which runs on a single thread), so code that partitions work or buffers by thread reads the
+        team size inside the region (teamSize) instead of relying on the number it requested.
+        The solvers whose iterates depend on the schedule of the threads (the asynchronous Hogwild and
+        PASSCoDe updates) are only parallel on an explicit request of more than one thread
+        (asynchronousThreads): with the default 0 they stay serial and reproducible.
+        Without OpenMP everything runs on one thread.
+ */
+
+#ifndef Jensen_THREADS_H
+#define Jensen_THREADS_H
+
+namespace jensen {
+
+int resolveThreads(const int nThreads);                 // the threads to request: nThreads if positive, else all cores
+int asynchronousThreads(const int nThreads);                 // nThreads if more than one, else 1
+int teamSize();                 // the threads of the enclosing parallel region (1 outside one)
+int threadNum();                 // the number of the calling thread in its team, from 0
+
+}
+#endif
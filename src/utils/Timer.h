@@ -0,0 +1,16 @@
+// Copyright (C) Rishabh Iyer, John T. Halloran, and Kai Wei
+// Licensed under the Open Software License version 3.0
+// See COPYING or http://opensource.org/licenses/OSL-3.0
+/*
+        Wall-clock time for the timings reported by the solvers, the benchmarks and the tools.
+ */
+
+#ifndef Jensen_TIMER_H
+#define Jensen_TIMER_H
+
+namespace jensen {
+
+double now();                 // seconds on a monotonic clock (only differences are meaningful)
+
+}
+#endif
@@ -4,3 +4,6 @@
 #include "arguments.h"
 #include "error.h"
 #include "utils.h"
+#include "MappedFile.h"
+#include "Threads.h"
+#include "Timer.h"
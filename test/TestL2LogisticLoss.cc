@@ -101,5 +101,12 @@ int main(int argc, char** argv){
 	#ifndef DEBUG
 	cin.get();
 	#endif
-	x = sgdStochasticAverageGradient(ll, x0, n, 2, 1, 200, 1e-4, numEpochs, 1.0);
+	x = sgdStochasticAverageGradient(ll, x0, n, 1, 1e-4, numEpochs);
+
+	cout<<"*******************************************************************\n";
+	cout<<"SGD with SAGA for Logistic Loss, press enter to continue...\n";
+	#ifndef DEBUG
+	cin.get();
+	#endif
+	x = sgdSAGA(ll, x0, n, 1.0/3, 1e-4, numEpochs);
 }
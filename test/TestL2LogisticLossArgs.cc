@@ -121,7 +121,7 @@ int main(int argc, char** argv){
 	 #ifndef DEBUG
 	   cin.get();
 	 #endif
-	   sgdStochasticAverageGradient(ll, Vector(m, 0), n, 2, 1, 200, 1e-4, 250, 1.0);
+	   sgdStochasticAverageGradient(ll, Vector(m, 0), n, 1, 1e-4, 250);
 	   // cout<<"*******************************************************************\n";
 	   // cout<<"Stochastic Gradient Descent with Line Search for Logistic Loss, press enter to continue...\n";
 	   // #ifndef DEBUG
@@ -0,0 +1,57 @@
+// Copyright (C) Rishabh Iyer, John T. Halloran, and Kai Wei
+// Licensed under the Open Software License version 3.0
+// See COPYING or http://opensource.org/licenses/OSL-3.0
+/*
+        Author: Rishabh Iyer
+ *
+ */
+
+#include <iostream>
+#include <cstdlib>
+#include "../src/jensen.h"
+using namespace jensen;
+using namespace std;
+
+int main(int argc, char** argv){
+	char* featureFile = "../data/20newsgroup.feat";
+	char* labelFile = "../data/20newsgroup.label";
+	int n; // number of data items
+	int m; // numFeatures
+	vector<struct SparseFeature> features = readFeatureVectorSparse(featureFile, n, m);
+	Vector y = readVector(labelFile, n) - 1;
+	int nClasses = 0;
+	for (int i = 0; i < n; i++)
+		nClasses = max(nClasses, (int) y[i] + 1);
+	int numEpochs = 50;
+	L2SoftmaxLoss<SparseFeature> ll(m, features, y, nClasses, 1);
+
+	Vector x0((long int) m*nClasses, 0), x;
+	cout<<"*******************************************************************\n";
+	cout<<"Testing Gradient Descent with Line Search for Softmax Loss, press enter to continue...\n";
+	#ifndef DEBUG
+	cin.get();
+	#endif
+	x = gdLineSearch(ll, x0, 1, 1e-4, numEpochs);
+
+	cout<<"*******************************************************************\n";
+	cout<<"L-BFGS for Softmax Loss, press enter to continue...\n";
+	#ifndef DEBUG
+	cin.get();
+	#endif
+	x = lbfgsMin(ll, x0, 1, 1e-4, numEpochs);
+
+	cout<<"*******************************************************************\n";
+	cout<<"Trust Region Newton Method for Softmax Loss, press enter to continue...\n";
+	cout<<"Note: This method does not check norm(gradient) < tol to determine convergence\n";
+	#ifndef DEBUG
+	cin.get();
+	#endif
+	x = tron(ll, x0, numEpochs);
+
+	cout<<"*******************************************************************\n";
+	cout<<"Stochastic Gradient Descent with AdaGrad for Softmax Loss, press enter to continue...\n";
+	#ifndef DEBUG
+	cin.get();
+	#endif
+	x = sgdAdagrad(ll, x0, n, 1e-2, 200, 1e-4, numEpochs);
+}
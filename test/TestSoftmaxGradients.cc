@@ -0,0 +1,109 @@
+// Copyright (C) Rishabh Iyer, John T. Halloran, and Kai Wei
+// Licensed under the Open Software License version 3.0
+// See COPYING or http://opensource.org/licenses/OSL-3.0
+/*
+        Checks the gradient and the Hessian vector product of the softmax losses against central finite
+        differences of the function value and of the gradient, on a small synthetic dataset. The point has
+        no zero coordinates and the steps do not cross zero, so the L1 term is differentiable there: its
+        pseudo-gradient is the gradient and the Hessian of the smooth part is the Hessian.
+        Returns a non-zero status on a mismatch.
+        Author: Rishabh Iyer
+ *
+ */
+
+#include <iostream>
+#include <cstdlib>
+#include <math.h>
+#include "../src/jensen.h"
+using namespace jensen;
+using namespace std;
+
+#define STEP 1e-5
+#define TOLERANCE 1e-6
+
+static int failures = 0;
+
+static double relativeDifference(const Vector& a, const Vector& b){
+	double d = 0, s = 0;
+	for (int j = 0; j < a.size(); j++) {
+		d += (a[j] - b[j])*(a[j] - b[j]);
+		s += b[j]*b[j];
+	}
+	return (a.size() == b.size()) ? sqrt(d/max(s, 1e-300)) : 1;
+}
+
+static void syntheticDataset(int n, int m, vector<SparseFeature>& features, Vector& y, int nClasses){
+	srand(1);
+	features.resize(n);
+	y.resize(n);
+	for (int i = 0; i < n; i++) {
+		features[i].index = i;
+		features[i].numFeatures = m;
+		for (int j = 0; j < m; j++) {
+			if (rand() % 3 == 0) {
+				features[i].featureIndex.push_back(j);
+				features[i].featureVec.push_back(2.0*rand()/RAND_MAX - 1);
+			}
+		}
+		features[i].numUniqueFeatures = features[i].featureIndex.size();
+		y[i] = rand() % nClasses;
+	}
+}
+
+static void check(const char* name, const char* quantity, const Vector& analytic, const Vector& numeric){
+	double e = relativeDifference(analytic, numeric);
+	bool ok = (e <= TOLERANCE);
+	printf("%-16s %-24s %s (relative difference %.2e)\n", name, quantity, ok ? "ok" : "FAILED", e);
+	failures += !ok;
+}
+
+template <class Loss>
+static void test(const char* name, const Loss& loss){
+	int m = loss.size();
+	Vector x(m), v(m);
+	for (int j = 0; j < m; j++) {
+		x[j] = 0.1*sin(j + 1.0);
+		x[j] += (x[j] < 0) ? -0.05 : 0.05;                 // |x_j| >= 0.05, far from the kink of the L1 term
+		v[j] = cos(j + 1.0);
+	}
+	double f;
+	Vector g, Hv;
+	loss.eval(x, f, g);
+	loss.evalHessianVectorProduct(x, v, Hv);
+
+	// the j-th coordinate of the gradient from (f(x + h e_j) - f(x - h e_j)) / 2h
+	Vector numericGradient(m, 0), xh(x);
+	for (int j = 0; j < m; j++) {
+		xh[j] = x[j] + STEP;
+		double fp = loss.eval(xh);
+		xh[j] = x[j] - STEP;
+		double fm = loss.eval(xh);
+		xh[j] = x[j];
+		numericGradient[j] = (fp - fm)/(2*STEP);
+	}
+	check(name, "gradient", g, numericGradient);
+
+	// H v from (g(x + h v) - g(x - h v)) / 2h
+	Vector xp(x), xm(x);
+	for (int j = 0; j < m; j++) {
+		xp[j] += STEP*v[j];
+		xm[j] -= STEP*v[j];
+	}
+	Vector numericHv = loss.evalGradient(xp);
+	Vector gm = loss.evalGradient(xm);
+	for (int j = 0; j < m; j++)
+		numericHv[j] = (numericHv[j] - gm[j])/(2*STEP);
+	check(name, "Hessian vector product", Hv, numericHv);
+}
+
+int main(int argc, char** argv){
+	int n = 200, m = 10, nClasses = 3;
+	vector<SparseFeature> features;
+	Vector y;
+	syntheticDataset(n, m, features, y, nClasses);
+	test("Softmax L2LR", L2SoftmaxLoss<SparseFeature>(m, features, y, nClasses, 1));
+	test("Softmax L1LR", L1SoftmaxLoss<SparseFeature>(m, features, y, nClasses, 1));
+	if (failures > 0)
+		printf("%d checks FAILED\n", failures);
+	return (failures > 0) ? 1 : 0;
+}
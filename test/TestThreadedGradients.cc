@@ -0,0 +1,134 @@
+// Copyright (C) Rishabh Iyer, John T. Halloran, and Kai Wei
+// Licensed under the Open Software License version 3.0
+// See COPYING or http://opensource.org/licenses/OSL-3.0
+/*
+        Checks that the row-partitioned losses give the same function value, gradient and Hessian vector
+        product with one thread and with several, also when the runtime grants fewer threads than
+        requested: with dynamic teams, and from inside a parallel region (where the nested region runs
+        on a single thread), on objects that have and have not been evaluated before.
+        Returns a non-zero status on a mismatch.
+        Author: Rishabh Iyer
+ *
+ */
+
+#include <iostream>
+#include <cstdlib>
+#include <math.h>
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+#include "../src/jensen.h"
+using namespace jensen;
+using namespace std;
+
+#define NUM_THREADS 4
+#define TOLERANCE 1e-9
+
+static int failures = 0;
+
+static double relativeDifference(const Vector& a, const Vector& b){
+	double d = 0, s = 0;
+	for (int j = 0; j < a.size(); j++) {
+		d += (a[j] - b[j])*(a[j] - b[j]);
+		s += b[j]*b[j];
+	}
+	return (a.size() == b.size()) ? sqrt(d/max(s, 1e-300)) : 1;
+}
+
+static void syntheticDataset(int n, int m, vector<SparseFeature>& features, Vector& y, int nClasses){
+	srand(1);
+	features.resize(n);
+	y.resize(n);
+	for (int i = 0; i < n; i++) {
+		features[i].index = i;
+		features[i].numFeatures = m;
+		for (int j = 0; j < m; j++) {
+			if (rand() % 5 == 0) {
+				features[i].featureIndex.push_back(j);
+				features[i].featureVec.push_back(2.0*rand()/RAND_MAX - 1);
+			}
+		}
+		features[i].numUniqueFeatures = features[i].featureIndex.size();
+		y[i] = (nClasses == 2) ? ((rand() % 2) ? 1 : -1) : rand() % nClasses;
+	}
+}
+
+// f, the gradient and a Hessian vector product of a fresh copy of the loss with T threads.
+template <class Loss>
+static void evaluate(const Loss& loss, const int T, const Vector& x, const Vector& v, double& f, Vector& g, Vector& Hv){
+	Loss c(loss);
+	c.setNumThreads(T);
+	c.eval(x, f, g);
+	c.evalHessianVectorProduct(x, v, Hv);
+}
+
+static void check(const char* name, const char* mode, double f, double f1, const Vector& g, const Vector& g1,
+                  const Vector& Hv, const Vector& Hv1){
+	double e = max(fabs(f - f1)/max(fabs(f1), 1.0), max(relativeDifference(g, g1), relativeDifference(Hv, Hv1)));
+	bool ok = (e <= TOLERANCE);
+	printf("%-16s %-24s %s (relative difference %.2e)\n", name, mode, ok ? "ok" : "FAILED", e);
+	failures += !ok;
+}
+
+template <class Loss>
+static void test(const char* name, const Loss& loss){
+	int m = loss.size();
+	Vector x(m), v(m);
+	for (int j = 0; j < m; j++) {
+		x[j] = 0.1*sin(j + 1.0);
+		v[j] = cos(j + 1.0);
+	}
+	double f1, f;
+	Vector g1, Hv1, g, Hv;
+	evaluate(loss, 1, x, v, f1, g1, Hv1);
+	evaluate(loss, NUM_THREADS, x, v, f, g, Hv);
+	check(name, "top level", f, f1, g, g1, Hv, Hv1);
+
+	// the same object evaluated again with a different team, so stale buffers would show
+	Loss c(loss);
+	c.setNumThreads(NUM_THREADS);
+	c.eval(x, f, g);
+	bool ok = true;
+	#pragma omp parallel num_threads(2)
+	{
+		double ft;
+		Vector gt, Hvt;
+		evaluate(loss, NUM_THREADS, x, v, ft, gt, Hvt);                 // a fresh object per thread
+		#pragma omp critical
+		{
+			ok = ok && (max(fabs(ft - f1)/max(fabs(f1), 1.0), max(relativeDifference(gt, g1), relativeDifference(Hvt, Hv1)))
+			            <= TOLERANCE);
+		}
+		#pragma omp single
+		{
+			c.eval(x, ft, gt);                 // the object evaluated at top level before
+			c.evalHessianVectorProduct(x, v, Hvt);
+			ok = ok && (max(fabs(ft - f1)/max(fabs(f1), 1.0), max(relativeDifference(gt, g1), relativeDifference(Hvt, Hv1)))
+			            <= TOLERANCE);
+		}
+	}
+	printf("%-16s %-24s %s\n", name, "inside a parallel region", ok ? "ok" : "FAILED");
+	failures += !ok;
+
+#ifdef _OPENMP
+	omp_set_dynamic(1);
+	evaluate(loss, NUM_THREADS, x, v, f, g, Hv);
+	omp_set_dynamic(0);
+	check(name, "dynamic teams", f, f1, g, g1, Hv, Hv1);
+#endif
+}
+
+int main(int argc, char** argv){
+	int n = 20000, m = 50, nClasses = 4;
+	vector<SparseFeature> features, multiclassFeatures;
+	Vector y, multiclassY;
+	syntheticDataset(n, m, features, y, 2);
+	syntheticDataset(n, m, multiclassFeatures, multiclassY, nClasses);
+	test("L2LR", L2LogisticLoss<SparseFeature>(m, features, y, 1));
+	test("L2SmoothSVM", L2SmoothSVMLoss<SparseFeature>(m, features, y, 1));
+	test("OvR L2LR", L2OneVsRestLoss<SparseFeature>(m, multiclassFeatures, multiclassY, nClasses, 1, OVR_LOGISTIC));
+	test("Softmax L2LR", L2SoftmaxLoss<SparseFeature>(m, multiclassFeatures, multiclassY, nClasses, 1));
+	if (failures > 0)
+		printf("%d checks FAILED\n", failures);
+	return (failures > 0) ? 1 : 0;
+}
@@ -0,0 +1,56 @@
+// Copyright (C) Rishabh Iyer, John T. Halloran, and Kai Wei
+// Licensed under the Open Software License version 3.0
+// See COPYING or http://opensource.org/licenses/OSL-3.0
+/*
+        Converts a LIBSVM text file into the binary dataset format of Jensen, which can be
+        memory-mapped by readDatasetBinary (or readDataset) without any parsing.
+ *
+ */
+
+#include <iostream>
+#include <cstdlib>
+#include "../src/jensen.h"
+using namespace jensen;
+using namespace std;
+char* inFile = NULL;
+char* outFile = NULL;
+bool verify = false;
+char* help = NULL;
+
+Arg Arg::Args[]={
+	Arg("in", Arg::Req, inFile, "the input LIBSVM data file",Arg::SINGLE),
+	Arg("out", Arg::Req, outFile, "the output binary data file",Arg::SINGLE),
+	Arg("verify", Arg::Opt, verify, "map the written file and compare it with the input",Arg::SINGLE),
+	Arg("help", Arg::Help, help, "Print this message"),
+	Arg()
+};
+
+int main(int argc, char** argv){
+	bool parse_was_ok = Arg::parse(argc,(char**)argv);
+	if(!parse_was_ok) {
+		Arg::usage(); exit(-1);
+	}
+	int n, m;
+	SparseDataset features;
+	Vector y;
+	readFeatureLabelsLibSVM(inFile, features, y, n, m);
+	writeDatasetBinary(outFile, features, y);
+	cout << "Wrote " << n << " instances with " << m << " features and " << features.nnz() << " non-zeros to " << outFile << "\n";
+	if (verify) {
+		int nb, mb;
+		SparseDataset mapped;
+		Vector yb;
+		readDatasetBinary(outFile, mapped, yb, nb, mb);
+		bool same = (nb == n) && (mb == m) && (mapped.nnz() == features.nnz()) && (yb == y);
+		for (int i = 0; same && (i <= n); i++)
+			same = (mapped.rowPointers()[i] == features.rowPointers()[i]);
+		for (long int k = 0; same && (k < features.nnz()); k++)
+			same = (mapped.indices()[k] == features.indices()[k]) && (mapped.data()[k] == features.data()[k]);
+		if (!same) {
+			cout << "Verification failed: " << outFile << " does not match " << inFile << "\n";
+			return -1;
+		}
+		cout << "Verified " << outFile << "\n";
+	}
+	return 0;
+}
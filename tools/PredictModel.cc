@@ -0,0 +1,85 @@
+// Copyright (C) Rishabh Iyer, John T. Halloran, and Kai Wei
+// Licensed under the Open Software License version 3.0
+// See COPYING or http://opensource.org/licenses/OSL-3.0
+/*
+        Scores a dataset (LIBSVM or binary) with a binary model written by saveModelBinary (e.g. the
+        -model option of the classification examples). The model is memory-mapped and the rows are
+        predicted directly from the mapping, in parallel.
+ *
+ */
+
+#include <iostream>
+#include <cstdlib>
+#include <stdio.h>
+#include <time.h>
+#include "../src/jensen.h"
+using namespace jensen;
+using namespace std;
+char* modelFile = NULL;
+char* dataFile = NULL;
+char* outFile = NULL;
+int nThreads = 0;
+bool probability = false;
+bool startwith1 = false;
+char* help = NULL;
+
+Arg Arg::Args[]={
+	Arg("model", Arg::Req, modelFile, "the binary model file",Arg::SINGLE),
+	Arg("data", Arg::Req, dataFile, "the data file to score (LIBSVM or binary)",Arg::SINGLE),
+	Arg("out", Arg::Opt, outFile, "write the predictions (and probabilities) to this file",Arg::SINGLE),
+	Arg("probability", Arg::Opt, probability, "also compute the class probabilities",Arg::SINGLE),
+	Arg("nThreads", Arg::Opt, nThreads, "number of threads used for scoring (default 0: all cores)",Arg::SINGLE),
+	Arg("startwith1", Arg::Opt, startwith1, "Whether the labels start with one or zero"),
+	Arg("help", Arg::Help, help, "Print this message"),
+	Arg()
+};
+
+int main(int argc, char** argv){
+	bool parse_was_ok = Arg::parse(argc,(char**)argv);
+	if(!parse_was_ok) {
+		Arg::usage(); exit(-1);
+	}
+	double start = now();
+	ModelFile model(modelFile);
+	double mapped = now();
+	cout << "Mapped a " << (model.isSparse() ? "sparse" : "dense") << " model with " << model.numClasses() << " classes and "
+	     << model.numFeatures() << " features in " << mapped - start << " seconds.\n";
+
+	int n, m;
+	SparseDataset data;
+	Vector y;
+	readDataset(dataFile, data, y, n, m);
+	if (startwith1)
+		y = y - 1;
+	int K = model.numClasses();
+	Vector labels(n), prob;
+	double scoring = now();
+	model.predictBatch<SparseRow>(data, labels, nThreads);
+	if (probability) {
+		prob.resize((long int) n*K);
+		model.predictProbabilityBatch<SparseRow>(data, prob, nThreads);
+	}
+	double scored = now();
+	double correct = 0;
+	for (int i = 0; i < n; i++) {
+		if (labels[i] == y[i])
+			correct++;
+	}
+	cout << "Scored " << n << " rows in " << scored - scoring << " seconds, accuracy " << correct/n << "\n";
+
+	if (outFile != NULL) {
+		FILE* fp = fopen(outFile, "w");
+		if (fp == NULL) {
+			cout << "Cannot open " << outFile << "\n";
+			return -1;
+		}
+		for (int i = 0; i < n; i++) {
+			fprintf(fp, "%g", labels[i]);
+			for (int c = 0; probability && (c < K); c++)
+				fprintf(fp, " %g", prob[(long int) i*K + c]);
+			fprintf(fp, "\n");
+		}
+		fclose(fp);
+	}
+	return 0;
+}